@@ -0,0 +1,93 @@
+'use strict';
+const common = require('../common.js');
+const {
+  AsyncLocalStorage,
+  createHook,
+  executionAsyncId
+} = require('async_hooks');
+
+// Compares the native context propagation of AsyncLocalStorage with the
+// classic approach of propagating a store through async_hooks callbacks.
+
+const bench = common.createBenchmark(main, {
+  n: [1e5],
+  storage: ['none', 'hooks', 'native'],
+  type: ['promise', 'timers']
+});
+
+function createHookStorage() {
+  const stores = new Map();
+  const hook = createHook({
+    init(asyncId, type, triggerAsyncId) {
+      const store = stores.get(executionAsyncId());
+      if (store !== undefined)
+        stores.set(asyncId, store);
+    },
+    destroy(asyncId) {
+      stores.delete(asyncId);
+    }
+  }).enable();
+  return {
+    run(store, fn) {
+      stores.set(executionAsyncId(), store);
+      return fn();
+    },
+    getStore() {
+      return stores.get(executionAsyncId());
+    },
+    disable() {
+      hook.disable();
+    }
+  };
+}
+
+function createStorage(kind) {
+  switch (kind) {
+    case 'none':
+      return {
+        run(store, fn) { return fn(); },
+        getStore() {},
+        disable() {}
+      };
+    case 'hooks':
+      return createHookStorage();
+    case 'native':
+      return new AsyncLocalStorage();
+    default:
+      throw new Error(`Unsupported storage "${kind}"`);
+  }
+}
+
+async function runPromises(storage, n) {
+  for (let i = 0; i < n; i++) {
+    await Promise.resolve(i);
+    storage.getStore();
+  }
+}
+
+function runTimers(storage, n, cb) {
+  let i = 0;
+  function next() {
+    storage.getStore();
+    if (++i === n)
+      return cb();
+    setImmediate(next);
+  }
+  setImmediate(next);
+}
+
+function main({ n, storage: kind, type }) {
+  const storage = createStorage(kind);
+  const done = () => {
+    bench.end(n);
+    storage.disable();
+  };
+
+  bench.start();
+  storage.run({ id: 1 }, () => {
+    if (type === 'promise')
+      runPromises(storage, n).then(done);
+    else
+      runTimers(storage, n, done);
+  });
+}
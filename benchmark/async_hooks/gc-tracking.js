@@ -1,11 +1,13 @@
 'use strict';
 const common = require('../common.js');
-const { AsyncResource } = require('async_hooks');
+const { AsyncResource, createBatchHook, createHook } = require('async_hooks');
 
 const bench = common.createBenchmark(main, {
   n: [1e6],
   method: [
     'trackingEnabled',
+    'trackingEnabledWithDestroyHook',
+    'trackingEnabledWithBatchHook',
     'trackingDisabled',
   ]
 }, {
@@ -31,6 +33,22 @@ function main({ n, method }) {
       }
       endAfterGC(n);
       break;
+    case 'trackingEnabledWithDestroyHook':
+      createHook({ destroy() {} }).enable();
+      bench.start();
+      for (i = 0; i < n; i++) {
+        new AsyncResource('foobar');
+      }
+      endAfterGC(n);
+      break;
+    case 'trackingEnabledWithBatchHook':
+      createBatchHook(() => {}).enable();
+      bench.start();
+      for (i = 0; i < n; i++) {
+        new AsyncResource('foobar');
+      }
+      endAfterGC(n);
+      break;
     case 'trackingDisabled':
       bench.start();
       for (i = 0; i < n; i++) {
@@ -0,0 +1,32 @@
+'use strict';
+const common = require('../common.js');
+
+const bench = common.createBenchmark(main, {
+  hooks: ['none', 'callbacks', 'batched'],
+  connections: [50, 500]
+});
+
+function main({ hooks, connections }) {
+  const { createBatchHook, createHook } = require('async_hooks');
+  if (hooks === 'callbacks') {
+    createHook({
+      init() {},
+      before() {},
+      after() {},
+      destroy() {}
+    }).enable();
+  } else if (hooks === 'batched') {
+    createBatchHook(() => {}).enable();
+  }
+
+  const server = require('../fixtures/simple-http-server.js')
+  .listen(common.PORT)
+  .on('listening', () => {
+    bench.http({
+      path: '/buffer/4/4/normal/1',
+      connections
+    }, () => {
+      server.close();
+    });
+  });
+}
@@ -15,14 +15,15 @@ if (process.argv[2] === 'child') {
       64, 256, 1024, 4096, 16384, 65536,
       65536 << 4, 65536 << 8
     ],
-    dur: [5]
+    dur: [5],
+    serialization: ['json', 'advanced']
   });
   const spawn = require('child_process').spawn;
 
-  function main({ dur, len }) {
+  function main({ dur, len, serialization }) {
     bench.start();
 
-    const options = { 'stdio': ['ignore', 1, 2, 'ipc'] };
+    const options = { 'stdio': ['ignore', 1, 2, 'ipc'], serialization };
     const child = spawn(process.argv[0],
                         [process.argv[1], 'child', len], options);
 
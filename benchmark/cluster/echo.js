@@ -5,12 +5,23 @@ if (cluster.isMaster) {
   const common = require('../common.js');
   const bench = common.createBenchmark(main, {
     workers: [1],
-    payload: ['string', 'object'],
+    payload: ['string', 'object', 'connection'],
     sendsPerBroadcast: [1, 10],
-    n: [1e5]
+    schedulingPolicy: ['rr', 'none', 'reuseport'],
+    n: [1e5],
+    connections: [1e4]
   });
 
-  function main({ n, workers, sendsPerBroadcast, payload }) {
+  function main({ n, workers, sendsPerBroadcast, payload, schedulingPolicy,
+                  connections }) {
+    cluster.schedulingPolicy =
+      cluster[`SCHED_${schedulingPolicy.toUpperCase()}`];
+
+    if (payload === 'connection') {
+      connectionRate(connections, workers, sendsPerBroadcast);
+      return;
+    }
+
     const expectedPerBroadcast = sendsPerBroadcast * workers;
     var readies = 0;
     var broadcasts = 0;
@@ -60,6 +71,50 @@ if (cluster.isMaster) {
       }
     }
   }
+
+  // Measures how many short-lived connections per second the workers can
+  // accept, with `sendsPerBroadcast` connections in flight per worker.
+  function connectionRate(connections, workers, concurrency) {
+    const net = require('net');
+    var listening = 0;
+    var started = 0;
+    var finished = 0;
+    var port;
+
+    for (var i = 0; i < workers; ++i)
+      cluster.fork({ BENCH_PAYLOAD: 'connection' });
+
+    cluster.on('listening', (worker, address) => {
+      port = address.port;
+      if (++listening === workers) {
+        bench.start();
+        for (var i = 0; i < concurrency * workers; ++i)
+          connect();
+      }
+    });
+
+    function connect() {
+      if (started === connections)
+        return;
+      started++;
+      const socket = net.connect(port);
+      socket.on('connect', () => socket.end('hello'));
+      socket.on('close', onClose);
+      socket.resume();
+    }
+
+    function onClose() {
+      if (++finished < connections)
+        return connect();
+      bench.end(connections);
+      for (const id in cluster.workers)
+        cluster.workers[id].disconnect();
+    }
+  }
+} else if (process.env.BENCH_PAYLOAD === 'connection') {
+  require('net').createServer((socket) => {
+    socket.on('data', (data) => socket.end(data));
+  }).listen(0);
 } else {
   process.on('message', function(msg) {
     process.send(msg);
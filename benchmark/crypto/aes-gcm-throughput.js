@@ -1,14 +1,18 @@
 'use strict';
+// Encrypts and decrypts `n` messages of `len` bytes with Cipheriv and
+// Decipheriv objects, or with crypto.aeadSeal() and crypto.aeadOpen(), which
+// can also work in place on a preallocated buffer.
 const common = require('../common.js');
 const crypto = require('crypto');
 const keylen = { 'aes-128-gcm': 16, 'aes-192-gcm': 24, 'aes-256-gcm': 32 };
 const bench = common.createBenchmark(main, {
   n: [500],
+  impl: ['cipher', 'seal', 'seal-in-place'],
   cipher: ['aes-128-gcm', 'aes-192-gcm', 'aes-256-gcm'],
   len: [1024, 4 * 1024, 16 * 1024, 64 * 1024, 256 * 1024, 1024 * 1024]
 });
 
-function main({ n, len, cipher }) {
+function main({ n, len, cipher, impl }) {
   // Default cipher for tests.
   if (cipher === '')
     cipher = 'aes-128-gcm';
@@ -17,7 +21,11 @@ function main({ n, len, cipher }) {
   const iv = crypto.randomBytes(12);
   const associate_data = Buffer.alloc(16, 'z');
   bench.start();
-  AEAD_Bench(cipher, message, associate_data, key, iv, n, len);
+  if (impl === 'cipher')
+    AEAD_Bench(cipher, message, associate_data, key, iv, n, len);
+  else
+    Seal_Bench(cipher, message, associate_data, key, iv, n, len,
+               impl === 'seal-in-place');
 }
 
 function AEAD_Bench(cipher, message, associate_data, key, iv, n, len) {
@@ -40,3 +48,23 @@ function AEAD_Bench(cipher, message, associate_data, key, iv, n, len) {
 
   bench.end(mbits);
 }
+
+function Seal_Bench(cipher, message, associate_data, key, iv, n, len,
+                    inPlace) {
+  const written = n * len;
+  const bits = written * 8;
+  const mbits = bits / (1024 * 1024);
+  const options = { aad: associate_data };
+  if (inPlace) {
+    options.output = Buffer.alloc(len + 16);
+    message.copy(options.output);
+    message = options.output.slice(0, len);
+  }
+
+  for (var i = 0; i < n; i++) {
+    const sealed = crypto.aeadSeal(cipher, key, iv, message, options);
+    crypto.aeadOpen(cipher, key, iv, sealed, options);
+  }
+
+  bench.end(mbits);
+}
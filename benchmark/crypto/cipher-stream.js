@@ -6,7 +6,7 @@ const bench = common.createBenchmark(main, {
   cipher: [ 'AES192', 'AES256' ],
   type: ['asc', 'utf', 'buf'],
   len: [2, 1024, 102400, 1024 * 1024],
-  api: ['legacy', 'stream']
+  api: ['legacy', 'stream', 'update-into']
 });
 
 function main({ api, cipher, type, len, writes }) {
@@ -56,7 +56,14 @@ function main({ api, cipher, type, len, writes }) {
       throw new Error(`unknown message type: ${type}`);
   }
 
-  const fn = api === 'stream' ? streamWrite : legacyWrite;
+  var fn = legacyWrite;
+  if (api === 'stream') {
+    fn = streamWrite;
+  } else if (api === 'update-into') {
+    // updateInto() only takes buffers.
+    message = Buffer.from(message, encoding);
+    fn = updateIntoWrite;
+  }
 
   // Write data as fast as possible to alice, and have bob decrypt.
   // use old API for comparison to v0.8
@@ -101,3 +108,18 @@ function legacyWrite(alice, bob, message, encoding, writes) {
   const gbits = written / (1024 * 1024 * 1024);
   bench.end(gbits);
 }
+
+function updateIntoWrite(alice, bob, message, encoding, writes) {
+  // Both ciphers write to the same preallocated buffers on every write.
+  const enc = Buffer.allocUnsafe(message.length + 16);
+  const dec = Buffer.allocUnsafe(enc.length + 16);
+  var written = 0;
+  for (var i = 0; i < writes; i++) {
+    const len = alice.updateInto(message, enc);
+    written += bob.updateInto(enc.slice(0, len), dec);
+  }
+  written += bob.updateInto(alice.final(), dec);
+  written += bob.final().length;
+  const gbits = written / (1024 * 1024 * 1024);
+  bench.end(gbits);
+}
@@ -0,0 +1,56 @@
+// Compares hashing a file by piping a read stream into a Hash object against
+// crypto.hashFile(), which reads and hashes the file on the threadpool.
+// `concurrent` files are hashed at the same time, `n` times in total.
+'use strict';
+const common = require('../common.js');
+const crypto = require('crypto');
+const fs = require('fs');
+const path = require('path');
+const filename = path.resolve(process.env.NODE_TMPDIR || __dirname,
+                              `.removeme-benchmark-garbage-${process.pid}`);
+
+const bench = common.createBenchmark(main, {
+  method: ['stream', 'hashFile'],
+  algo: ['sha256'],
+  filesize: [16 * 1024 * 1024],
+  concurrent: [1, 4],
+  n: [20]
+});
+
+function main({ method, algo, filesize, concurrent, n }) {
+  fs.writeFileSync(filename, Buffer.alloc(filesize, 'b'));
+
+  const hashFile = method === 'stream' ? hashStream : crypto.hashFile;
+  var started = 0;
+  var finished = 0;
+
+  bench.start();
+  for (var i = 0; i < concurrent; i++)
+    next();
+
+  function next() {
+    if (started === n)
+      return;
+    started++;
+    hashFile(algo, filename, 'hex', (err) => {
+      if (err)
+        throw err;
+      if (++finished === n)
+        return end();
+      next();
+    });
+  }
+
+  function end() {
+    bench.end(n * filesize / (1024 * 1024));
+    try { fs.unlinkSync(filename); } catch {}
+  }
+}
+
+function hashStream(algo, filename, encoding, callback) {
+  const hash = crypto.createHash(algo);
+  fs.createReadStream(filename)
+    .on('error', callback)
+    .pipe(hash)
+    .on('finish', () => callback(null, hash.read().toString(encoding)));
+}
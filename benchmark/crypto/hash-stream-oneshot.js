@@ -0,0 +1,45 @@
+// Compares computing digests with a Hash object against the one-shot
+// crypto.hash(), synchronously and asynchronously. `n` digests are computed
+// one after another.
+'use strict';
+const common = require('../common.js');
+const crypto = require('crypto');
+
+const bench = common.createBenchmark(main, {
+  method: ['createHash', 'hash', 'hashAsync'],
+  algo: ['sha256'],
+  len: [64, 1024 * 1024],
+  n: [1e3]
+});
+
+function main({ method, algo, len, n }) {
+  const data = Buffer.alloc(len, 'b');
+  var i = 0;
+
+  switch (method) {
+    case 'createHash':
+      bench.start();
+      for (; i < n; i++)
+        crypto.createHash(algo).update(data).digest('hex');
+      bench.end(n);
+      break;
+    case 'hash':
+      bench.start();
+      for (; i < n; i++)
+        crypto.hash(algo, data, 'hex');
+      bench.end(n);
+      break;
+    case 'hashAsync':
+      bench.start();
+      (function next(err) {
+        if (err)
+          throw err;
+        if (i++ === n)
+          return bench.end(n);
+        crypto.hash(algo, data, 'hex', next);
+      })();
+      break;
+    default:
+      throw new Error(`Unsupported method: ${method}`);
+  }
+}
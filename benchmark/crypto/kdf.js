@@ -0,0 +1,54 @@
+'use strict';
+// Derives `n` keys with `n` concurrent crypto.pbkdf2() or crypto.scrypt()
+// calls on libuv's threadpool, or with a single batch on the kdf queue, and
+// reports the derivations per second. `scrypt-p4` uses a parallelization
+// parameter of 4, whose lanes a batch runs on separate threads when it has
+// fewer items than the kdf queue has threads.
+const common = require('../common.js');
+const crypto = require('crypto');
+
+const bench = common.createBenchmark(main, {
+  mode: ['async', 'batch'],
+  kdf: ['pbkdf2', 'scrypt', 'scrypt-p4'],
+  n: [1, 64]
+});
+
+const scryptOptions = {
+  'scrypt': { N: 16384, r: 8, p: 1 },
+  'scrypt-p4': { N: 16384, r: 8, p: 4 }
+};
+
+function main({ mode, kdf, n }) {
+  const items = [];
+  for (var i = 0; i < n; i++)
+    items.push({ password: `password${i}`, salt: crypto.randomBytes(16) });
+
+  function done(err) {
+    if (err)
+      throw err;
+    bench.end(n);
+  }
+
+  bench.start();
+  if (mode === 'batch') {
+    if (kdf === 'pbkdf2')
+      crypto.pbkdf2Batch(items, 10000, 64, 'sha512', done);
+    else
+      crypto.scryptBatch(items, 64, scryptOptions[kdf], done);
+    return;
+  }
+
+  var remaining = n;
+  function onKey(err) {
+    if (err)
+      throw err;
+    if (--remaining === 0)
+      done();
+  }
+  for (const { password, salt } of items) {
+    if (kdf === 'pbkdf2')
+      crypto.pbkdf2(password, salt, 10000, 64, 'sha512', onKey);
+    else
+      crypto.scrypt(password, salt, 64, scryptOptions[kdf], onKey);
+  }
+}
@@ -0,0 +1,32 @@
+// Measures crypto.randomBytes() for small and large sizes. Synchronous
+// requests of up to 256 bytes are served from a pool.
+'use strict';
+const common = require('../common.js');
+const crypto = require('crypto');
+
+const bench = common.createBenchmark(main, {
+  mode: ['sync', 'async'],
+  len: [16, 1024],
+  n: [1e5]
+});
+
+function main({ mode, len, n }) {
+  var i = 0;
+
+  if (mode === 'sync') {
+    bench.start();
+    for (; i < n; i++)
+      crypto.randomBytes(len);
+    bench.end(n);
+    return;
+  }
+
+  bench.start();
+  (function next(err) {
+    if (err)
+      throw err;
+    if (i++ === n)
+      return bench.end(n);
+    crypto.randomBytes(len, next);
+  })();
+}
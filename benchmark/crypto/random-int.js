@@ -0,0 +1,30 @@
+// Measures crypto.randomInt(), synchronously and with a callback.
+'use strict';
+const common = require('../common.js');
+const { randomInt } = require('crypto');
+
+const bench = common.createBenchmark(main, {
+  mode: ['sync', 'async'],
+  n: [1e6]
+});
+
+function main({ mode, n }) {
+  var i = 0;
+
+  if (mode === 'sync') {
+    bench.start();
+    for (; i < n; i++)
+      randomInt(1000);
+    bench.end(n);
+    return;
+  }
+
+  bench.start();
+  (function next(err) {
+    if (err)
+      throw err;
+    if (i++ === n)
+      return bench.end(n);
+    randomInt(1000, next);
+  })();
+}
@@ -0,0 +1,17 @@
+// Measures crypto.randomUUID(), with and without the pool of random data.
+'use strict';
+const common = require('../common.js');
+const { randomUUID } = require('crypto');
+
+const bench = common.createBenchmark(main, {
+  disableEntropyCache: [0, 1],
+  n: [1e6]
+});
+
+function main({ disableEntropyCache, n }) {
+  const options = { disableEntropyCache: !!disableEntropyCache };
+  bench.start();
+  for (var i = 0; i < n; i++)
+    randomUUID(options);
+  bench.end(n);
+}
@@ -0,0 +1,82 @@
+'use strict';
+// Signs `n` small messages with RSA keys, on the main thread one after
+// another, with `concurrent` asynchronous signatures in flight on the
+// threadpool, or in `concurrent` batches of crypto.signBatch().
+const common = require('../common.js');
+const crypto = require('crypto');
+const fs = require('fs');
+const path = require('path');
+const fixtures_keydir = path.resolve(__dirname, '../../test/fixtures/keys/');
+const RSA_PrivatePem = {};
+
+['1024', '2048', '4096'].forEach(function(key) {
+  RSA_PrivatePem[key] =
+    fs.readFileSync(`${fixtures_keydir}/rsa_private_${key}.pem`);
+});
+
+const bench = common.createBenchmark(main, {
+  mode: ['sync', 'async', 'batch'],
+  keylen: ['2048', '4096'],
+  concurrent: [1, 4],
+  n: [200]
+});
+
+function main({ mode, keylen, concurrent, n }) {
+  const privateKey = RSA_PrivatePem[keylen];
+  const message = Buffer.from(JSON.stringify({ sub: '1234567890', iat: 1 }));
+
+  switch (mode) {
+    case 'sync':
+      bench.start();
+      for (var i = 0; i < n; i++)
+        crypto.createSign('sha256').update(message).sign(privateKey);
+      bench.end(n);
+      break;
+    case 'async':
+      signAsync(privateKey, message, concurrent, n);
+      break;
+    case 'batch':
+      signBatch(privateKey, message, concurrent, n);
+      break;
+    default:
+      throw new Error(`Unsupported mode: ${mode}`);
+  }
+}
+
+function signAsync(privateKey, message, concurrent, n) {
+  var started = 0;
+  var finished = 0;
+
+  bench.start();
+  for (var i = 0; i < concurrent; i++)
+    next();
+
+  function next() {
+    if (started === n)
+      return;
+    started++;
+    crypto.createSign('sha256').update(message).sign(privateKey, (err) => {
+      if (err)
+        throw err;
+      if (++finished === n)
+        return bench.end(n);
+      next();
+    });
+  }
+}
+
+function signBatch(privateKey, message, concurrent, n) {
+  var remaining = concurrent;
+
+  bench.start();
+  for (var i = 0; i < concurrent; i++) {
+    const size = Math.floor(n / concurrent) + (i < n % concurrent ? 1 : 0);
+    const payloads = new Array(size).fill(message);
+    crypto.signBatch('sha256', payloads, privateKey, (err) => {
+      if (err)
+        throw err;
+      if (--remaining === 0)
+        bench.end(n);
+    });
+  }
+}
@@ -0,0 +1,80 @@
+'use strict';
+
+// Measures dns.lookup() throughput while the threadpool is kept busy with
+// crypto.scrypt() calls. With `queue=dedicated` the crypto work runs on its
+// own threads (--threadpool-queue=crypto:2), with `queue=shared` it competes
+// with the lookups for the libuv threadpool. The lookups run in a child
+// process, because the queue configuration is a process-wide option.
+
+const common = require('../common.js');
+const { fork } = require('child_process');
+
+if (process.env.BENCH_LOOKUP_N !== undefined) {
+  child(+process.env.BENCH_LOOKUP_N, process.env.BENCH_BACKGROUND);
+  return;
+}
+
+const bench = common.createBenchmark(main, {
+  n: [1e4],
+  queue: ['shared', 'dedicated'],
+  background: ['none', 'scrypt']
+});
+
+function main({ n, queue, background }) {
+  const execArgv =
+    queue === 'dedicated' ? ['--threadpool-queue=crypto:2'] : [];
+  const env = Object.assign({}, process.env, {
+    BENCH_LOOKUP_N: n,
+    BENCH_BACKGROUND: background
+  });
+
+  fork(__filename, [], { execArgv, env }).once('message', (seconds) => {
+    common.sendResult({
+      name: bench.name,
+      conf: bench.config,
+      rate: n / seconds,
+      time: seconds,
+      type: 'report'
+    });
+  });
+}
+
+function child(n, background) {
+  const { lookup } = require('dns');
+  const crypto = require('crypto');
+  const concurrent = 4;
+  var started = 0;
+  var finished = 0;
+  var backgroundRunning = background === 'scrypt';
+
+  function scrypt() {
+    if (backgroundRunning)
+      crypto.scrypt('password', 'salt', 64, scrypt);
+  }
+
+  for (var i = 0; i < 4; i++)
+    scrypt();
+
+  const start = process.hrtime();
+  for (var j = 0; j < concurrent; j++)
+    next();
+
+  function next() {
+    if (started === n)
+      return;
+    started++;
+    lookup('localhost', (err) => {
+      if (err)
+        throw err;
+      if (++finished === n)
+        return end();
+      next();
+    });
+  }
+
+  function end() {
+    const elapsed = process.hrtime(start);
+    backgroundRunning = false;
+    process.send(elapsed[0] + elapsed[1] / 1e9, () => process.disconnect());
+  }
+}
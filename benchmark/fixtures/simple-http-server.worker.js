@@ -0,0 +1,8 @@
+'use strict';
+
+const { parentPort, workerData } = require('worker_threads');
+
+require('./simple-http-server.js').listen({
+  port: workerData.port,
+  reusePort: true
+}, () => parentPort.postMessage('listening'));
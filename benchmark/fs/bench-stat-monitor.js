@@ -0,0 +1,31 @@
+'use strict';
+
+// Measures the overhead that an enabled perf_hooks threadpool monitor adds to
+// fs.stat() calls, which are recorded as `fs` latency.
+
+const common = require('../common');
+const fs = require('fs');
+const { monitorThreadPool } = require('perf_hooks');
+
+const bench = common.createBenchmark(main, {
+  n: [20e4],
+  monitor: ['off', 'on']
+});
+
+function main({ n, monitor }) {
+  const threadPoolMonitor = monitorThreadPool();
+  if (monitor === 'on')
+    threadPoolMonitor.enable();
+
+  bench.start();
+  (function r(cntr) {
+    if (cntr-- <= 0) {
+      bench.end(n);
+      threadPoolMonitor.disable();
+      return;
+    }
+    fs.stat(__filename, function() {
+      r(cntr);
+    });
+  }(n));
+}
@@ -0,0 +1,110 @@
+'use strict';
+
+// Mixed asynchronous file system load: stat(), open() + read() + close() and
+// write() with the occasional fdatasync(), `concurrent` operations at a time.
+// Reports operations per second and, on a separate line, the 99th percentile
+// latency of a single operation in microseconds. `background=pbkdf2` keeps
+// the threadpool busy with crypto work at the same time.
+
+const common = require('../common');
+const fs = require('fs');
+const path = require('path');
+const crypto = require('crypto');
+
+const tmpdir = require('../../test/common/tmpdir');
+
+const bench = common.createBenchmark(main, {
+  n: [1e5],
+  concurrent: [16, 128],
+  backend: ['io_uring', 'threadpool'],
+  background: ['none', 'pbkdf2']
+});
+
+function main({ n, concurrent, backend, background }) {
+  // Read when the first request is made, io_uring is only used on Linux.
+  if (backend === 'threadpool')
+    process.env.UV_USE_IO_URING = '0';
+
+  tmpdir.refresh();
+  const filename = path.join(tmpdir.path, 'mixed-load');
+  const fd = fs.openSync(filename, 'w');
+  const buffer = Buffer.alloc(4096, 'x');
+  const readBuffer = Buffer.alloc(4096);
+  const latencies = new Float64Array(n);
+
+  var started = 0;
+  var finished = 0;
+  var backgroundRunning = background !== 'none';
+
+  if (backgroundRunning) {
+    for (var i = 0; i < 4; i++)
+      pbkdf2();
+  }
+
+  bench.start();
+  for (var j = 0; j < concurrent; j++)
+    next();
+
+  function pbkdf2() {
+    if (!backgroundRunning)
+      return;
+    crypto.pbkdf2('password', 'salt', 1e4, 64, 'sha512', pbkdf2);
+  }
+
+  function next() {
+    if (started === n)
+      return;
+    const index = started++;
+    const start = process.hrtime();
+    const done = (err) => {
+      if (err)
+        throw err;
+      const elapsed = process.hrtime(start);
+      latencies[index] = elapsed[0] * 1e6 + elapsed[1] / 1e3;
+      if (++finished === n)
+        return end();
+      next();
+    };
+
+    switch (index % 4) {
+      case 0:
+        fs.stat(__filename, done);
+        break;
+      case 1:
+        fs.open(__filename, 'r', (err, readFd) => {
+          if (err)
+            return done(err);
+          fs.read(readFd, readBuffer, 0, readBuffer.length, 0, (err) => {
+            if (err)
+              return done(err);
+            fs.close(readFd, done);
+          });
+        });
+        break;
+      case 2:
+        fs.write(fd, buffer, 0, buffer.length, 0, done);
+        break;
+      case 3:
+        if (index % 64 === 3)
+          fs.fdatasync(fd, done);
+        else
+          fs.fstat(fd, done);
+        break;
+    }
+  }
+
+  function end() {
+    bench.end(n);
+    backgroundRunning = false;
+    fs.closeSync(fd);
+
+    latencies.sort();
+    common.sendResult({
+      name: `${bench.name} p99 latency (us)`,
+      conf: bench.config,
+      rate: latencies[Math.min(n - 1, Math.floor(n * 0.99))],
+      time: 0,
+      type: 'report'
+    });
+  }
+}
@@ -0,0 +1,88 @@
+'use strict';
+
+// Compares an http server scaled out with cluster worker processes against
+// the same number of Worker threads in one process that each listen on the
+// port with `reusePort`. Besides the request rate, the total RSS of all
+// processes involved is reported once the load test has finished.
+
+const common = require('../common.js');
+const cluster = require('cluster');
+const path = require('path');
+const PORT = common.PORT;
+
+if (cluster.isWorker) {
+  require('../fixtures/simple-http-server.js').listen(PORT);
+  process.on('message', () => process.send(process.memoryUsage().rss));
+} else {
+  var bench = common.createBenchmark(main, {
+    mode: ['cluster', 'worker_threads'],
+    workers: [4],
+    len: [1024],
+    c: [50]
+  }, { flags: ['--experimental-worker'] });
+}
+
+const workerPath = path.resolve(__dirname, '..', 'fixtures',
+                                'simple-http-server.worker.js');
+
+function main({ mode, workers, len, c }) {
+  const children = [];
+  var listening = 0;
+
+  if (mode === 'cluster') {
+    for (var i = 0; i < workers; i++)
+      children.push(cluster.fork().on('listening', onListening));
+  } else {
+    const { Worker } = require('worker_threads');
+    for (var j = 0; j < workers; j++) {
+      const worker = new Worker(workerPath, { workerData: { port: PORT } });
+      children.push(worker.once('message', onListening));
+    }
+  }
+
+  function onListening() {
+    if (++listening < workers)
+      return;
+
+    bench.http({
+      path: `/bytes/${len}`,
+      connections: c
+    }, reportRSS);
+  }
+
+  function reportRSS() {
+    // Worker threads are part of the RSS of this process, cluster workers
+    // each have their own.
+    var rss = process.memoryUsage().rss;
+    var pending = mode === 'cluster' ? children.length : 0;
+
+    if (pending === 0)
+      return done();
+
+    for (const worker of children) {
+      worker.once('message', (workerRSS) => {
+        rss += workerRSS;
+        if (--pending === 0)
+          done();
+      });
+      worker.send('rss');
+    }
+
+    function done() {
+      common.sendResult({
+        name: `${bench.name} rss`,
+        conf: bench.config,
+        rate: rss / (1024 * 1024),
+        time: 0,
+        type: 'report'
+      });
+
+      for (const child of children) {
+        if (mode === 'cluster')
+          child.destroy();
+        else
+          child.terminate();
+      }
+    }
+  }
+}
@@ -0,0 +1,51 @@
+'use strict';
+
+// Measures the cost of recording trace events on the thread that emits them,
+// for each trace event format and buffer mode. These are process-wide
+// settings, so every configuration runs in a child process of its own.
+
+if (process.argv[2] === 'child') {
+  const { internalBinding } = require('internal/test/binding');
+  const { trace } = internalBinding('trace_events');
+  const {
+    TRACE_EVENT_PHASE_NESTABLE_ASYNC_BEGIN: kBeforeEvent
+  } = internalBinding('constants').trace;
+
+  const n = +process.argv[3];
+  const start = process.hrtime();
+  for (var i = 0; i < n; i++) {
+    trace(kBeforeEvent, 'foo', 'test', i, 'test');
+  }
+  process.send(process.hrtime(start));
+} else {
+  const common = require('../common.js');
+  const path = require('path');
+  const { fork } = require('child_process');
+  const tmpdir = require('../../test/common/tmpdir');
+
+  const bench = common.createBenchmark(main, {
+    n: [1e6],
+    format: ['json', 'protobuf'],
+    mode: ['streaming', 'flight-recorder']
+  });
+
+  function main({ n, format, mode }) {
+    tmpdir.refresh();
+    const execArgv = [
+      '--expose-internals',
+      '--trace-event-categories', 'foo',
+      '--trace-event-format', format,
+      '--trace-event-file-pattern',
+      // eslint-disable-next-line no-template-curly-in-string
+      path.join(tmpdir.path, 'node_trace.${rotation}.log')
+    ];
+    if (mode === 'flight-recorder')
+      execArgv.push('--trace-event-flight-recorder');
+
+    const child = fork(__filename, ['child', n], { execArgv });
+    child.on('message', (elapsed) => {
+      bench.report(n / (elapsed[0] + elapsed[1] / 1e9), elapsed);
+    });
+    child.on('exit', () => tmpdir.refresh());
+  }
+}
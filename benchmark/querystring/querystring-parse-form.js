@@ -0,0 +1,38 @@
+'use strict';
+// Parses form bodies of `pairs` key/value pairs, from a few hundred bytes up to
+// about 1MB. Every fifth key is repeated; with `encoding=percent` the values
+// contain escapes and `+` that have to be decoded.
+const common = require('../common.js');
+const querystring = require('querystring');
+
+const bench = common.createBenchmark(main, {
+  pairs: [10, 25000],
+  encoding: ['none', 'percent'],
+  n: [1e3]
+});
+
+function makeInput(pairs, encoding) {
+  const value = encoding === 'percent' ?
+    'caf%C3%A9+au+lait%2C+s%27il+vous+pla%C3%AEt' :
+    'the_quick_brown_fox_jumps_over_it';
+  const parts = [];
+  for (var i = 0; i < pairs; i++)
+    parts.push(`field${i % 5 === 4 ? i - 1 : i}=${value}`);
+  return parts.join('&');
+}
+
+function main({ pairs, encoding, n }) {
+  const input = makeInput(pairs, encoding);
+  // Scale the iterations so that every configuration parses about as many
+  // bytes.
+  const iterations = Math.max(1, Math.round(n * 1e4 / pairs));
+  const options = { maxKeys: 0 };
+  var i;
+  for (i = 0; i < iterations; i++)
+    querystring.parse(input, '&', '=', options);
+
+  bench.start();
+  for (i = 0; i < iterations; i++)
+    querystring.parse(input, '&', '=', options);
+  bench.end(iterations);
+}
@@ -0,0 +1,40 @@
+'use strict';
+const common = require('../common.js');
+
+// Simulates a server with a large number of sockets that each have an idle
+// timeout which is re-armed whenever there is activity on the socket.
+const bench = common.createBenchmark(main, {
+  active: [1e6],
+  n: [5e6]
+});
+
+const CHUNK = 10000;
+
+function main({ active, n }) {
+  const timersList = [];
+  for (var i = 0; i < active; i++)
+    timersList.push(setTimeout(cb, 10 + i % 90).unref());
+
+  var rearmed = 0;
+  var index = 0;
+
+  function churn() {
+    const end = Math.min(rearmed + CHUNK, n);
+    for (; rearmed < end; rearmed++) {
+      timersList[index].refresh();
+      index = (index + 7919) % active;
+    }
+    if (rearmed < n) {
+      setImmediate(churn);
+      return;
+    }
+    bench.end(n);
+    for (var j = 0; j < active; j++)
+      clearTimeout(timersList[j]);
+  }
+
+  bench.start();
+  churn();
+}
+
+function cb() {}
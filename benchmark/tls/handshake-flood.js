@@ -0,0 +1,71 @@
+'use strict';
+// Floods a server with new, non-resumed connections. With
+// `metric=handshakes` it measures the handshakes per second, and with
+// `metric=timers` how often a 1 ms timer fires meanwhile, which shows how
+// responsive the event loop stays while the server signs the handshakes.
+const common = require('../common.js');
+const { SSL_OP_NO_TICKET } = require('crypto').constants;
+const fixtures = require('../../test/common/fixtures');
+const tls = require('tls');
+
+const bench = common.createBenchmark(main, {
+  key: ['rsa', 'ec'],
+  asyncPrivateKey: ['true', 'false'],
+  metric: ['handshakes', 'timers'],
+  concurrency: [10, 100],
+  dur: [5]
+});
+
+const credentials = {
+  rsa: {
+    key: fixtures.readKey('agent1-key.pem'),
+    cert: fixtures.readKey('agent1-cert.pem'),
+    ciphers: 'ECDHE-RSA-AES128-GCM-SHA256'
+  },
+  ec: {
+    key: fixtures.readKey('ec-key.pem'),
+    cert: fixtures.readKey('ec-cert.pem'),
+    ciphers: 'ECDHE-ECDSA-AES128-GCM-SHA256'
+  }
+};
+
+function main({ key, asyncPrivateKey, metric, concurrency, dur }) {
+  const options = Object.assign({
+    secureOptions: SSL_OP_NO_TICKET,
+    asyncPrivateKey: asyncPrivateKey === 'true'
+  }, credentials[key]);
+  const server = tls.createServer(options, (socket) => socket.end());
+  var handshakes = 0;
+  var timers = 0;
+  var running = true;
+
+  function connect() {
+    const client = tls.connect({
+      port: server.address().port,
+      rejectUnauthorized: false
+    }, () => {
+      handshakes++;
+      client.on('close', () => {
+        if (running) connect();
+      });
+      client.resume();
+    });
+  }
+
+  function tick() {
+    timers++;
+    if (running) setTimeout(tick, 1);
+  }
+
+  server.listen(0, () => {
+    bench.start();
+    setTimeout(() => {
+      running = false;
+      bench.end(metric === 'handshakes' ? handshakes : timers);
+      process.exit(0);
+    }, dur * 1000);
+    setTimeout(tick, 1);
+    for (var i = 0; i < concurrency; i++)
+      connect();
+  });
+}
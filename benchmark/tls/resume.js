@@ -0,0 +1,86 @@
+'use strict';
+// Measures TLS handshakes per second when clients resume their sessions on a
+// group of servers, like the workers of a cluster. Each connection is made to
+// the next server, with the session of the previous connection.
+//
+// With `shared=true` the servers share a file-backed session cache, or a
+// ticket key rotation secret. Otherwise every server has its own.
+const common = require('../common.js');
+const { SSL_OP_NO_TICKET } = require('crypto').constants;
+const fixtures = require('../../test/common/fixtures');
+const path = require('path');
+const tls = require('tls');
+
+const bench = common.createBenchmark(main, {
+  resumption: ['none', 'sessionid', 'ticket'],
+  servers: [1, 4],
+  shared: ['true', 'false'],
+  concurrency: [1, 10],
+  dur: [5]
+});
+
+function createServers(resumption, count, shared) {
+  const tmpdir = require('../../test/common/tmpdir');
+  tmpdir.refresh();
+  const cachePath = path.join(tmpdir.path, 'tls-sessions');
+  const secret = Buffer.alloc(32, 'benchmark');
+
+  const servers = [];
+  for (var i = 0; i < count; i++) {
+    const options = {
+      key: fixtures.readKey('agent2-key.pem'),
+      cert: fixtures.readKey('agent2-cert.pem'),
+      ciphers: 'ECDHE-RSA-AES128-GCM-SHA256'
+    };
+    if (resumption === 'sessionid') {
+      options.secureOptions = SSL_OP_NO_TICKET;
+      options.sessionCache =
+        tls.createSessionCache(shared ? { path: cachePath } : {});
+    } else if (resumption === 'ticket') {
+      options.ticketKeyRotation = shared ? { secret } : true;
+    } else {
+      options.secureOptions = SSL_OP_NO_TICKET;
+    }
+    servers.push(tls.createServer(options, (socket) => socket.end()));
+  }
+  return servers;
+}
+
+function main({ resumption, servers: count, shared, concurrency, dur }) {
+  const servers = createServers(resumption, count, shared === 'true');
+  var listening = 0;
+  var handshakes = 0;
+  var next = 0;
+  var running = true;
+
+  function connect(session) {
+    const server = servers[next++ % servers.length];
+    const client = tls.connect({
+      port: server.address().port,
+      rejectUnauthorized: false,
+      session: resumption === 'none' ? undefined : session
+    }, () => {
+      handshakes++;
+      const newSession = client.getSession();
+      client.on('close', () => {
+        if (running) connect(newSession);
+      });
+      client.resume();
+    });
+  }
+
+  for (const server of servers) {
+    server.listen(0, () => {
+      if (++listening < servers.length)
+        return;
+      bench.start();
+      setTimeout(() => {
+        running = false;
+        bench.end(handshakes);
+        process.exit(0);
+      }, dur * 1000);
+      for (var i = 0; i < concurrency; i++)
+        connect();
+    });
+  }
+}
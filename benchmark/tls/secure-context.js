@@ -0,0 +1,25 @@
+'use strict';
+// Measures how many secure contexts per second can be created from the same
+// certificate and key, like the contexts of a server that hosts many names.
+const common = require('../common.js');
+const fixtures = require('../../test/common/fixtures');
+const tls = require('tls');
+
+const bench = common.createBenchmark(main, {
+  ca: ['true', 'false'],
+  n: [1e3]
+});
+
+function main({ ca, n }) {
+  const options = {
+    key: fixtures.readKey('agent1-key.pem'),
+    cert: fixtures.readKey('agent1-cert.pem'),
+    ca: ca === 'true' ? fixtures.readKey('ca1-cert.pem') : undefined
+  };
+  const contexts = [];
+
+  bench.start();
+  for (var i = 0; i < n; i++)
+    contexts.push(tls.createSecureContext(options));
+  bench.end(n);
+}
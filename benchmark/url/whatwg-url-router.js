@@ -0,0 +1,38 @@
+'use strict';
+// Parses absolute http: and https: URLs, like a server does for the requests
+// it routes, with `hosts` distinct hostnames and then reads one property of
+// each URL.
+const common = require('../common.js');
+
+const bench = common.createBenchmark(main, {
+  hosts: [1, 100],
+  access: ['none', 'pathname', 'href'],
+  n: [1e5]
+});
+
+function main({ hosts, access, n }) {
+  const inputs = [];
+  for (var i = 0; i < 1000; i++) {
+    inputs.push(`https://api${i % hosts}.example.com/v1/users/${i}/posts` +
+                `?page=${i % 7}&sort=asc`);
+  }
+
+  var noDead;  // Avoid dead code elimination.
+  bench.start();
+  for (i = 0; i < n; i++) {
+    const url = new URL(inputs[i % inputs.length]);
+    switch (access) {
+      case 'none':
+        noDead = url;
+        break;
+      case 'pathname':
+        noDead = url.pathname;
+        break;
+      case 'href':
+        noDead = url.href;
+        break;
+    }
+  }
+  bench.end(n);
+  return noDead;
+}
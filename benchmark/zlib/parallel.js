@@ -0,0 +1,50 @@
+'use strict';
+const common = require('../common.js');
+const zlib = require('zlib');
+
+// Compares one-shot gzip compression of a large buffer on a single thread
+// with the same compression split across several threads.
+const bench = common.createBenchmark(main, {
+  method: ['gzip', 'gzipSync'],
+  parallel: [1, 4],
+  inputLen: [16 * 1024 * 1024],
+  n: [20]
+});
+
+function main({ n, method, parallel, inputLen }) {
+  // Text-like input that compresses at a realistic ratio.
+  const words = [];
+  for (var w = 0; w < 1024; w++)
+    words.push(Math.random().toString(36).slice(2, 2 + (w % 9) + 1));
+  const parts = [];
+  var length = 0;
+  while (length < inputLen) {
+    const word = words[(Math.random() * words.length) | 0];
+    parts.push(word);
+    length += word.length + 1;
+  }
+  const input = Buffer.from(parts.join(' ')).slice(0, inputLen);
+  const options = { parallel };
+
+  var i = 0;
+  switch (method) {
+    case 'gzip':
+      bench.start();
+      (function next(err) {
+        if (err)
+          throw err;
+        if (i++ === n)
+          return bench.end(n);
+        zlib.gzip(input, options, next);
+      })();
+      break;
+    case 'gzipSync':
+      bench.start();
+      for (; i < n; ++i)
+        zlib.gzipSync(input, options);
+      bench.end(n);
+      break;
+    default:
+      throw new Error('Unsupported gzip method');
+  }
+}
@@ -0,0 +1,70 @@
+'use strict';
+const common = require('../common.js');
+const zlib = require('zlib');
+
+// Compares compressing many small messages one at a time with the one-shot
+// methods against compressing them in batches with a zlib pool, with and
+// without a shared dictionary. `n` is the total number of messages.
+const bench = common.createBenchmark(main, {
+  api: ['deflateRawSync', 'batch', 'batchSync'],
+  dictionary: ['true', 'false'],
+  batchSize: [64],
+  inputLen: [128],
+  n: [1e5]
+});
+
+function main({ n, api, dictionary, batchSize, inputLen }) {
+  const fields = '{"type":"update","symbol":"","bid":,"ask":,"size":}';
+  const options = dictionary === 'true' ? { dictionary: Buffer.from(fields) } :
+    {};
+  const messages = [];
+  for (var m = 0; m < batchSize; m++) {
+    const message = JSON.stringify({
+      type: 'update',
+      symbol: Math.random().toString(36).slice(2, 6),
+      bid: Math.random() * 100,
+      ask: Math.random() * 100,
+      size: (Math.random() * 1000) | 0
+    });
+    messages.push(Buffer.from(message.padEnd(inputLen, ' ')));
+  }
+
+  const batches = Math.ceil(n / batchSize);
+  var i = 0;
+  switch (api) {
+    case 'deflateRawSync':
+      bench.start();
+      for (; i < batches; i++) {
+        for (var j = 0; j < batchSize; j++)
+          zlib.deflateRawSync(messages[j], options);
+      }
+      bench.end(batches * batchSize);
+      break;
+    case 'batch': {
+      const pool = zlib.createPool('deflateRaw', options);
+      bench.start();
+      (function next(err) {
+        if (err)
+          throw err;
+        if (i++ === batches) {
+          bench.end(batches * batchSize);
+          pool.close();
+          return;
+        }
+        pool.batch(messages, next);
+      })();
+      break;
+    }
+    case 'batchSync': {
+      const pool = zlib.createPool('deflateRaw', options);
+      bench.start();
+      for (; i < batches; i++)
+        pool.batchSync(messages);
+      bench.end(batches * batchSize);
+      pool.close();
+      break;
+    }
+    default:
+      throw new Error('Unsupported api');
+  }
+}
@@ -248,6 +248,7 @@ void uv__platform_invalidate_fd(uv_loop_t* loop, int fd);
 void uv__async_close(uv_async_t* handle);
 void uv__check_close(uv_check_t* handle);
 void uv__fs_event_close(uv_fs_event_t* handle);
+void uv__fs_post(uv_loop_t* loop, uv_fs_t* req);
 void uv__idle_close(uv_idle_t* handle);
 void uv__pipe_close(uv_pipe_t* handle);
 void uv__poll_close(uv_poll_t* handle);
@@ -322,6 +323,22 @@ UV_UNUSED(static char* uv__basename_r(const char* path)) {
 
 #if defined(__linux__)
 int uv__inotify_fork(uv_loop_t* loop, void* old_watchers);
+int uv__iou_flush(uv_loop_t* loop);
+int uv__iou_fs_close(uv_loop_t* loop, uv_fs_t* req);
+int uv__iou_fs_fsync(uv_loop_t* loop, uv_fs_t* req, uint32_t fsync_flags);
+int uv__iou_fs_open(uv_loop_t* loop, uv_fs_t* req);
+int uv__iou_fs_read_or_write(uv_loop_t* loop, uv_fs_t* req, int is_read);
+int uv__iou_fs_statx(uv_loop_t* loop,
+                     uv_fs_t* req,
+                     int is_fstat,
+                     int is_lstat);
+#else
+#define uv__iou_fs_close(loop, req) 0
+#define uv__iou_fs_fsync(loop, req, fsync_flags) 0
+#define uv__iou_fs_open(loop, req) 0
+#define uv__iou_fs_read_or_write(loop, req, is_read) 0
+#define uv__iou_fs_statx(loop, req, is_fstat, is_lstat) 0
+#define UV__IORING_FSYNC_DATASYNC 1
 #endif
 
 #endif /* UV_UNIX_INTERNAL_H_ */
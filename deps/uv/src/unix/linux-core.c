@@ -35,9 +35,12 @@
 
 #include <net/if.h>
 #include <sys/epoll.h>
+#include <sys/mman.h>
 #include <sys/param.h>
 #include <sys/prctl.h>
 #include <sys/sysinfo.h>
+#include <sys/sysmacros.h>
+#include <sys/utsname.h>
 #include <unistd.h>
 #include <fcntl.h>
 #include <time.h>
@@ -74,6 +77,10 @@
 # define CLOCK_BOOTTIME 7
 #endif
 
+struct uv__iou;
+
+static void uv__iou_delete(uv_loop_t* loop, struct uv__iou* iou);
+static void uv__iou_fork(uv_loop_t* loop, struct uv__iou* iou);
 static int read_models(unsigned int numcpus, uv_cpu_info_t* ci);
 static int read_times(FILE* statfile_fp,
                       unsigned int numcpus,
@@ -111,22 +118,37 @@ int uv__platform_loop_init(uv_loop_t* loop) {
 int uv__io_fork(uv_loop_t* loop) {
   int err;
   void* old_watchers;
+  struct uv__iou* iou;
 
   old_watchers = loop->inotify_watchers;
 
+  /* Keep the io_uring state, it still knows about requests in flight. */
+  iou = loop->internal_fields;
+  loop->internal_fields = NULL;
+
   uv__close(loop->backend_fd);
   loop->backend_fd = -1;
   uv__platform_loop_delete(loop);
 
   err = uv__platform_loop_init(loop);
+  loop->internal_fields = iou;
   if (err)
     return err;
 
+  if (iou != NULL)
+    uv__iou_fork(loop, iou);
+
   return uv__inotify_fork(loop, old_watchers);
 }
 
 
 void uv__platform_loop_delete(uv_loop_t* loop) {
+  if (loop->internal_fields != NULL) {
+    uv__iou_delete(loop, loop->internal_fields);
+    uv__free(loop->internal_fields);
+    loop->internal_fields = NULL;
+  }
+
   if (loop->inotify_fd == -1) return;
   uv__io_stop(loop, &loop->inotify_read_watcher, POLLIN);
   uv__close(loop->inotify_fd);
@@ -187,6 +209,633 @@ int uv__io_check_fd(uv_loop_t* loop, int fd) {
 }
 
 
+/* io_uring support for file system requests.
+ *
+ * Asynchronous uv_fs_read(), uv_fs_write(), uv_fs_open(), uv_fs_close(),
+ * uv_fs_stat(), uv_fs_lstat(), uv_fs_fstat(), uv_fs_fsync() and
+ * uv_fs_fdatasync() requests are submitted to a per-loop io_uring instead of
+ * the threadpool when the kernel supports it. That saves the round trip
+ * through a threadpool thread and doesn't let slow disks hog the threads that
+ * DNS lookups and user work share.
+ *
+ * The ring is created the first time it's needed. Submissions are batched
+ * and handed to the kernel right before the loop polls for I/O, completions
+ * are reaped from an I/O watcher on the ring's file descriptor. Requests fall
+ * back to the threadpool when the ring is full or io_uring is not available,
+ * or when it's disabled by setting UV_USE_IO_URING=0 in the environment.
+ *
+ * Short writes are resubmitted until everything is written, like the
+ * threadpool does. The ring belongs to the parent after a fork: requests that
+ * were in flight fail with UV_ECANCELED in the child, which gets a ring of
+ * its own.
+ */
+struct uv__iou {
+  uint32_t* sqhead;
+  uint32_t* sqtail;
+  uint32_t* sqflags;
+  uint32_t sqmask;
+  uint32_t* cqhead;
+  uint32_t* cqtail;
+  uint32_t cqmask;
+  struct uv__io_uring_sqe* sqe;
+  struct uv__io_uring_cqe* cqe;
+  void* sq;
+  size_t sqlen;
+  size_t sqelen;
+  uint32_t unsubmitted;
+  uint32_t in_flight;
+  int ringfd;
+  uv__io_t watcher;
+  /* Requests in flight, linked through their work_req.wq. */
+  QUEUE requests;
+  /* Requests that were in flight when the loop forked. */
+  QUEUE cancelled;
+  uv__io_t cancel_watcher;
+};
+
+
+/* Older kernels have io_uring but lack some of the operations used here, or
+ * have bugs in them. Only use it on 5.10.186 and newer.
+ */
+static int uv__iou_kernel_supported(void) {
+  struct utsname u;
+  unsigned major;
+  unsigned minor;
+  unsigned patch;
+  const char* val;
+
+  val = getenv("UV_USE_IO_URING");
+  if (val != NULL && atoi(val) == 0)
+    return 0;
+
+  if (uname(&u) != 0)
+    return 0;
+
+  patch = 0;
+  if (sscanf(u.release, "%u.%u.%u", &major, &minor, &patch) < 2)
+    return 0;
+
+  return major * 65536 + minor * 256 + patch >= 5 * 65536 + 10 * 256 + 186;
+}
+
+
+static void uv__iou_io_cb(uv_loop_t* loop, uv__io_t* w, unsigned int events);
+static void uv__iou_cancel_cb(uv_loop_t* loop,
+                              uv__io_t* w,
+                              unsigned int events);
+
+
+static void uv__iou_init(uv_loop_t* loop, struct uv__iou* iou) {
+  struct uv__io_uring_params params;
+  uint32_t* sqarray;
+  size_t cqlen;
+  size_t sqlen;
+  size_t sqelen;
+  uint32_t i;
+  char* sq;
+  char* sqe;
+  int ringfd;
+
+  iou->ringfd = -1;
+
+  if (!uv__iou_kernel_supported())
+    return;
+
+  memset(&params, 0, sizeof(params));
+  ringfd = uv__io_uring_setup(64, &params);
+  if (ringfd == -1)
+    return;
+
+  /* The single mmap feature and the no-drop guarantee for completions exist
+   * in every kernel that passes the version check but can't hurt to check.
+   */
+  if (!(params.features & UV__IORING_FEAT_SINGLE_MMAP))
+    goto fail;
+
+  if (!(params.features & UV__IORING_FEAT_NODROP))
+    goto fail;
+
+  sqlen = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+  cqlen = params.cq_off.cqes +
+          params.cq_entries * sizeof(struct uv__io_uring_cqe);
+  if (cqlen > sqlen)
+    sqlen = cqlen;
+  sqelen = params.sq_entries * sizeof(struct uv__io_uring_sqe);
+
+  sq = mmap(0,
+            sqlen,
+            PROT_READ | PROT_WRITE,
+            MAP_SHARED | MAP_POPULATE,
+            ringfd,
+            UV__IORING_OFF_SQ_RING);
+
+  if (sq == MAP_FAILED)
+    goto fail;
+
+  sqe = mmap(0,
+             sqelen,
+             PROT_READ | PROT_WRITE,
+             MAP_SHARED | MAP_POPULATE,
+             ringfd,
+             UV__IORING_OFF_SQES);
+
+  if (sqe == MAP_FAILED) {
+    munmap(sq, sqlen);
+    goto fail;
+  }
+
+  if (uv__cloexec(ringfd, 1)) {
+    munmap(sq, sqlen);
+    munmap(sqe, sqelen);
+    goto fail;
+  }
+
+  iou->sqhead = (uint32_t*) (sq + params.sq_off.head);
+  iou->sqtail = (uint32_t*) (sq + params.sq_off.tail);
+  iou->sqflags = (uint32_t*) (sq + params.sq_off.flags);
+  iou->sqmask = *(uint32_t*) (sq + params.sq_off.ring_mask);
+  iou->cqhead = (uint32_t*) (sq + params.cq_off.head);
+  iou->cqtail = (uint32_t*) (sq + params.cq_off.tail);
+  iou->cqmask = *(uint32_t*) (sq + params.cq_off.ring_mask);
+  iou->cqe = (struct uv__io_uring_cqe*) (sq + params.cq_off.cqes);
+  iou->sqe = (struct uv__io_uring_sqe*) sqe;
+  iou->sq = sq;
+  iou->sqlen = sqlen;
+  iou->sqelen = sqelen;
+  iou->unsubmitted = 0;
+  iou->in_flight = 0;
+  iou->ringfd = ringfd;
+
+  /* Submission queue entry N always lives in slot N. */
+  sqarray = (uint32_t*) (sq + params.sq_off.array);
+  for (i = 0; i <= iou->sqmask; i++)
+    sqarray[i] = i;
+
+  uv__io_init(&iou->watcher, uv__iou_io_cb, ringfd);
+  uv__io_start(loop, &iou->watcher, POLLIN);
+
+  return;
+
+fail:
+  uv__close(ringfd);
+}
+
+
+static void uv__iou_delete(uv_loop_t* loop, struct uv__iou* iou) {
+  if (iou->ringfd == -1)
+    return;
+
+  uv__io_stop(loop, &iou->watcher, POLLIN);
+  munmap(iou->sq, iou->sqlen);
+  munmap(iou->sqe, iou->sqelen);
+  uv__close(iou->ringfd);
+  iou->ringfd = -1;
+}
+
+
+/* The kernel completes the requests that were in flight for the parent, the
+ * child can't reap them. Fail them with UV_ECANCELED from the next loop
+ * iteration; uv_loop_fork() is too early to run callbacks.
+ */
+static void uv__iou_fork(uv_loop_t* loop, struct uv__iou* iou) {
+  if (iou->ringfd == -1)
+    return;
+
+  uv__iou_delete(loop, iou);
+
+  if (!QUEUE_EMPTY(&iou->requests)) {
+    QUEUE_ADD(&iou->cancelled, &iou->requests);
+    QUEUE_INIT(&iou->requests);
+    uv__io_feed(loop, &iou->cancel_watcher);
+  }
+
+  uv__iou_init(loop, iou);
+}
+
+
+static struct uv__iou* uv__iou_get(uv_loop_t* loop) {
+  struct uv__iou* iou;
+
+  iou = loop->internal_fields;
+  if (iou == NULL) {
+    iou = uv__malloc(sizeof(*iou));
+    if (iou == NULL)
+      return NULL;
+
+    QUEUE_INIT(&iou->requests);
+    QUEUE_INIT(&iou->cancelled);
+    uv__io_init(&iou->cancel_watcher, uv__iou_cancel_cb, -1);
+    uv__iou_init(loop, iou);
+    loop->internal_fields = iou;
+  }
+
+  if (iou->ringfd == -1)
+    return NULL;
+
+  return iou;
+}
+
+
+static struct uv__io_uring_sqe* uv__iou_next_sqe(struct uv__iou* iou,
+                                                 uv_fs_t* req) {
+  struct uv__io_uring_sqe* sqe;
+  uint32_t head;
+  uint32_t tail;
+  uint32_t slot;
+
+  head = __atomic_load_n(iou->sqhead, __ATOMIC_ACQUIRE);
+  tail = *iou->sqtail + iou->unsubmitted;
+  if (tail - head > iou->sqmask)
+    return NULL;  /* No free slot. */
+
+  slot = tail & iou->sqmask;
+  sqe = iou->sqe + slot;
+  memset(sqe, 0, sizeof(*sqe));
+  sqe->user_data = (uintptr_t) req;
+  iou->unsubmitted++;
+
+  return sqe;
+}
+
+
+static struct uv__io_uring_sqe* uv__iou_get_sqe(uv_loop_t* loop,
+                                                uv_fs_t* req) {
+  struct uv__io_uring_sqe* sqe;
+  struct uv__iou* iou;
+
+  iou = uv__iou_get(loop);
+  if (iou == NULL)
+    return NULL;
+
+  /* Also keep the number of requests in flight below the size of the
+   * completion ring, the kernel would have to buffer them otherwise.
+   */
+  if (iou->in_flight > 2 * iou->sqmask)
+    return NULL;
+
+  sqe = uv__iou_next_sqe(iou, req);
+  if (sqe == NULL)
+    return NULL;  /* Fall back to the threadpool. */
+
+  /* Pacify uv_cancel(), it should see a request that's already running: one
+   * that is queued but has no work function.
+   */
+  req->work_req.loop = loop;
+  req->work_req.work = NULL;
+  req->work_req.done = NULL;
+  QUEUE_INSERT_TAIL(&iou->requests, &req->work_req.wq);
+
+  uv__req_register(loop, req);
+  iou->in_flight++;
+
+  return sqe;
+}
+
+
+/* Returns non-zero if the kernel couldn't take all of the entries. */
+int uv__iou_flush(uv_loop_t* loop) {
+  struct uv__iou* iou;
+  uint32_t head;
+  uint32_t tail;
+  int rc;
+
+  iou = loop->internal_fields;
+  if (iou == NULL || iou->ringfd == -1)
+    return 0;
+
+  if (iou->unsubmitted != 0) {
+    __atomic_store_n(iou->sqtail,
+                     *iou->sqtail + iou->unsubmitted,
+                     __ATOMIC_RELEASE);
+    iou->unsubmitted = 0;
+  }
+
+  /* Includes entries that an earlier batch couldn't submit. */
+  tail = *iou->sqtail;
+  head = __atomic_load_n(iou->sqhead, __ATOMIC_ACQUIRE);
+  if (tail == head)
+    return 0;
+
+  do
+    rc = uv__io_uring_enter(iou->ringfd, tail - head, 0, 0);
+  while (rc == -1 && errno == EINTR);
+
+  /* The kernel is short on memory or still has to move buffered completions
+   * over. The entries stay in the ring and go out with the next batch, the
+   * caller makes sure that there is one soon.
+   */
+  if (rc == -1 && errno != EAGAIN && errno != EBUSY)
+    abort();
+
+  return __atomic_load_n(iou->sqhead, __ATOMIC_ACQUIRE) != tail;
+}
+
+
+static void uv__iou_statx_to_stat(const struct uv__statx* statxbuf,
+                                  uv_stat_t* buf) {
+  buf->st_dev = makedev(statxbuf->stx_dev_major, statxbuf->stx_dev_minor);
+  buf->st_mode = statxbuf->stx_mode;
+  buf->st_nlink = statxbuf->stx_nlink;
+  buf->st_uid = statxbuf->stx_uid;
+  buf->st_gid = statxbuf->stx_gid;
+  buf->st_rdev = makedev(statxbuf->stx_rdev_major, statxbuf->stx_rdev_minor);
+  buf->st_ino = statxbuf->stx_ino;
+  buf->st_size = statxbuf->stx_size;
+  buf->st_blksize = statxbuf->stx_blksize;
+  buf->st_blocks = statxbuf->stx_blocks;
+  buf->st_atim.tv_sec = statxbuf->stx_atime.tv_sec;
+  buf->st_atim.tv_nsec = statxbuf->stx_atime.tv_nsec;
+  buf->st_mtim.tv_sec = statxbuf->stx_mtime.tv_sec;
+  buf->st_mtim.tv_nsec = statxbuf->stx_mtime.tv_nsec;
+  buf->st_ctim.tv_sec = statxbuf->stx_ctime.tv_sec;
+  buf->st_ctim.tv_nsec = statxbuf->stx_ctime.tv_nsec;
+  /* Same as the stat() based code path when the birth time is unknown. */
+  if (statxbuf->stx_mask & UV__STATX_BTIME) {
+    buf->st_birthtim.tv_sec = statxbuf->stx_btime.tv_sec;
+    buf->st_birthtim.tv_nsec = statxbuf->stx_btime.tv_nsec;
+  } else {
+    buf->st_birthtim = buf->st_ctim;
+  }
+  buf->st_flags = 0;
+  buf->st_gen = 0;
+}
+
+
+static void uv__iou_prep_read_or_write(struct uv__io_uring_sqe* sqe,
+                                       uv_fs_t* req,
+                                       int is_read) {
+  sqe->addr = (uintptr_t) req->bufs;
+  sqe->fd = req->file;
+  sqe->len = req->nbufs;
+  sqe->off = req->off < 0 ? -1 : req->off;  /* -1 is the current position. */
+  sqe->opcode = is_read ? UV__IORING_OP_READV : UV__IORING_OP_WRITEV;
+}
+
+
+/* Accounts for `res` bytes written by a uv_fs_write() request, and returns
+ * non-zero if the rest of the buffers has been submitted again. Like
+ * uv__fs_write_all(), req->result holds the number of bytes written so far,
+ * and the error is only reported if nothing was written.
+ */
+static int uv__iou_write_more(uv_loop_t* loop,
+                              struct uv__iou* iou,
+                              uv_fs_t* req,
+                              int res) {
+  struct uv__io_uring_sqe* sqe;
+  unsigned int n;
+  size_t size;
+
+  if (res <= 0) {
+    if (req->result == 0)
+      req->result = res;
+    return 0;
+  }
+
+  req->result += res;
+  if (req->off >= 0)
+    req->off += res;
+
+  /* Drop what was written. The remaining buffers are moved to the start of
+   * req->bufs, which has to stay as it is to be freed.
+   */
+  size = res;
+  for (n = 0; n < req->nbufs && req->bufs[n].len <= size; n++)
+    size -= req->bufs[n].len;
+
+  if (n == req->nbufs)
+    return 0;
+
+  req->bufs[n].base += size;
+  req->bufs[n].len -= size;
+  memmove(req->bufs, req->bufs + n, (req->nbufs - n) * sizeof(*req->bufs));
+  req->nbufs -= n;
+
+  sqe = uv__iou_next_sqe(iou, req);
+  if (sqe == NULL) {
+    uv__iou_flush(loop);
+    sqe = uv__iou_next_sqe(iou, req);
+  }
+
+  if (sqe == NULL) {
+    /* The kernel doesn't take more entries right now. */
+    QUEUE_REMOVE(&req->work_req.wq);
+    uv__req_unregister(loop, req);
+    iou->in_flight--;
+    uv__fs_post(loop, req);
+    return 1;
+  }
+
+  uv__iou_prep_read_or_write(sqe, req, /* is_read */ 0);
+  return 1;
+}
+
+
+static void uv__iou_fs_done(uv_fs_t* req, int res) {
+  switch (req->fs_type) {
+  case UV_FS_READ:
+  case UV_FS_WRITE:
+    /* uv__iou_write_more() already updated the result of writes. */
+    if (req->fs_type == UV_FS_READ)
+      req->result = res;
+    if (req->bufs != req->bufsml)
+      uv__free(req->bufs);
+    req->bufs = NULL;
+    req->nbufs = 0;
+    break;
+  case UV_FS_STAT:
+  case UV_FS_LSTAT:
+  case UV_FS_FSTAT:
+    req->result = res;
+    if (req->result == 0)
+      uv__iou_statx_to_stat(req->ptr, &req->statbuf);
+    uv__free(req->ptr);
+    req->ptr = req->result == 0 ? &req->statbuf : NULL;
+    break;
+  default:
+    req->result = res;
+    break;
+  }
+}
+
+
+static void uv__iou_io_cb(uv_loop_t* loop, uv__io_t* w, unsigned int events) {
+  struct uv__io_uring_cqe* cqe;
+  struct uv__iou* iou;
+  uv_fs_t* req;
+  uint32_t head;
+  uint32_t tail;
+  int res;
+
+  iou = container_of(w, struct uv__iou, watcher);
+
+  for (;;) {
+    head = *iou->cqhead;
+    tail = __atomic_load_n(iou->cqtail, __ATOMIC_ACQUIRE);
+
+    for (; head != tail; head++) {
+      cqe = iou->cqe + (head & iou->cqmask);
+      req = (uv_fs_t*) (uintptr_t) cqe->user_data;
+      res = cqe->res;
+      assert(req->type == UV_FS);
+
+      /* Hand the slot back before the callback, it may submit more work. */
+      __atomic_store_n(iou->cqhead, head + 1, __ATOMIC_RELEASE);
+
+      if (req->fs_type == UV_FS_WRITE)
+        if (uv__iou_write_more(loop, iou, req, res))
+          continue;
+
+      QUEUE_REMOVE(&req->work_req.wq);
+      QUEUE_INIT(&req->work_req.wq);
+      uv__req_unregister(loop, req);
+      iou->in_flight--;
+
+      uv__iou_fs_done(req, res);
+      req->cb(req);
+    }
+
+    /* Completions that didn't fit in the ring are buffered by the kernel and
+     * only moved over when asked.
+     */
+    if (!(__atomic_load_n(iou->sqflags, __ATOMIC_ACQUIRE) &
+          UV__IORING_SQ_CQ_OVERFLOW)) {
+      break;
+    }
+
+    while (uv__io_uring_enter(iou->ringfd, 0, 0, UV__IORING_ENTER_GETEVENTS))
+      if (errno != EINTR)
+        abort();
+  }
+}
+
+
+static void uv__iou_cancel_cb(uv_loop_t* loop,
+                              uv__io_t* w,
+                              unsigned int events) {
+  struct uv__iou* iou;
+  uv_fs_t* req;
+  QUEUE* q;
+
+  iou = container_of(w, struct uv__iou, cancel_watcher);
+
+  while (!QUEUE_EMPTY(&iou->cancelled)) {
+    q = QUEUE_HEAD(&iou->cancelled);
+    QUEUE_REMOVE(q);
+    QUEUE_INIT(q);
+
+    req = container_of(q, uv_fs_t, work_req.wq);
+    uv__req_unregister(loop, req);
+
+    uv__iou_fs_done(req, UV_ECANCELED);
+    req->result = UV_ECANCELED;
+    req->cb(req);
+  }
+}
+
+
+int uv__iou_fs_close(uv_loop_t* loop, uv_fs_t* req) {
+  struct uv__io_uring_sqe* sqe;
+
+  sqe = uv__iou_get_sqe(loop, req);
+  if (sqe == NULL)
+    return 0;
+
+  sqe->fd = req->file;
+  sqe->opcode = UV__IORING_OP_CLOSE;
+
+  return 1;
+}
+
+
+int uv__iou_fs_fsync(uv_loop_t* loop, uv_fs_t* req, uint32_t fsync_flags) {
+  struct uv__io_uring_sqe* sqe;
+
+  sqe = uv__iou_get_sqe(loop, req);
+  if (sqe == NULL)
+    return 0;
+
+  sqe->fd = req->file;
+  sqe->op_flags = fsync_flags;
+  sqe->opcode = UV__IORING_OP_FSYNC;
+
+  return 1;
+}
+
+
+int uv__iou_fs_open(uv_loop_t* loop, uv_fs_t* req) {
+  struct uv__io_uring_sqe* sqe;
+
+  sqe = uv__iou_get_sqe(loop, req);
+  if (sqe == NULL)
+    return 0;
+
+  sqe->addr = (uintptr_t) req->path;
+  sqe->fd = AT_FDCWD;
+  sqe->len = req->mode;
+  sqe->op_flags = req->flags | O_CLOEXEC;
+  sqe->opcode = UV__IORING_OP_OPENAT;
+
+  return 1;
+}
+
+
+int uv__iou_fs_read_or_write(uv_loop_t* loop, uv_fs_t* req, int is_read) {
+  struct uv__io_uring_sqe* sqe;
+
+  /* The threadpool splits larger requests into several system calls. */
+  if (req->nbufs > (unsigned int) uv__getiovmax())
+    return 0;
+
+  sqe = uv__iou_get_sqe(loop, req);
+  if (sqe == NULL)
+    return 0;
+
+  uv__iou_prep_read_or_write(sqe, req, is_read);
+
+  return 1;
+}
+
+
+int uv__iou_fs_statx(uv_loop_t* loop,
+                     uv_fs_t* req,
+                     int is_fstat,
+                     int is_lstat) {
+  struct uv__io_uring_sqe* sqe;
+  struct uv__statx* statxbuf;
+
+  statxbuf = uv__malloc(sizeof(*statxbuf));
+  if (statxbuf == NULL)
+    return 0;
+
+  sqe = uv__iou_get_sqe(loop, req);
+  if (sqe == NULL) {
+    uv__free(statxbuf);
+    return 0;
+  }
+
+  req->ptr = statxbuf;
+
+  sqe->addr = (uintptr_t) "";  /* Empty string, for AT_EMPTY_PATH. */
+  sqe->fd = AT_FDCWD;
+  sqe->len = UV__STATX_BASIC_STATS | UV__STATX_BTIME;
+  sqe->off = (uintptr_t) statxbuf;
+  sqe->op_flags = UV__AT_STATX_SYNC_AS_STAT;
+  sqe->opcode = UV__IORING_OP_STATX;
+
+  if (is_fstat) {
+    sqe->fd = req->file;
+    sqe->op_flags |= UV__AT_EMPTY_PATH;
+  } else {
+    sqe->addr = (uintptr_t) req->path;
+  }
+
+  if (is_lstat)
+    sqe->op_flags |= UV__AT_SYMLINK_NOFOLLOW;
+
+  return 1;
+}
+
+
 void uv__io_poll(uv_loop_t* loop, int timeout) {
   /* A bug in kernels < 2.6.37 makes timeouts larger than ~30 minutes
    * effectively infinite on 32 bits architectures.  To avoid blocking
@@ -214,6 +863,12 @@ void uv__io_poll(uv_loop_t* loop, int timeout) {
   int op;
   int i;
 
+  /* Poll again soon if the kernel couldn't take all of the submissions, they
+   * would otherwise wait for an unrelated event.
+   */
+  if (uv__iou_flush(loop) && (timeout < 0 || timeout > 1))
+    timeout = 1;
+
   if (loop->nfds == 0) {
     assert(QUEUE_EMPTY(&loop->watcher_queue));
     return;
@@ -0,0 +1,391 @@
+/* Copyright libuv project contributors. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+/* These tests are Unix only. */
+#ifndef _WIN32
+
+#include "uv.h"
+#include "task.h"
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#if defined(__linux__)
+#include <sys/syscall.h>
+#include <sys/utsname.h>
+#endif
+
+#define TEST_FILE "test_file_io_uring"
+
+/* Mirrors the checks in src/unix/linux-core.c: the tests that need io_uring
+ * are skipped where libuv uses the threadpool instead.
+ */
+static int io_uring_supported(void) {
+#if defined(__linux__) && defined(__NR_io_uring_setup)
+  struct utsname u;
+  unsigned major;
+  unsigned minor;
+  unsigned patch;
+  const char* val;
+  char params[120];
+  long fd;
+
+  val = getenv("UV_USE_IO_URING");
+  if (val != NULL && atoi(val) == 0)
+    return 0;
+
+  if (uname(&u) != 0)
+    return 0;
+
+  patch = 0;
+  if (sscanf(u.release, "%u.%u.%u", &major, &minor, &patch) < 2)
+    return 0;
+
+  if (major * 65536 + minor * 256 + patch < 5 * 65536 + 10 * 256 + 186)
+    return 0;
+
+  memset(params, 0, sizeof(params));
+  fd = syscall(__NR_io_uring_setup, 1, params);
+  if (fd == -1)
+    return 0;
+
+  close(fd);
+  return 1;
+#else
+  return 0;
+#endif
+}
+
+
+static uv_work_t pause_reqs[4];
+static uv_sem_t pause_sems[ARRAY_SIZE(pause_reqs)];
+
+
+static void work_cb(uv_work_t* req) {
+  uv_sem_wait(pause_sems + (req - pause_reqs));
+}
+
+
+static void done_cb(uv_work_t* req, int status) {
+  ASSERT(status == 0);
+  uv_sem_destroy(pause_sems + (req - pause_reqs));
+}
+
+
+/* Requests that complete while every thread is blocked went through the ring.
+ */
+static void saturate_threadpool(uv_loop_t* loop) {
+  char buf[64];
+  size_t i;
+
+  snprintf(buf,
+           sizeof(buf),
+           "UV_THREADPOOL_SIZE=%lu",
+           (unsigned long)ARRAY_SIZE(pause_reqs));
+  putenv(buf);
+
+  for (i = 0; i < ARRAY_SIZE(pause_reqs); i += 1) {
+    ASSERT(0 == uv_sem_init(pause_sems + i, 0));
+    ASSERT(0 == uv_queue_work(loop, pause_reqs + i, work_cb, done_cb));
+  }
+}
+
+
+static void unblock_threadpool(void) {
+  size_t i;
+
+  for (i = 0; i < ARRAY_SIZE(pause_reqs); i += 1)
+    uv_sem_post(pause_sems + i);
+}
+
+
+static uv_fs_t open_req;
+static uv_fs_t write_req;
+static uv_fs_t fsync_req;
+static uv_fs_t fdatasync_req;
+static uv_fs_t fstat_req;
+static uv_fs_t read_req;
+static uv_fs_t close_req;
+static uv_file file;
+static char read_buf[32];
+static int close_cb_called;
+
+
+static void close_cb(uv_fs_t* req) {
+  ASSERT(req == &close_req);
+  ASSERT(req->result == 0);
+  uv_fs_req_cleanup(req);
+  close_cb_called++;
+  unblock_threadpool();
+}
+
+
+static void read_cb(uv_fs_t* req) {
+  ASSERT(req == &read_req);
+  ASSERT(req->result == 14);
+  ASSERT(0 == memcmp(read_buf, "hello io_uring", 14));
+  uv_fs_req_cleanup(req);
+  ASSERT(0 == uv_fs_close(req->loop, &close_req, file, close_cb));
+}
+
+
+static void fstat_cb(uv_fs_t* req) {
+  uv_buf_t buf;
+
+  ASSERT(req == &fstat_req);
+  ASSERT(req->result == 0);
+  ASSERT(req->statbuf.st_size == 14);
+  uv_fs_req_cleanup(req);
+
+  buf = uv_buf_init(read_buf, sizeof(read_buf));
+  ASSERT(0 == uv_fs_read(req->loop, &read_req, file, &buf, 1, 0, read_cb));
+}
+
+
+static void fdatasync_cb(uv_fs_t* req) {
+  ASSERT(req == &fdatasync_req);
+  ASSERT(req->result == 0);
+  uv_fs_req_cleanup(req);
+  ASSERT(0 == uv_fs_fstat(req->loop, &fstat_req, file, fstat_cb));
+}
+
+
+static void fsync_cb(uv_fs_t* req) {
+  ASSERT(req == &fsync_req);
+  ASSERT(req->result == 0);
+  uv_fs_req_cleanup(req);
+  ASSERT(0 == uv_fs_fdatasync(req->loop, &fdatasync_req, file, fdatasync_cb));
+}
+
+
+static void write_cb(uv_fs_t* req) {
+  ASSERT(req == &write_req);
+  ASSERT(req->result == 14);
+  uv_fs_req_cleanup(req);
+  ASSERT(0 == uv_fs_fsync(req->loop, &fsync_req, file, fsync_cb));
+}
+
+
+static void open_cb(uv_fs_t* req) {
+  uv_buf_t bufs[2];
+
+  ASSERT(req == &open_req);
+  ASSERT(req->result >= 0);
+  file = req->result;
+  uv_fs_req_cleanup(req);
+
+  bufs[0] = uv_buf_init("hello ", 6);
+  bufs[1] = uv_buf_init("io_uring", 8);
+  ASSERT(0 == uv_fs_write(req->loop, &write_req, file, bufs, 2, 0, write_cb));
+}
+
+
+TEST_IMPL(fs_io_uring_rw) {
+  uv_loop_t* loop;
+  uv_fs_t unlink_req;
+
+  if (!io_uring_supported())
+    RETURN_SKIP("io_uring is not used on this platform.");
+
+  loop = uv_default_loop();
+  uv_fs_unlink(NULL, &unlink_req, TEST_FILE, NULL);
+  uv_fs_req_cleanup(&unlink_req);
+
+  /* None of the requests can run on the threadpool until the file is closed.
+   */
+  saturate_threadpool(loop);
+  ASSERT(0 == uv_fs_open(loop,
+                         &open_req,
+                         TEST_FILE,
+                         O_RDWR | O_CREAT | O_TRUNC,
+                         S_IRUSR | S_IWUSR,
+                         open_cb));
+
+  ASSERT(0 == uv_run(loop, UV_RUN_DEFAULT));
+  ASSERT(1 == close_cb_called);
+
+  uv_fs_unlink(NULL, &unlink_req, TEST_FILE, NULL);
+  uv_fs_req_cleanup(&unlink_req);
+
+  MAKE_VALGRIND_HAPPY();
+  return 0;
+}
+
+
+#define SHORT_WRITE_SIZE (4 * 1024 * 1024)
+
+static int short_write_fds[2];
+static size_t short_write_received;
+static int short_write_cb_called;
+
+
+static void short_write_reader(void* arg) {
+  char buf[4096];
+  ssize_t n;
+  ssize_t i;
+
+  for (;;) {
+    n = read(short_write_fds[0], buf, sizeof(buf));
+    if (n == 0)
+      break;
+    ASSERT(n > 0);
+    for (i = 0; i < n; i++)
+      ASSERT(buf[i] == (char) ((short_write_received + i) % 251));
+    short_write_received += n;
+  }
+}
+
+
+static void short_write_cb(uv_fs_t* req) {
+  ASSERT(req->result == SHORT_WRITE_SIZE);
+  uv_fs_req_cleanup(req);
+  short_write_cb_called++;
+}
+
+
+TEST_IMPL(fs_io_uring_short_write) {
+  /* A write to a pipe that has less room than the buffers ends early. The
+   * rest is written before the callback runs, whether the request goes
+   * through io_uring or through the threadpool.
+   */
+  uv_thread_t reader;
+  uv_loop_t* loop;
+  uv_buf_t bufs[2];
+  uv_fs_t req;
+  char* data;
+  size_t i;
+
+  data = malloc(SHORT_WRITE_SIZE);
+  ASSERT(data != NULL);
+  for (i = 0; i < SHORT_WRITE_SIZE; i++)
+    data[i] = (char) (i % 251);
+
+  ASSERT(0 == pipe(short_write_fds));
+  ASSERT(0 == uv_thread_create(&reader, short_write_reader, NULL));
+
+  loop = uv_default_loop();
+  bufs[0] = uv_buf_init(data, 1000);
+  bufs[1] = uv_buf_init(data + 1000, SHORT_WRITE_SIZE - 1000);
+  ASSERT(0 == uv_fs_write(loop,
+                          &req,
+                          short_write_fds[1],
+                          bufs,
+                          ARRAY_SIZE(bufs),
+                          -1,
+                          short_write_cb));
+  ASSERT(0 == uv_run(loop, UV_RUN_DEFAULT));
+  ASSERT(1 == short_write_cb_called);
+
+  ASSERT(0 == close(short_write_fds[1]));
+  ASSERT(0 == uv_thread_join(&reader));
+  ASSERT(short_write_received == SHORT_WRITE_SIZE);
+  ASSERT(0 == close(short_write_fds[0]));
+  free(data);
+
+  MAKE_VALGRIND_HAPPY();
+  return 0;
+}
+
+
+static int fork_fds[2];
+static char fork_buf[1];
+static int fork_read_cb_called;
+static int fork_stat_cb_called;
+static int is_child;
+
+
+static void fork_read_cb(uv_fs_t* req) {
+  if (is_child) {
+    /* The parent still owns the request. */
+    ASSERT(req->result == UV_ECANCELED);
+  } else {
+    ASSERT(req->result == 1);
+    ASSERT(fork_buf[0] == 'x');
+  }
+  uv_fs_req_cleanup(req);
+  fork_read_cb_called++;
+}
+
+
+static void fork_stat_cb(uv_fs_t* req) {
+  ASSERT(req->result == 0);
+  uv_fs_req_cleanup(req);
+  fork_stat_cb_called++;
+}
+
+
+TEST_IMPL(fs_io_uring_fork) {
+  uv_loop_t* loop;
+  uv_fs_t read_req;
+  uv_fs_t stat_req;
+  uv_buf_t buf;
+  pid_t child_pid;
+  pid_t waited_pid;
+  int child_stat;
+
+  if (!io_uring_supported())
+    RETURN_SKIP("io_uring is not used on this platform.");
+
+  loop = uv_default_loop();
+  ASSERT(0 == pipe(fork_fds));
+
+  /* Nothing has been written yet, so the read stays in flight. */
+  buf = uv_buf_init(fork_buf, sizeof(fork_buf));
+  ASSERT(0 == uv_fs_read(loop, &read_req, fork_fds[0], &buf, 1, -1,
+                         fork_read_cb));
+  ASSERT(1 == uv_run(loop, UV_RUN_NOWAIT));
+  ASSERT(0 == fork_read_cb_called);
+
+  child_pid = fork();
+  ASSERT(child_pid != -1);
+
+  if (child_pid == 0) {
+    is_child = 1;
+    ASSERT(0 == uv_loop_fork(loop));
+    ASSERT(0 == uv_run(loop, UV_RUN_DEFAULT));
+    ASSERT(1 == fork_read_cb_called);
+
+    /* The child has a ring of its own. */
+    ASSERT(0 == uv_fs_stat(loop, &stat_req, ".", fork_stat_cb));
+    ASSERT(0 == uv_run(loop, UV_RUN_DEFAULT));
+    ASSERT(1 == fork_stat_cb_called);
+  } else {
+    waited_pid = waitpid(child_pid, &child_stat, 0);
+    ASSERT(waited_pid == child_pid);
+    ASSERT(WIFEXITED(child_stat));
+    ASSERT(0 == WEXITSTATUS(child_stat));
+
+    ASSERT(1 == write(fork_fds[1], "x", 1));
+    ASSERT(0 == uv_run(loop, UV_RUN_DEFAULT));
+    ASSERT(1 == fork_read_cb_called);
+  }
+
+  ASSERT(0 == close(fork_fds[0]));
+  ASSERT(0 == close(fork_fds[1]));
+
+  MAKE_VALGRIND_HAPPY();
+  return 0;
+}
+
+#endif  /* !_WIN32 */
@@ -347,6 +347,11 @@ TEST_DECLARE   (fs_partial_write)
 TEST_DECLARE   (fs_file_pos_after_op_with_offset)
 TEST_DECLARE   (fs_null_req)
 TEST_DECLARE   (fs_read_dir)
+#ifndef _WIN32
+TEST_DECLARE   (fs_io_uring_rw)
+TEST_DECLARE   (fs_io_uring_short_write)
+TEST_DECLARE   (fs_io_uring_fork)
+#endif
 #ifdef _WIN32
 TEST_DECLARE   (fs_exclusive_sharing_mode)
 TEST_DECLARE   (fs_file_flag_no_buffering)
@@ -904,6 +909,11 @@ TASK_LIST_START
   TEST_ENTRY  (fs_file_pos_after_op_with_offset)
   TEST_ENTRY  (fs_null_req)
   TEST_ENTRY  (fs_read_dir)
+#ifndef _WIN32
+  TEST_ENTRY  (fs_io_uring_rw)
+  TEST_ENTRY  (fs_io_uring_short_write)
+  TEST_ENTRY  (fs_io_uring_fork)
+#endif
 #ifdef _WIN32
   TEST_ENTRY  (fs_exclusive_sharing_mode)
   TEST_ENTRY  (fs_file_flag_no_buffering)
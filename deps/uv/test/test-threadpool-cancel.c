@@ -243,6 +243,9 @@ TEST_IMPL(threadpool_cancel_fs) {
   unsigned n;
   uv_buf_t iov;
 
+  /* Requests that go through io_uring can't be cancelled. */
+  ASSERT(0 == uv_os_setenv("UV_USE_IO_URING", "0"));
+
   INIT_CANCEL_INFO(&ci, reqs);
   loop = uv_default_loop();
   saturate_threadpool();
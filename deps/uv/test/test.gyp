@@ -34,6 +34,7 @@
         'test-fs.c',
         'test-fs-copyfile.c',
         'test-fs-event.c',
+        'test-fs-io-uring.c',
         'test-fs-poll.c',
         'test-getters-setters.c',
         'test-get-currentexe.c',
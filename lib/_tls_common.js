@@ -205,6 +205,9 @@ exports.createSecureContext = function createSecureContext(options) {
     }
   }
 
+  if (options.asyncPrivateKey)
+    c.context.enableAsyncPrivateKey();
+
   // Do not keep read/write buffers in free list for OpenSSL < 1.1.0. (For
   // OpenSSL 1.1.0, buffers are malloced and freed without the use of a
   // freelist.)
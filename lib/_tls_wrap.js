@@ -36,9 +36,16 @@ const { TCP, constants: TCPConstants } = internalBinding('tcp_wrap');
 const tls_wrap = internalBinding('tls_wrap');
 const { Pipe, constants: PipeConstants } = internalBinding('pipe_wrap');
 const { owner_symbol } = require('internal/async_hooks').symbols;
+const {
+  kHandle: kSessionCacheHandle,
+  SessionCache
+} = require('internal/tls');
+const { isArrayBufferView } = require('internal/util/types');
 const { SecureContext: NativeSecureContext } = internalBinding('crypto');
 const {
+  ERR_INCOMPATIBLE_OPTION_PAIR,
   ERR_INVALID_ARG_TYPE,
+  ERR_INVALID_ARG_VALUE,
   ERR_MULTIPLE_CALLBACK,
   ERR_SOCKET_CLOSED,
   ERR_TLS_DH_PARAM_SIZE,
@@ -49,13 +56,14 @@ const {
   ERR_TLS_SESSION_ATTACK,
   ERR_TLS_SNI_FROM_SERVER
 } = require('internal/errors').codes;
-const { validateString } = require('internal/validators');
+const { validateString, validateUint32 } = require('internal/validators');
 const kConnectOptions = Symbol('connect-options');
 const kDisableRenegotiation = Symbol('disable-renegotiation');
 const kErrorEmitted = Symbol('error-emitted');
 const kHandshakeTimeout = Symbol('handshake-timeout');
 const kRes = Symbol('res');
 const kSNICallback = Symbol('snicallback');
+const kTicketKeyRotation = Symbol('ticket-key-rotation');
 
 const noop = () => {};
 
@@ -965,6 +973,8 @@ Server.prototype.setSecureContext = function(options) {
   else
     this.secureOptions = undefined;
 
+  this.asyncPrivateKey = !!options.asyncPrivateKey;
+
   if (options.sessionIdContext) {
     this.sessionIdContext = options.sessionIdContext;
   } else {
@@ -990,22 +1000,90 @@ Server.prototype.setSecureContext = function(options) {
     secureOptions: this.secureOptions,
     honorCipherOrder: this.honorCipherOrder,
     crl: this.crl,
-    sessionIdContext: this.sessionIdContext
+    sessionIdContext: this.sessionIdContext,
+    asyncPrivateKey: this.asyncPrivateKey
   });
 
   if (this.sessionTimeout)
     this._sharedCreds.context.setSessionTimeout(this.sessionTimeout);
 
+  if (options.sessionCache !== undefined &&
+      !(options.sessionCache instanceof SessionCache)) {
+    throw new ERR_INVALID_ARG_TYPE(
+      'options.sessionCache', 'tls.SessionCache', options.sessionCache);
+  }
+  this.sessionCache = options.sessionCache;
+  if (this.sessionCache) {
+    this._sharedCreds.context.setSessionCache(
+      this.sessionCache[kSessionCacheHandle]);
+  }
+
+  if (options.ticketKeys && options.ticketKeyRotation) {
+    throw new ERR_INCOMPATIBLE_OPTION_PAIR('ticketKeys', 'ticketKeyRotation');
+  }
+
   if (options.ticketKeys) {
     this.ticketKeys = options.ticketKeys;
     this.setTicketKeys(this.ticketKeys);
+  } else if (options.ticketKeyRotation) {
+    this[kTicketKeyRotation] =
+      normalizeTicketKeyRotation(options.ticketKeyRotation);
+    enableTicketKeyRotation(this, this[kTicketKeyRotation]);
   } else {
     this.setTicketKeys(this.getTicketKeys());
   }
 };
 
 
+function normalizeTicketKeyRotation(options) {
+  if (options === true)
+    options = {};
+  else if (options === null || typeof options !== 'object')
+    throw new ERR_INVALID_ARG_TYPE(
+      'options.ticketKeyRotation', ['boolean', 'Object'], options);
+
+  const { interval = 3600, overlap = 300 } = options;
+  let { secret } = options;
+  validateUint32(interval, 'options.ticketKeyRotation.interval', true);
+  validateUint32(overlap, 'options.ticketKeyRotation.overlap');
+  if (secret === undefined) {
+    secret = crypto.randomBytes(32);
+  } else if (!isArrayBufferView(secret)) {
+    throw new ERR_INVALID_ARG_TYPE(
+      'options.ticketKeyRotation.secret',
+      ['Buffer', 'TypedArray', 'DataView'],
+      secret);
+  } else if (secret.byteLength < 32) {
+    throw new ERR_INVALID_ARG_VALUE(
+      'options.ticketKeyRotation.secret', secret,
+      'must be at least 32 bytes long');
+  } else {
+    secret = Buffer.from(secret.buffer, secret.byteOffset, secret.byteLength);
+  }
+  return { secret, interval, overlap };
+}
+
+
+function enableTicketKeyRotation(server, { secret, interval, overlap }) {
+  server._sharedCreds.context.enableTicketKeyRotation(secret,
+                                                      interval,
+                                                      overlap);
+}
+
+
+// Cluster workers that share a server adopt the ticket keys, or the rotation
+// secret, of the first one, so that they can resume each other's sessions.
 Server.prototype._getServerData = function() {
+  const rotation = this[kTicketKeyRotation];
+  if (rotation) {
+    return {
+      ticketKeyRotation: {
+        secret: rotation.secret.toString('hex'),
+        interval: rotation.interval,
+        overlap: rotation.overlap
+      }
+    };
+  }
   return {
     ticketKeys: this.getTicketKeys().toString('hex')
   };
@@ -1013,7 +1091,17 @@ Server.prototype._getServerData = function() {
 
 
 Server.prototype._setServerData = function(data) {
-  this.setTicketKeys(Buffer.from(data.ticketKeys, 'hex'));
+  if (data.ticketKeyRotation) {
+    const { secret, interval, overlap } = data.ticketKeyRotation;
+    this[kTicketKeyRotation] = {
+      secret: Buffer.from(secret, 'hex'),
+      interval,
+      overlap
+    };
+    enableTicketKeyRotation(this, this[kTicketKeyRotation]);
+  } else {
+    this.setTicketKeys(Buffer.from(data.ticketKeys, 'hex'));
+  }
 };
 
 
@@ -1024,6 +1112,7 @@ Server.prototype.getTicketKeys = function getTicketKeys(keys) {
 
 Server.prototype.setTicketKeys = function setTicketKeys(keys) {
   this._sharedCreds.context.setTicketKeys(keys);
+  this[kTicketKeyRotation] = undefined;
 };
 
 
@@ -1076,7 +1165,9 @@ Server.prototype.addContext = function(servername, context) {
                       servername.replace(/([.^$+?\-\\[\]{}])/g, '\\$1')
                                 .replace(/\*/g, '[^.]*') +
                       '$');
-  this._contexts.push([re, tls.createSecureContext(context).context]);
+  // The context is created when a client first asks for it. Servers that
+  // host many names only pay for the ones that are in use.
+  this._contexts.push([re, context, null]);
 };
 
 function SNICallback(servername, callback) {
@@ -1085,7 +1176,16 @@ function SNICallback(servername, callback) {
   for (var i = 0; i < contexts.length; i++) {
     const elem = contexts[i];
     if (elem[0].test(servername)) {
-      callback(null, elem[1]);
+      if (elem[2] === null) {
+        try {
+          elem[2] = tls.createSecureContext(elem[1]).context;
+        } catch (err) {
+          callback(err);
+          return;
+        }
+        elem[1] = null;
+      }
+      callback(null, elem[2]);
       return;
     }
   }
@@ -4,7 +4,7 @@ const {
   ERR_ASYNC_CALLBACK,
   ERR_INVALID_ASYNC_ID
 } = require('internal/errors').codes;
-const { validateString } = require('internal/validators');
+const { validateString, validateUint32 } = require('internal/validators');
 const internal_async_hooks = require('internal/async_hooks');
 
 // Get functions
@@ -18,6 +18,13 @@ const {
   getHookArrays,
   enableHooks,
   disableHooks,
+  enableBatchHook,
+  disableBatchHook,
+  drainEventBuffer,
+  enableContextFrames,
+  disableContextFrames,
+  getContextFrame,
+  setContextFrame,
   // Internal Embedder API
   newAsyncId,
   getDefaultTriggerAsyncId,
@@ -31,7 +38,7 @@ const {
 const {
   async_id_symbol, trigger_async_id_symbol,
   init_symbol, before_symbol, after_symbol, destroy_symbol,
-  promise_resolve_symbol
+  promise_resolve_symbol, context_frame_symbol, batch_symbol
 } = internal_async_hooks.symbols;
 
 // Get constants
@@ -123,6 +130,46 @@ function createHook(fns) {
 }
 
 
+// Batched Listener API //
+
+const kDefaultBatchCapacity = 4096;
+const capacity_symbol = Symbol('capacity');
+
+// Unlike AsyncHook, a BatchHook does not re-enter JS for every event. Events
+// are recorded into a native buffer and handed to the callback in batches.
+class BatchHook {
+  constructor(callback, options = {}) {
+    if (typeof callback !== 'function')
+      throw new ERR_ASYNC_CALLBACK('callback');
+    const { capacity = kDefaultBatchCapacity } = options;
+    validateUint32(capacity, 'options.capacity', true);
+
+    this[batch_symbol] = callback;
+    this[capacity_symbol] = capacity;
+  }
+
+  enable() {
+    enableBatchHook(this, this[capacity_symbol]);
+    return this;
+  }
+
+  disable() {
+    disableBatchHook(this);
+    return this;
+  }
+
+  flush() {
+    drainEventBuffer();
+    return this;
+  }
+}
+
+
+function createBatchHook(callback, options) {
+  return new BatchHook(callback, options);
+}
+
+
 // Embedder API //
 
 const destroyedSymbol = Symbol('destroyed');
@@ -157,6 +204,7 @@ class AsyncResource {
 
     this[async_id_symbol] = newAsyncId();
     this[trigger_async_id_symbol] = triggerAsyncId;
+    this[context_frame_symbol] = getContextFrame();
     // This prop name (destroyed) has to be synchronized with C++
     this[destroyedSymbol] = { destroyed: false };
 
@@ -171,7 +219,7 @@ class AsyncResource {
 
   emitBefore() {
     showEmitBeforeAfterWarning();
-    emitBefore(this[async_id_symbol], this[trigger_async_id_symbol]);
+    emitBefore(this[async_id_symbol], this[trigger_async_id_symbol], this);
     return this;
   }
 
@@ -182,7 +230,7 @@ class AsyncResource {
   }
 
   runInAsyncScope(fn, thisArg, ...args) {
-    emitBefore(this[async_id_symbol], this[trigger_async_id_symbol]);
+    emitBefore(this[async_id_symbol], this[trigger_async_id_symbol], this);
     let ret;
     try {
       ret = Reflect.apply(fn, thisArg, args);
@@ -208,10 +256,76 @@ class AsyncResource {
 }
 
 
+// Context Storage API //
+
+// A context frame is an immutable Map from AsyncLocalStorage instances to
+// their stores. It is captured natively by every async resource on creation
+// and made current again when the resource's callbacks run, so no JS hook
+// runs per resource.
+function frameWith(frame, key, store) {
+  const next = frame === undefined ? new Map() : new Map(frame);
+  next.set(key, store);
+  return next;
+}
+
+class AsyncLocalStorage {
+  constructor() {
+    this.enabled = false;
+  }
+
+  disable() {
+    if (this.enabled) {
+      this.enabled = false;
+      disableContextFrames();
+    }
+  }
+
+  _enable() {
+    if (!this.enabled) {
+      this.enabled = true;
+      enableContextFrames();
+    }
+  }
+
+  enterWith(store) {
+    this._enable();
+    setContextFrame(frameWith(getContextFrame(), this, store));
+  }
+
+  run(store, callback, ...args) {
+    this._enable();
+    const previousFrame = getContextFrame();
+    setContextFrame(frameWith(previousFrame, this, store));
+    try {
+      return Reflect.apply(callback, null, args);
+    } finally {
+      setContextFrame(previousFrame);
+    }
+  }
+
+  exit(callback, ...args) {
+    if (!this.enabled)
+      return Reflect.apply(callback, null, args);
+    return this.run(undefined, callback, ...args);
+  }
+
+  getStore() {
+    if (!this.enabled)
+      return undefined;
+    const frame = getContextFrame();
+    if (frame === undefined)
+      return undefined;
+    return frame.get(this);
+  }
+}
+
+
 // Placing all exports down here because the exported classes won't export
 // otherwise.
 module.exports = {
   // Public API
+  AsyncLocalStorage,
+  createBatchHook,
   createHook,
   executionAsyncId,
   triggerAsyncId,
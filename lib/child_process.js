@@ -114,12 +114,12 @@ exports.fork = function fork(modulePath /* , args, options */) {
 };
 
 
-exports._forkChild = function _forkChild(fd) {
+exports._forkChild = function _forkChild(fd, serializationMode) {
   // set process.send()
   var p = new Pipe(PipeConstants.IPC);
   p.open(fd);
   p.unref();
-  const control = setupChannel(process, p);
+  const control = setupChannel(process, p, serializationMode);
   process.on('newListener', function onNewListener(name) {
     if (name === 'message' || name === 'disconnect') control.ref();
   });
@@ -554,7 +554,8 @@ var spawn = exports.spawn = function spawn(/* file, args, options */) {
     envPairs: opts.envPairs,
     stdio: options.stdio,
     uid: options.uid,
-    gid: options.gid
+    gid: options.gid,
+    serialization: options.serialization
   });
 
   return child;
@@ -45,14 +45,18 @@ const { getFipsCrypto, setFipsCrypto } = internalBinding('crypto');
 const {
   randomBytes,
   randomFill,
-  randomFillSync
+  randomFillSync,
+  randomInt,
+  randomUUID
 } = require('internal/crypto/random');
 const {
   pbkdf2,
+  pbkdf2Batch,
   pbkdf2Sync
 } = require('internal/crypto/pbkdf2');
 const {
   scrypt,
+  scryptBatch,
   scryptSync
 } = require('internal/crypto/scrypt');
 const {
@@ -65,6 +69,8 @@ const {
   ECDH
 } = require('internal/crypto/diffiehellman');
 const {
+  aeadOpen,
+  aeadSeal,
   Cipher,
   Cipheriv,
   Decipher,
@@ -76,11 +82,14 @@ const {
 } = require('internal/crypto/cipher');
 const {
   Sign,
-  Verify
+  Verify,
+  signBatch
 } = require('internal/crypto/sig');
 const {
   Hash,
-  Hmac
+  Hmac,
+  hash,
+  hashFile
 } = require('internal/crypto/hash');
 const {
   getCiphers,
@@ -142,6 +151,8 @@ function createVerify(algorithm, options) {
 
 module.exports = exports = {
   // Methods
+  aeadOpen,
+  aeadSeal,
   createCipheriv,
   createDecipheriv,
   createDiffieHellman,
@@ -155,7 +166,10 @@ module.exports = exports = {
   getCurves,
   getDiffieHellman: createDiffieHellmanGroup,
   getHashes,
+  hash,
+  hashFile,
   pbkdf2,
+  pbkdf2Batch,
   pbkdf2Sync,
   generateKeyPair,
   generateKeyPairSync,
@@ -166,9 +180,13 @@ module.exports = exports = {
   randomBytes,
   randomFill,
   randomFillSync,
+  randomInt,
+  randomUUID,
   scrypt,
+  scryptBatch,
   scryptSync,
   setEngine,
+  signBatch,
   timingSafeEqual,
   getFips: !fipsMode ? getFipsDisabled :
     fipsForced ? getFipsForced : getFipsCrypto,
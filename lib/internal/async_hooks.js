@@ -29,8 +29,20 @@ const async_wrap = internalBinding('async_wrap');
  * popAsyncIds() call removes two doubles from it.
  * It has a fixed size, so if that is exceeded, calls to the native
  * side are used instead in pushAsyncIds() and popAsyncIds().
+ *
+ * context_frames is an Array shared with Environment::AsyncHooks. Index 0
+ * holds the context frame of the current execution context, and index n + 1
+ * holds the frame that was current when the n-th entry of async_ids_stack was
+ * pushed. Resources capture the current frame on creation, and it is restored
+ * when their callbacks run. It is only maintained while
+ * async_hook_fields[kUsesContextFrames] > 0.
  */
-const { async_hook_fields, async_id_fields, owner_symbol } = async_wrap;
+const {
+  async_hook_fields,
+  async_id_fields,
+  context_frames,
+  owner_symbol
+} = async_wrap;
 // Store the pair executionAsyncId and triggerAsyncId in a std::stack on
 // Environment::AsyncHooks::async_ids_stack_ tracks the resource responsible for
 // the current execution stack. This is unwound as each resource exits. In the
@@ -39,6 +51,12 @@ const { async_hook_fields, async_id_fields, owner_symbol } = async_wrap;
 const { pushAsyncIds: pushAsyncIds_, popAsyncIds: popAsyncIds_ } = async_wrap;
 // For performance reasons, only track Promises when a hook is enabled.
 const { enablePromiseHook, disablePromiseHook } = async_wrap;
+// Context frames are propagated through promises by a separate native hook
+// that never calls into JS.
+const {
+  enableContextFramePromiseHook,
+  disableContextFramePromiseHook
+} = async_wrap;
 // Properties in active_hooks are used to keep track of the set of hooks being
 // executed in case another hook is enabled/disabled. The new set of hooks is
 // then restored once the active set of hooks is finished executing.
@@ -72,11 +90,29 @@ const { registerDestroyHook } = async_wrap;
 // for a given step, that step can bail out early.
 const { kInit, kBefore, kAfter, kDestroy, kTotals, kPromiseResolve,
         kCheck, kExecutionAsyncId, kAsyncIdCounter, kTriggerAsyncId,
-        kDefaultTriggerAsyncId, kStackLength } = async_wrap.constants;
+        kDefaultTriggerAsyncId, kStackLength,
+        kUsesContextFrames } = async_wrap.constants;
+
+// Batched hooks receive async events through a buffer of fixed-size records
+// that is filled without calling into JS, and drained once per event loop
+// iteration or when it is full.
+const {
+  kEventBuffer, kEventBufferLength, kEventBufferCapacity, kEventBufferDropped,
+  kEventType, kEventAsyncId, kEventTriggerAsyncId, kEventResourceType,
+  kEventRecordSize
+} = async_wrap.constants;
+const {
+  queueEventBufferDrain,
+  registerEventType,
+  getEventTypeName: getEventTypeName_
+} = async_wrap;
+const batch_hooks = [];
+let event_buffer = null;
 
 // Used in AsyncHook and AsyncResource.
 const async_id_symbol = Symbol('asyncId');
 const trigger_async_id_symbol = Symbol('triggerAsyncId');
+const context_frame_symbol = Symbol('contextFrame');
 const init_symbol = Symbol('init');
 const before_symbol = Symbol('before');
 const after_symbol = Symbol('after');
@@ -87,6 +123,7 @@ const emitAfterNative = emitHookFactory(after_symbol, 'emitAfterNative');
 const emitDestroyNative = emitHookFactory(destroy_symbol, 'emitDestroyNative');
 const emitPromiseResolveNative =
     emitHookFactory(promise_resolve_symbol, 'emitPromiseResolveNative');
+const batch_symbol = Symbol('batch');
 
 // Setup the callbacks that node::AsyncWrap will call when there are hooks to
 // process. They use the same functions as the JS embedder API. These callbacks
@@ -96,7 +133,8 @@ async_wrap.setupHooks({ init: emitInitNative,
                         before: emitBeforeNative,
                         after: emitAfterNative,
                         destroy: emitDestroyNative,
-                        promise_resolve: emitPromiseResolveNative });
+                        promise_resolve: emitPromiseResolveNative,
+                        drain_events: drainEventBuffer });
 
 // Used to fatally abort the process if a callback throws.
 function fatalError(e) {
@@ -301,15 +339,16 @@ function defaultTriggerAsyncIdScope(triggerAsyncId, block, ...args) {
 
 
 function initHooksExist() {
-  return async_hook_fields[kInit] > 0;
+  return async_hook_fields[kInit] > 0 || async_hook_fields[kEventBuffer] > 0;
 }
 
 function afterHooksExist() {
-  return async_hook_fields[kAfter] > 0;
+  return async_hook_fields[kAfter] > 0 || async_hook_fields[kEventBuffer] > 0;
 }
 
 function destroyHooksExist() {
-  return async_hook_fields[kDestroy] > 0;
+  return async_hook_fields[kDestroy] > 0 ||
+         async_hook_fields[kEventBuffer] > 0;
 }
 
 
@@ -324,7 +363,7 @@ function emitInitScript(asyncId, type, triggerAsyncId, resource) {
 
   // Short circuit all checks for the common case. Which is that no hooks have
   // been set. Do this to remove performance impact for embedders (and core).
-  if (async_hook_fields[kInit] === 0)
+  if (async_hook_fields[kInit] === 0 && async_hook_fields[kEventBuffer] === 0)
     return;
 
   // This can run after the early return check b/c running this function
@@ -333,18 +372,27 @@ function emitInitScript(asyncId, type, triggerAsyncId, resource) {
     triggerAsyncId = getDefaultTriggerAsyncId();
   }
 
-  emitInitNative(asyncId, type, triggerAsyncId, resource);
+  if (async_hook_fields[kEventBuffer] > 0)
+    recordEvent(kInit, asyncId, triggerAsyncId, getEventTypeId(type));
+
+  if (async_hook_fields[kInit] > 0)
+    emitInitNative(asyncId, type, triggerAsyncId, resource);
 }
 
 
-function emitBeforeScript(asyncId, triggerAsyncId) {
+// `resource` is optional. If it is passed, its context frame becomes the
+// current one until the matching emitAfterScript() call.
+function emitBeforeScript(asyncId, triggerAsyncId, resource) {
   // Validate the ids. An id of -1 means it was never set and is visible on the
   // call graph. An id < -1 should never happen in any circumstance. Throw
   // on user calls because async state should still be recoverable.
   validateAsyncId(asyncId, 'asyncId');
   validateAsyncId(triggerAsyncId, 'triggerAsyncId');
 
-  pushAsyncIds(asyncId, triggerAsyncId);
+  pushAsyncIds(asyncId, triggerAsyncId, resource);
+
+  if (async_hook_fields[kEventBuffer] > 0)
+    recordEvent(kBefore, asyncId, -1, 0);
 
   if (async_hook_fields[kBefore] > 0)
     emitBeforeNative(asyncId);
@@ -354,6 +402,9 @@ function emitBeforeScript(asyncId, triggerAsyncId) {
 function emitAfterScript(asyncId) {
   validateAsyncId(asyncId, 'asyncId');
 
+  if (async_hook_fields[kEventBuffer] > 0)
+    recordEvent(kAfter, asyncId, -1, 0);
+
   if (async_hook_fields[kAfter] > 0)
     emitAfterNative(asyncId);
 
@@ -365,8 +416,11 @@ function emitDestroyScript(asyncId) {
   validateAsyncId(asyncId, 'asyncId');
 
   // Return early if there are no destroy callbacks, or invalid asyncId.
-  if (async_hook_fields[kDestroy] === 0 || asyncId <= 0)
+  if ((async_hook_fields[kDestroy] === 0 &&
+       async_hook_fields[kEventBuffer] === 0) || asyncId <= 0)
     return;
+  // The native side also records the event for batched hooks, once the queue
+  // is drained, so that they see it in the same order as the other hooks.
   async_wrap.queueDestroyAsyncId(asyncId);
 }
 
@@ -374,6 +428,8 @@ function emitDestroyScript(asyncId) {
 // Keep in sync with Environment::AsyncHooks::clear_async_id_stack
 // in src/env-inl.h.
 function clearAsyncIdStack() {
+  if (async_hook_fields[kUsesContextFrames] > 0)
+    context_frames.length = 0;
   async_id_fields[kExecutionAsyncId] = 0;
   async_id_fields[kTriggerAsyncId] = 0;
   async_hook_fields[kStackLength] = 0;
@@ -386,12 +442,21 @@ function hasAsyncIdStack() {
 
 
 // This is the equivalent of the native push_async_ids() call.
-function pushAsyncIds(asyncId, triggerAsyncId) {
+function pushAsyncIds(asyncId, triggerAsyncId, resource) {
   const offset = async_hook_fields[kStackLength];
-  if (offset * 2 >= async_wrap.async_ids_stack.length)
-    return pushAsyncIds_(asyncId, triggerAsyncId);
+  if (offset * 2 >= async_wrap.async_ids_stack.length) {
+    if (resource === undefined)
+      return pushAsyncIds_(asyncId, triggerAsyncId);
+    return pushAsyncIds_(asyncId, triggerAsyncId,
+                         resource[context_frame_symbol]);
+  }
   async_wrap.async_ids_stack[offset * 2] = async_id_fields[kExecutionAsyncId];
   async_wrap.async_ids_stack[offset * 2 + 1] = async_id_fields[kTriggerAsyncId];
+  if (async_hook_fields[kUsesContextFrames] > 0) {
+    context_frames[offset + 1] = context_frames[0];
+    if (resource !== undefined)
+      context_frames[0] = resource[context_frame_symbol];
+  }
   async_hook_fields[kStackLength]++;
   async_id_fields[kExecutionAsyncId] = asyncId;
   async_id_fields[kTriggerAsyncId] = triggerAsyncId;
@@ -412,11 +477,191 @@ function popAsyncIds(asyncId) {
   const offset = stackLength - 1;
   async_id_fields[kExecutionAsyncId] = async_wrap.async_ids_stack[2 * offset];
   async_id_fields[kTriggerAsyncId] = async_wrap.async_ids_stack[2 * offset + 1];
+  if (async_hook_fields[kUsesContextFrames] > 0) {
+    context_frames[0] = context_frames[offset + 1];
+    context_frames[offset + 1] = undefined;
+  }
   async_hook_fields[kStackLength] = offset;
   return offset > 0;
 }
 
 
+// Batched Hooks //
+
+const event_names = [];
+event_names[kInit] = 'init';
+event_names[kBefore] = 'before';
+event_names[kAfter] = 'after';
+event_names[kDestroy] = 'destroy';
+event_names[kPromiseResolve] = 'promiseResolve';
+
+// Resource types are stored as numbers. AsyncWrap providers use their
+// provider id, other types are interned by the native side on first use.
+const event_type_names = [];
+for (const name of Object.keys(async_wrap.Providers))
+  event_type_names[async_wrap.Providers[name]] = name;
+const event_type_ids = new Map();
+
+function getEventTypeId(type) {
+  let id = event_type_ids.get(type);
+  if (id === undefined) {
+    id = registerEventType(type);
+    event_type_ids.set(type, id);
+    event_type_names[id] = type;
+  }
+  return id;
+}
+
+function getEventTypeName(id) {
+  let name = event_type_names[id];
+  if (name === undefined) {
+    // Types that were first seen by the native embedder API.
+    name = getEventTypeName_(id);
+    event_type_names[id] = name;
+  }
+  return name;
+}
+
+// A read-only view of the records drained from the event buffer.
+class AsyncEventBatch {
+  constructor(records, length, dropped) {
+    this.records = records;
+    this.length = length;
+    // The number of events that were lost because the buffer was full while
+    // it could not be drained.
+    this.dropped = dropped;
+  }
+
+  type(index) {
+    return event_names[this.records[index * kEventRecordSize + kEventType]];
+  }
+
+  asyncId(index) {
+    return this.records[index * kEventRecordSize + kEventAsyncId];
+  }
+
+  // Only known for 'init' events, -1 otherwise.
+  triggerAsyncId(index) {
+    return this.records[index * kEventRecordSize + kEventTriggerAsyncId];
+  }
+
+  // Only known for 'init' events, undefined otherwise.
+  resourceType(index) {
+    if (this.type(index) !== 'init')
+      return undefined;
+    return getEventTypeName(
+      this.records[index * kEventRecordSize + kEventResourceType]);
+  }
+
+  * [Symbol.iterator]() {
+    for (var i = 0; i < this.length; i++) {
+      yield {
+        type: this.type(i),
+        asyncId: this.asyncId(i),
+        triggerAsyncId: this.triggerAsyncId(i),
+        resourceType: this.resourceType(i)
+      };
+    }
+  }
+}
+
+// Called from native once per event loop iteration after events have been
+// recorded, when the buffer is full, or on demand through flush().
+function drainEventBuffer() {
+  const length = async_hook_fields[kEventBufferLength];
+  const dropped = async_hook_fields[kEventBufferDropped];
+  if (event_buffer === null || (length === 0 && dropped === 0))
+    return;
+
+  const batch = new AsyncEventBatch(
+    event_buffer.slice(0, length * kEventRecordSize), length, dropped);
+  async_hook_fields[kEventBufferLength] = 0;
+  async_hook_fields[kEventBufferDropped] = 0;
+
+  // Events that are emitted by the callbacks end up in the next batch.
+  const hooks = batch_hooks.slice();
+  try {
+    for (var i = 0; i < hooks.length; i++)
+      hooks[i][batch_symbol](batch);
+  } catch (e) {
+    fatalError(e);
+  }
+}
+
+// This is the equivalent of the native RecordEvent() in src/async_wrap.cc.
+function recordEvent(type, asyncId, triggerAsyncId, resourceType) {
+  let length = async_hook_fields[kEventBufferLength];
+  if (length >= async_hook_fields[kEventBufferCapacity]) {
+    drainEventBuffer();
+    length = async_hook_fields[kEventBufferLength];
+    if (length >= async_hook_fields[kEventBufferCapacity]) {
+      async_hook_fields[kEventBufferDropped]++;
+      return;
+    }
+  }
+
+  const offset = length * kEventRecordSize;
+  event_buffer[offset + kEventType] = type;
+  event_buffer[offset + kEventAsyncId] = asyncId;
+  event_buffer[offset + kEventTriggerAsyncId] = triggerAsyncId;
+  event_buffer[offset + kEventResourceType] = resourceType;
+  async_hook_fields[kEventBufferLength] = length + 1;
+
+  if (length === 0)
+    queueEventBufferDrain();
+}
+
+function enableBatchHook(hook, capacity) {
+  if (batch_hooks.includes(hook))
+    return;
+  if (event_buffer === null)
+    event_buffer = async_wrap.enableEventBuffer(capacity);
+  batch_hooks.push(hook);
+  async_hook_fields[kEventBuffer] = batch_hooks.length;
+  if (batch_hooks.length === 1)
+    enableHooks();
+}
+
+function disableBatchHook(hook) {
+  const index = batch_hooks.indexOf(hook);
+  if (index === -1)
+    return;
+  // Deliver everything that was recorded while the hook was enabled.
+  drainEventBuffer();
+  batch_hooks.splice(index, 1);
+  async_hook_fields[kEventBuffer] = batch_hooks.length;
+  if (batch_hooks.length === 0)
+    disableHooks();
+}
+
+
+// Context Frames //
+
+// Context frames are opaque values that are captured by async resources when
+// they are created and restored when their callbacks run. Both steps happen
+// without calling into JS hooks, see AsyncWrap::AsyncReset() and
+// ContextFramePromiseHook() in src/async_wrap.cc.
+function enableContextFrames() {
+  if (async_hook_fields[kUsesContextFrames]++ === 0)
+    enableContextFramePromiseHook();
+}
+
+function disableContextFrames() {
+  if (--async_hook_fields[kUsesContextFrames] === 0) {
+    disableContextFramePromiseHook();
+    context_frames.length = 0;
+  }
+}
+
+function getContextFrame() {
+  return context_frames[0];
+}
+
+function setContextFrame(frame) {
+  context_frames[0] = frame;
+}
+
+
 function executionAsyncId() {
   return async_id_fields[kExecutionAsyncId];
 }
@@ -434,7 +679,7 @@ module.exports = {
   symbols: {
     async_id_symbol, trigger_async_id_symbol,
     init_symbol, before_symbol, after_symbol, destroy_symbol,
-    promise_resolve_symbol, owner_symbol
+    promise_resolve_symbol, owner_symbol, context_frame_symbol, batch_symbol
   },
   constants: {
     kInit, kBefore, kAfter, kDestroy, kTotals, kPromiseResolve
@@ -444,6 +689,13 @@ module.exports = {
   clearDefaultTriggerAsyncId,
   clearAsyncIdStack,
   hasAsyncIdStack,
+  enableBatchHook,
+  disableBatchHook,
+  drainEventBuffer,
+  enableContextFrames,
+  disableContextFrames,
+  getContextFrame,
+  setContextFrame,
   // Internal Embedder API
   newAsyncId,
   getOrSetAsyncId,
@@ -34,6 +34,7 @@ const { TCP } = internalBinding('tcp_wrap');
 const { TTY } = internalBinding('tty_wrap');
 const { UDP } = internalBinding('udp_wrap');
 const SocketList = require('internal/socket_list');
+const serialization = require('internal/child_process/serialization');
 const { owner_symbol } = require('internal/async_hooks').symbols;
 const { convertToValidSignal } = require('internal/util');
 const { isArrayBufferView } = require('internal/util/types');
@@ -54,7 +55,6 @@ const {
 const { SocketListSend, SocketListReceive } = SocketList;
 
 // Lazy loaded for startup performance.
-let StringDecoder;
 // Lazy loaded for startup performance and to allow monkey patching of
 // internalBinding('http_parser').HTTPParser.
 let freeParser;
@@ -321,6 +321,14 @@ ChildProcess.prototype.spawn = function(options) {
   ipcFd = stdio.ipcFd;
   stdio = options.stdio = stdio.stdio;
 
+  const serializationMode = options.serialization;
+  if (serializationMode !== undefined &&
+      serializationMode !== 'json' &&
+      serializationMode !== 'advanced') {
+    throw new ERR_INVALID_OPT_VALUE('options.serialization',
+                                    serializationMode);
+  }
+
   if (ipc !== undefined) {
     // Let child process know about opened IPC channel
     if (options.envPairs === undefined)
@@ -332,6 +340,10 @@ ChildProcess.prototype.spawn = function(options) {
     }
 
     options.envPairs.push('NODE_CHANNEL_FD=' + ipcFd);
+    if (serializationMode !== undefined) {
+      options.envPairs.push('NODE_CHANNEL_SERIALIZATION_MODE=' +
+                            serializationMode);
+    }
   }
 
   validateString(options.file, 'options.file');
@@ -412,7 +424,7 @@ ChildProcess.prototype.spawn = function(options) {
     this.stdio.push(stdio[i].socket === undefined ? null : stdio[i].socket);
 
   // Add .send() method and start listening for IPC data
-  if (ipc !== undefined) setupChannel(this, ipc);
+  if (ipc !== undefined) setupChannel(this, ipc, serializationMode);
 
   return err;
 };
@@ -479,7 +491,7 @@ class Control extends EventEmitter {
   }
 }
 
-function setupChannel(target, channel) {
+function setupChannel(target, channel, serializationMode) {
   target.channel = channel;
 
   // _channel can be deprecated in version 8
@@ -494,12 +506,16 @@ function setupChannel(target, channel) {
 
   const control = new Control(channel);
 
-  if (StringDecoder === undefined)
-    StringDecoder = require('string_decoder').StringDecoder;
-  var decoder = new StringDecoder('utf8');
-  var jsonBuffer = '';
+  if (serializationMode === undefined)
+    serializationMode = 'json';
+  const {
+    initMessageChannel,
+    parseChannelMessages,
+    writeChannelMessage
+  } = serialization[serializationMode];
+  initMessageChannel(channel);
+
   var pendingHandle = null;
-  channel.buffering = false;
   channel.pendingHandle = null;
   channel.onread = function(arrayBuffer) {
     const recvHandle = channel.pendingHandle;
@@ -507,25 +523,11 @@ function setupChannel(target, channel) {
     if (arrayBuffer) {
       const nread = streamBaseState[kReadBytesOrError];
       const offset = streamBaseState[kArrayBufferOffset];
-      const pool = new Uint8Array(arrayBuffer, offset, nread);
       if (recvHandle)
         pendingHandle = recvHandle;
 
-      // Linebreak is used as a message end sign
-      var chunks = decoder.write(pool).split('\n');
-      var numCompleteChunks = chunks.length - 1;
-      // Last line does not have trailing linebreak
-      var incompleteChunk = chunks[numCompleteChunks];
-      if (numCompleteChunks === 0) {
-        jsonBuffer += incompleteChunk;
-        this.buffering = jsonBuffer.length !== 0;
-        return;
-      }
-      chunks[0] = jsonBuffer + chunks[0];
-
-      for (var i = 0; i < numCompleteChunks; i++) {
-        var message = JSON.parse(chunks[i]);
-
+      for (const message of parseChannelMessages(channel, arrayBuffer,
+                                                 offset, nread)) {
         // There will be at most one NODE_HANDLE message in every chunk we
         // read because SCM_RIGHTS messages don't get coalesced. Make sure
         // that we deliver the handle with the right message however.
@@ -540,9 +542,6 @@ function setupChannel(target, channel) {
           handleMessage(message, undefined, false);
         }
       }
-      jsonBuffer = incompleteChunk;
-      this.buffering = jsonBuffer.length !== 0;
-
     } else {
       this.buffering = false;
       target.disconnect();
@@ -727,8 +726,7 @@ function setupChannel(target, channel) {
 
     var req = new WriteWrap();
 
-    var string = JSON.stringify(message) + '\n';
-    var err = channel.writeUtf8String(req, string, handle);
+    var err = writeChannelMessage(channel, req, message, handle);
     var wasAsyncWrite = streamBaseState[kLastWriteWasAsync];
 
     if (err === 0) {
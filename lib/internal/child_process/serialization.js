@@ -0,0 +1,111 @@
+'use strict';
+
+const { Buffer } = require('buffer');
+const { StringDecoder } = require('string_decoder');
+const v8 = require('v8');
+const { FastBuffer } = require('internal/buffer');
+const { FrameParser } = internalBinding('serdes');
+
+const kFrameParser = Symbol('kFrameParser');
+const kJSONBuffer = Symbol('kJSONBuffer');
+const kStringDecoder = Symbol('kStringDecoder');
+
+// Space for the length of a frame, which is filled in after the message has
+// been serialized so that the frame can be written without another copy.
+const kFrameHeaderPlaceholder = Buffer.alloc(4);
+
+// The default serializer turns Buffers into plain Uint8Arrays, so mark every
+// host object with whether it was a Buffer.
+class ChildProcessSerializer extends v8.DefaultSerializer {
+  _writeHostObject(object) {
+    this.writeUint32(Buffer.isBuffer(object) ? 1 : 0);
+    super._writeHostObject(object);
+  }
+}
+
+class ChildProcessDeserializer extends v8.DefaultDeserializer {
+  _readHostObject() {
+    const isBuffer = this.readUint32() === 1;
+    const view = super._readHostObject();
+    if (!isBuffer)
+      return view;
+    return new FastBuffer(view.buffer, view.byteOffset, view.byteLength);
+  }
+}
+
+// Every serialization mode provides the same three functions:
+// - initMessageChannel(channel) sets up the state for reading from `channel`.
+// - parseChannelMessages(channel, arrayBuffer, offset, length) consumes the
+//   data that has been read, and returns an iterator over the messages that
+//   it completes. It also updates `channel.buffering`.
+// - writeChannelMessage(channel, req, message, handle) sends `message` and
+//   returns a libuv error code.
+const advanced = {
+  initMessageChannel(channel) {
+    channel[kFrameParser] = new FrameParser();
+    channel.buffering = false;
+  },
+
+  *parseChannelMessages(channel, arrayBuffer, offset, length) {
+    // The frames are split off in C++, without converting the data to a
+    // string or looking at the message contents.
+    const parser = channel[kFrameParser];
+    const frames = parser.push(arrayBuffer, offset, length);
+    channel.buffering = parser.pendingBytes() > 0;
+    for (var i = 0; i < frames.length; i++) {
+      const deserializer = new ChildProcessDeserializer(frames[i]);
+      deserializer.readHeader();
+      yield deserializer.readValue();
+    }
+  },
+
+  writeChannelMessage(channel, req, message, handle) {
+    const serializer = new ChildProcessSerializer();
+    serializer.writeRawBytes(kFrameHeaderPlaceholder);
+    serializer.writeHeader();
+    serializer.writeValue(message);
+    const frame = serializer.releaseBuffer();
+    frame.writeUInt32BE(frame.length - kFrameHeaderPlaceholder.length, 0);
+    // Keep the data alive until the write has finished.
+    req.buffer = frame;
+    return channel.writeBuffer(req, frame, handle);
+  }
+};
+
+const json = {
+  initMessageChannel(channel) {
+    channel[kJSONBuffer] = '';
+    channel[kStringDecoder] = undefined;
+    channel.buffering = false;
+  },
+
+  *parseChannelMessages(channel, arrayBuffer, offset, length) {
+    if (channel[kStringDecoder] === undefined)
+      channel[kStringDecoder] = new StringDecoder('utf8');
+
+    // Linebreak is used as a message end sign
+    const pool = new Uint8Array(arrayBuffer, offset, length);
+    const chunks = channel[kStringDecoder].write(pool).split('\n');
+    const numCompleteChunks = chunks.length - 1;
+    // Last line does not have trailing linebreak
+    const incompleteChunk = chunks[numCompleteChunks];
+    if (numCompleteChunks === 0) {
+      channel[kJSONBuffer] += incompleteChunk;
+      channel.buffering = channel[kJSONBuffer].length !== 0;
+      return;
+    }
+    chunks[0] = channel[kJSONBuffer] + chunks[0];
+    channel[kJSONBuffer] = incompleteChunk;
+    channel.buffering = incompleteChunk.length !== 0;
+
+    for (var i = 0; i < numCompleteChunks; i++)
+      yield JSON.parse(chunks[i]);
+  },
+
+  writeChannelMessage(channel, req, message, handle) {
+    const string = JSON.stringify(message) + '\n';
+    return channel.writeUtf8String(req, string, handle);
+  }
+};
+
+module.exports = { advanced, json };
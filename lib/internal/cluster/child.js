@@ -2,6 +2,8 @@
 const assert = require('assert');
 const path = require('path');
 const EventEmitter = require('events');
+const net = require('net');
+const { constants: TCPConstants } = internalBinding('tcp_wrap');
 const { owner_symbol } = require('internal/async_hooks').symbols;
 const Worker = require('internal/cluster/worker');
 const { internal, sendHelper } = require('internal/cluster/utils');
@@ -89,6 +91,8 @@ cluster._getServer = function(obj, options, cb) {
 
     if (handle)
       shared(reply, handle, indexesKey, cb);  // Shared listen socket.
+    else if (reply.reuseport)
+      reuseport(reply, message, indexesKey, cb);  // Own listen socket.
     else
       rr(reply, indexesKey, cb);              // Round-robin.
   });
@@ -120,6 +124,29 @@ function shared(message, handle, indexesKey, cb) {
   cb(message.errno, handle);
 }
 
+// SO_REUSEPORT. Every worker listens on a socket of its own, bound to the
+// port that the master reserved, and the kernel distributes connections.
+function reuseport(message, query, indexesKey, cb) {
+  if (message.errno)
+    return cb(message.errno, null);
+
+  const handle = net._createServerHandle(query.address,
+                                         message.sockname.port,
+                                         query.addressType,
+                                         query.fd,
+                                         query.flags |
+                                           TCPConstants.TCP_REUSEPORT);
+
+  if (typeof handle === 'number') {
+    // Let the master release its socket if this was the last worker.
+    send({ act: 'close', key: message.key });
+    indexes.delete(indexesKey);
+    return cb(handle, null);
+  }
+
+  shared(message, handle, indexesKey, cb);
+}
+
 // Round-robin. Master distributes handles across workers.
 function rr(message, indexesKey, cb) {
   if (message.errno)
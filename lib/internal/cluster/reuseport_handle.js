@@ -0,0 +1,60 @@
+'use strict';
+const assert = require('assert');
+const net = require('net');
+const { constants: TCPConstants } = internalBinding('tcp_wrap');
+
+module.exports = ReusePortHandle;
+
+// The master binds, but never listens on, a socket with SO_REUSEPORT set.
+// That reserves the address and turns port 0 into a real port number. Each
+// worker then binds and listens on a SO_REUSEPORT socket of its own for that
+// same port, and the kernel spreads incoming connections across them.
+function ReusePortHandle(key, address, port, addressType, fd, flags) {
+  this.key = key;
+  this.workers = [];
+  this.handle = null;
+  this.errno = 0;
+  this.sockname = null;
+
+  const rval = net._createServerHandle(address, port, addressType, fd,
+                                       flags | TCPConstants.TCP_REUSEPORT);
+
+  if (typeof rval === 'number') {
+    this.errno = rval;
+    return;
+  }
+
+  const out = {};
+  const err = rval.getsockname(out);
+
+  if (err) {
+    rval.close();
+    this.errno = err;
+    return;
+  }
+
+  this.handle = rval;
+  this.sockname = out;
+}
+
+ReusePortHandle.prototype.add = function(worker, send) {
+  assert(this.workers.indexOf(worker) === -1);
+  this.workers.push(worker);
+  send(this.errno, { reuseport: true, sockname: this.sockname }, null);
+};
+
+ReusePortHandle.prototype.remove = function(worker) {
+  const index = this.workers.indexOf(worker);
+
+  if (index === -1)
+    return false; // The worker wasn't sharing this handle.
+
+  this.workers.splice(index, 1);
+
+  if (this.workers.length !== 0)
+    return false;
+
+  this.handle.close();
+  this.handle = null;
+  return true;
+};
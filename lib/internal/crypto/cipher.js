@@ -1,16 +1,23 @@
 'use strict';
 
+const { AsyncWrap, Providers } = internalBinding('async_wrap');
 const {
   RSA_PKCS1_OAEP_PADDING,
   RSA_PKCS1_PADDING
 } = internalBinding('constants').crypto;
 
 const {
+  ERR_BUFFER_OUT_OF_BOUNDS,
   ERR_CRYPTO_INVALID_STATE,
   ERR_INVALID_ARG_TYPE,
+  ERR_INVALID_ARG_VALUE,
+  ERR_INVALID_CALLBACK,
   ERR_INVALID_OPT_VALUE
 } = require('internal/errors').codes;
-const { validateString } = require('internal/validators');
+const {
+  validateString,
+  validateUint32
+} = require('internal/validators');
 
 const {
   getDefaultEncoding,
@@ -20,9 +27,11 @@ const {
 } = require('internal/crypto/util');
 
 const { isArrayBufferView } = require('internal/util/types');
+const { Buffer } = require('buffer');
 
 const {
   CipherBase,
+  aeadCipher: _aeadCipher,
   privateDecrypt: _privateDecrypt,
   privateEncrypt: _privateEncrypt,
   publicDecrypt: _publicDecrypt,
@@ -37,12 +46,31 @@ const { deprecate, normalizeEncoding } = require('internal/util');
 // Lazy loaded for startup performance.
 let StringDecoder;
 
+// Buffer chunks that are written to a cipher stream are encrypted or decrypted
+// into slices of a pool that belongs to the stream, instead of into a new
+// allocation for every chunk.
+const kStreamPoolSize = 64 * 1024;
+// EVP_MAX_BLOCK_LENGTH, the most that OpenSSL adds to the input of an update.
+const kMaxBlockLength = 32;
+const kPool = Symbol('kPool');
+const kPoolOffset = Symbol('kPoolOffset');
+
 function rsaFunctionFor(method, defaultPadding) {
-  return (options, buffer) => {
+  return (options, buffer, callback) => {
     const key = options.key || options;
     const padding = options.padding || defaultPadding;
     const passphrase = options.passphrase || null;
-    return method(toBuf(key), buffer, padding, passphrase);
+    if (callback === undefined)
+      return method(toBuf(key), buffer, padding, passphrase);
+
+    if (typeof callback !== 'function')
+      throw new ERR_INVALID_CALLBACK();
+    const wrap = new AsyncWrap(Providers.PUBLICKEYCIPHERREQUEST);
+    wrap.ondone = (err, result) => {
+      if (err) return callback.call(wrap, err);
+      callback.call(wrap, null, result);
+    };
+    method(toBuf(key), buffer, padding, passphrase, wrap);
   };
 }
 
@@ -80,6 +108,8 @@ function createCipherBase(cipher, credential, options, decipher, iv) {
     this[kHandle].initiv(cipher, credential, iv, authTagLength);
   }
   this._decoder = null;
+  this[kPool] = null;
+  this[kPoolOffset] = 0;
 
   LazyTransform.call(this, options);
 }
@@ -126,8 +156,27 @@ function Cipher(cipher, password, options) {
 Object.setPrototypeOf(Cipher.prototype, LazyTransform.prototype);
 Object.setPrototypeOf(Cipher, LazyTransform);
 
+function updateIntoPool(cipher, chunk) {
+  const size = chunk.byteLength + kMaxBlockLength;
+  let pool = cipher[kPool];
+  if (pool === null || pool.length - cipher[kPoolOffset] < size) {
+    pool = cipher[kPool] = Buffer.allocUnsafe(Math.max(size, kStreamPoolSize));
+    cipher[kPoolOffset] = 0;
+  }
+  const offset = cipher[kPoolOffset];
+  const written = cipher[kHandle].updateInto(chunk, pool, offset);
+  if (written < 0)
+    return cipher[kHandle].update(chunk);
+  // Keep the next output 8-byte aligned, like the pool of Buffer.
+  cipher[kPoolOffset] = (offset + written + 7) & ~7;
+  return pool.slice(offset, offset + written);
+}
+
 Cipher.prototype._transform = function _transform(chunk, encoding, callback) {
-  this.push(this[kHandle].update(chunk, encoding));
+  if (typeof chunk === 'string')
+    this.push(this[kHandle].update(chunk, encoding));
+  else
+    this.push(updateIntoPool(this, chunk));
   callback();
 };
 
@@ -161,6 +210,28 @@ Cipher.prototype.update = function update(data, inputEncoding, outputEncoding) {
 };
 
 
+Cipher.prototype.updateInto = function updateInto(data, output, offset = 0) {
+  if (!isArrayBufferView(data)) {
+    throw new ERR_INVALID_ARG_TYPE('data',
+                                   ['Buffer', 'TypedArray', 'DataView'],
+                                   data);
+  }
+  if (!isArrayBufferView(output)) {
+    throw new ERR_INVALID_ARG_TYPE('output',
+                                   ['Buffer', 'TypedArray', 'DataView'],
+                                   output);
+  }
+  validateUint32(offset, 'offset');
+  if (offset > output.byteLength)
+    throw new ERR_BUFFER_OUT_OF_BOUNDS('offset');
+
+  const written = this[kHandle].updateInto(data, output, offset);
+  if (written < 0)
+    throw new ERR_BUFFER_OUT_OF_BOUNDS('output');
+  return written;
+};
+
+
 Cipher.prototype.final = function final(outputEncoding) {
   outputEncoding = outputEncoding || getDefaultEncoding();
   const ret = this[kHandle].final();
@@ -232,6 +303,7 @@ function addCipherPrototypeFunctions(constructor) {
   constructor.prototype._transform = Cipher.prototype._transform;
   constructor.prototype._flush = Cipher.prototype._flush;
   constructor.prototype.update = Cipher.prototype.update;
+  constructor.prototype.updateInto = Cipher.prototype.updateInto;
   constructor.prototype.final = Cipher.prototype.final;
   constructor.prototype.setAutoPadding = Cipher.prototype.setAutoPadding;
   if (constructor === Cipheriv) {
@@ -284,7 +356,87 @@ Object.setPrototypeOf(Decipheriv, LazyTransform);
 addCipherPrototypeFunctions(Decipheriv);
 legacyNativeHandle(Decipheriv);
 
+function getAEADOptions(options) {
+  if (options === undefined)
+    return {};
+  if (options === null || typeof options !== 'object')
+    throw new ERR_INVALID_ARG_TYPE('options', 'Object', options);
+  return options;
+}
+
+function getAEADOutput(options, length) {
+  const { output, outputOffset = 0 } = options;
+  if (output === undefined)
+    return [Buffer.allocUnsafe(length), 0];
+  if (!isArrayBufferView(output)) {
+    throw new ERR_INVALID_ARG_TYPE('options.output',
+                                   ['Buffer', 'TypedArray', 'DataView'],
+                                   output);
+  }
+  validateUint32(outputOffset, 'options.outputOffset');
+  if (outputOffset > output.byteLength ||
+      output.byteLength - outputOffset < length) {
+    throw new ERR_BUFFER_OUT_OF_BOUNDS('options.output');
+  }
+  return [output, outputOffset];
+}
+
+function aeadCipher(encrypt, algorithm, key, iv, input, options) {
+  validateString(algorithm, 'algorithm');
+  key = toBuf(key);
+  if (!isArrayBufferView(key))
+    throw invalidArrayBufferView('key', key);
+  iv = toBuf(iv);
+  if (!isArrayBufferView(iv))
+    throw invalidArrayBufferView('iv', iv);
+  const name = encrypt ? 'plaintext' : 'sealed';
+  if (!isArrayBufferView(input)) {
+    throw new ERR_INVALID_ARG_TYPE(name,
+                                   ['Buffer', 'TypedArray', 'DataView'],
+                                   input);
+  }
+
+  options = getAEADOptions(options);
+  const { aad, authTagLength = 16 } = options;
+  if (aad !== undefined && !isArrayBufferView(aad)) {
+    throw new ERR_INVALID_ARG_TYPE('options.aad',
+                                   ['Buffer', 'TypedArray', 'DataView'],
+                                   aad);
+  }
+  if (authTagLength >>> 0 !== authTagLength)
+    throw new ERR_INVALID_OPT_VALUE('authTagLength', authTagLength);
+
+  // Sealed data is the ciphertext followed by the authentication tag.
+  let authTag;
+  if (!encrypt) {
+    if (input.byteLength < authTagLength) {
+      throw new ERR_INVALID_ARG_VALUE(
+        name, input, 'must contain the authentication tag');
+    }
+    const length = input.byteLength - authTagLength;
+    authTag = new Uint8Array(input.buffer, input.byteOffset + length,
+                             authTagLength);
+    input = new Uint8Array(input.buffer, input.byteOffset, length);
+  }
+
+  const length = input.byteLength + (encrypt ? authTagLength : 0);
+  const [output, offset] = getAEADOutput(options, length);
+  const written = _aeadCipher(encrypt, algorithm, key, iv, input, aad, authTag,
+                              authTagLength, output, offset);
+  return Buffer.from(output.buffer, output.byteOffset + offset, written);
+}
+
+function aeadSeal(algorithm, key, iv, plaintext, options) {
+  return aeadCipher(true, algorithm, key, iv, plaintext, options);
+}
+
+function aeadOpen(algorithm, key, iv, sealed, options) {
+  return aeadCipher(false, algorithm, key, iv, sealed, options);
+}
+
 module.exports = {
+  aeadOpen,
+  aeadSeal,
   Cipher,
   Cipheriv,
   Decipher,
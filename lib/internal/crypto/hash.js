@@ -1,8 +1,11 @@
 'use strict';
 
+const { AsyncWrap, Providers } = internalBinding('async_wrap');
 const {
   Hash: _Hash,
-  Hmac: _Hmac
+  Hmac: _Hmac,
+  hash: _hash,
+  hashFile: _hashFile
 } = process.binding('crypto');
 
 const {
@@ -18,11 +21,14 @@ const {
   ERR_CRYPTO_HASH_DIGEST_NO_UTF16,
   ERR_CRYPTO_HASH_FINALIZED,
   ERR_CRYPTO_HASH_UPDATE_FAILED,
-  ERR_INVALID_ARG_TYPE
+  ERR_INVALID_ARG_TYPE,
+  ERR_INVALID_CALLBACK
 } = require('internal/errors').codes;
 const { validateString } = require('internal/validators');
 const { normalizeEncoding } = require('internal/util');
 const { isArrayBufferView } = require('internal/util/types');
+const { validatePath } = require('internal/fs/utils');
+const { toPathIfFileURL } = require('internal/url');
 const LazyTransform = require('internal/streams/lazy_transform');
 const kState = Symbol('kState');
 const kFinalized = Symbol('kFinalized');
@@ -127,7 +133,82 @@ Hmac.prototype._transform = Hash.prototype._transform;
 
 legacyNativeHandle(Hmac);
 
+// The asynchronous form of hash() only hands inputs of at least this size to
+// the threadpool. Hashing smaller ones takes less time than scheduling them.
+const kHashAsyncThreshold = 64 * 1024;
+
+function getDigestEncoding(outputEncoding) {
+  outputEncoding = outputEncoding || getDefaultEncoding();
+  if (normalizeEncoding(outputEncoding) === 'utf16le')
+    throw new ERR_CRYPTO_HASH_DIGEST_NO_UTF16();
+  // Explicit conversion for backward compatibility.
+  return `${outputEncoding}`;
+}
+
+function onHashDone(wrap, callback) {
+  wrap.ondone = (err, digest) => {
+    if (err) return callback.call(wrap, err);
+    callback.call(wrap, null, digest);
+  };
+}
+
+function hash(algorithm, data, outputEncoding, callback) {
+  if (typeof outputEncoding === 'function') {
+    callback = outputEncoding;
+    outputEncoding = undefined;
+  }
+  validateString(algorithm, 'algorithm');
+  if (typeof data !== 'string' && !isArrayBufferView(data)) {
+    throw new ERR_INVALID_ARG_TYPE('data',
+                                   ['string', 'TypedArray', 'DataView'], data);
+  }
+  outputEncoding = getDigestEncoding(outputEncoding);
+
+  if (callback === undefined)
+    return _hash(algorithm, data, outputEncoding);
+  if (typeof callback !== 'function')
+    throw new ERR_INVALID_CALLBACK();
+
+  if (typeof data === 'string')
+    data = Buffer.from(data);
+  if (data.byteLength < kHashAsyncThreshold) {
+    let digest;
+    try {
+      digest = _hash(algorithm, data, outputEncoding);
+    } catch (err) {
+      process.nextTick(callback, err);
+      return;
+    }
+    process.nextTick(callback, null, digest);
+    return;
+  }
+
+  const wrap = new AsyncWrap(Providers.HASHREQUEST);
+  wrap.buffer = data;  // Retains the data while the request is in flight.
+  onHashDone(wrap, callback);
+  _hash(algorithm, data, outputEncoding, wrap);
+}
+
+function hashFile(algorithm, path, outputEncoding, callback) {
+  if (typeof outputEncoding === 'function') {
+    callback = outputEncoding;
+    outputEncoding = undefined;
+  }
+  validateString(algorithm, 'algorithm');
+  path = toPathIfFileURL(path);
+  validatePath(path);
+  outputEncoding = getDigestEncoding(outputEncoding);
+  if (typeof callback !== 'function')
+    throw new ERR_INVALID_CALLBACK();
+
+  const wrap = new AsyncWrap(Providers.HASHREQUEST);
+  onHashDone(wrap, callback);
+  _hashFile(algorithm, path, outputEncoding, wrap);
+}
+
 module.exports = {
   Hash,
-  Hmac
+  Hmac,
+  hash,
+  hashFile
 };
@@ -2,8 +2,11 @@
 
 const { AsyncWrap, Providers } = internalBinding('async_wrap');
 const { Buffer } = require('buffer');
-const { pbkdf2: _pbkdf2 } = internalBinding('crypto');
-const { validateUint32 } = require('internal/validators');
+const {
+  pbkdf2: _pbkdf2,
+  pbkdf2Batch: _pbkdf2Batch
+} = internalBinding('crypto');
+const { validateString, validateUint32 } = require('internal/validators');
 const { deprecate } = require('internal/util');
 const {
   ERR_CRYPTO_INVALID_DIGEST,
@@ -13,6 +16,8 @@ const {
 } = require('internal/errors').codes;
 const {
   getDefaultEncoding,
+  getKeyDerivationItems,
+  splitKeys,
   validateArrayBufferView,
 } = require('internal/crypto/util');
 
@@ -51,6 +56,37 @@ function pbkdf2Sync(password, salt, iterations, keylen, digest) {
   return keybuf.toString(encoding);
 }
 
+function pbkdf2Batch(items, iterations, keylen, digest, callback) {
+  validateString(digest, 'digest');
+  iterations = validateUint32(iterations, 'iterations', 0);
+  keylen = validateUint32(keylen, 'keylen', 0);
+  const { passwords, salts } = getKeyDerivationItems(items);
+
+  if (typeof callback !== 'function')
+    throw new ERR_INVALID_CALLBACK();
+
+  const encoding = getDefaultEncoding();
+  const count = passwords.length;
+  const keybuf = Buffer.alloc(keylen * count);
+
+  // An empty batch is only validated.
+  let wrap;
+  if (count > 0) {
+    wrap = new AsyncWrap(Providers.PBKDF2REQUEST);
+    wrap.ondone = (ex) => {  // Retains keybuf while request is in flight.
+      if (ex === null) ex = new ERR_CRYPTO_PBKDF2_ERROR();
+      if (ex) return callback.call(wrap, ex);
+      callback.call(wrap, null, splitKeys(keybuf, count, encoding));
+    };
+  }
+
+  const rc = _pbkdf2Batch(keybuf, passwords, salts, iterations, digest, wrap);
+  if (rc === -1)
+    throw new ERR_CRYPTO_INVALID_DIGEST(digest);
+  if (count === 0)
+    process.nextTick(callback, null, []);
+}
+
 const defaultDigest = deprecate(() => 'sha1',
                                 'Calling pbkdf2 or pbkdf2Sync with "digest" ' +
                                 'set to null is deprecated.',
@@ -83,5 +119,6 @@ function handleError(keybuf, password, salt, iterations, digest, wrap) {
 
 module.exports = {
   pbkdf2,
+  pbkdf2Batch,
   pbkdf2Sync
 };
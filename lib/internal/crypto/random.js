@@ -8,12 +8,29 @@ const {
   ERR_INVALID_CALLBACK,
   ERR_OUT_OF_RANGE
 } = require('internal/errors').codes;
-const { validateNumber } = require('internal/validators');
+const { validateInteger, validateNumber } = require('internal/validators');
 const { isArrayBufferView } = require('internal/util/types');
 
 const kMaxUint32 = 2 ** 32 - 1;
 const kMaxPossibleLength = Math.min(kMaxLength, kMaxUint32);
 
+// Small synchronous requests, randomUUID() and randomInt() draw their bytes
+// from a pool that is filled in bulk, which saves a call into OpenSSL for each
+// of them. The pool is refilled synchronously, so that synchronous calls
+// neither create async resources nor use the threadpool. It is never exposed,
+// only copied from.
+const kPoolSize = 4096;
+const kMaxPooledSize = 256;
+let pool;
+let poolOffset = kPoolSize;
+
+// randomInt() draws 48-bit values.
+const kMaxRandomIntRange = 2 ** 48 - 1;
+
+const kHexBytes = [];
+for (var i = 0; i < 256; i++)
+  kHexBytes[i] = (i < 16 ? '0' : '') + i.toString(16);
+
 function assertOffset(offset, elementSize, length) {
   validateNumber(offset, 'offset');
   offset *= elementSize;
@@ -42,6 +59,30 @@ function assertSize(size, elementSize, offset, length) {
   return size >>> 0;  // Convert to uint32.
 }
 
+function refillPool() {
+  if (pool === undefined)
+    pool = Buffer.allocUnsafeSlow(kPoolSize);
+  handleError(pool, 0, kPoolSize);
+  poolOffset = 0;
+}
+
+// Returns the offset of `size` unused bytes in `pool`.
+function takeFromPool(size) {
+  if (poolOffset + size > kPoolSize)
+    refillPool();
+  const offset = poolOffset;
+  poolOffset += size;
+  return offset;
+}
+
+function fillFromPool(buf, offset, size) {
+  const start = takeFromPool(size);
+  const target = buf instanceof Uint8Array ? buf :
+    new Uint8Array(buf.buffer, buf.byteOffset, buf.byteLength);
+  target.set(pool.subarray(start, start + size), offset);
+  return buf;
+}
+
 function randomBytes(size, cb) {
   size = assertSize(size, 1, 0, Infinity);
   if (cb !== undefined && typeof cb !== 'function')
@@ -49,7 +90,11 @@ function randomBytes(size, cb) {
 
   const buf = Buffer.alloc(size);
 
-  if (!cb) return handleError(buf, 0, size);
+  if (!cb) {
+    if (size <= kMaxPooledSize)
+      return fillFromPool(buf, 0, size);
+    return handleError(buf, 0, size);
+  }
 
   const wrap = new AsyncWrap(Providers.RANDOMBYTESREQUEST);
   wrap.ondone = (ex) => {  // Retains buf while request is in flight.
@@ -75,6 +120,8 @@ function randomFillSync(buf, offset = 0, size) {
     size = assertSize(size, elementSize, offset, buf.byteLength);
   }
 
+  if (size <= kMaxPooledSize)
+    return fillFromPool(buf, offset, size);
   return handleError(buf, offset, size);
 }
 
@@ -113,6 +160,90 @@ function randomFill(buf, offset, size, cb) {
   _randomBytes(buf, offset, size, wrap);
 }
 
+function randomInt(min, max, cb) {
+  // randomInt(max[, cb])
+  const minNotSpecified = max === undefined || typeof max === 'function';
+  if (minNotSpecified) {
+    cb = max;
+    max = min;
+    min = 0;
+  }
+  if (cb !== undefined && typeof cb !== 'function')
+    throw new ERR_INVALID_CALLBACK();
+
+  validateInteger(min, 'min');
+  validateInteger(max, 'max');
+  if (max <= min) {
+    throw new ERR_OUT_OF_RANGE(
+      'max', `greater than the value of "min" (${min})`, max);
+  }
+  const range = max - min;
+  if (range > kMaxRandomIntRange) {
+    throw new ERR_OUT_OF_RANGE(minNotSpecified ? 'max' : 'max - min',
+                               `<= ${kMaxRandomIntRange}`, range);
+  }
+
+  // Values at or above `limit` would make the lower results more likely, they
+  // are rejected.
+  const limit = kMaxRandomIntRange + 1 - ((kMaxRandomIntRange + 1) % range);
+  let value;
+  do {
+    const offset = takeFromPool(6);
+    value = pool.readUIntBE(offset, 6);
+  } while (value >= limit);
+  const result = min + value % range;
+
+  if (cb === undefined)
+    return result;
+  process.nextTick(cb, null, result);
+}
+
+function randomUUID(options) {
+  if (options !== undefined &&
+      (options === null || typeof options !== 'object')) {
+    throw new ERR_INVALID_ARG_TYPE('options', 'Object', options);
+  }
+  const disableEntropyCache =
+    options === undefined ? false : options.disableEntropyCache;
+  if (disableEntropyCache !== undefined &&
+      typeof disableEntropyCache !== 'boolean') {
+    throw new ERR_INVALID_ARG_TYPE('options.disableEntropyCache', 'boolean',
+                                   disableEntropyCache);
+  }
+
+  let buf;
+  let offset;
+  if (disableEntropyCache) {
+    buf = handleError(Buffer.alloc(16), 0, 16);
+    offset = 0;
+  } else {
+    offset = takeFromPool(16);
+    buf = pool;
+  }
+
+  // Version 4 and the RFC 4122 variant.
+  return kHexBytes[buf[offset]] +
+    kHexBytes[buf[offset + 1]] +
+    kHexBytes[buf[offset + 2]] +
+    kHexBytes[buf[offset + 3]] +
+    '-' +
+    kHexBytes[buf[offset + 4]] +
+    kHexBytes[buf[offset + 5]] +
+    '-' +
+    kHexBytes[(buf[offset + 6] & 0x0f) | 0x40] +
+    kHexBytes[buf[offset + 7]] +
+    '-' +
+    kHexBytes[(buf[offset + 8] & 0x3f) | 0x80] +
+    kHexBytes[buf[offset + 9]] +
+    '-' +
+    kHexBytes[buf[offset + 10]] +
+    kHexBytes[buf[offset + 11]] +
+    kHexBytes[buf[offset + 12]] +
+    kHexBytes[buf[offset + 13]] +
+    kHexBytes[buf[offset + 14]] +
+    kHexBytes[buf[offset + 15]];
+}
+
 function handleError(buf, offset, size) {
   const ex = _randomBytes(buf, offset, size);
   if (ex) throw ex;
@@ -122,5 +253,7 @@ function handleError(buf, offset, size) {
 module.exports = {
   randomBytes,
   randomFill,
-  randomFillSync
+  randomFillSync,
+  randomInt,
+  randomUUID
 };
@@ -2,7 +2,10 @@
 
 const { AsyncWrap, Providers } = internalBinding('async_wrap');
 const { Buffer } = require('buffer');
-const { scrypt: _scrypt } = internalBinding('crypto');
+const {
+  scrypt: _scrypt,
+  scryptBatch: _scryptBatch
+} = internalBinding('crypto');
 const { validateUint32 } = require('internal/validators');
 const {
   ERR_CRYPTO_SCRYPT_INVALID_PARAMETER,
@@ -11,6 +14,8 @@ const {
 } = require('internal/errors').codes;
 const {
   getDefaultEncoding,
+  getKeyDerivationItems,
+  splitKeys,
   validateArrayBufferView,
 } = require('internal/crypto/util');
 
@@ -58,9 +63,48 @@ function scryptSync(password, salt, keylen, options = defaults) {
   return keybuf.toString(encoding);
 }
 
+function scryptBatch(items, keylen, options, callback = defaults) {
+  if (callback === defaults) {
+    callback = options;
+    options = defaults;
+  }
+
+  if (_scryptBatch === undefined)
+    throw new ERR_CRYPTO_SCRYPT_NOT_SUPPORTED();
+
+  keylen = validateUint32(keylen, 'keylen');
+  const { N, r, p, maxmem } = checkOptions(options);
+  const { passwords, salts } = getKeyDerivationItems(items);
+
+  if (typeof callback !== 'function')
+    throw new ERR_INVALID_CALLBACK();
+
+  const encoding = getDefaultEncoding();
+  const count = passwords.length;
+  const keybuf = Buffer.alloc(keylen * count);
+
+  // An empty batch is only validated.
+  let wrap;
+  if (count > 0) {
+    wrap = new AsyncWrap(Providers.SCRYPTREQUEST);
+    wrap.ondone = (ex) => {  // Retains keybuf while request is in flight.
+      if (ex === null) ex = new ERR_CRYPTO_SCRYPT_INVALID_PARAMETER();
+      if (ex) return callback.call(wrap, ex);
+      callback.call(wrap, null, splitKeys(keybuf, count, encoding));
+    };
+  }
+
+  throwIfError(
+    _scryptBatch(keybuf, passwords, salts, N, r, p, maxmem, wrap));
+  if (count === 0)
+    process.nextTick(callback, null, []);
+}
+
 function handleError(keybuf, password, salt, N, r, p, maxmem, wrap) {
-  const ex = _scrypt(keybuf, password, salt, N, r, p, maxmem, wrap);
+  throwIfError(_scrypt(keybuf, password, salt, N, r, p, maxmem, wrap));
+}
 
+function throwIfError(ex) {
   if (ex === undefined)
     return;
 
@@ -78,6 +122,10 @@ function check(password, salt, keylen, options) {
   salt = validateArrayBufferView(salt, 'salt');
   keylen = validateUint32(keylen, 'keylen');
 
+  return { password, salt, keylen, ...checkOptions(options) };
+}
+
+function checkOptions(options) {
   let { N, r, p, maxmem } = defaults;
   if (options && options !== defaults) {
     let has_N, has_r, has_p;
@@ -107,7 +155,7 @@ function check(password, salt, keylen, options) {
     if (maxmem === 0) maxmem = defaults.maxmem;
   }
 
-  return { password, salt, keylen, N, r, p, maxmem };
+  return { N, r, p, maxmem };
 }
 
-module.exports = { scrypt, scryptSync };
+module.exports = { scrypt, scryptBatch, scryptSync };
@@ -1,11 +1,18 @@
 'use strict';
 
+const { AsyncWrap, Providers } = internalBinding('async_wrap');
 const {
   ERR_CRYPTO_SIGN_KEY_REQUIRED,
+  ERR_INVALID_ARG_TYPE,
+  ERR_INVALID_CALLBACK,
   ERR_INVALID_OPT_VALUE
 } = require('internal/errors').codes;
 const { validateString } = require('internal/validators');
-const { Sign: _Sign, Verify: _Verify } = internalBinding('crypto');
+const {
+  Sign: _Sign,
+  Verify: _Verify,
+  signBatch: _signBatch
+} = internalBinding('crypto');
 const {
   RSA_PSS_SALTLEN_AUTO,
   RSA_PKCS1_PADDING
@@ -67,7 +74,32 @@ function getIntOption(name, defaultValue, options) {
   return defaultValue;
 }
 
-Sign.prototype.sign = function sign(options, encoding) {
+function encodeSignature(signature, encoding) {
+  encoding = encoding || getDefaultEncoding();
+  if (encoding && encoding !== 'buffer')
+    return signature.toString(encoding);
+  return signature;
+}
+
+// Runs the rest of an operation on the threadpool and calls `callback` with
+// its result, after `transform` has been applied to it.
+function makeRequest(callback, transform) {
+  if (typeof callback !== 'function')
+    throw new ERR_INVALID_CALLBACK();
+  const wrap = new AsyncWrap(Providers.SIGNREQUEST);
+  wrap.ondone = (err, result) => {
+    if (err) return callback.call(wrap, err);
+    callback.call(wrap, null, transform(result));
+  };
+  return wrap;
+}
+
+Sign.prototype.sign = function sign(options, encoding, callback) {
+  if (typeof encoding === 'function') {
+    callback = encoding;
+    encoding = undefined;
+  }
+
   if (!options)
     throw new ERR_CRYPTO_SIGN_KEY_REQUIRED();
 
@@ -81,13 +113,15 @@ Sign.prototype.sign = function sign(options, encoding) {
 
   key = validateArrayBufferView(key, 'key');
 
-  var ret = this[kHandle].sign(key, passphrase, rsaPadding, pssSaltLength);
-
-  encoding = encoding || getDefaultEncoding();
-  if (encoding && encoding !== 'buffer')
-    ret = ret.toString(encoding);
+  if (callback !== undefined) {
+    const wrap = makeRequest(callback,
+                             (ret) => encodeSignature(ret, encoding));
+    this[kHandle].sign(key, passphrase, rsaPadding, pssSaltLength, wrap);
+    return;
+  }
 
-  return ret;
+  var ret = this[kHandle].sign(key, passphrase, rsaPadding, pssSaltLength);
+  return encodeSignature(ret, encoding);
 };
 
 
@@ -107,7 +141,13 @@ Object.setPrototypeOf(Verify, Writable);
 Verify.prototype._write = Sign.prototype._write;
 Verify.prototype.update = Sign.prototype.update;
 
-Verify.prototype.verify = function verify(options, signature, sigEncoding) {
+Verify.prototype.verify = function verify(options, signature, sigEncoding,
+                                          callback) {
+  if (typeof sigEncoding === 'function') {
+    callback = sigEncoding;
+    sigEncoding = undefined;
+  }
+
   var key = options.key || options;
   sigEncoding = sigEncoding || getDefaultEncoding();
 
@@ -121,12 +161,45 @@ Verify.prototype.verify = function verify(options, signature, sigEncoding) {
   signature = validateArrayBufferView(toBuf(signature, sigEncoding),
                                       'signature');
 
+  if (callback !== undefined) {
+    const wrap = makeRequest(callback, (ret) => ret);
+    this[kHandle].verify(key, signature, rsaPadding, pssSaltLength, wrap);
+    return;
+  }
+
   return this[kHandle].verify(key, signature, rsaPadding, pssSaltLength);
 };
 
 legacyNativeHandle(Verify);
 
+function signBatch(algorithm, payloads, options, encoding, callback) {
+  if (typeof encoding === 'function') {
+    callback = encoding;
+    encoding = undefined;
+  }
+  validateString(algorithm, 'algorithm');
+  if (!Array.isArray(payloads))
+    throw new ERR_INVALID_ARG_TYPE('payloads', 'Array', payloads);
+  if (!options)
+    throw new ERR_CRYPTO_SIGN_KEY_REQUIRED();
+
+  const key = validateArrayBufferView(options.key || options, 'key');
+  const passphrase = options.passphrase || null;
+  const rsaPadding = getPadding(options);
+  const pssSaltLength = getSaltLength(options);
+  const data = payloads.map((payload, i) => {
+    return validateArrayBufferView(toBuf(payload), `payloads[${i}]`);
+  });
+
+  const wrap = makeRequest(callback, (signatures) => {
+    return signatures.map((signature) => encodeSignature(signature, encoding));
+  });
+  _signBatch(algorithm, key, passphrase, rsaPadding, pssSaltLength, data,
+             wrap);
+}
+
 module.exports = {
   Sign,
-  Verify
+  Verify,
+  signBatch
 };
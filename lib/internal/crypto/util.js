@@ -109,8 +109,38 @@ function validateArrayBufferView(buffer, name) {
   return buffer;
 }
 
+// Splits the `{ password, salt }` pairs of a key derivation batch into two
+// arrays of ArrayBufferViews.
+function getKeyDerivationItems(items) {
+  if (!Array.isArray(items))
+    throw new ERR_INVALID_ARG_TYPE('items', 'Array', items);
+  const passwords = new Array(items.length);
+  const salts = new Array(items.length);
+  for (var i = 0; i < items.length; i++) {
+    const item = items[i];
+    if (item === null || typeof item !== 'object')
+      throw new ERR_INVALID_ARG_TYPE(`items[${i}]`, 'Object', item);
+    passwords[i] = validateArrayBufferView(item.password,
+                                           `items[${i}].password`);
+    salts[i] = validateArrayBufferView(item.salt, `items[${i}].salt`);
+  }
+  return { passwords, salts };
+}
+
+// The keys of a batch are derived into consecutive ranges of one buffer.
+function splitKeys(keybuf, count, encoding) {
+  const keylen = keybuf.length / count;
+  const keys = new Array(count);
+  for (var i = 0; i < count; i++) {
+    const key = keybuf.slice(i * keylen, (i + 1) * keylen);
+    keys[i] = encoding === 'buffer' ? key : key.toString(encoding);
+  }
+  return keys;
+}
+
 module.exports = {
   validateArrayBufferView,
+  getKeyDerivationItems,
   getCiphers,
   getCurves,
   getDefaultEncoding,
@@ -119,6 +149,7 @@ module.exports = {
   legacyNativeHandle,
   setDefaultEncoding,
   setEngine,
+  splitKeys,
   timingSafeEqual,
   toBuf
 };
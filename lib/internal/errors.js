@@ -603,6 +603,8 @@ E('ERR_FS_FILE_TOO_LARGE', 'File size (%s) is greater than possible Buffer: ' +
 E('ERR_FS_INVALID_SYMLINK_TYPE',
   'Symlink type must be one of "dir", "file", or "junction". Received "%s"',
   Error); // Switch to TypeError. The current implementation does not seem right
+E('ERR_HEAP_PROFILER_ACTIVE',
+  'A sampling heap profile is already being recorded', Error);
 E('ERR_HTTP2_ALTSVC_INVALID_ORIGIN',
   'HTTP/2 ALTSVC frames require a valid origin', TypeError);
 E('ERR_HTTP2_ALTSVC_LENGTH',
@@ -961,3 +963,4 @@ E('ERR_WORKER_UNSUPPORTED_EXTENSION',
   'The worker script extension must be ".js" or ".mjs". Received "%s"',
   TypeError);
 E('ERR_ZLIB_INITIALIZATION_FAILED', 'Initialization failed', Error);
+E('ERR_ZLIB_POOL_CLOSED', 'Cannot call %s() on a closed pool', Error);
@@ -5,6 +5,7 @@ exports.setup = setupNextTick;
 function setupNextTick(_setupNextTick, _setupPromises) {
   const {
     getDefaultTriggerAsyncId,
+    getContextFrame,
     newAsyncId,
     initHooksExist,
     destroyHooksExist,
@@ -12,7 +13,7 @@ function setupNextTick(_setupNextTick, _setupPromises) {
     emitBefore,
     emitAfter,
     emitDestroy,
-    symbols: { async_id_symbol, trigger_async_id_symbol }
+    symbols: { async_id_symbol, trigger_async_id_symbol, context_frame_symbol }
   } = require('internal/async_hooks');
   const emitPromiseRejectionWarnings =
     require('internal/process/promises').setup(_setupPromises);
@@ -52,7 +53,7 @@ function setupNextTick(_setupNextTick, _setupPromises) {
     do {
       while (tock = queue.shift()) {
         const asyncId = tock[async_id_symbol];
-        emitBefore(asyncId, tock[trigger_async_id_symbol]);
+        emitBefore(asyncId, tock[trigger_async_id_symbol], tock);
         // emitDestroy() places the async_id_symbol into an asynchronous queue
         // that calls the destroy callback in the future. It's called before
         // calling tock.callback so destroy will be called even if the callback
@@ -90,6 +91,7 @@ function setupNextTick(_setupNextTick, _setupPromises) {
       const asyncId = newAsyncId();
       this[async_id_symbol] = asyncId;
       this[trigger_async_id_symbol] = triggerAsyncId;
+      this[context_frame_symbol] = getContextFrame();
 
       if (initHooksExist()) {
         emitInit(asyncId,
@@ -2,9 +2,11 @@
 
 const {
   getDefaultTriggerAsyncId,
+  getContextFrame,
   newAsyncId,
   initHooksExist,
-  emitInit
+  emitInit,
+  symbols: { context_frame_symbol }
 } = require('internal/async_hooks');
 // Symbols for storing async id state.
 const async_id_symbol = Symbol('asyncId');
@@ -22,6 +24,8 @@ const { inspect } = require('util');
 const TIMEOUT_MAX = 2 ** 31 - 1;
 
 const kRefed = Symbol('refed');
+// The id of an armed timer in the native timer wheel, or -1.
+const kTimerId = Symbol('timerId');
 
 module.exports = {
   TIMEOUT_MAX,
@@ -30,6 +34,7 @@ module.exports = {
   trigger_async_id_symbol,
   Timeout,
   kRefed,
+  kTimerId,
   initAsyncResource,
   setUnrefTimeout,
   validateTimerDuration
@@ -47,6 +52,7 @@ function initAsyncResource(resource, type) {
   const asyncId = resource[async_id_symbol] = newAsyncId();
   const triggerAsyncId =
     resource[trigger_async_id_symbol] = getDefaultTriggerAsyncId();
+  resource[context_frame_symbol] = getContextFrame();
   if (initHooksExist())
     emitInit(asyncId, type, triggerAsyncId, resource);
 }
@@ -66,8 +72,6 @@ function Timeout(callback, after, args, isRepeat) {
   }
 
   this._idleTimeout = after;
-  this._idlePrev = this;
-  this._idleNext = this;
   this._idleStart = null;
   // This must be set to null first to avoid function tracking
   // on the hidden class, revisit in V8 versions after 6.2
@@ -78,11 +82,12 @@ function Timeout(callback, after, args, isRepeat) {
   this._destroyed = false;
 
   this[kRefed] = null;
+  this[kTimerId] = -1;
 
   initAsyncResource(this, 'Timeout');
 }
 
-// Make sure the linked list only shows the minimal necessary information.
+// Make sure inspecting a timer only shows the minimal necessary information.
 Timeout.prototype[inspect.custom] = function(_, options) {
   return inspect(this, {
     ...options,
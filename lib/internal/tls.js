@@ -1,5 +1,16 @@
 'use strict';
 
+const { SessionCache: NativeSessionCache } = internalBinding('crypto');
+const {
+  ERR_INVALID_ARG_TYPE
+} = require('internal/errors').codes;
+const { validatePath } = require('internal/fs/utils');
+const { validateUint32 } = require('internal/validators');
+const { toPathIfFileURL } = require('internal/url');
+
+const kHandle = Symbol('kHandle');
+const kStats = Symbol('kStats');
+
 // Example:
 // C=US\nST=CA\nL=SF\nO=Joyent\nOU=Node.js\nCN=ca1\nemailAddress=ry@clouds.org
 function parseCertString(s) {
@@ -23,6 +34,51 @@ function parseCertString(s) {
   return out;
 }
 
+// Keep in sync with SessionCacheStore::StatsField.
+const kHits = 0;
+const kMisses = 1;
+const kStores = 2;
+const kEvictions = 3;
+const kStatsFieldCount = 4;
+
+class SessionCache {
+  constructor(options = {}) {
+    if (options === null || typeof options !== 'object')
+      throw new ERR_INVALID_ARG_TYPE('options', 'Object', options);
+
+    const { maxEntries = 10240, ttl = 300 } = options;
+    let { path } = options;
+    if (path !== undefined) {
+      path = toPathIfFileURL(path);
+      validatePath(path, 'options.path');
+      if (typeof path !== 'string')
+        throw new ERR_INVALID_ARG_TYPE('options.path', ['string', 'URL'], path);
+    }
+    validateUint32(maxEntries, 'options.maxEntries', true);
+    validateUint32(ttl, 'options.ttl', true);
+
+    this[kHandle] = new NativeSessionCache(path, maxEntries, ttl);
+    this[kStats] = new Float64Array(kStatsFieldCount);
+  }
+
+  get maxEntries() {
+    return this[kHandle].getMaxEntries();
+  }
+
+  getStats() {
+    const stats = this[kStats];
+    this[kHandle].getStats(stats);
+    return {
+      hits: stats[kHits],
+      misses: stats[kMisses],
+      stores: stats[kStores],
+      evictions: stats[kEvictions]
+    };
+  }
+}
+
 module.exports = {
-  parseCertString
+  kHandle,
+  parseCertString,
+  SessionCache
 };
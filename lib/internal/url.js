@@ -42,6 +42,7 @@ const {
   domainToASCII: _domainToASCII,
   domainToUnicode: _domainToUnicode,
   encodeAuth,
+  findComponents,
   toUSVString: _toUSVString,
   parse,
   setURLConstructor,
@@ -54,6 +55,17 @@ const {
   URL_FLAGS_HAS_USERNAME,
   URL_FLAGS_IS_DEFAULT_SCHEME_PORT,
   URL_FLAGS_SPECIAL,
+  kComponentCount,
+  kComponentFlags,
+  kComponentFragmentStart,
+  kComponentHostEnd,
+  kComponentHostStart,
+  kComponentPathEnd,
+  kComponentPathStart,
+  kComponentPort,
+  kComponentQueryEnd,
+  kComponentQueryStart,
+  kComponentSchemeEnd,
   kFragment,
   kHost,
   kHostname,
@@ -71,6 +83,9 @@ const special = Symbol('special');
 const searchParams = Symbol('query');
 const kFormat = Symbol('format');
 
+// Filled in by findComponents().
+const components = new Int32Array(kComponentCount);
+
 // https://tc39.github.io/ecma262/#sec-%iteratorprototype%-object
 const IteratorPrototype = Object.getPrototypeOf(
   Object.getPrototypeOf([][Symbol.iterator]())
@@ -237,6 +252,34 @@ function onParseComplete(flags, protocol, username, password,
   initSearchParams(this[searchParams], query);
 }
 
+// Like onParseComplete(), but takes the components that findComponents()
+// found out of `input`.
+function onFindComponentsComplete(input, host) {
+  const ctx = this[context];
+  const flags = components[kComponentFlags];
+  ctx.flags = flags;
+  ctx.scheme = input.slice(0, components[kComponentSchemeEnd]);
+  ctx.host = host !== undefined ? host :
+    input.slice(components[kComponentHostStart], components[kComponentHostEnd]);
+  const port = components[kComponentPort];
+  ctx.port = port === -1 ? null : port;
+  const pathStart = components[kComponentPathStart];
+  const pathEnd = components[kComponentPathEnd];
+  // Skip the slash in front of the first segment.
+  ctx.path = pathStart === pathEnd ?
+    [''] : input.slice(pathStart + 1, pathEnd).split('/');
+  ctx.query = (flags & URL_FLAGS_HAS_QUERY) !== 0 ?
+    input.slice(components[kComponentQueryStart],
+                components[kComponentQueryEnd]) :
+    null;
+  ctx.fragment = (flags & URL_FLAGS_HAS_FRAGMENT) !== 0 ?
+    input.slice(components[kComponentFragmentStart]) :
+    null;
+  this[searchParams] = new URLSearchParams();
+  this[searchParams][context] = this;
+  initSearchParams(this[searchParams], ctx.query);
+}
+
 function onParseError(flags, input) {
   const error = new ERR_INVALID_URL(input);
   error.input = input;
@@ -316,6 +359,12 @@ class URL {
       base_context = new URL(base)[context];
     }
     this[context] = new URLContext();
+    // Absolute http: and https: URLs do not depend on the base.
+    const host = findComponents(input, components);
+    if (host !== false) {
+      onFindComponentsComplete.call(this, input, host);
+      return;
+    }
     parse(input, -1, base_context, undefined, onParseComplete.bind(this),
           onParseError);
   }
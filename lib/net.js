@@ -97,8 +97,11 @@ const {
 
 function noop() {}
 
-function getFlags(ipv6Only) {
-  return ipv6Only === true ? TCPConstants.UV_TCP_IPV6ONLY : 0;
+function getFlags(options) {
+  var flags = options.ipv6Only === true ? TCPConstants.UV_TCP_IPV6ONLY : 0;
+  if (options.reusePort === true)
+    flags |= TCPConstants.TCP_REUSEPORT;
+  return flags;
 }
 
 function createHandle(fd, is_server) {
@@ -1188,12 +1191,12 @@ function createServerHandle(address, port, addressType, fd, flags) {
       if (err) {
         handle.close();
         // Fallback to ipv4
-        return createServerHandle('0.0.0.0', port);
+        return createServerHandle('0.0.0.0', port, 4, undefined, flags);
       }
     } else if (addressType === 6) {
       err = handle.bind6(address, port, flags);
     } else {
-      err = handle.bind(address, port);
+      err = handle.bind(address, port, flags);
     }
   }
 
@@ -1296,7 +1299,9 @@ function listenInCluster(server, address, port, addressType,
 
   if (cluster === undefined) cluster = require('cluster');
 
-  if (cluster.isMaster || exclusive) {
+  // With reusePort, every process or thread binds a socket of its own.
+  if (cluster.isMaster || exclusive ||
+      (flags & TCPConstants.TCP_REUSEPORT) !== 0) {
     // Will create a new handle
     // _listen2 sets up the listened handle, it is still named like this
     // to avoid breaking code that wraps this method
@@ -1350,7 +1355,7 @@ Server.prototype.listen = function(...args) {
     toNumber(args.length > 2 && args[2]);  // (port, host, backlog)
 
   options = options._handle || options.handle || options;
-  const flags = getFlags(options.ipv6Only);
+  const flags = getFlags(options);
   // (handle[, backlog][, cb]) where handle is an object with a handle
   if (options instanceof TCP) {
     this._handle = options;
@@ -1388,8 +1393,10 @@ Server.prototype.listen = function(...args) {
                       options.exclusive, flags);
     } else { // Undefined host, listens on unspecified address
       // Default addressType 4 will be used to search for master server
+      // ipv6Only has never applied without a host.
       listenInCluster(this, null, options.port | 0, 4,
-                      backlog, undefined, options.exclusive);
+                      backlog, undefined, options.exclusive,
+                      flags & ~TCPConstants.UV_TCP_IPV6ONLY);
     }
     return this;
   }
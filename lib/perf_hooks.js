@@ -30,6 +30,37 @@ const {
   NODE_PERFORMANCE_MILESTONE_ENVIRONMENT
 } = constants;
 
+const {
+  ThreadPoolMonitor: ThreadPoolMonitorHandle,
+  getQueueStats,
+  queueNames: threadPoolQueueNames,
+  workTypes: threadPoolWorkTypes,
+  constants: {
+    kQueueThreads,
+    kQueueDedicated,
+    kQueuePriority,
+    kQueuePending,
+    kQueueRunning,
+    kQueueCompleted,
+    kQueueWaitTime,
+    kQueueRunTime,
+    kQueueStatsFieldCount,
+    kWaitHistogram,
+    kRunHistogram,
+    kLatencyHistogram,
+    kHistogramsPerWorkType,
+    kSubBucketBits,
+    kHistogramCount,
+    kHistogramMin,
+    kHistogramMax,
+    kHistogramSum,
+    kHistogramSumOfSquares,
+    kHistogramFirstBucket,
+    kHistogramBucketCount,
+    kHistogramFieldCount
+  }
+} = internalBinding('threadpool');
+
 const { AsyncResource } = require('async_hooks');
 const L = require('internal/linkedlist');
 const kInspect = require('internal/util').customInspectSymbol;
@@ -46,6 +77,9 @@ const kGetEntries = Symbol('get-entries');
 const kIndex = Symbol('index');
 const kMarks = Symbol('marks');
 const kCount = Symbol('count');
+const kHandle = Symbol('handle');
+const kFields = Symbol('fields');
+const kOffset = Symbol('offset');
 
 const observers = {};
 const observerableTypes = [
@@ -537,9 +571,167 @@ function sortedInsert(list, entry) {
   list.splice(location, 0, entry);
 }
 
+const threadPoolPriorities = ['low', 'normal', 'high'];
+let threadPoolStats;
+
+function getThreadPoolStatistics() {
+  if (threadPoolStats === undefined) {
+    threadPoolStats = new Float64Array(
+      threadPoolQueueNames.length * kQueueStatsFieldCount);
+  }
+  getQueueStats(threadPoolStats);
+
+  const queues = [];
+  for (var i = 0; i < threadPoolQueueNames.length; i++) {
+    const offset = i * kQueueStatsFieldCount;
+    queues.push({
+      name: threadPoolQueueNames[i],
+      threads: threadPoolStats[offset + kQueueThreads],
+      dedicated: threadPoolStats[offset + kQueueDedicated] === 1,
+      priority: threadPoolPriorities[threadPoolStats[offset + kQueuePriority]],
+      pending: threadPoolStats[offset + kQueuePending],
+      running: threadPoolStats[offset + kQueueRunning],
+      completed: threadPoolStats[offset + kQueueCompleted],
+      waitTime: threadPoolStats[offset + kQueueWaitTime] / 1e6,
+      runTime: threadPoolStats[offset + kQueueRunTime] / 1e6
+    });
+  }
+  return queues;
+}
+
+// The largest value that is recorded into the histogram bucket `index`, see
+// BucketIndex() in src/node_threadpool.cc.
+function bucketHighestValue(index) {
+  const subBuckets = 1 << kSubBucketBits;
+  if (index < subBuckets)
+    return index;
+  const width = 2 ** ((index >> kSubBucketBits) - 1);
+  return ((index & (subBuckets - 1)) + subBuckets) * width + width - 1;
+}
+
+// A snapshot of the times, in nanoseconds, recorded for one kind of work.
+class ThreadPoolHistogram {
+  constructor(fields, offset) {
+    this[kFields] = fields;
+    this[kOffset] = offset;
+  }
+
+  get count() {
+    return this[kFields][this[kOffset] + kHistogramCount];
+  }
+
+  get min() {
+    return this[kFields][this[kOffset] + kHistogramMin];
+  }
+
+  get max() {
+    return this[kFields][this[kOffset] + kHistogramMax];
+  }
+
+  get mean() {
+    const count = this.count;
+    if (count === 0)
+      return 0;
+    return this[kFields][this[kOffset] + kHistogramSum] / count;
+  }
+
+  get stddev() {
+    const count = this.count;
+    if (count === 0)
+      return 0;
+    const mean = this.mean;
+    const squares = this[kFields][this[kOffset] + kHistogramSumOfSquares];
+    return Math.sqrt(Math.max(squares / count - mean * mean, 0));
+  }
+
+  percentile(percentile) {
+    if (typeof percentile !== 'number') {
+      const errors = lazyErrors();
+      throw new errors.ERR_INVALID_ARG_TYPE('percentile', 'number',
+                                            percentile);
+    }
+    if (!(percentile > 0 && percentile <= 100)) {
+      const errors = lazyErrors();
+      throw new errors.ERR_INVALID_ARG_VALUE.RangeError('percentile',
+                                                        percentile);
+    }
+
+    const count = this.count;
+    if (count === 0)
+      return 0;
+    const target = Math.ceil(count * percentile / 100);
+    const fields = this[kFields];
+    const first = this[kOffset] + kHistogramFirstBucket;
+    let seen = 0;
+    for (var i = 0; i < kHistogramBucketCount; i++) {
+      seen += fields[first + i];
+      if (seen >= target)
+        return Math.min(Math.max(bucketHighestValue(i), this.min), this.max);
+    }
+    return this.max;
+  }
+
+  [kInspect]() {
+    return {
+      count: this.count,
+      min: this.min,
+      max: this.max,
+      mean: this.mean,
+      stddev: this.stddev,
+      p50: this.percentile(50),
+      p99: this.percentile(99)
+    };
+  }
+}
+
+class ThreadPoolMonitor {
+  constructor() {
+    this[kHandle] = new ThreadPoolMonitorHandle();
+  }
+
+  enable() {
+    return this[kHandle].enable();
+  }
+
+  disable() {
+    return this[kHandle].disable();
+  }
+
+  reset() {
+    this[kHandle].reset();
+  }
+
+  get(type) {
+    const index = threadPoolWorkTypes.indexOf(type);
+    if (index === -1) {
+      const errors = lazyErrors();
+      throw new errors.ERR_INVALID_ARG_VALUE(
+        'type', type, `must be one of: ${threadPoolWorkTypes.join(', ')}`);
+    }
+
+    const fields =
+      new Float64Array(kHistogramsPerWorkType * kHistogramFieldCount);
+    this[kHandle].read(index, fields);
+    return {
+      wait: new ThreadPoolHistogram(fields,
+                                    kWaitHistogram * kHistogramFieldCount),
+      run: new ThreadPoolHistogram(fields,
+                                   kRunHistogram * kHistogramFieldCount),
+      latency: new ThreadPoolHistogram(fields,
+                                       kLatencyHistogram * kHistogramFieldCount)
+    };
+  }
+}
+
+function monitorThreadPool() {
+  return new ThreadPoolMonitor();
+}
+
 module.exports = {
   performance,
-  PerformanceObserver
+  PerformanceObserver,
+  getThreadPoolStatistics,
+  monitorThreadPool
 };
 
 Object.defineProperty(module.exports, 'constants', {
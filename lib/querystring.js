@@ -29,6 +29,11 @@ const {
   hexTable,
   isHexTable
 } = require('internal/querystring');
+const {
+  escape: _escape,
+  parse: _parse
+} = internalBinding('querystring');
+const { ERR_INVALID_URI } = require('internal/errors').codes;
 const QueryString = module.exports = {
   unescapeBuffer,
   // `unescape()` is a JS global, so we need to use a different local name
@@ -131,6 +136,8 @@ const noEscape = [
   0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, // 96 - 111
   1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 1, 0  // 112 - 127
 ];
+const kMinNativeEscapeLength = 8;
+
 // QueryString.escape() replaces encodeURIComponent()
 // http://www.ecma-international.org/ecma-262/5.1/#sec-15.1.3.4
 function qsEscape(str) {
@@ -141,7 +148,13 @@ function qsEscape(str) {
       str += '';
   }
 
-  return encodeStr(str, noEscape, hexTable);
+  // Below this length, the call into C++ costs more than it saves.
+  if (str.length < kMinNativeEscapeLength)
+    return encodeStr(str, noEscape, hexTable);
+  const escaped = _escape(str);
+  if (escaped === undefined)
+    throw new ERR_INVALID_URI();
+  return escaped;
 }
 
 function stringifyPrimitive(v) {
@@ -236,6 +249,17 @@ function parse(qs, sep, eq, options) {
   }
   const customDecode = (decode !== qsUnescape);
 
+  if (sepLen === 1 && eqLen === 1 && !customDecode) {
+    // The pairs with one entry per key, or undefined if a key or value
+    // needs the fallback decoder.
+    const entries = _parse(qs, sepCodes[0], eqCodes[0], pairs);
+    if (entries !== undefined) {
+      for (var n = 0; n < entries.length; n += 2)
+        obj[entries[n]] = entries[n + 1];
+      return obj;
+    }
+  }
+
   var lastPos = 0;
   var sepIdx = 0;
   var eqIdx = 0;
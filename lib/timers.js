@@ -25,17 +25,21 @@ const {
   getLibuvNow,
   setupTimers,
   scheduleTimer,
+  flushTimerOps,
+  pollExpiredTimers,
   toggleTimerRef,
+  timerInfo,
+  timerOps,
+  expiredTimers,
   immediateInfo,
   toggleImmediateRef
 } = internalBinding('timers');
-const L = require('internal/linkedlist');
-const PriorityQueue = require('internal/priority_queue');
 const {
   async_id_symbol,
   trigger_async_id_symbol,
   Timeout,
   kRefed,
+  kTimerId,
   initAsyncResource,
   validateTimerDuration
 } = require('internal/timers');
@@ -56,8 +60,13 @@ const kCount = 0;
 const kRefCount = 1;
 const kHasOutstanding = 2;
 
+// *Must* match Environment::TimerInfo::Fields in src/env.h.
+const kOpsLength = 0;
+const kNextExpiry = 1;
+const kExpiredLength = 2;
+
 // Call into C++ to assign callbacks that are responsible for processing
-// Immediates and TimerLists.
+// Immediates and expired timers.
 setupTimers(processImmediate, processTimers);
 
 // HOW and WHY the timers implementation works the way it does.
@@ -65,14 +74,10 @@ setupTimers(processImmediate, processTimers);
 // Timers are crucial to Node.js. Internally, any TCP I/O connection creates a
 // timer so that we can time out of connections. Additionally, many user
 // libraries and applications also use timers. As such there may be a
-// significantly large amount of timeouts scheduled at any given time.
-// Therefore, it is very important that the timers implementation is performant
-// and efficient.
-//
-// Note: It is suggested you first read through the lib/internal/linkedlist.js
-// linked list implementation, since timers depend on it extensively. It can be
-// somewhat counter-intuitive at first, as it is not actually a class. Instead,
-// it is a set of helpers that operate on an existing object.
+// significantly large amount of timeouts scheduled at any given time, many of
+// which are re-armed over and over again without ever expiring. Therefore, it
+// is very important that the timers implementation is performant and
+// efficient.
 //
 // In order to be as performant as possible, the architecture and data
 // structures are designed so that they are optimized to handle the following
@@ -80,91 +85,39 @@ setupTimers(processImmediate, processTimers);
 
 // - Adding a new timer. (insert)
 // - Removing an existing timer. (remove)
+// - Re-arming an existing timer. (insert)
 // - Handling a timer timing out. (timeout)
 //
-// Whenever possible, the implementation tries to make the complexity of these
-// operations as close to constant-time as possible.
-// (So that performance is not impacted by the number of scheduled timers.)
-//
-// Object maps are kept which contain linked lists keyed by their duration in
-// milliseconds.
-//
-/* eslint-disable node-core/non-ascii-character */
+// All of these are constant-time operations, so that performance is not
+// impacted by the number of scheduled timers.
 //
-// ╔════ > Object Map
-// ║
-// ╠══
-// ║ lists: { '40': { }, '320': { etc } } (keys of millisecond duration)
-// ╚══          ┌────┘
-//              │
-// ╔══          │
-// ║ TimersList { _idleNext: { }, _idlePrev: (self) }
-// ║         ┌────────────────┘
-// ║    ╔══  │                              ^
-// ║    ║    { _idleNext: { },  _idlePrev: { }, _onTimeout: (callback) }
-// ║    ║      ┌───────────┘
-// ║    ║      │                                  ^
-// ║    ║      { _idleNext: { etc },  _idlePrev: { }, _onTimeout: (callback) }
-// ╠══  ╠══
-// ║    ║
-// ║    ╚════ >  Actual JavaScript timeouts
-// ║
-// ╚════ > Linked List
+// Timers are kept in a hierarchical timing wheel (see src/timer_wheel.h)
+// that is owned by the Environment and driven by a single libuv timer. Every
+// armed timer is assigned a small integer id that indexes `timerSlots` on this
+// side and the wheel's entries on the native side.
 //
-/* eslint-enable node-core/non-ascii-character */
-//
-// With this, virtually constant-time insertion (append), removal, and timeout
-// is possible in the JavaScript layer. Any one list of timers is able to be
-// sorted by just appending to it because all timers within share the same
-// duration. Therefore, any timer added later will always have been scheduled to
-// timeout later, thus only needing to be appended.
-// Removal from an object-property linked list is also virtually constant-time
-// as can be seen in the lib/internal/linkedlist.js implementation.
-// Timeouts only need to process any timers currently due to expire, which will
-// always be at the beginning of the list for reasons stated above. Any timers
-// after the first one encountered that does not yet need to timeout will also
-// always be due to timeout at a later time.
-//
-// Less-than constant time operations are thus contained in two places:
-// The PriorityQueue — an efficient binary heap implementation that does all
-// operations in worst-case O(log n) time — which manages the order of expiring
-// Timeout lists and the object map lookup of a specific list by the duration of
-// timers within (or creation of a new list). However, these operations combined
-// have shown to be trivial in comparison to other timers architectures.
-
-
-// Object map containing linked lists of timers, keyed and sorted by their
-// duration in milliseconds.
+// Inserting and removing timers is done by appending (id, expiry) pairs to
+// `timerOps`, a typed array that is shared with C++, so that arming a timer
+// does not allocate and does not cross into C++. The queued operations are
+// applied in bulk whenever the wheel is polled or the array fills up.
 //
-// - key = time in milliseconds
-// - value = linked list
-const lists = Object.create(null);
-
-// This is a priority queue with a custom sorting function that first compares
-// the expiry times of two lists and if they're the same then compares their
-// individual IDs to determine which list was created first.
-const queue = new PriorityQueue(compareTimersLists, setPosition);
-
-function compareTimersLists(a, b) {
-  const expiryDiff = a.expiry - b.expiry;
-  if (expiryDiff === 0) {
-    if (a.id < b.id)
-      return -1;
-    if (a.id > b.id)
-      return 1;
-  }
-  return expiryDiff;
-}
+// When timers expire, C++ writes their ids into `expiredTimers` in the order
+// in which they are due and calls `processTimers()` once, which then keeps
+// asking for further batches until no expired timers are left. A timer that
+// has been cancelled or re-armed after it was collected is simply skipped.
 
-function setPosition(node, pos) {
-  node.priorityQueuePosition = pos;
-}
 
-let nextExpiry = Infinity;
+// Armed timers, indexed by their id in the native timer wheel. Ids of timers
+// that are no longer armed are recycled through `freeTimerIds`.
+const timerSlots = [];
+const freeTimerIds = [];
 
-let timerListId = Number.MIN_SAFE_INTEGER;
 let refCount = 0;
 
+// The position in `expiredTimers` up to which timers have been processed. This
+// is kept across calls so processing resumes correctly after an exception.
+let expiredIndex = 0;
+
 function incRefCount() {
   if (refCount++ === 0)
     toggleTimerRef(true);
@@ -175,6 +128,42 @@ function decRefCount() {
     toggleTimerRef(false);
 }
 
+function queueTimerOp(id, expiry) {
+  let length = timerInfo[kOpsLength];
+  if (length === timerOps.length) {
+    flushTimerOps();
+    length = 0;
+  }
+  timerOps[length] = id;
+  timerOps[length + 1] = expiry;
+  timerInfo[kOpsLength] = length + 2;
+}
+
+function armTimer(item, expiry) {
+  let id = item[kTimerId];
+  if (id === undefined || id === -1) {
+    id = freeTimerIds.length > 0 ? freeTimerIds.pop() : timerSlots.length;
+    item[kTimerId] = id;
+    timerSlots[id] = item;
+  }
+  queueTimerOp(id, expiry);
+}
+
+function releaseTimerId(item) {
+  const id = item[kTimerId];
+  timerSlots[id] = undefined;
+  freeTimerIds.push(id);
+  item[kTimerId] = -1;
+}
+
+function disarmTimer(item) {
+  const id = item[kTimerId];
+  if (id === undefined || id === -1)
+    return;
+  queueTimerOp(id, -1);
+  releaseTimerId(item);
+}
+
 // Schedule or re-schedule a timer.
 // The item must have been enroll()'d first.
 const active = exports.active = function(item) {
@@ -190,8 +179,7 @@ exports._unrefActive = function(item) {
 
 // The underlying logic for scheduling or re-scheduling a timer.
 //
-// Appends a timer onto the end of an existing timers list, or creates a new
-// list if one does not already exist for the specified timeout duration.
+// Arms the timer in the timer wheel, moving it if it was already armed.
 function insert(item, refed, start) {
   const msecs = item._idleTimeout;
   if (msecs < 0 || msecs === undefined)
@@ -199,18 +187,13 @@ function insert(item, refed, start) {
 
   item._idleStart = start;
 
-  // Use an existing list if there is one, otherwise we need to make a new one.
-  var list = lists[msecs];
-  if (list === undefined) {
-    debug('no %d list was found in insert, creating a new one', msecs);
-    const expiry = start + msecs;
-    lists[msecs] = list = new TimersList(expiry, msecs);
-    queue.insert(list);
-
-    if (nextExpiry > expiry) {
-      scheduleTimer(msecs);
-      nextExpiry = expiry;
-    }
+  const expiry = start + msecs;
+  armTimer(item, expiry);
+
+  if (timerInfo[kNextExpiry] > expiry) {
+    debug('scheduling timer to run in %d', msecs);
+    scheduleTimer(msecs);
+    timerInfo[kNextExpiry] = expiry;
   }
 
   if (!item[async_id_symbol] || item._destroyed) {
@@ -225,138 +208,91 @@ function insert(item, refed, start) {
       decRefCount();
   }
   item[kRefed] = refed;
-
-  L.append(list, item);
 }
 
-function TimersList(expiry, msecs) {
-  this._idleNext = this; // Create the list with the linkedlist properties to
-  this._idlePrev = this; // prevent any unnecessary hidden class changes.
-  this.expiry = expiry;
-  this.id = timerListId++;
-  this.msecs = msecs;
-  this.priorityQueuePosition = null;
+// A timer that was collected by the timer wheel is no longer armed unless it
+// has been re-armed since, in which case it is not due yet.
+function isDue(timer, now) {
+  return timer._idleStart + timer._idleTimeout <= now;
 }
 
-// Make sure the linked list only shows the minimal necessary information.
-TimersList.prototype[util.inspect.custom] = function(_, options) {
-  return util.inspect(this, {
-    ...options,
-    // Only inspect one level.
-    depth: 0,
-    // It should not recurse.
-    customInspect: false
-  });
-};
-
 const { _tickCallback: runNextTicks } = process;
 function processTimers(now) {
-  debug('process timer lists %d', now);
-  nextExpiry = Infinity;
-
-  let list;
-  let ranAtLeastOneList = false;
-  while (list = queue.peek()) {
-    if (list.expiry > now) {
-      nextExpiry = list.expiry;
-      return refCount > 0 ? nextExpiry : -nextExpiry;
+  debug('process timers %d', now);
+
+  let ranAtLeastOneTimer = false;
+  do {
+    const length = timerInfo[kExpiredLength];
+    while (expiredIndex < length) {
+      if (ranAtLeastOneTimer) {
+        runNextTicks();
+        ranAtLeastOneTimer = false;
+      }
+
+      const timer = timerSlots[expiredTimers[expiredIndex++]];
+      if (timer === undefined || !isDue(timer, now))
+        continue;
+
+      ranAtLeastOneTimer = true;
+      onTimeout(timer, now);
     }
-    if (ranAtLeastOneList)
-      runNextTicks();
-    else
-      ranAtLeastOneList = true;
-    listOnTimeout(list, now);
-  }
-  return 0;
+    expiredIndex = 0;
+  } while (pollExpiredTimers(now) > 0);
+
+  return refCount > 0;
 }
 
-function listOnTimeout(list, now) {
-  const msecs = list.msecs;
+function onTimeout(timer, now) {
+  debug('timeout callback %d', timer._idleTimeout);
 
-  debug('timeout callback %d', msecs);
+  const asyncId = timer[async_id_symbol];
 
-  var diff, timer;
-  let ranAtLeastOneTimer = false;
-  while (timer = L.peek(list)) {
-    diff = now - timer._idleStart;
-
-    // Check if this loop iteration is too early for the next timer.
-    // This happens if there are more timers scheduled for later in the list.
-    if (diff < msecs) {
-      list.expiry = Math.max(timer._idleStart + msecs, now + 1);
-      list.id = timerListId++;
-      queue.percolateDown(1);
-      debug('%d list wait because diff is %d', msecs, diff);
-      return;
-    }
+  if (!timer._onTimeout) {
+    releaseTimerId(timer);
+    if (timer[kRefed])
+      refCount--;
+    timer[kRefed] = null;
 
-    if (ranAtLeastOneTimer)
-      runNextTicks();
-    else
-      ranAtLeastOneTimer = true;
+    if (destroyHooksExist() && !timer._destroyed) {
+      emitDestroy(asyncId);
+      timer._destroyed = true;
+    }
+    return;
+  }
 
-    // The actual logic for when a timeout happens.
-    L.remove(timer);
+  emitBefore(asyncId, timer[trigger_async_id_symbol], timer);
 
-    const asyncId = timer[async_id_symbol];
+  let start;
+  if (timer._repeat)
+    start = getLibuvNow();
 
-    if (!timer._onTimeout) {
+  try {
+    const args = timer._timerArgs;
+    if (!args)
+      timer._onTimeout();
+    else
+      Reflect.apply(timer._onTimeout, timer, args);
+  } finally {
+    if (timer._repeat && timer._idleTimeout !== -1) {
+      timer._idleTimeout = timer._repeat;
+      if (start === undefined)
+        start = getLibuvNow();
+      insert(timer, timer[kRefed], start);
+    } else if (timer[kTimerId] !== -1 && isDue(timer, now)) {
+      // The timer was neither cancelled nor re-armed by its callback.
+      releaseTimerId(timer);
       if (timer[kRefed])
         refCount--;
       timer[kRefed] = null;
 
       if (destroyHooksExist() && !timer._destroyed) {
-        emitDestroy(asyncId);
+        emitDestroy(timer[async_id_symbol]);
         timer._destroyed = true;
       }
-      continue;
     }
-
-    emitBefore(asyncId, timer[trigger_async_id_symbol]);
-
-    let start;
-    if (timer._repeat)
-      start = getLibuvNow();
-
-    try {
-      const args = timer._timerArgs;
-      if (!args)
-        timer._onTimeout();
-      else
-        Reflect.apply(timer._onTimeout, timer, args);
-    } finally {
-      if (timer._repeat && timer._idleTimeout !== -1) {
-        timer._idleTimeout = timer._repeat;
-        if (start === undefined)
-          start = getLibuvNow();
-        insert(timer, timer[kRefed], start);
-      } else {
-        if (timer[kRefed])
-          refCount--;
-        timer[kRefed] = null;
-
-        if (destroyHooksExist() && !timer._destroyed) {
-          emitDestroy(timer[async_id_symbol]);
-          timer._destroyed = true;
-        }
-      }
-    }
-
-    emitAfter(asyncId);
   }
 
-  // If `L.peek(list)` returned nothing, the list was either empty or we have
-  // called all of the timer timeouts.
-  // As such, we can remove the list from the object map and the PriorityQueue.
-  debug('%d list empty', msecs);
-
-  // The current list may have been removed and recreated since the reference
-  // to `list` was created. Make sure they're the same instance of the list
-  // before destroying.
-  if (list === lists[msecs]) {
-    delete lists[msecs];
-    queue.shift();
-  }
+  emitAfter(asyncId);
 }
 
 
@@ -370,23 +306,10 @@ function unenroll(item) {
     item._destroyed = true;
   }
 
-  L.remove(item);
-
-  // We only delete refed lists because unrefed ones are incredibly likely
-  // to come from http and be recreated shortly after.
-  // TODO: Long-term this could instead be handled by creating an internal
-  // clearTimeout that makes it clear that the list should not be deleted.
-  // That function could then be used by http and other similar modules.
-  if (item[kRefed]) {
-    const list = lists[item._idleTimeout];
-    if (list !== undefined && L.isEmpty(list)) {
-      debug('unenroll: list empty');
-      queue.removeAt(list.priorityQueuePosition);
-      delete lists[list.msecs];
-    }
+  disarmTimer(item);
 
+  if (item[kRefed])
     decRefCount();
-  }
   item[kRefed] = null;
 
   // If active is called later, then we want to make sure not to insert again
@@ -405,11 +328,10 @@ exports.unenroll = util.deprecate(unenroll,
 function enroll(item, msecs) {
   msecs = validateTimerDuration(msecs);
 
-  // if this item was already in a list somewhere
-  // then we should unenroll it from that
-  if (item._idleNext) unenroll(item);
+  // if this item was already armed
+  // then we should unenroll it first
+  if (item[kTimerId] >= 0) unenroll(item);
 
-  L.init(item);
   item._idleTimeout = msecs;
 }
 
@@ -624,7 +546,7 @@ function processImmediate() {
     prevImmediate = immediate;
 
     const asyncId = immediate[async_id_symbol];
-    emitBefore(asyncId, immediate[trigger_async_id_symbol]);
+    emitBefore(asyncId, immediate[trigger_async_id_symbol], immediate);
 
     try {
       const argv = immediate._argv;
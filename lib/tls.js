@@ -295,6 +295,10 @@ exports.parseCertString = internalUtil.deprecate(
 
 exports.createSecureContext = _tls_common.createSecureContext;
 exports.SecureContext = _tls_common.SecureContext;
+exports.SessionCache = internalTLS.SessionCache;
+exports.createSessionCache = function createSessionCache(options) {
+  return new internalTLS.SessionCache(options);
+};
 exports.TLSSocket = _tls_wrap.TLSSocket;
 exports.Server = _tls_wrap.Server;
 exports.createServer = _tls_wrap.createServer;
@@ -17,7 +17,11 @@ const { isMainThread } = require('internal/worker');
 if (!hasTracing || !isMainThread)
   throw new ERR_TRACE_EVENTS_UNAVAILABLE();
 
-const { CategorySet, getEnabledCategories } = internalBinding('trace_events');
+const {
+  CategorySet,
+  getEnabledCategories,
+  dumpTraceBuffer
+} = internalBinding('trace_events');
 const { customInspectSymbol } = require('internal/util');
 const { format } = require('util');
 
@@ -86,5 +90,6 @@ function createTracing(options) {
 
 module.exports = {
   createTracing,
+  dumpTraceBuffer,
   getEnabledCategories
 };
@@ -15,12 +15,31 @@
 'use strict';
 
 const { Buffer } = require('buffer');
-const { validateString } = require('internal/validators');
+const { resolve } = require('path');
+const {
+  ERR_HEAP_PROFILER_ACTIVE,
+  ERR_INVALID_ARG_TYPE,
+  ERR_INVALID_CALLBACK
+} = require('internal/errors').codes;
+const { getOptionValue } = require('internal/options');
+const {
+  validateInt32,
+  validateString,
+  validateUint32
+} = require('internal/validators');
 const {
   Serializer: _Serializer,
   Deserializer: _Deserializer
 } = internalBinding('serdes');
 const { copy } = internalBinding('buffer');
+const { AsyncWrap, Providers } = internalBinding('async_wrap');
+const {
+  startCpuProfiling,
+  stopCpuProfiling,
+  startHeapProfiling,
+  stopHeapProfiling
+} = internalBinding('profiler');
+const { triggerHeapSnapshot } = internalBinding('heap_utils');
 const { objectToString } = require('internal/util');
 const { FastBuffer } = require('internal/buffer');
 
@@ -107,6 +126,78 @@ function getHeapSpaceStatistics() {
   return heapSpaceStatistics;
 }
 
+let cpuProfileCount = 0;
+
+function captureCpuProfile(options, callback) {
+  if (options === null || typeof options !== 'object')
+    throw new ERR_INVALID_ARG_TYPE('options', 'Object', options);
+  if (typeof callback !== 'function')
+    throw new ERR_INVALID_CALLBACK();
+
+  const {
+    duration,
+    interval = getOptionValue('--cpu-prof-interval'),
+    filename
+  } = options;
+  validateUint32(duration, 'options.duration', true);
+  validateInt32(interval, 'options.interval', 1);
+  let path;
+  if (filename !== undefined) {
+    validateString(filename, 'options.filename');
+    path = resolve(filename);
+  }
+
+  // Every capture has its own profile, so captures can overlap each other
+  // and a profile started through --cpu-prof.
+  const title = `v8.captureCpuProfile ${++cpuProfileCount}`;
+  startCpuProfiling(title, interval);
+  setTimeout(() => {
+    const wrap = new AsyncWrap(Providers.CPUPROFILEWRITEREQ);
+    wrap.ondone = (err, filename) => callback(err, filename);
+    stopCpuProfiling(title, path, wrap);
+  }, duration);
+}
+
+function captureHeapProfile(options, callback) {
+  if (options === null || typeof options !== 'object')
+    throw new ERR_INVALID_ARG_TYPE('options', 'Object', options);
+  if (typeof callback !== 'function')
+    throw new ERR_INVALID_CALLBACK();
+
+  const {
+    duration,
+    samplingInterval = getOptionValue('--heap-prof-interval'),
+    stackDepth = getOptionValue('--heap-prof-stack-depth'),
+    filename
+  } = options;
+  validateUint32(duration, 'options.duration', true);
+  validateUint32(samplingInterval, 'options.samplingInterval', true);
+  validateInt32(stackDepth, 'options.stackDepth', 1);
+  let path;
+  if (filename !== undefined) {
+    validateString(filename, 'options.filename');
+    path = resolve(filename);
+  }
+
+  // Unlike the CPU profiler, V8 only supports one sampling heap profiler per
+  // isolate at a time.
+  if (!startHeapProfiling(samplingInterval, stackDepth))
+    throw new ERR_HEAP_PROFILER_ACTIVE();
+  setTimeout(() => {
+    const wrap = new AsyncWrap(Providers.HEAPPROFILEWRITEREQ);
+    wrap.ondone = (err, filename) => callback(err, filename);
+    stopHeapProfiling(path, wrap);
+  }, duration);
+}
+
+function writeHeapSnapshot(filename) {
+  if (filename !== undefined) {
+    validateString(filename, 'filename');
+    filename = resolve(filename);
+  }
+  return triggerHeapSnapshot(filename);
+}
+
 /* V8 serialization API */
 
 /* JS methods for the base objects */
@@ -210,9 +301,12 @@ function deserialize(buffer) {
 
 module.exports = {
   cachedDataVersionTag,
+  captureCpuProfile,
+  captureHeapProfile,
   getHeapStatistics,
   getHeapSpaceStatistics,
   setFlagsFromString,
+  writeHeapSnapshot,
   Serializer,
   Deserializer,
   DefaultSerializer,
@@ -24,8 +24,11 @@
 const {
   ERR_BUFFER_TOO_LARGE,
   ERR_INVALID_ARG_TYPE,
+  ERR_INVALID_ARG_VALUE,
+  ERR_INVALID_CALLBACK,
   ERR_OUT_OF_RANGE,
-  ERR_ZLIB_INITIALIZATION_FAILED
+  ERR_ZLIB_INITIALIZATION_FAILED,
+  ERR_ZLIB_POOL_CLOSED
 } = require('internal/errors').codes;
 const Transform = require('_stream_transform');
 const {
@@ -35,6 +38,7 @@ const {
     isArrayBufferView
   }
 } = require('util');
+const { validateInt32 } = require('internal/validators');
 const binding = internalBinding('zlib');
 const assert = require('assert').ok;
 const {
@@ -65,13 +69,16 @@ const codes = {
   Z_VERSION_ERROR: constants.Z_VERSION_ERROR
 };
 
+// The highest `parallel` option value for the one-shot deflate methods.
+const kMaxParallel = 128;
+
 const ckeys = Object.keys(codes);
 for (var ck = 0; ck < ckeys.length; ck++) {
   var ckey = ckeys[ck];
   codes[codes[ckey]] = ckey;
 }
 
-function zlibBuffer(engine, buffer, callback) {
+function zlibBuffer(engine, buffer, callback, parallel) {
   if (typeof callback !== 'function')
     throw new ERR_INVALID_ARG_TYPE('callback', 'function', callback);
   // Streams do not support non-Buffer ArrayBufferViews yet. Convert it to a
@@ -82,6 +89,15 @@ function zlibBuffer(engine, buffer, callback) {
   } else if (isAnyArrayBuffer(buffer)) {
     buffer = Buffer.from(buffer);
   }
+  if (parallel > 1) {
+    if (typeof buffer === 'string')
+      buffer = Buffer.from(buffer);
+    if (isArrayBufferView(buffer) &&
+        buffer.byteLength > binding.PARALLEL_BLOCK_SIZE) {
+      processParallel(engine, buffer, parallel, callback);
+      return;
+    }
+  }
   engine.buffers = null;
   engine.nread = 0;
   engine.cb = callback;
@@ -124,7 +140,7 @@ function zlibBufferOnEnd() {
     this.cb(null, buf);
 }
 
-function zlibBufferSync(engine, buffer) {
+function zlibBufferSync(engine, buffer, parallel) {
   if (typeof buffer === 'string') {
     buffer = Buffer.from(buffer);
   } else if (!isArrayBufferView(buffer)) {
@@ -138,12 +154,58 @@ function zlibBufferSync(engine, buffer) {
       );
     }
   }
-  buffer = processChunkSync(engine, buffer, engine._finishFlushFlag);
+  if (parallel > 1 && buffer.byteLength > binding.PARALLEL_BLOCK_SIZE)
+    buffer = processParallelSync(engine, buffer, parallel);
+  else
+    buffer = processChunkSync(engine, buffer, engine._finishFlushFlag);
   if (engine._info)
     return { buffer, engine };
   return buffer;
 }
 
+// Compresses all of `buffer` at once, in blocks that are spread across up to
+// `parallel` threads. See ParallelDeflate in src/node_zlib.cc.
+function processParallel(engine, buffer, parallel, callback) {
+  const handle = engine._handle;
+  engine.cb = callback;
+  engine.on('error', zlibBufferOnError);
+  // Keep the input alive while it is being compressed.
+  handle.buffer = buffer;
+  handle.parallelWrite(buffer, parallel, processParallelCallback);
+}
+
+function processParallelCallback(result) {
+  // This callback's context (`this`) is the `_handle` (ZCtx) object.
+  const engine = this[owner_symbol];
+  engine.bytesWritten = this.buffer.byteLength;
+  this.buffer = null;
+  engine.close();
+  if (result === undefined)
+    engine.cb(new ERR_BUFFER_TOO_LARGE());
+  else if (engine._info)
+    engine.cb(null, { buffer: result, engine });
+  else
+    engine.cb(null, result);
+}
+
+function processParallelSync(engine, buffer, parallel) {
+  var error;
+  engine.on('error', function onError(er) {
+    error = er;
+  });
+
+  const result = engine._handle.parallelWriteSync(buffer, parallel);
+  if (error)
+    throw error;
+
+  engine.bytesWritten = buffer.byteLength;
+  _close(engine);
+
+  if (result === undefined)
+    throw new ERR_BUFFER_TOO_LARGE();
+  return result;
+}
+
 function zlibOnError(message, errno, code) {
   var self = this[owner_symbol];
   // there is no way to cleanly recover.
@@ -560,9 +622,8 @@ const zlibDefaultOpts = {
   finishFlush: Z_FINISH,
   fullFlush: Z_FULL_FLUSH
 };
-// Base class for all streams actually backed by zlib and using zlib-specific
-// parameters.
-function Zlib(opts, mode) {
+// Validates the zlib-specific options that `mode` is initialized with.
+function getInitOptions(opts, mode) {
   var windowBits = Z_DEFAULT_WINDOWBITS;
   var level = Z_DEFAULT_COMPRESSION;
   var memLevel = Z_DEFAULT_MEMLEVEL;
@@ -610,6 +671,20 @@ function Zlib(opts, mode) {
     }
   }
 
+  return { windowBits, level, memLevel, strategy, dictionary };
+}
+
+// Base class for all streams actually backed by zlib and using zlib-specific
+// parameters.
+function Zlib(opts, mode) {
+  const {
+    windowBits,
+    level,
+    memLevel,
+    strategy,
+    dictionary
+  } = getInitOptions(opts, mode);
+
   const handle = new binding.Zlib(mode);
   // Ideally, we could let ZlibBase() set up _writeState. I haven't been able
   // to come up with a good solution that doesn't break our internal API,
@@ -718,10 +793,140 @@ function Unzip(opts) {
 Object.setPrototypeOf(Unzip.prototype, Zlib.prototype);
 Object.setPrototypeOf(Unzip, Zlib);
 
-function createConvenienceMethod(ctor, sync) {
+// Returns the number of threads that a one-shot compression with `opts` may
+// use. Blocks after the first can not refer back to a preset dictionary, so
+// compression with one is never split up.
+function getParallelism(opts) {
+  if (!opts || opts.parallel === undefined)
+    return 1;
+  validateInt32(opts.parallel, 'options.parallel', 1, kMaxParallel);
+  return opts.dictionary === undefined ? opts.parallel : 1;
+}
+
+const poolModes = {
+  deflate: DEFLATE,
+  deflateRaw: DEFLATERAW,
+  gzip: GZIP,
+  inflate: INFLATE,
+  inflateRaw: INFLATERAW,
+  gunzip: GUNZIP
+};
+
+const kHandle = Symbol('kHandle');
+
+function toPoolInput(buffer, index) {
+  if (typeof buffer === 'string')
+    return Buffer.from(buffer);
+  if (isArrayBufferView(buffer))
+    return buffer;
+  if (isAnyArrayBuffer(buffer))
+    return Buffer.from(buffer);
+  throw new ERR_INVALID_ARG_TYPE(
+    `buffers[${index}]`,
+    ['string', 'Buffer', 'TypedArray', 'DataView', 'ArrayBuffer'],
+    buffer
+  );
+}
+
+function poolError(message, errno, code) {
+  if (code === 'ERR_BUFFER_TOO_LARGE')
+    return new ERR_BUFFER_TOO_LARGE();
+  // eslint-disable-next-line no-restricted-syntax
+  const error = new Error(message);
+  error.errno = errno;
+  error.code = code;
+  return error;
+}
+
+function checkBatch(pool, buffers, method) {
+  if (pool[kHandle] === null)
+    throw new ERR_ZLIB_POOL_CLOSED(method);
+  if (!Array.isArray(buffers))
+    throw new ERR_INVALID_ARG_TYPE('buffers', 'Array', buffers);
+  return buffers.map(toPoolInput);
+}
+
+// Splits the output of a batch into the results for the individual inputs.
+function splitPoolOutput(output, ends) {
+  const results = new Array(ends.length);
+  var start = 0;
+  for (var i = 0; i < ends.length; i++) {
+    results[i] = output.slice(start, ends[i]);
+    start = ends[i];
+  }
+  return results;
+}
+
+class ZlibPool {
+  constructor(type, opts) {
+    const mode = poolModes[type];
+    if (typeof type !== 'string' || mode === undefined) {
+      throw new ERR_INVALID_ARG_VALUE(
+        'type', type, `must be one of: ${Object.keys(poolModes).join(', ')}`);
+    }
+
+    const {
+      windowBits,
+      level,
+      memLevel,
+      strategy,
+      dictionary
+    } = getInitOptions(opts, mode);
+    this[kHandle] = new binding.ZlibPool(mode, windowBits, level, memLevel,
+                                         strategy, dictionary);
+  }
+
+  batch(buffers, callback) {
+    if (typeof callback !== 'function')
+      throw new ERR_INVALID_CALLBACK();
+    const inputs = checkBatch(this, buffers, 'batch');
+    if (inputs.length === 0) {
+      process.nextTick(callback, null, []);
+      return;
+    }
+
+    const ends = new Uint32Array(inputs.length);
+    this[kHandle].batch(inputs, ends, (output, message, errno, code) => {
+      if (output === undefined)
+        callback(poolError(message, errno, code));
+      else
+        callback(null, splitPoolOutput(output, ends));
+    });
+  }
+
+  batchSync(buffers) {
+    const inputs = checkBatch(this, buffers, 'batchSync');
+    if (inputs.length === 0)
+      return [];
+
+    const ends = new Uint32Array(inputs.length);
+    var result;
+    var error;
+    this[kHandle].batchSync(inputs, ends, (output, message, errno, code) => {
+      if (output === undefined)
+        error = poolError(message, errno, code);
+      else
+        result = splitPoolOutput(output, ends);
+    });
+    if (error)
+      throw error;
+    return result;
+  }
+
+  close() {
+    if (this[kHandle] === null)
+      return;
+    this[kHandle].close();
+    this[kHandle] = null;
+  }
+
+}
+
+function createConvenienceMethod(ctor, sync, parallel = false) {
   if (sync) {
     return function syncBufferWrapper(buffer, opts) {
-      return zlibBufferSync(new ctor(opts), buffer);
+      const threads = parallel ? getParallelism(opts) : 1;
+      return zlibBufferSync(new ctor(opts), buffer, threads);
     };
   } else {
     return function asyncBufferWrapper(buffer, opts, callback) {
@@ -729,7 +934,8 @@ function createConvenienceMethod(ctor, sync) {
         callback = opts;
         opts = {};
       }
-      return zlibBuffer(new ctor(opts), buffer, callback);
+      const threads = parallel ? getParallelism(opts) : 1;
+      return zlibBuffer(new ctor(opts), buffer, callback, threads);
     };
   }
 }
@@ -762,12 +968,12 @@ module.exports = {
 
   // Convenience methods.
   // compress/decompress a string or buffer in one step.
-  deflate: createConvenienceMethod(Deflate, false),
-  deflateSync: createConvenienceMethod(Deflate, true),
-  gzip: createConvenienceMethod(Gzip, false),
-  gzipSync: createConvenienceMethod(Gzip, true),
-  deflateRaw: createConvenienceMethod(DeflateRaw, false),
-  deflateRawSync: createConvenienceMethod(DeflateRaw, true),
+  deflate: createConvenienceMethod(Deflate, false, true),
+  deflateSync: createConvenienceMethod(Deflate, true, true),
+  gzip: createConvenienceMethod(Gzip, false, true),
+  gzipSync: createConvenienceMethod(Gzip, true, true),
+  deflateRaw: createConvenienceMethod(DeflateRaw, false, true),
+  deflateRawSync: createConvenienceMethod(DeflateRaw, true, true),
   unzip: createConvenienceMethod(Unzip, false),
   unzipSync: createConvenienceMethod(Unzip, true),
   inflate: createConvenienceMethod(Inflate, false),
@@ -786,6 +992,13 @@ Object.defineProperties(module.exports, {
   createGzip: createProperty(Gzip),
   createGunzip: createProperty(Gunzip),
   createUnzip: createProperty(Unzip),
+  createPool: {
+    configurable: true,
+    enumerable: true,
+    value: function(type, options) {
+      return new ZlibPool(type, options);
+    }
+  },
   constants: {
     configurable: false,
     enumerable: true,
@@ -88,8 +88,10 @@
       'lib/internal/buffer.js',
       'lib/internal/cli_table.js',
       'lib/internal/child_process.js',
+      'lib/internal/child_process/serialization.js',
       'lib/internal/cluster/child.js',
       'lib/internal/cluster/master.js',
+      'lib/internal/cluster/reuseport_handle.js',
       'lib/internal/cluster/round_robin_handle.js',
       'lib/internal/cluster/shared_handle.js',
       'lib/internal/cluster/utils.js',
@@ -369,8 +371,11 @@
         'src/node_platform.cc',
         'src/node_postmortem_metadata.cc',
         'src/node_process.cc',
+        'src/node_profiler.cc',
+        'src/node_querystring.cc',
         'src/node_serdes.cc',
         'src/node_stat_watcher.cc',
+        'src/node_threadpool.cc',
         'src/node_trace_events.cc',
         'src/node_types.cc',
         'src/node_url.cc',
@@ -390,10 +395,12 @@
         'src/string_bytes.cc',
         'src/string_decoder.cc',
         'src/tcp_wrap.cc',
+        'src/timer_wheel.cc',
         'src/timers.cc',
         'src/tracing/agent.cc',
         'src/tracing/node_trace_buffer.cc',
         'src/tracing/node_trace_writer.cc',
+        'src/tracing/proto_trace_writer.cc',
         'src/tracing/trace_event.cc',
         'src/tracing/traced_value.cc',
         'src/tty_wrap.cc',
@@ -444,9 +451,11 @@
         'src/node_perf_common.h',
         'src/node_persistent.h',
         'src/node_platform.h',
+        'src/node_profiler.h',
         'src/node_revert.h',
         'src/node_root_certs.h',
         'src/node_stat_watcher.h',
+        'src/node_threadpool.h',
         'src/node_union_bytes.h',
         'src/node_url.h',
         'src/node_version.h',
@@ -466,9 +475,11 @@
         'src/string_decoder-inl.h',
         'src/string_search.h',
         'src/tcp_wrap.h',
+        'src/timer_wheel.h',
         'src/tracing/agent.h',
         'src/tracing/node_trace_buffer.h',
         'src/tracing/node_trace_writer.h',
+        'src/tracing/proto_trace_writer.h',
         'src/tracing/trace_event.h',
         'src/tracing/trace_event_common.h',
         'src/tracing/traced_value.h',
@@ -602,13 +613,21 @@
         [ 'node_use_openssl=="true"', {
           'sources': [
             'src/node_crypto.cc',
+            'src/node_crypto_async_key.cc',
             'src/node_crypto_bio.cc',
             'src/node_crypto_clienthello.cc',
+            'src/node_crypto_pem_cache.cc',
+            'src/node_crypto_scrypt.cc',
+            'src/node_crypto_session_cache.cc',
             'src/node_crypto.h',
+            'src/node_crypto_async_key.h',
             'src/node_crypto_bio.h',
             'src/node_crypto_clienthello.h',
             'src/node_crypto_clienthello-inl.h',
             'src/node_crypto_groups.h',
+            'src/node_crypto_pem_cache.h',
+            'src/node_crypto_scrypt.h',
+            'src/node_crypto_session_cache.h',
             'src/tls_wrap.cc',
             'src/tls_wrap.h'
           ],
@@ -920,6 +939,7 @@
         'test/cctest/test_node_postmortem_metadata.cc',
         'test/cctest/test_environment.cc',
         'test/cctest/test_platform.cc',
+        'test/cctest/test_timer_wheel.cc',
         'test/cctest/test_traced_value.cc',
         'test/cctest/test_util.cc',
         'test/cctest/test_url.cc'
@@ -45,17 +45,26 @@ inline double AsyncWrap::get_trigger_async_id() const {
 }
 
 
+inline v8::Local<v8::Value> AsyncWrap::context_frame() const {
+  if (context_frame_.IsEmpty())
+    return v8::Undefined(env()->isolate());
+  return PersistentToLocal::Strong(context_frame_);
+}
+
+
 inline AsyncWrap::AsyncScope::AsyncScope(AsyncWrap* wrap)
     : wrap_(wrap) {
   Environment* env = wrap->env();
-  if (env->async_hooks()->fields()[Environment::AsyncHooks::kBefore] == 0)
+  if (env->async_hooks()->fields()[Environment::AsyncHooks::kBefore] == 0 &&
+      env->async_hooks()->fields()[Environment::AsyncHooks::kEventBuffer] == 0)
     return;
   EmitBefore(env, wrap->get_async_id());
 }
 
 inline AsyncWrap::AsyncScope::~AsyncScope() {
   Environment* env = wrap_->env();
-  if (env->async_hooks()->fields()[Environment::AsyncHooks::kAfter] == 0)
+  if (env->async_hooks()->fields()[Environment::AsyncHooks::kAfter] == 0 &&
+      env->async_hooks()->fields()[Environment::AsyncHooks::kEventBuffer] == 0)
     return;
   EmitAfter(env, wrap_->get_async_id());
 }
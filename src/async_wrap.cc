@@ -88,8 +88,61 @@ struct AsyncWrapObject : public AsyncWrap {
   SET_SELF_SIZE(AsyncWrapObject)
 };
 
+void AsyncWrap::DrainEventBufferCallback(Environment* env, void* data) {
+  AsyncHooks* async_hooks = env->async_hooks();
+  if (!env->can_call_into_js() ||
+      (async_hooks->fields()[AsyncHooks::kEventBufferLength] == 0 &&
+       async_hooks->fields()[AsyncHooks::kEventBufferDropped] == 0)) {
+    return;
+  }
+
+  HandleScope handle_scope(env->isolate());
+  Local<Function> fn = env->async_hooks_drain_events_function();
+  TryCatchScope try_catch(env, TryCatchScope::CatchMode::kFatal);
+  USE(fn->Call(env->context(), Undefined(env->isolate()), 0, nullptr));
+}
+
+// Appends a fixed-size record to the event buffer that is used by batched
+// hooks instead of calling into JS for every event. A drain is scheduled for
+// the first record in an empty buffer. If the buffer is full, it is drained
+// synchronously, and the record is dropped (and counted) if that does not
+// make room. This is never called from GC callbacks: destroy events are only
+// recorded when the destroy queue is drained.
+static void RecordEvent(Environment* env,
+                        AsyncHooks::Fields type,
+                        double async_id,
+                        double trigger_async_id = -1,
+                        uint32_t resource_type = AsyncWrap::PROVIDER_NONE) {
+  AsyncHooks* async_hooks = env->async_hooks();
+  AliasedBuffer<double, v8::Float64Array>* buffer =
+      async_hooks->event_buffer();
+  if (buffer == nullptr) return;
+
+  uint32_t capacity = async_hooks->fields()[AsyncHooks::kEventBufferCapacity];
+  uint32_t length = async_hooks->fields()[AsyncHooks::kEventBufferLength];
+  if (length >= capacity) {
+    AsyncWrap::DrainEventBufferCallback(env, nullptr);
+    length = async_hooks->fields()[AsyncHooks::kEventBufferLength];
+    if (length >= capacity) {
+      async_hooks->fields()[AsyncHooks::kEventBufferDropped] += 1;
+      return;
+    }
+  }
+
+  const size_t offset = length * AsyncHooks::kEventRecordSize;
+  (*buffer)[offset + AsyncHooks::kEventType] = type;
+  (*buffer)[offset + AsyncHooks::kEventAsyncId] = async_id;
+  (*buffer)[offset + AsyncHooks::kEventTriggerAsyncId] = trigger_async_id;
+  (*buffer)[offset + AsyncHooks::kEventResourceType] = resource_type;
+  async_hooks->fields()[AsyncHooks::kEventBufferLength] = length + 1;
+
+  if (length == 0)
+    env->SetUnrefImmediate(AsyncWrap::DrainEventBufferCallback, nullptr);
+}
+
 void AsyncWrap::DestroyAsyncIdsCallback(Environment* env, void* data) {
   Local<Function> fn = env->async_hooks_destroy_function();
+  AsyncHooks* async_hooks = env->async_hooks();
 
   TryCatchScope try_catch(env, TryCatchScope::CatchMode::kFatal);
 
@@ -98,6 +151,12 @@ void AsyncWrap::DestroyAsyncIdsCallback(Environment* env, void* data) {
     destroy_async_id_list.swap(*env->destroy_async_id_list());
     if (!env->can_call_into_js()) return;
     for (auto async_id : destroy_async_id_list) {
+      // Batched hooks see the destroy at the same point as the others.
+      if (async_hooks->fields()[AsyncHooks::kEventBuffer] > 0)
+        RecordEvent(env, AsyncHooks::kDestroy, async_id);
+      if (async_hooks->fields()[AsyncHooks::kDestroy] == 0)
+        continue;
+
       // Want each callback to be cleaned up after itself, instead of cleaning
       // them all up after the while() loop completes.
       HandleScope scope(env->isolate());
@@ -115,6 +174,9 @@ void Emit(Environment* env, double async_id, AsyncHooks::Fields type,
           Local<Function> fn) {
   AsyncHooks* async_hooks = env->async_hooks();
 
+  if (async_hooks->fields()[AsyncHooks::kEventBuffer] > 0)
+    RecordEvent(env, type, async_id);
+
   if (async_hooks->fields()[type] == 0 || !env->can_call_into_js())
     return;
 
@@ -275,6 +337,36 @@ static void PromiseHook(PromiseHookType type, Local<Promise> promise,
 }
 
 
+// Propagates the context frame to promise reactions. Unlike PromiseHook(),
+// this never calls into JS and does not create PromiseWrap objects.
+static void ContextFramePromiseHook(PromiseHookType type,
+                                    Local<Promise> promise,
+                                    Local<Value> parent,
+                                    void* arg) {
+  Environment* env = static_cast<Environment*>(arg);
+  AsyncHooks* async_hooks = env->async_hooks();
+  if (!async_hooks->uses_context_frames()) return;
+
+  if (type == PromiseHookType::kInit) {
+    Local<Value> frame = async_hooks->context_frame();
+    if (frame->IsUndefined()) return;
+    USE(promise->SetPrivate(env->context(),
+                            env->context_frame_private_symbol(),
+                            frame));
+  } else if (type == PromiseHookType::kBefore) {
+    Local<Value> frame;
+    if (!promise->GetPrivate(env->context(),
+                             env->context_frame_private_symbol())
+            .ToLocal(&frame)) {
+      return;
+    }
+    async_hooks->enter_promise_context_frame(frame);
+  } else if (type == PromiseHookType::kAfter) {
+    async_hooks->exit_promise_context_frame();
+  }
+}
+
+
 static void SetupHooks(const FunctionCallbackInfo<Value>& args) {
   Environment* env = Environment::GetCurrent(args);
 
@@ -299,6 +391,7 @@ static void SetupHooks(const FunctionCallbackInfo<Value>& args) {
   SET_HOOK_FN(after);
   SET_HOOK_FN(destroy);
   SET_HOOK_FN(promise_resolve);
+  SET_HOOK_FN(drain_events);
 #undef SET_HOOK_FN
 
   {
@@ -334,6 +427,26 @@ static void DisablePromiseHook(const FunctionCallbackInfo<Value>& args) {
 }
 
 
+static void EnableContextFramePromiseHook(
+    const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  env->AddPromiseHook(ContextFramePromiseHook, static_cast<void*>(env));
+}
+
+
+static void DisableContextFramePromiseHook(
+    const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+
+  // Delay the call to `RemovePromiseHook` for the same reason as in
+  // DisablePromiseHook(), so that an entered frame is always exited.
+  env->isolate()->EnqueueMicrotask([](void* data) {
+    Environment* env = static_cast<Environment*>(data);
+    env->RemovePromiseHook(ContextFramePromiseHook, data);
+  }, static_cast<void*>(env));
+}
+
+
 class DestroyParam {
  public:
   double asyncId;
@@ -391,7 +504,11 @@ void AsyncWrap::PushAsyncIds(const FunctionCallbackInfo<Value>& args) {
   // then the checks in push_async_ids() and pop_async_id() will.
   double async_id = args[0]->NumberValue(env->context()).FromJust();
   double trigger_async_id = args[1]->NumberValue(env->context()).FromJust();
-  env->async_hooks()->push_async_ids(async_id, trigger_async_id);
+  // The optional third argument is the context frame of the resource.
+  Local<Value> frame;
+  if (args.Length() > 2)
+    frame = args[2];
+  env->async_hooks()->push_async_ids(async_id, trigger_async_id, frame);
 }
 
 
@@ -411,6 +528,55 @@ void AsyncWrap::AsyncReset(const FunctionCallbackInfo<Value>& args) {
 }
 
 
+static void EnableEventBuffer(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  AsyncHooks* async_hooks = env->async_hooks();
+  CHECK(args[0]->IsUint32());
+
+  // The buffer is created once and then shared by all batched hooks, so the
+  // first hook that is enabled determines its capacity.
+  if (async_hooks->event_buffer() == nullptr) {
+    uint32_t capacity = args[0].As<Uint32>()->Value();
+    CHECK_GT(capacity, 0);
+    async_hooks->set_event_buffer(
+        std::make_unique<AliasedBuffer<double, v8::Float64Array>>(
+            env->isolate(), capacity * AsyncHooks::kEventRecordSize));
+    async_hooks->fields()[AsyncHooks::kEventBufferCapacity] = capacity;
+  }
+
+  args.GetReturnValue().Set(async_hooks->event_buffer()->GetJSArray());
+}
+
+
+static void QueueEventBufferDrain(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  env->SetUnrefImmediate(AsyncWrap::DrainEventBufferCallback, nullptr);
+}
+
+
+static void RegisterEventType(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(args[0]->IsString());
+  Utf8Value name(env->isolate(), args[0]);
+  args.GetReturnValue().Set(
+      env->async_hooks()->event_type_id(std::string(*name, name.length())));
+}
+
+
+static void GetEventTypeName(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(args[0]->IsUint32());
+  const std::string* name =
+      env->async_hooks()->event_type_name(args[0].As<Uint32>()->Value());
+  if (name == nullptr) return;
+  args.GetReturnValue().Set(
+      String::NewFromUtf8(env->isolate(),
+                          name->data(),
+                          NewStringType::kNormal,
+                          name->size()).ToLocalChecked());
+}
+
+
 void AsyncWrap::QueueDestroyAsyncId(const FunctionCallbackInfo<Value>& args) {
   CHECK(args[0]->IsNumber());
   AsyncWrap::EmitDestroy(
@@ -445,6 +611,16 @@ void AsyncWrap::Initialize(Local<Object> target,
   env->SetMethod(target, "enablePromiseHook", EnablePromiseHook);
   env->SetMethod(target, "disablePromiseHook", DisablePromiseHook);
   env->SetMethod(target, "registerDestroyHook", RegisterDestroyHook);
+  env->SetMethod(target, "enableEventBuffer", EnableEventBuffer);
+  env->SetMethod(target, "queueEventBufferDrain", QueueEventBufferDrain);
+  env->SetMethod(target, "registerEventType", RegisterEventType);
+  env->SetMethod(target, "getEventTypeName", GetEventTypeName);
+  env->SetMethod(target,
+                 "enableContextFramePromiseHook",
+                 EnableContextFramePromiseHook);
+  env->SetMethod(target,
+                 "disableContextFramePromiseHook",
+                 DisableContextFramePromiseHook);
 
   PropertyAttribute ReadOnlyDontDelete =
       static_cast<PropertyAttribute>(ReadOnly | DontDelete);
@@ -481,6 +657,13 @@ void AsyncWrap::Initialize(Local<Object> target,
               env->async_ids_stack_string(),
               env->async_hooks()->async_ids_stack().GetJSArray()).FromJust();
 
+  // The current context frame lives at index 0 of this array, followed by
+  // the frames saved alongside each entry of async_ids_stack. It is only
+  // maintained while async_hook_fields[kUsesContextFrames] > 0.
+  target->Set(context,
+              FIXED_ONE_BYTE_STRING(env->isolate(), "context_frames"),
+              env->async_hooks()->context_frames()).FromJust();
+
   target->Set(context,
               FIXED_ONE_BYTE_STRING(env->isolate(), "owner_symbol"),
               env->owner_symbol()).FromJust();
@@ -502,6 +685,16 @@ void AsyncWrap::Initialize(Local<Object> target,
   SET_HOOKS_CONSTANT(kAsyncIdCounter);
   SET_HOOKS_CONSTANT(kDefaultTriggerAsyncId);
   SET_HOOKS_CONSTANT(kStackLength);
+  SET_HOOKS_CONSTANT(kUsesContextFrames);
+  SET_HOOKS_CONSTANT(kEventBuffer);
+  SET_HOOKS_CONSTANT(kEventBufferLength);
+  SET_HOOKS_CONSTANT(kEventBufferCapacity);
+  SET_HOOKS_CONSTANT(kEventBufferDropped);
+  SET_HOOKS_CONSTANT(kEventType);
+  SET_HOOKS_CONSTANT(kEventAsyncId);
+  SET_HOOKS_CONSTANT(kEventTriggerAsyncId);
+  SET_HOOKS_CONSTANT(kEventResourceType);
+  SET_HOOKS_CONSTANT(kEventRecordSize);
 #undef SET_HOOKS_CONSTANT
   FORCE_SET_TARGET_FIELD(target, "constants", constants);
 
@@ -520,6 +713,7 @@ void AsyncWrap::Initialize(Local<Object> target,
   env->set_async_hooks_after_function(Local<Function>());
   env->set_async_hooks_destroy_function(Local<Function>());
   env->set_async_hooks_promise_resolve_function(Local<Function>());
+  env->set_async_hooks_drain_events_function(Local<Function>());
   env->set_async_hooks_binding(target);
 
   // TODO(addaleax): This block might better work as a
@@ -582,7 +776,10 @@ void AsyncWrap::EmitTraceEventDestroy() {
 }
 
 void AsyncWrap::EmitDestroy(Environment* env, double async_id) {
-  if (env->async_hooks()->fields()[AsyncHooks::kDestroy] == 0 ||
+  // This may be called from GC callbacks, so batched hooks also only record
+  // the event when DestroyAsyncIdsCallback() runs.
+  if ((env->async_hooks()->fields()[AsyncHooks::kDestroy] == 0 &&
+       env->async_hooks()->fields()[AsyncHooks::kEventBuffer] == 0) ||
       !env->can_call_into_js()) {
     return;
   }
@@ -611,6 +808,19 @@ void AsyncWrap::AsyncReset(double execution_async_id, bool silent) {
     execution_async_id == -1 ? env()->new_async_id() : execution_async_id;
   trigger_async_id_ = env()->get_default_trigger_async_id();
 
+  // Capture the current context frame so that it can be restored when this
+  // resource calls back into JS. This does not involve any JS calls.
+  if (env()->async_hooks()->uses_context_frames()) {
+    HandleScope handle_scope(env()->isolate());
+    Local<Value> frame = env()->async_hooks()->context_frame();
+    if (frame->IsUndefined())
+      context_frame_.Reset();
+    else
+      context_frame_.Reset(env()->isolate(), frame);
+  } else {
+    context_frame_.Reset();
+  }
+
   switch (provider_type()) {
 #define V(PROVIDER)                                                           \
     case PROVIDER_ ## PROVIDER:                                               \
@@ -635,6 +845,11 @@ void AsyncWrap::AsyncReset(double execution_async_id, bool silent) {
 
   if (silent) return;
 
+  if (env()->async_hooks()->fields()[AsyncHooks::kEventBuffer] > 0) {
+    RecordEvent(env(), AsyncHooks::kInit,
+                async_id_, trigger_async_id_, provider_type());
+  }
+
   EmitAsyncInit(env(), object(),
                 env()->async_hooks()->provider_string(provider_type()),
                 async_id_, trigger_async_id_);
@@ -678,7 +893,7 @@ MaybeLocal<Value> AsyncWrap::MakeCallback(const Local<Function> cb,
   ProviderType provider = provider_type();
   async_context context { get_async_id(), get_trigger_async_id() };
   MaybeLocal<Value> ret = InternalMakeCallback(
-      env(), object(), cb, argc, argv, context);
+      env(), object(), cb, argc, argv, context, context_frame());
 
   // This is a static call with cached values because the `this` object may
   // no longer be alive at this point.
@@ -737,6 +952,14 @@ async_context EmitAsyncInit(Isolate* isolate,
     trigger_async_id  // trigger_async_id_
   };
 
+  if (env->async_hooks()->fields()[AsyncHooks::kEventBuffer] > 0) {
+    Utf8Value type(isolate, name);
+    RecordEvent(env, AsyncHooks::kInit, context.async_id,
+                context.trigger_async_id,
+                env->async_hooks()->event_type_id(
+                    std::string(*type, type.length())));
+  }
+
   // Run init hooks
   AsyncWrap::EmitAsyncInit(env, resource, name, context.async_id,
                            context.trigger_async_id);
@@ -33,6 +33,7 @@ namespace node {
 
 #define NODE_ASYNC_NON_CRYPTO_PROVIDER_TYPES(V)                               \
   V(NONE)                                                                     \
+  V(CPUPROFILEWRITEREQ)                                                       \
   V(DNSCHANNEL)                                                               \
   V(FILEHANDLE)                                                               \
   V(FILEHANDLECLOSEREQ)                                                       \
@@ -41,6 +42,7 @@ namespace node {
   V(FSREQPROMISE)                                                             \
   V(GETADDRINFOREQWRAP)                                                       \
   V(GETNAMEINFOREQWRAP)                                                       \
+  V(HEAPPROFILEWRITEREQ)                                                      \
   V(HTTP2SESSION)                                                             \
   V(HTTP2STREAM)                                                              \
   V(HTTP2PING)                                                                \
@@ -70,10 +72,13 @@ namespace node {
 
 #if HAVE_OPENSSL
 #define NODE_ASYNC_CRYPTO_PROVIDER_TYPES(V)                                   \
+  V(HASHREQUEST)                                                              \
   V(PBKDF2REQUEST)                                                            \
   V(KEYPAIRGENREQUEST)                                                        \
+  V(PUBLICKEYCIPHERREQUEST)                                                   \
   V(RANDOMBYTESREQUEST)                                                       \
   V(SCRYPTREQUEST)                                                            \
+  V(SIGNREQUEST)                                                              \
   V(TLSWRAP)
 #else
 #define NODE_ASYNC_CRYPTO_PROVIDER_TYPES(V)
@@ -142,6 +147,7 @@ class AsyncWrap : public BaseObject {
   void EmitTraceEventDestroy();
 
   static void DestroyAsyncIdsCallback(Environment* env, void* data);
+  static void DrainEventBufferCallback(Environment* env, void* data);
 
   inline ProviderType provider_type() const;
 
@@ -149,6 +155,10 @@ class AsyncWrap : public BaseObject {
 
   inline double get_trigger_async_id() const;
 
+  // The context frame that was current when this resource was (re)set, or
+  // undefined if context frames were not in use at that point.
+  inline v8::Local<v8::Value> context_frame() const;
+
   void AsyncReset(double execution_async_id = -1, bool silent = false);
 
   // Only call these within a valid HandleScope.
@@ -204,6 +214,7 @@ class AsyncWrap : public BaseObject {
   // Because the values may be Reset(), cannot be made const.
   double async_id_ = -1;
   double trigger_async_id_;
+  Persistent<v8::Value> context_frame_;
 };
 
 }  // namespace node
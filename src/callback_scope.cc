@@ -9,6 +9,7 @@ using v8::HandleScope;
 using v8::Isolate;
 using v8::Local;
 using v8::Object;
+using v8::Value;
 
 using AsyncHooks = Environment::AsyncHooks;
 
@@ -32,12 +33,15 @@ InternalCallbackScope::InternalCallbackScope(AsyncWrap* async_wrap)
     : InternalCallbackScope(async_wrap->env(),
                             async_wrap->object(),
                             { async_wrap->get_async_id(),
-                              async_wrap->get_trigger_async_id() }) {}
+                              async_wrap->get_trigger_async_id() },
+                            kRequireResource,
+                            async_wrap->context_frame()) {}
 
 InternalCallbackScope::InternalCallbackScope(Environment* env,
                                              Local<Object> object,
                                              const async_context& asyncContext,
-                                             ResourceExpectation expect)
+                                             ResourceExpectation expect,
+                                             Local<Value> context_frame)
   : env_(env),
     async_context_(asyncContext),
     object_(object),
@@ -61,7 +65,8 @@ InternalCallbackScope::InternalCallbackScope(Environment* env,
   }
 
   env->async_hooks()->push_async_ids(async_context_.async_id,
-                               async_context_.trigger_async_id);
+                                     async_context_.trigger_async_id,
+                                     context_frame);
   pushed_ids_ = true;
 }
 
@@ -37,6 +37,8 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include <limits>
+
 namespace node {
 
 inline v8::Isolate* IsolateData::isolate() const {
@@ -68,6 +70,8 @@ inline Environment::AsyncHooks::AsyncHooks()
   // and flag changes won't be included.
   fields_[kCheck] = 1;
 
+  context_frames_.Reset(env()->isolate(), v8::Array::New(env()->isolate()));
+
   // kDefaultTriggerAsyncId should be -1, this indicates that there is no
   // specified default value and it should fallback to the executionAsyncId.
   // 0 is not used as the magic value, because that indicates a missing context
@@ -108,6 +112,60 @@ Environment::AsyncHooks::async_ids_stack() {
   return async_ids_stack_;
 }
 
+inline AliasedBuffer<double, v8::Float64Array>*
+Environment::AsyncHooks::event_buffer() {
+  return event_buffer_.get();
+}
+
+inline void Environment::AsyncHooks::set_event_buffer(
+    std::unique_ptr<AliasedBuffer<double, v8::Float64Array>> buffer) {
+  event_buffer_ = std::move(buffer);
+}
+
+inline const std::string* Environment::AsyncHooks::event_type_name(
+    uint32_t id) const {
+  if (id < AsyncWrap::PROVIDERS_LENGTH ||
+      id - AsyncWrap::PROVIDERS_LENGTH >= event_type_names_.size()) {
+    return nullptr;
+  }
+  return &event_type_names_[id - AsyncWrap::PROVIDERS_LENGTH];
+}
+
+inline v8::Local<v8::Array> Environment::AsyncHooks::context_frames() {
+  return PersistentToLocal::Strong(context_frames_);
+}
+
+inline bool Environment::AsyncHooks::uses_context_frames() {
+  return fields_[kUsesContextFrames] > 0;
+}
+
+inline v8::Local<v8::Value> Environment::AsyncHooks::context_frame() {
+  return context_frames()->Get(env()->context(), 0).ToLocalChecked();
+}
+
+inline void Environment::AsyncHooks::set_context_frame(
+    v8::Local<v8::Value> frame) {
+  context_frames()->Set(env()->context(), 0, frame).FromJust();
+}
+
+inline void Environment::AsyncHooks::enter_promise_context_frame(
+    v8::Local<v8::Value> frame) {
+  if (promise_context_frame_entered_) return;
+  promise_saved_context_frame_.Reset(env()->isolate(), context_frame());
+  set_context_frame(frame);
+  promise_context_frame_entered_ = true;
+}
+
+inline void Environment::AsyncHooks::exit_promise_context_frame() {
+  // The hook may have been enabled while a reaction job was running, in which
+  // case there is no matching enter_promise_context_frame() call.
+  if (!promise_context_frame_entered_) return;
+  set_context_frame(
+      PersistentToLocal::Strong(promise_saved_context_frame_));
+  promise_saved_context_frame_.Reset();
+  promise_context_frame_entered_ = false;
+}
+
 inline v8::Local<v8::String> Environment::AsyncHooks::provider_string(int idx) {
   return providers_[idx].Get(env()->isolate());
 }
@@ -121,8 +179,10 @@ inline Environment* Environment::AsyncHooks::env() {
 }
 
 // Remember to keep this code aligned with pushAsyncIds() in JS.
-inline void Environment::AsyncHooks::push_async_ids(double async_id,
-                                                    double trigger_async_id) {
+inline void Environment::AsyncHooks::push_async_ids(
+    double async_id,
+    double trigger_async_id,
+    v8::Local<v8::Value> frame) {
   // Since async_hooks is experimental, do only perform the check
   // when async_hooks is enabled.
   if (fields_[kCheck] > 0) {
@@ -135,6 +195,13 @@ inline void Environment::AsyncHooks::push_async_ids(double async_id,
     grow_async_ids_stack();
   async_ids_stack_[2 * offset] = async_id_fields_[kExecutionAsyncId];
   async_ids_stack_[2 * offset + 1] = async_id_fields_[kTriggerAsyncId];
+  if (uses_context_frames()) {
+    v8::HandleScope handle_scope(env()->isolate());
+    context_frames()->Set(env()->context(), offset + 1, context_frame())
+        .FromJust();
+    if (!frame.IsEmpty())
+      set_context_frame(frame);
+  }
   fields_[kStackLength] += 1;
   async_id_fields_[kExecutionAsyncId] = async_id;
   async_id_fields_[kTriggerAsyncId] = trigger_async_id;
@@ -168,6 +235,14 @@ inline bool Environment::AsyncHooks::pop_async_id(double async_id) {
   uint32_t offset = fields_[kStackLength] - 1;
   async_id_fields_[kExecutionAsyncId] = async_ids_stack_[2 * offset];
   async_id_fields_[kTriggerAsyncId] = async_ids_stack_[2 * offset + 1];
+  if (uses_context_frames()) {
+    v8::HandleScope handle_scope(env()->isolate());
+    v8::Local<v8::Context> context = env()->context();
+    v8::Local<v8::Array> frames = context_frames();
+    set_context_frame(frames->Get(context, offset + 1).ToLocalChecked());
+    frames->Set(context, offset + 1, v8::Undefined(env()->isolate()))
+        .FromJust();
+  }
   fields_[kStackLength] = offset;
 
   return fields_[kStackLength] > 0;
@@ -175,6 +250,13 @@ inline bool Environment::AsyncHooks::pop_async_id(double async_id) {
 
 // Keep in sync with clearAsyncIdStack in lib/internal/async_hooks.js.
 inline void Environment::AsyncHooks::clear_async_id_stack() {
+  if (uses_context_frames()) {
+    v8::HandleScope handle_scope(env()->isolate());
+    v8::Local<v8::Context> context = env()->context();
+    v8::Local<v8::Array> frames = context_frames();
+    for (uint32_t i = 0; i <= fields_[kStackLength]; i++)
+      frames->Set(context, i, v8::Undefined(env()->isolate())).FromJust();
+  }
   async_id_fields_[kExecutionAsyncId] = 0;
   async_id_fields_[kTriggerAsyncId] = 0;
   fields_[kStackLength] = 0;
@@ -258,6 +340,27 @@ inline void Environment::ImmediateInfo::ref_count_dec(uint32_t decrement) {
   fields_[kRefCount] -= decrement;
 }
 
+inline Environment::TimerInfo::TimerInfo(v8::Isolate* isolate)
+    : fields_(isolate, kFieldsCount),
+      ops_(isolate, kOpsCapacity * 2),
+      expired_(isolate, kExpiredCapacity) {
+  fields_[kNextExpiry] = std::numeric_limits<double>::infinity();
+}
+
+inline AliasedBuffer<double, v8::Float64Array>&
+    Environment::TimerInfo::fields() {
+  return fields_;
+}
+
+inline AliasedBuffer<double, v8::Float64Array>& Environment::TimerInfo::ops() {
+  return ops_;
+}
+
+inline AliasedBuffer<uint32_t, v8::Uint32Array>&
+    Environment::TimerInfo::expired() {
+  return expired_;
+}
+
 inline Environment::TickInfo::TickInfo(v8::Isolate* isolate)
     : fields_(isolate, kFieldsCount) {}
 
@@ -414,6 +517,10 @@ inline Environment::ImmediateInfo* Environment::immediate_info() {
   return &immediate_info_;
 }
 
+inline Environment::TimerInfo* Environment::timer_info() {
+  return &timer_info_;
+}
+
 inline Environment::TickInfo* Environment::tick_info() {
   return &tick_info_;
 }
@@ -558,6 +665,27 @@ inline void Environment::set_http2_state(
   http2_state_ = std::move(buffer);
 }
 
+inline profiler::CpuProfileRecorder* Environment::cpu_profile_recorder() {
+  if (!cpu_profile_recorder_)
+    cpu_profile_recorder_.reset(new profiler::CpuProfileRecorder(this));
+  return cpu_profile_recorder_.get();
+}
+
+inline threadpool::CompletionQueue*
+Environment::threadpool_completion_queue() const {
+  return threadpool_completion_queue_;
+}
+
+inline void Environment::set_threadpool_completion_queue(
+    threadpool::CompletionQueue* queue) {
+  threadpool_completion_queue_ = queue;
+}
+
+inline std::vector<threadpool::Monitor*>*
+Environment::threadpool_monitors() {
+  return &threadpool_monitors_;
+}
+
 bool Environment::debug_enabled(DebugCategory category) const {
 #ifdef DEBUG
   CHECK_GE(static_cast<int>(category), 0);
@@ -14,6 +14,7 @@
 
 #include <stdio.h>
 #include <algorithm>
+#include <cmath>
 
 namespace node {
 
@@ -169,6 +170,7 @@ Environment::Environment(IsolateData* isolate_data,
     : isolate_(context->GetIsolate()),
       isolate_data_(isolate_data),
       immediate_info_(context->GetIsolate()),
+      timer_info_(context->GetIsolate()),
       tick_info_(context->GetIsolate()),
       timer_base_(uv_now(isolate_data->event_loop())),
       printed_error_(false),
@@ -643,6 +645,39 @@ void Environment::ToggleTimerRef(bool ref) {
   }
 }
 
+void Environment::TimerInfo::FlushOps() {
+  const size_t length = static_cast<size_t>(fields_[kOpsLength]);
+  CHECK_LE(length, ops_.Length());
+  for (size_t i = 0; i < length; i += 2) {
+    const uint32_t id = static_cast<uint32_t>(ops_[i]);
+    const double expiry = ops_[i + 1];
+    if (expiry < 0)
+      wheel_.Remove(id);
+    else
+      wheel_.Insert(id, static_cast<uint64_t>(std::ceil(expiry)));
+  }
+  fields_[kOpsLength] = 0;
+}
+
+size_t Environment::TimerInfo::PollExpired(uint64_t now) {
+  FlushOps();
+  uint32_t ids[kExpiredCapacity];
+  const size_t count = wheel_.Poll(now, ids, kExpiredCapacity);
+  for (size_t i = 0; i < count; i++)
+    expired_[i] = ids[i];
+  fields_[kExpiredLength] = count;
+  return count;
+}
+
+uint64_t Environment::TimerInfo::UpdateNextExpiry() {
+  const uint64_t next_expiry = wheel_.NextExpiry();
+  if (next_expiry == TimerWheel::kNoExpiry)
+    fields_[kNextExpiry] = std::numeric_limits<double>::infinity();
+  else
+    fields_[kNextExpiry] = static_cast<double>(next_expiry);
+  return next_expiry;
+}
+
 void Environment::RunTimers(uv_timer_t* handle) {
   Environment* env = Environment::from_timer_handle(handle);
   TraceEventScope trace_scope(TRACING_CATEGORY_NODE1(environment),
@@ -657,50 +692,54 @@ void Environment::RunTimers(uv_timer_t* handle) {
   Local<Object> process = env->process_object();
   InternalCallbackScope scope(env, process, {0, 0});
 
+  TimerInfo* timer_info = env->timer_info();
   Local<Function> cb = env->timers_callback_function();
   MaybeLocal<Value> ret;
   Local<Value> arg = env->GetNow();
-  // This code will loop until all currently due timers will process. It is
-  // impossible for us to end up in an infinite loop due to how the JS-side
-  // is structured.
-  do {
-    TryCatchScope try_catch(env);
-    try_catch.SetVerbose(true);
-    ret = cb->Call(env->context(), process, 1, &arg);
-  } while (ret.IsEmpty() && env->can_call_into_js());
-
-  // NOTE(apapirovski): If it ever becomes possible that `call_into_js` above
-  // is reset back to `true` after being previously set to `false` then this
-  // code becomes invalid and needs to be rewritten. Otherwise catastrophic
-  // timers corruption will occur and all timers behaviour will become
-  // entirely unpredictable.
-  if (ret.IsEmpty())
-    return;
-
-  // To allow for less JS-C++ boundary crossing, the value returned from JS
-  // serves a few purposes:
-  // 1. If it's 0, no more timers exist and the handle should be unrefed
-  // 2. If it's > 0, the value represents the next timer's expiry and there
-  //    is at least one timer remaining that is refed.
-  // 3. If it's < 0, the absolute value represents the next timer's expiry
-  //    and there are no timers that are refed.
-  int64_t expiry_ms =
-      ret.ToLocalChecked()->IntegerValue(env->context()).FromJust();
+  const uint64_t now = uv_now(env->event_loop()) - env->timer_base();
+
+  // JS only needs to be called when timers have actually expired, waking up
+  // may also just have cascaded timers closer to their expiry. Once called,
+  // JS collects any further batches of expired timers on its own. This code
+  // will loop until all currently due timers will process. It is impossible
+  // for us to end up in an infinite loop due to how the JS-side is
+  // structured.
+  if (timer_info->PollExpired(now) > 0) {
+    do {
+      TryCatchScope try_catch(env);
+      try_catch.SetVerbose(true);
+      ret = cb->Call(env->context(), process, 1, &arg);
+    } while (ret.IsEmpty() && env->can_call_into_js());
+
+    // NOTE(apapirovski): If it ever becomes possible that `call_into_js`
+    // above is reset back to `true` after being previously set to `false`
+    // then this code becomes invalid and needs to be rewritten. Otherwise
+    // catastrophic timers corruption will occur and all timers behaviour
+    // will become entirely unpredictable.
+    if (ret.IsEmpty())
+      return;
+  }
 
   uv_handle_t* h = reinterpret_cast<uv_handle_t*>(handle);
 
-  if (expiry_ms != 0) {
-    int64_t duration_ms =
-        llabs(expiry_ms) - (uv_now(env->event_loop()) - env->timer_base());
+  const uint64_t next_expiry = timer_info->UpdateNextExpiry();
+  if (next_expiry == TimerWheel::kNoExpiry) {
+    uv_unref(h);
+    return;
+  }
 
-    env->ScheduleTimer(duration_ms > 0 ? duration_ms : 1);
+  int64_t duration_ms = static_cast<int64_t>(next_expiry) -
+      static_cast<int64_t>(uv_now(env->event_loop()) - env->timer_base());
+  env->ScheduleTimer(duration_ms > 0 ? duration_ms : 1);
 
-    if (expiry_ms > 0)
+  // To allow for less JS-C++ boundary crossing, the value returned from JS
+  // tells us whether any of the remaining timers are refed. If JS was not
+  // called, the ref state of the handle is still up to date.
+  if (!ret.IsEmpty()) {
+    if (ret.ToLocalChecked()->IsTrue())
       uv_ref(h);
     else
       uv_unref(h);
-  } else {
-    uv_unref(h);
   }
 }
 
@@ -867,13 +906,25 @@ void Environment::AsyncHooks::grow_async_ids_stack() {
       async_ids_stack_.GetJSArray()).FromJust();
 }
 
+uint32_t Environment::AsyncHooks::event_type_id(const std::string& name) {
+  auto it = event_type_ids_.find(name);
+  if (it != event_type_ids_.end())
+    return it->second;
+  uint32_t id = AsyncWrap::PROVIDERS_LENGTH + event_type_names_.size();
+  event_type_names_.push_back(name);
+  event_type_ids_.emplace(name, id);
+  return id;
+}
+
 uv_key_t Environment::thread_local_env = {};
 
 void Environment::Exit(int exit_code) {
-  if (is_main_thread())
+  if (is_main_thread()) {
+    profiler::EndStartedProfilers(this);
     exit(exit_code);
-  else
+  } else {
     worker_context_->Exit(exit_code);
+  }
 }
 
 void Environment::stop_sub_worker_contexts() {
@@ -31,9 +31,11 @@
 #include "handle_wrap.h"
 #include "node.h"
 #include "node_binding.h"
+#include "node_profiler.h"
 #include "node_http2_state.h"
 #include "node_options.h"
 #include "req_wrap.h"
+#include "timer_wheel.h"
 #include "util.h"
 #include "uv.h"
 #include "v8.h"
@@ -61,6 +63,11 @@ namespace performance {
 class performance_state;
 }
 
+namespace threadpool {
+class CompletionQueue;
+class Monitor;
+}
+
 namespace tracing {
 class AgentWriterHandle;
 }
@@ -106,6 +113,7 @@ constexpr size_t kFsStatsBufferLength = kFsStatsFieldsNumber * 2;
 #define PER_ISOLATE_PRIVATE_SYMBOL_PROPERTIES(V)                              \
   V(alpn_buffer_private_symbol, "node:alpnBuffer")                            \
   V(arrow_message_private_symbol, "node:arrowMessage")                        \
+  V(context_frame_private_symbol, "node:contextFrame")                        \
   V(contextify_context_private_symbol, "node:contextify:context")             \
   V(contextify_global_private_symbol, "node:contextify:global")               \
   V(decorated_private_symbol, "node:decorated")                               \
@@ -318,6 +326,7 @@ constexpr size_t kFsStatsBufferLength = kFsStatsFieldsNumber * 2;
   V(async_hooks_before_function, v8::Function)                                 \
   V(async_hooks_binding, v8::Object)                                           \
   V(async_hooks_destroy_function, v8::Function)                                \
+  V(async_hooks_drain_events_function, v8::Function)                           \
   V(async_hooks_init_function, v8::Function)                                   \
   V(async_hooks_promise_resolve_function, v8::Function)                        \
   V(async_wrap_ctor_template, v8::FunctionTemplate)                            \
@@ -460,9 +469,23 @@ class Environment {
       kTotals,
       kCheck,
       kStackLength,
+      kUsesContextFrames,
+      kEventBuffer,
+      kEventBufferLength,
+      kEventBufferCapacity,
+      kEventBufferDropped,
       kFieldsCount,
     };
 
+    // Layout of a single record in the event buffer.
+    enum EventRecordFields {
+      kEventType,
+      kEventAsyncId,
+      kEventTriggerAsyncId,
+      kEventResourceType,
+      kEventRecordSize,
+    };
+
     enum UidFields {
       kExecutionAsyncId,
       kTriggerAsyncId,
@@ -474,13 +497,37 @@ class Environment {
     inline AliasedBuffer<uint32_t, v8::Uint32Array>& fields();
     inline AliasedBuffer<double, v8::Float64Array>& async_id_fields();
     inline AliasedBuffer<double, v8::Float64Array>& async_ids_stack();
+    // Created lazily when the first batched hook is enabled.
+    inline AliasedBuffer<double, v8::Float64Array>* event_buffer();
+    inline void set_event_buffer(
+        std::unique_ptr<AliasedBuffer<double, v8::Float64Array>> buffer);
+    // Resource types that are not AsyncWrap providers are interned and
+    // identified by numbers >= AsyncWrap::PROVIDERS_LENGTH in the event buffer.
+    uint32_t event_type_id(const std::string& name);
+    inline const std::string* event_type_name(uint32_t id) const;
+    inline v8::Local<v8::Array> context_frames();
+
+    // The context frame is the value that is propagated from the execution
+    // context that creates a resource to the callbacks of that resource.
+    // It is only tracked while fields()[kUsesContextFrames] > 0.
+    inline bool uses_context_frames();
+    inline v8::Local<v8::Value> context_frame();
+    inline void set_context_frame(v8::Local<v8::Value> frame);
+    // Promise reactions never nest, so a single slot is enough to restore
+    // the frame once a reaction job has finished.
+    inline void enter_promise_context_frame(v8::Local<v8::Value> frame);
+    inline void exit_promise_context_frame();
 
     inline v8::Local<v8::String> provider_string(int idx);
 
     inline void no_force_checks();
     inline Environment* env();
 
-    inline void push_async_ids(double async_id, double trigger_async_id);
+    // If context frames are in use, the current frame is saved along with the
+    // ids and replaced by `frame`, unless that is empty.
+    inline void push_async_ids(double async_id, double trigger_async_id,
+                               v8::Local<v8::Value> frame =
+                                   v8::Local<v8::Value>());
     inline bool pop_async_id(double async_id);
     inline void clear_async_id_stack();  // Used in fatal exceptions.
 
@@ -516,6 +563,15 @@ class Environment {
     AliasedBuffer<uint32_t, v8::Uint32Array> fields_;
     // Attached to a Float64Array that tracks the state of async resources.
     AliasedBuffer<double, v8::Float64Array> async_id_fields_;
+    // Index 0 holds the current context frame, index n + 1 holds the frame
+    // that was current when the n-th entry of async_ids_stack_ was pushed.
+    Persistent<v8::Array> context_frames_;
+    // Fixed-size records of async events for batched hooks, if any.
+    std::unique_ptr<AliasedBuffer<double, v8::Float64Array>> event_buffer_;
+    std::unordered_map<std::string, uint32_t> event_type_ids_;
+    std::vector<std::string> event_type_names_;
+    Persistent<v8::Value> promise_saved_context_frame_;
+    bool promise_context_frame_entered_ = false;
 
     void grow_async_ids_stack();
 
@@ -565,6 +621,48 @@ class Environment {
     DISALLOW_COPY_AND_ASSIGN(ImmediateInfo);
   };
 
+  // Owns the timer wheel behind setTimeout() and friends. JS queues timer
+  // insertions and removals into `ops()` and reads the ids of expired
+  // timers back from `expired()`, so re-arming a timer does not need to
+  // cross into C++ at all.
+  class TimerInfo {
+   public:
+    inline AliasedBuffer<double, v8::Float64Array>& fields();
+    inline AliasedBuffer<double, v8::Float64Array>& ops();
+    inline AliasedBuffer<uint32_t, v8::Uint32Array>& expired();
+
+    // Applies the operations queued up by JS to the wheel.
+    void FlushOps();
+    // Applies queued operations, then moves the next batch of timers that
+    // have expired by `now` into `expired()` and returns its size.
+    size_t PollExpired(uint64_t now);
+    // Returns the next time at which timers need to be processed, or
+    // TimerWheel::kNoExpiry if there are none, and tells JS about it.
+    uint64_t UpdateNextExpiry();
+
+   private:
+    friend class Environment;  // So we can call the constructor.
+    inline explicit TimerInfo(v8::Isolate* isolate);
+
+    enum Fields {
+      kOpsLength,
+      kNextExpiry,
+      kExpiredLength,
+      kFieldsCount
+    };
+
+    static const size_t kOpsCapacity = 1024;
+    static const size_t kExpiredCapacity = 1024;
+
+    AliasedBuffer<double, v8::Float64Array> fields_;
+    // Pairs of (timer id, expiry). A negative expiry removes the timer.
+    AliasedBuffer<double, v8::Float64Array> ops_;
+    AliasedBuffer<uint32_t, v8::Uint32Array> expired_;
+    TimerWheel wheel_;
+
+    DISALLOW_COPY_AND_ASSIGN(TimerInfo);
+  };
+
   class TickInfo {
    public:
     inline AliasedBuffer<uint8_t, v8::Uint8Array>& fields();
@@ -655,6 +753,7 @@ class Environment {
 
   inline AsyncHooks* async_hooks();
   inline ImmediateInfo* immediate_info();
+  inline TimerInfo* timer_info();
   inline TickInfo* tick_info();
   inline uint64_t timer_base() const;
 
@@ -716,6 +815,18 @@ class Environment {
   inline http2::Http2State* http2_state() const;
   inline void set_http2_state(std::unique_ptr<http2::Http2State> state);
 
+  // Created on first use, by --cpu-prof or by the v8 module.
+  inline profiler::CpuProfileRecorder* cpu_profile_recorder();
+
+  // Receives ThreadPoolWork that ran on a dedicated threadpool queue.
+  // Created on first use and closed by a cleanup hook.
+  inline threadpool::CompletionQueue* threadpool_completion_queue() const;
+  inline void set_threadpool_completion_queue(
+      threadpool::CompletionQueue* queue);
+
+  // The perf_hooks.monitorThreadPool() monitors that are currently enabled.
+  inline std::vector<threadpool::Monitor*>* threadpool_monitors();
+
   inline bool debug_enabled(DebugCategory category) const;
   inline void set_debug_enabled(DebugCategory category, bool enabled);
   void set_debug_categories(const std::string& cats, bool enabled);
@@ -940,6 +1051,7 @@ class Environment {
 
   AsyncHooks async_hooks_;
   ImmediateInfo immediate_info_;
+  TimerInfo timer_info_;
   TickInfo tick_info_;
   const uint64_t timer_base_;
   bool printed_error_;
@@ -1004,6 +1116,9 @@ class Environment {
   char* http_parser_buffer_;
   bool http_parser_buffer_in_use_ = false;
   std::unique_ptr<http2::Http2State> http2_state_;
+  std::unique_ptr<profiler::CpuProfileRecorder> cpu_profile_recorder_;
+  threadpool::CompletionQueue* threadpool_completion_queue_ = nullptr;
+  std::vector<threadpool::Monitor*> threadpool_monitors_;
 
   bool debug_enabled_[static_cast<int>(DebugCategory::CATEGORY_COUNT)] = {0};
 
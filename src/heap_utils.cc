@@ -1,6 +1,8 @@
 #include "node_internals.h"
 #include "env.h"
 
+#include <fcntl.h>
+
 using v8::Array;
 using v8::Boolean;
 using v8::Context;
@@ -232,6 +234,38 @@ class BufferOutputStream : public v8::OutputStream {
   std::unique_ptr<JSString> buffer_;
 };
 
+// Writes every chunk of a serialized heap snapshot to a file as soon as it is
+// produced, so that memory usage stays bounded by the chunk size no matter
+// how large the heap is.
+class FileOutputStream : public v8::OutputStream {
+ public:
+  explicit FileOutputStream(uv_file fd) : fd_(fd) {}
+
+  void EndOfStream() override {}
+  int GetChunkSize() override { return 64 * 1024; }
+  WriteResult WriteAsciiChunk(char* data, int size) override {
+    while (size > 0) {
+      uv_fs_t req;
+      uv_buf_t buf = uv_buf_init(data, size);
+      const int written = uv_fs_write(nullptr, &req, fd_, &buf, 1, -1, nullptr);
+      uv_fs_req_cleanup(&req);
+      if (written < 0) {
+        status_ = written;
+        return kAbort;
+      }
+      data += written;
+      size -= written;
+    }
+    return kContinue;
+  }
+
+  int status() const { return status_; }
+
+ private:
+  const uv_file fd_;
+  int status_ = 0;
+};
+
 void CreateHeapDump(const FunctionCallbackInfo<Value>& args) {
   Isolate* isolate = args.GetIsolate();
   const HeapSnapshot* snapshot = isolate->GetHeapProfiler()->TakeHeapSnapshot();
@@ -245,6 +279,21 @@ void CreateHeapDump(const FunctionCallbackInfo<Value>& args) {
   }
 }
 
+void TriggerHeapSnapshot(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(args[0]->IsString() || args[0]->IsUndefined());
+  const std::string path = args[0]->IsString() ?
+      std::string(*Utf8Value(env->isolate(), args[0])) :
+      profiler::GetHeapSnapshotPath(env);
+  const char* syscall;
+  const int err = WriteSnapshot(env->isolate(), path, &syscall);
+  if (err != 0)
+    return env->ThrowUVException(err, syscall, nullptr, path.c_str());
+  args.GetReturnValue().Set(
+      String::NewFromUtf8(env->isolate(), path.c_str(),
+                          v8::NewStringType::kNormal).ToLocalChecked());
+}
+
 void Initialize(Local<Object> target,
                 Local<Value> unused,
                 Local<Context> context,
@@ -253,6 +302,34 @@ void Initialize(Local<Object> target,
 
   env->SetMethodNoSideEffect(target, "buildEmbedderGraph", BuildEmbedderGraph);
   env->SetMethodNoSideEffect(target, "createHeapDump", CreateHeapDump);
+  env->SetMethod(target, "triggerHeapSnapshot", TriggerHeapSnapshot);
+}
+
+int WriteSnapshot(Isolate* isolate,
+                  const std::string& path,
+                  const char** syscall) {
+  uv_fs_t req;
+  *syscall = "open";
+  const int fd = uv_fs_open(nullptr, &req, path.c_str(),
+                            O_WRONLY | O_CREAT | O_TRUNC, 0644, nullptr);
+  uv_fs_req_cleanup(&req);
+  if (fd < 0)
+    return fd;
+
+  const HeapSnapshot* snapshot = isolate->GetHeapProfiler()->TakeHeapSnapshot();
+  FileOutputStream out(fd);
+  snapshot->Serialize(&out, HeapSnapshot::kJSON);
+  const_cast<HeapSnapshot*>(snapshot)->Delete();
+
+  const int close_err = uv_fs_close(nullptr, &req, fd, nullptr);
+  uv_fs_req_cleanup(&req);
+  if (out.status() != 0) {
+    *syscall = "write";
+    return out.status();
+  }
+  // Some write errors, e.g. on network file systems, are only reported here.
+  *syscall = "close";
+  return close_err;
 }
 
 }  // namespace heap
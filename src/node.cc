@@ -220,7 +220,9 @@ class NodeTraceStateObserver :
 static struct {
 #if NODE_USE_V8_PLATFORM
   void Initialize(int thread_pool_size) {
-    tracing_agent_.reset(new tracing::Agent());
+    tracing_agent_.reset(new tracing::Agent(
+        per_process_opts->trace_event_flight_recorder ?
+            tracing::Agent::kRingBuffer : tracing::Agent::kStreamingBuffer));
     node::tracing::TraceEventHelper::SetAgent(tracing_agent_.get());
     auto controller = tracing_agent_->GetTracingController();
     controller->AddTraceStateObserver(new NodeTraceStateObserver(controller));
@@ -272,7 +274,10 @@ static struct {
           ParseCommaSeparatedSet(per_process_opts->trace_event_categories),
           std::unique_ptr<tracing::AsyncTraceWriter>(
               new tracing::NodeTraceWriter(
-                  per_process_opts->trace_event_file_pattern)),
+                  per_process_opts->trace_event_file_pattern,
+                  per_process_opts->trace_event_format == "protobuf" ?
+                      tracing::NodeTraceWriter::kProtobuf :
+                      tracing::NodeTraceWriter::kJSON)),
           tracing::Agent::kUseDefaultCategories);
     }
   }
@@ -494,6 +499,14 @@ const char* signo_string(int signo) {
   }
 }
 
+int signo_from_string(const std::string& name) {
+  for (int signo = 1; signo < 64; signo++) {
+    if (name == signo_string(signo))
+      return signo;
+  }
+  return 0;
+}
+
 void* ArrayBufferAllocator::Allocate(size_t size) {
   if (zero_fill_field_ || per_process_opts->zero_fill_all_buffers)
     return UncheckedCalloc(size);
@@ -542,9 +555,12 @@ MaybeLocal<Value> InternalMakeCallback(Environment* env,
                                        const Local<Function> callback,
                                        int argc,
                                        Local<Value> argv[],
-                                       async_context asyncContext) {
+                                       async_context asyncContext,
+                                       Local<Value> context_frame) {
   CHECK(!recv.IsEmpty());
-  InternalCallbackScope scope(env, recv, asyncContext);
+  InternalCallbackScope scope(env, recv, asyncContext,
+                              InternalCallbackScope::kRequireResource,
+                              context_frame);
   if (scope.Failed()) {
     return MaybeLocal<Value>();
   }
@@ -1906,6 +1922,8 @@ inline int Start(Isolate* isolate, IsolateData* isolate_data,
     return 12;  // Signal internal error.
   }
 
+  profiler::StartProfilers(&env);
+
   {
     Environment::AsyncCallbackScope callback_scope(&env);
     env.async_hooks()->push_async_ids(1, 0);
@@ -1941,6 +1959,8 @@ inline int Start(Isolate* isolate, IsolateData* isolate_data,
 
   const int exit_code = EmitExit(&env);
 
+  profiler::EndStartedProfilers(&env);
+
   WaitForInspectorDisconnect(&env);
 
   env.set_can_call_into_js(false);
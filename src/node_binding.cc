@@ -44,6 +44,8 @@
   V(performance)                                                               \
   V(pipe_wrap)                                                                 \
   V(process_wrap)                                                              \
+  V(profiler)                                                                  \
+  V(querystring)                                                               \
   V(serdes)                                                                    \
   V(signal_wrap)                                                               \
   V(spawn_sync)                                                                \
@@ -52,6 +54,7 @@
   V(string_decoder)                                                            \
   V(symbols)                                                                   \
   V(tcp_wrap)                                                                  \
+  V(threadpool)                                                                \
   V(timers)                                                                    \
   V(trace_events)                                                              \
   V(tty_wrap)                                                                  \
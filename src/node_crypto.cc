@@ -26,7 +26,9 @@
 #include "node_crypto.h"
 #include "node_crypto_bio.h"
 #include "node_crypto_groups.h"
+#include "node_crypto_scrypt.h"
 #include "node_crypto_clienthello-inl.h"
+#include "node_crypto_session_cache.h"
 #include "node_mutex.h"
 #include "node_internals.h"
 #include "tls_wrap.h"  // TLSWrap
@@ -42,7 +44,11 @@
 #include <string.h>
 
 #include <algorithm>
+#include <atomic>
+#include <limits>
 #include <memory>
+#include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -149,6 +155,8 @@ template void SSLWrap<TLSWrap>::OnClientHello(
     const ClientHelloParser::ClientHello& hello);
 template int SSLWrap<TLSWrap>::TLSExtStatusCallback(SSL* s, void* arg);
 template void SSLWrap<TLSWrap>::DestroySSL();
+template bool SSLWrap<TLSWrap>::AdvanceAsyncHandshake();
+template void SSLWrap<TLSWrap>::PrivateKeyOperationDone(void* arg);
 template int SSLWrap<TLSWrap>::SSLCertCallback(SSL* s, void* arg);
 template void SSLWrap<TLSWrap>::WaitForCertCb(CertCb cb, void* arg);
 template int SSLWrap<TLSWrap>::SelectALPNCallback(
@@ -354,6 +362,8 @@ void SecureContext::Initialize(Environment* env, Local<Object> target) {
   env->SetProtoMethod(t, "setOptions", SetOptions);
   env->SetProtoMethod(t, "setSessionIdContext", SetSessionIdContext);
   env->SetProtoMethod(t, "setSessionTimeout", SetSessionTimeout);
+  env->SetProtoMethod(t, "setSessionCache", SetSessionCache);
+  env->SetProtoMethod(t, "enableAsyncPrivateKey", EnableAsyncPrivateKey);
   env->SetProtoMethod(t, "close", Close);
   env->SetProtoMethod(t, "loadPKCS12", LoadPKCS12);
 #ifndef OPENSSL_NO_ENGINE
@@ -361,6 +371,7 @@ void SecureContext::Initialize(Environment* env, Local<Object> target) {
 #endif  // !OPENSSL_NO_ENGINE
   env->SetProtoMethodNoSideEffect(t, "getTicketKeys", GetTicketKeys);
   env->SetProtoMethod(t, "setTicketKeys", SetTicketKeys);
+  env->SetProtoMethod(t, "enableTicketKeyRotation", EnableTicketKeyRotation);
   env->SetProtoMethod(t, "setFreeListLength", SetFreeListLength);
   env->SetProtoMethod(t, "enableTicketKeyCallback", EnableTicketKeyCallback);
   env->SetProtoMethodNoSideEffect(t, "getCertificate", GetCertificate<true>);
@@ -402,6 +413,16 @@ void SecureContext::New(const FunctionCallbackInfo<Value>& args) {
 }
 
 
+void SecureContext::MemoryInfo(MemoryTracker* tracker) const {
+  if (ctx_)
+    tracker->TrackFieldWithSize("ctx", kExternalSize, "SSL_CTX");
+  // An entry that several contexts share is reported once, as a child of
+  // each of them.
+  for (const auto& entry : pem_entries_)
+    tracker->TrackField("pem", entry.get());
+}
+
+
 void SecureContext::Init(const FunctionCallbackInfo<Value>& args) {
   SecureContext* sc;
   ASSIGN_OR_RETURN_UNWRAP(&sc, args.Holder());
@@ -556,6 +577,31 @@ static BIOPointer LoadBIO(Environment* env, Local<Value> v) {
 }
 
 
+// Like LoadBIO(), but returns the objects that `parse` reads from the input,
+// which are shared with every other context that loads the same input, see
+// PEMCache.
+static std::shared_ptr<const PEMCacheEntry> LoadPEM(
+    Environment* env,
+    Local<Value> v,
+    PEMCache::Kind kind,
+    const char* passphrase,
+    const PEMCache::ParseFn& parse) {
+  HandleScope scope(env->isolate());
+
+  if (v->IsString()) {
+    const node::Utf8Value s(env->isolate(), v);
+    return PEMCache::Get(kind, *s, s.length(), passphrase, parse);
+  }
+
+  if (Buffer::HasInstance(v)) {
+    return PEMCache::Get(kind, Buffer::Data(v), Buffer::Length(v),
+                         passphrase, parse);
+  }
+
+  return nullptr;
+}
+
+
 void SecureContext::SetKey(const FunctionCallbackInfo<Value>& args) {
   Environment* env = Environment::GetCurrent(args);
 
@@ -578,19 +624,24 @@ void SecureContext::SetKey(const FunctionCallbackInfo<Value>& args) {
       THROW_AND_RETURN_IF_NOT_STRING(env, args[1], "Pass phrase");
   }
 
-  BIOPointer bio(LoadBIO(env, args[0]));
-  if (!bio)
+  if (!args[0]->IsString() && !Buffer::HasInstance(args[0]))
     return;
 
   node::Utf8Value passphrase(env->isolate(), args[1]);
+  char* pass = len == 1 ? nullptr : *passphrase;
+
+  std::shared_ptr<const PEMCacheEntry> pem = LoadPEM(
+      env, args[0], PEMCache::kPrivateKey, pass,
+      [pass](BIO* bio, PEMCacheEntry* entry) {
+        EVP_PKEY* key =
+            PEM_read_bio_PrivateKey(bio, nullptr, PasswordCallback, pass);
+        if (key == nullptr)
+          return false;
+        entry->SetKey(key);
+        return true;
+      });
 
-  EVPKeyPointer key(
-      PEM_read_bio_PrivateKey(bio.get(),
-                              nullptr,
-                              PasswordCallback,
-                              len == 1 ? nullptr : *passphrase));
-
-  if (!key) {
+  if (!pem) {
     unsigned long err = ERR_get_error();  // NOLINT(runtime/int)
     if (!err) {
       return env->ThrowError("PEM_read_bio_PrivateKey");
@@ -598,7 +649,7 @@ void SecureContext::SetKey(const FunctionCallbackInfo<Value>& args) {
     return ThrowCryptoError(env, err);
   }
 
-  int rv = SSL_CTX_use_PrivateKey(sc->ctx_.get(), key.get());
+  int rv = SSL_CTX_use_PrivateKey(sc->ctx_.get(), pem->key());
 
   if (!rv) {
     unsigned long err = ERR_get_error();  // NOLINT(runtime/int)
@@ -606,6 +657,8 @@ void SecureContext::SetKey(const FunctionCallbackInfo<Value>& args) {
       return env->ThrowError("SSL_CTX_use_PrivateKey");
     return ThrowCryptoError(env, err);
   }
+
+  sc->pem_entries_.push_back(std::move(pem));
 }
 
 
@@ -666,19 +719,15 @@ int SSL_CTX_use_certificate_chain(SSL_CTX* ctx,
       // no need to free `store`
     } else {
       // Increment issuer reference count
-      issuer = X509_dup(issuer);
-      if (issuer == nullptr) {
-        ret = 0;
-      }
+      X509_up_ref(issuer);
     }
   }
 
   issuer_->reset(issuer);
 
   if (ret && x != nullptr) {
-    cert->reset(X509_dup(x.get()));
-    if (!*cert)
-      ret = 0;
+    X509_up_ref(x.get());
+    cert->reset(x.get());
   }
   return ret;
 }
@@ -689,50 +738,55 @@ int SSL_CTX_use_certificate_chain(SSL_CTX* ctx,
 // sent to the peer in the Certificate message.
 //
 // Taken from OpenSSL - edited for style.
-int SSL_CTX_use_certificate_chain(SSL_CTX* ctx,
-                                  BIOPointer&& in,
-                                  X509Pointer* cert,
-                                  X509Pointer* issuer) {
+static bool ParseCertificateChain(BIO* in, PEMCacheEntry* entry) {
   // Just to ensure that `ERR_peek_last_error` below will return only errors
   // that we are interested in
   ERR_clear_error();
 
-  X509Pointer x(
-      PEM_read_bio_X509_AUX(in.get(), nullptr, NoPasswordCallback, nullptr));
-
-  if (!x)
-    return 0;
-
-  unsigned long err = 0;  // NOLINT(runtime/int)
+  X509* x = PEM_read_bio_X509_AUX(in, nullptr, NoPasswordCallback, nullptr);
 
-  StackOfX509 extra_certs(sk_X509_new_null());
-  if (!extra_certs)
-    return 0;
+  if (x == nullptr)
+    return false;
 
-  while (X509Pointer extra {PEM_read_bio_X509(in.get(),
-                                    nullptr,
-                                    NoPasswordCallback,
-                                    nullptr)}) {
-    if (sk_X509_push(extra_certs.get(), extra.get())) {
-      extra.release();
-      continue;
-    }
+  entry->AddCert(x);
 
-    return 0;
+  while (X509* extra =
+      PEM_read_bio_X509(in, nullptr, NoPasswordCallback, nullptr)) {
+    entry->AddCert(extra);
   }
 
   // When the while loop ends, it's usually just EOF.
-  err = ERR_peek_last_error();
+  unsigned long err = ERR_peek_last_error();  // NOLINT(runtime/int)
   if (ERR_GET_LIB(err) == ERR_LIB_PEM &&
       ERR_GET_REASON(err) == PEM_R_NO_START_LINE) {
     ERR_clear_error();
-  } else {
-    // some real error
+    return true;
+  }
+
+  // some real error
+  return false;
+}
+
+
+int SSL_CTX_use_certificate_chain(SSL_CTX* ctx,
+                                  const PEMCacheEntry& chain,
+                                  X509Pointer* cert,
+                                  X509Pointer* issuer) {
+  StackOfX509 extra_certs(sk_X509_new_null());
+  if (!extra_certs)
     return 0;
+
+  for (size_t i = 1; i < chain.certs().size(); i++) {
+    X509* extra = chain.certs()[i];
+    if (!sk_X509_push(extra_certs.get(), extra))
+      return 0;
+    X509_up_ref(extra);
   }
 
+  X509* x = chain.certs()[0];
+  X509_up_ref(x);
   return SSL_CTX_use_certificate_chain(ctx,
-                                       std::move(x),
+                                       X509Pointer(x),
                                        extra_certs.get(),
                                        cert,
                                        issuer);
@@ -749,17 +803,19 @@ void SecureContext::SetCert(const FunctionCallbackInfo<Value>& args) {
     return THROW_ERR_MISSING_ARGS(env, "Certificate argument is mandatory");
   }
 
-  BIOPointer bio(LoadBIO(env, args[0]));
-  if (!bio)
+  if (!args[0]->IsString() && !Buffer::HasInstance(args[0]))
     return;
 
+  std::shared_ptr<const PEMCacheEntry> pem = LoadPEM(
+      env, args[0], PEMCache::kCertChain, nullptr, ParseCertificateChain);
+
   sc->cert_.reset();
   sc->issuer_.reset();
 
-  int rv = SSL_CTX_use_certificate_chain(sc->ctx_.get(),
-                                         std::move(bio),
-                                         &sc->cert_,
-                                         &sc->issuer_);
+  int rv = pem && SSL_CTX_use_certificate_chain(sc->ctx_.get(),
+                                                *pem,
+                                                &sc->cert_,
+                                                &sc->issuer_);
 
   if (!rv) {
     unsigned long err = ERR_get_error();  // NOLINT(runtime/int)
@@ -768,6 +824,8 @@ void SecureContext::SetCert(const FunctionCallbackInfo<Value>& args) {
     }
     return ThrowCryptoError(env, err);
   }
+
+  sc->pem_entries_.push_back(std::move(pem));
 }
 
 
@@ -820,21 +878,29 @@ void SecureContext::AddCACert(const FunctionCallbackInfo<Value>& args) {
     return THROW_ERR_MISSING_ARGS(env, "CA certificate argument is mandatory");
   }
 
-  BIOPointer bio(LoadBIO(env, args[0]));
-  if (!bio)
+  std::shared_ptr<const PEMCacheEntry> pem = LoadPEM(
+      env, args[0], PEMCache::kCACerts, nullptr,
+      [](BIO* bio, PEMCacheEntry* entry) {
+        while (X509* x509 = PEM_read_bio_X509_AUX(
+            bio, nullptr, NoPasswordCallback, nullptr)) {
+          entry->AddCert(x509);
+        }
+        return true;
+      });
+  if (!pem)
     return;
 
   X509_STORE* cert_store = SSL_CTX_get_cert_store(sc->ctx_.get());
-  while (X509* x509 = PEM_read_bio_X509_AUX(
-      bio.get(), nullptr, NoPasswordCallback, nullptr)) {
+  for (X509* x509 : pem->certs()) {
     if (cert_store == root_cert_store) {
       cert_store = NewRootCertStore();
       SSL_CTX_set_cert_store(sc->ctx_.get(), cert_store);
     }
     X509_STORE_add_cert(cert_store, x509);
     SSL_CTX_add_client_CA(sc->ctx_.get(), x509);
-    X509_free(x509);
   }
+
+  sc->pem_entries_.push_back(std::move(pem));
 }
 
 
@@ -1098,6 +1164,43 @@ void SecureContext::SetSessionTimeout(const FunctionCallbackInfo<Value>& args) {
 }
 
 
+// Server sessions are stored in, and resumed from, the cache without calling
+// into JS, unless a connection has enabled the session callbacks.
+void SecureContext::SetSessionCache(const FunctionCallbackInfo<Value>& args) {
+  SecureContext* sc;
+  ASSIGN_OR_RETURN_UNWRAP(&sc, args.Holder());
+
+  if (args[0]->IsUndefined()) {
+    sc->session_cache_.reset();
+    return;
+  }
+
+  CHECK(args[0]->IsObject());
+  SessionCache* cache;
+  ASSIGN_OR_RETURN_UNWRAP(&cache, args[0].As<Object>());
+  sc->session_cache_ = cache->store();
+}
+
+
+// Moves the private key operations of the handshakes of connections that are
+// created from this context to the threadpool. Returns false if the key does
+// not support it, see NewAsyncKey().
+void SecureContext::EnableAsyncPrivateKey(
+    const FunctionCallbackInfo<Value>& args) {
+  SecureContext* sc;
+  ASSIGN_OR_RETURN_UNWRAP(&sc, args.Holder());
+
+  ClearErrorOnReturn clear_error_on_return;
+
+  // The key may be shared with other contexts, see PEMCache, so the context
+  // gets a copy of its own.
+  EVPKeyPointer key(NewAsyncKey(SSL_CTX_get0_privatekey(sc->ctx_.get())));
+  sc->async_private_key_ =
+      key && SSL_CTX_use_PrivateKey(sc->ctx_.get(), key.get()) == 1;
+  args.GetReturnValue().Set(sc->async_private_key_);
+}
+
+
 void SecureContext::Close(const FunctionCallbackInfo<Value>& args) {
   SecureContext* sc;
   ASSIGN_OR_RETURN_UNWRAP(&sc, args.Holder());
@@ -1232,6 +1335,15 @@ void SecureContext::GetTicketKeys(const FunctionCallbackInfo<Value>& args) {
   ASSIGN_OR_RETURN_UNWRAP(&wrap, args.Holder());
 
   Local<Object> buff = Buffer::New(wrap->env(), 48).ToLocalChecked();
+  if (!wrap->ticket_key_secret_.empty()) {
+    if (!wrap->RotateTicketKeys())
+      return wrap->env()->ThrowError("Error generating ticket keys");
+    const RotatingTicketKey& key = wrap->rotating_ticket_keys_.front();
+    memcpy(Buffer::Data(buff), key.name, 16);
+    memcpy(Buffer::Data(buff) + 16, key.hmac, 16);
+    memcpy(Buffer::Data(buff) + 32, key.aes, 16);
+    return args.GetReturnValue().Set(buff);
+  }
   memcpy(Buffer::Data(buff), wrap->ticket_key_name_, 16);
   memcpy(Buffer::Data(buff) + 16, wrap->ticket_key_hmac_, 16);
   memcpy(Buffer::Data(buff) + 32, wrap->ticket_key_aes_, 16);
@@ -1262,11 +1374,52 @@ void SecureContext::SetTicketKeys(const FunctionCallbackInfo<Value>& args) {
   memcpy(wrap->ticket_key_hmac_, Buffer::Data(args[0]) + 16, 16);
   memcpy(wrap->ticket_key_aes_, Buffer::Data(args[0]) + 32, 16);
 
+  // Fixed keys replace the rotating ones.
+  if (!wrap->ticket_key_secret_.empty()) {
+    OPENSSL_cleanse(wrap->ticket_key_secret_.data(),
+                    wrap->ticket_key_secret_.size());
+    wrap->ticket_key_secret_.clear();
+    wrap->rotating_ticket_keys_.clear();
+    SSL_CTX_set_tlsext_ticket_key_cb(wrap->ctx_.get(),
+                                     TicketCompatibilityCallback);
+  }
+
   args.GetReturnValue().Set(true);
 #endif  // !def(OPENSSL_NO_TLSEXT) && def(SSL_CTX_get_tlsext_ticket_keys)
 }
 
 
+// enableTicketKeyRotation(secret, interval, overlap)
+// Every interval of `interval` seconds, counted from the epoch, has its own
+// ticket keys, which are derived from `secret`. Contexts that share the secret
+// therefore agree on the keys without any coordination, as long as their
+// clocks do. Tickets that were issued under an older key are accepted, and
+// renewed, for `overlap` seconds after the key has been replaced.
+void SecureContext::EnableTicketKeyRotation(
+    const FunctionCallbackInfo<Value>& args) {
+#if !defined(OPENSSL_NO_TLSEXT) && defined(SSL_CTX_get_tlsext_ticket_keys)
+  SecureContext* wrap;
+  ASSIGN_OR_RETURN_UNWRAP(&wrap, args.Holder());
+  Environment* env = wrap->env();
+
+  CHECK(Buffer::HasInstance(args[0]));
+  CHECK(args[1]->IsUint32());
+  CHECK(args[2]->IsUint32());
+  CHECK_GT(args[1].As<Uint32>()->Value(), 0);
+
+  const char* secret = Buffer::Data(args[0]);
+  wrap->ticket_key_secret_.assign(secret, secret + Buffer::Length(args[0]));
+  wrap->ticket_key_interval_ = args[1].As<Uint32>()->Value();
+  wrap->ticket_key_overlap_ = args[2].As<Uint32>()->Value();
+  wrap->rotating_ticket_keys_.clear();
+  if (!wrap->RotateTicketKeys())
+    return env->ThrowError("Error generating ticket keys");
+
+  SSL_CTX_set_tlsext_ticket_key_cb(wrap->ctx_.get(), RotatingTicketKeyCallback);
+#endif  // !def(OPENSSL_NO_TLSEXT) && def(SSL_CTX_get_tlsext_ticket_keys)
+}
+
+
 void SecureContext::SetFreeListLength(const FunctionCallbackInfo<Value>& args) {
 }
 
@@ -1406,6 +1559,107 @@ int SecureContext::TicketCompatibilityCallback(SSL* ssl,
 }
 
 
+bool SecureContext::RotateTicketKeys() {
+  const int64_t interval = ticket_key_interval_;
+  const int64_t epoch = time(nullptr) / interval;
+  if (!rotating_ticket_keys_.empty() &&
+      rotating_ticket_keys_.front().epoch == epoch) {
+    return true;
+  }
+
+  // Keep every key whose overlap window has not ended before the start of
+  // the current interval. RotatingTicketKeyCallback() checks the exact time.
+  const int64_t overlap_intervals =
+      (ticket_key_overlap_ + interval - 1) / interval;
+  std::vector<RotatingTicketKey> keys;
+  for (int64_t e = epoch; e >= 0 && e >= epoch - overlap_intervals; e--) {
+    RotatingTicketKey key;
+    key.epoch = e;
+
+    unsigned char message[9];
+    for (int i = 0; i < 8; i++)
+      message[i] = static_cast<unsigned char>(e >> (56 - 8 * i));
+    unsigned char digest[EVP_MAX_MD_SIZE];
+    unsigned int digest_length;
+
+    message[8] = 'n';
+    if (HMAC(EVP_sha256(), ticket_key_secret_.data(),
+             ticket_key_secret_.size(), message, sizeof(message),
+             digest, &digest_length) == nullptr) {
+      return false;
+    }
+    memcpy(key.name, digest, sizeof(key.name));
+
+    message[8] = 'k';
+    if (HMAC(EVP_sha256(), ticket_key_secret_.data(),
+             ticket_key_secret_.size(), message, sizeof(message),
+             digest, &digest_length) == nullptr) {
+      return false;
+    }
+    memcpy(key.hmac, digest, sizeof(key.hmac));
+    memcpy(key.aes, digest + sizeof(key.hmac), sizeof(key.aes));
+    OPENSSL_cleanse(digest, sizeof(digest));
+
+    keys.push_back(key);
+  }
+
+  for (RotatingTicketKey& key : rotating_ticket_keys_)
+    OPENSSL_cleanse(&key, sizeof(key));
+  rotating_ticket_keys_ = std::move(keys);
+  return true;
+}
+
+
+int SecureContext::RotatingTicketKeyCallback(SSL* ssl,
+                                             unsigned char* name,
+                                             unsigned char* iv,
+                                             EVP_CIPHER_CTX* ectx,
+                                             HMAC_CTX* hctx,
+                                             int enc) {
+  SecureContext* sc = static_cast<SecureContext*>(
+      SSL_CTX_get_app_data(SSL_get_SSL_CTX(ssl)));
+
+  if (!sc->RotateTicketKeys())
+    return -1;
+  const RotatingTicketKey& current = sc->rotating_ticket_keys_.front();
+
+  if (enc) {
+    memcpy(name, current.name, sizeof(current.name));
+    if (RAND_bytes(iv, 16) <= 0 ||
+        EVP_EncryptInit_ex(ectx, EVP_aes_128_cbc(), nullptr,
+                           current.aes, iv) <= 0 ||
+        HMAC_Init_ex(hctx, current.hmac, sizeof(current.hmac),
+                     EVP_sha256(), nullptr) <= 0) {
+      return -1;
+    }
+    return 1;
+  }
+
+  const int64_t now = time(nullptr);
+  for (const RotatingTicketKey& key : sc->rotating_ticket_keys_) {
+    if (memcmp(name, key.name, sizeof(key.name)) != 0)
+      continue;
+    const bool is_current = &key == &current;
+    if (!is_current &&
+        (key.epoch + 1) * sc->ticket_key_interval_ +
+            sc->ticket_key_overlap_ <= now) {
+      break;
+    }
+    if (EVP_DecryptInit_ex(ectx, EVP_aes_128_cbc(), nullptr, key.aes,
+                           iv) <= 0 ||
+        HMAC_Init_ex(hctx, key.hmac, sizeof(key.hmac),
+                     EVP_sha256(), nullptr) <= 0) {
+      return -1;
+    }
+    // Have the client replace a ticket that uses an older key.
+    return is_current ? 1 : 2;
+  }
+
+  // None of the keys matches. Discard the ticket.
+  return 0;
+}
+
+
 void SecureContext::CtxGetter(const FunctionCallbackInfo<Value>& info) {
   SecureContext* sc;
   ASSIGN_OR_RETURN_UNWRAP(&sc, info.This());
@@ -1489,6 +1743,16 @@ SSL_SESSION* SSLWrap<Base>::GetSessionCallback(SSL* s,
   Base* w = static_cast<Base*>(SSL_get_app_data(s));
 
   *copy = 0;
+  if (!w->session_callbacks_ && w->session_cache_) {
+    unsigned char data[SessionCacheStore::kMaxSessionSize];
+    size_t length = w->session_cache_->Lookup(key, len, data);
+    if (length == 0)
+      return nullptr;
+    const unsigned char* p = data;
+    SSL_SESSION* session = d2i_SSL_SESSION(nullptr, &p, length);
+    OPENSSL_cleanse(data, length);
+    return session;
+  }
   return w->next_sess_.release();
 }
 
@@ -1496,9 +1760,25 @@ SSL_SESSION* SSLWrap<Base>::GetSessionCallback(SSL* s,
 template <class Base>
 int SSLWrap<Base>::NewSessionCallback(SSL* s, SSL_SESSION* sess) {
   Base* w = static_cast<Base*>(SSL_get_app_data(s));
-  Environment* env = w->ssl_env();
-  HandleScope handle_scope(env->isolate());
-  Context::Scope context_scope(env->context());
+
+  if (!w->session_callbacks_ && w->session_cache_) {
+    int size = i2d_SSL_SESSION(sess, nullptr);
+    if (size <= 0 ||
+        static_cast<size_t>(size) > SessionCacheStore::kMaxSessionSize) {
+      return 0;
+    }
+    unsigned char data[SessionCacheStore::kMaxSessionSize];
+    unsigned char* p = data;
+    i2d_SSL_SESSION(sess, &p);
+
+    unsigned int session_id_length;
+    const unsigned char* session_id = SSL_SESSION_get_id(sess,
+                                                         &session_id_length);
+    w->session_cache_->Store(session_id, session_id_length, data, size,
+                             SSL_SESSION_get_timeout(sess));
+    OPENSSL_cleanse(data, size);
+    return 0;
+  }
 
   if (!w->session_callbacks_)
     return 0;
@@ -1508,23 +1788,31 @@ int SSLWrap<Base>::NewSessionCallback(SSL* s, SSL_SESSION* sess) {
   if (size > SecureContext::kMaxSessionSize)
     return 0;
 
-  // Serialize session
-  Local<Object> buff = Buffer::New(env, size).ToLocalChecked();
-  unsigned char* serialized = reinterpret_cast<unsigned char*>(
-      Buffer::Data(buff));
-  memset(serialized, 0, size);
-  i2d_SSL_SESSION(sess, &serialized);
-
-  unsigned int session_id_length;
-  const unsigned char* session_id = SSL_SESSION_get_id(sess,
-                                                       &session_id_length);
-  Local<Object> session = Buffer::Copy(
-      env,
-      reinterpret_cast<const char*>(session_id),
-      session_id_length).ToLocalChecked();
-  Local<Value> argv[] = { session, buff };
+  SSL_SESSION_up_ref(sess);
+  std::shared_ptr<SSL_SESSION> sess_ref(sess, SSL_SESSION_free);
   w->new_session_wait_ = true;
-  w->MakeCallback(env->onnewsession_string(), arraysize(argv), argv);
+  w->RunOutsideAsyncJob([w, sess_ref, size]() {
+    Environment* env = w->ssl_env();
+    HandleScope handle_scope(env->isolate());
+    Context::Scope context_scope(env->context());
+
+    // Serialize session
+    Local<Object> buff = Buffer::New(env, size).ToLocalChecked();
+    unsigned char* serialized = reinterpret_cast<unsigned char*>(
+        Buffer::Data(buff));
+    memset(serialized, 0, size);
+    i2d_SSL_SESSION(sess_ref.get(), &serialized);
+
+    unsigned int session_id_length;
+    const unsigned char* session_id = SSL_SESSION_get_id(sess_ref.get(),
+                                                         &session_id_length);
+    Local<Object> session = Buffer::Copy(
+        env,
+        reinterpret_cast<const char*>(session_id),
+        session_id_length).ToLocalChecked();
+    Local<Value> argv[] = { session, buff };
+    w->MakeCallback(env->onnewsession_string(), arraysize(argv), argv);
+  });
 
   return 0;
 }
@@ -2445,16 +2733,20 @@ int SSLWrap<Base>::TLSExtStatusCallback(SSL* s, void* arg) {
     // Incoming response
     const unsigned char* resp;
     int len = SSL_get_tlsext_status_ocsp_resp(s, &resp);
-    Local<Value> arg;
-    if (resp == nullptr) {
-      arg = Null(env->isolate());
-    } else {
-      arg =
-          Buffer::Copy(env, reinterpret_cast<const char*>(resp), len)
-          .ToLocalChecked();
-    }
+    w->RunOutsideAsyncJob([w, resp, len]() {
+      Environment* env = w->env();
+      HandleScope handle_scope(env->isolate());
+      Local<Value> arg;
+      if (resp == nullptr) {
+        arg = Null(env->isolate());
+      } else {
+        arg =
+            Buffer::Copy(env, reinterpret_cast<const char*>(resp), len)
+            .ToLocalChecked();
+      }
 
-    w->MakeCallback(env->onocspresponse_string(), 1, &arg);
+      w->MakeCallback(env->onocspresponse_string(), 1, &arg);
+    });
 
     // Somehow, client is expecting different return value here
     return 1;
@@ -2501,31 +2793,34 @@ int SSLWrap<Base>::SSLCertCallback(SSL* s, void* arg) {
   if (w->cert_cb_running_)
     return -1;
 
-  Environment* env = w->env();
-  Local<Context> context = env->context();
-  HandleScope handle_scope(env->isolate());
-  Context::Scope context_scope(context);
   w->cert_cb_running_ = true;
+  w->RunOutsideAsyncJob([w, s]() {
+    Environment* env = w->env();
+    Local<Context> context = env->context();
+    HandleScope handle_scope(env->isolate());
+    Context::Scope context_scope(context);
+
+    Local<Object> info = Object::New(env->isolate());
+
+    const char* servername = SSL_get_servername(s, TLSEXT_NAMETYPE_host_name);
+    if (servername == nullptr) {
+      info->Set(context,
+                env->servername_string(),
+                String::Empty(env->isolate())).FromJust();
+    } else {
+      Local<String> str = OneByteString(env->isolate(), servername,
+                                        strlen(servername));
+      info->Set(context, env->servername_string(), str).FromJust();
+    }
 
-  Local<Object> info = Object::New(env->isolate());
-
-  const char* servername = SSL_get_servername(s, TLSEXT_NAMETYPE_host_name);
-  if (servername == nullptr) {
-    info->Set(context,
-              env->servername_string(),
-              String::Empty(env->isolate())).FromJust();
-  } else {
-    Local<String> str = OneByteString(env->isolate(), servername,
-                                      strlen(servername));
-    info->Set(context, env->servername_string(), str).FromJust();
-  }
-
-  const bool ocsp = (SSL_get_tlsext_status_type(s) == TLSEXT_STATUSTYPE_ocsp);
-  info->Set(context, env->ocsp_request_string(),
-            Boolean::New(env->isolate(), ocsp)).FromJust();
+    const bool ocsp =
+        (SSL_get_tlsext_status_type(s) == TLSEXT_STATUSTYPE_ocsp);
+    info->Set(context, env->ocsp_request_string(),
+              Boolean::New(env->isolate(), ocsp)).FromJust();
 
-  Local<Value> argv[] = { info };
-  w->MakeCallback(env->oncertcb_string(), arraysize(argv), argv);
+    Local<Value> argv[] = { info };
+    w->MakeCallback(env->oncertcb_string(), arraysize(argv), argv);
+  });
 
   if (!w->cert_cb_running_)
     return 1;
@@ -2607,10 +2902,78 @@ void SSLWrap<Base>::DestroySSL() {
     return;
 
   env_->isolate()->AdjustAmountOfExternalAllocatedMemory(-kExternalSize);
+  deferred_callbacks_.clear();
+
+  // The handshake job waits for the operation, which frees the SSL instead.
+  if (private_key_op_ != nullptr) {
+    private_key_op_->Abandon(std::move(ssl_));
+    private_key_op_ = nullptr;
+    return;
+  }
+
   ssl_.reset();
 }
 
 
+// Advances the handshake with SSL_do_handshake() in SSL_MODE_ASYNC, so that
+// the private key operations of a context with EnableAsyncPrivateKey() run
+// on the threadpool, see node_crypto_async_key.h. Errors are left on the
+// error queue, where the SSL_read() or SSL_write() that follows finds them.
+// Returns false while an operation is pending, or if a JS callback has
+// destroyed the SSL.
+template <class Base>
+bool SSLWrap<Base>::AdvanceAsyncHandshake() {
+  if (!async_private_key_ || SSL_is_init_finished(ssl_.get()))
+    return true;
+
+  if (private_key_op_ != nullptr)
+    return false;
+
+  for (;;) {
+    {
+      AsyncKeyScope scope(env_,
+                          &private_key_op_,
+                          PrivateKeyOperationDone,
+                          static_cast<Base*>(this));
+      SSL_set_mode(ssl_.get(), SSL_MODE_ASYNC);
+      SSL_do_handshake(ssl_.get());
+      // A paused job is resumed by the next call in SSL_MODE_ASYNC.
+      if (!SSL_waiting_for_async(ssl_.get()))
+        SSL_clear_mode(ssl_.get(), SSL_MODE_ASYNC);
+    }
+
+    if (deferred_callbacks_.empty())
+      break;
+
+    std::vector<std::function<void()>> callbacks;
+    callbacks.swap(deferred_callbacks_);
+    for (const auto& callback : callbacks) {
+      if (!ssl_)
+        return false;
+      callback();
+    }
+
+    // The callbacks may have let the handshake continue, for example by
+    // completing the certificate callback synchronously.
+    if (!ssl_ ||
+        private_key_op_ != nullptr ||
+        SSL_is_init_finished(ssl_.get())) {
+      break;
+    }
+  }
+
+  return ssl_ && private_key_op_ == nullptr;
+}
+
+
+template <class Base>
+void SSLWrap<Base>::PrivateKeyOperationDone(void* arg) {
+  Base* w = static_cast<Base*>(arg);
+  w->private_key_op_ = nullptr;
+  w->PrivateKeyOperationDoneCb();
+}
+
+
 template <class Base>
 void SSLWrap<Base>::SetSNIContext(SecureContext* sc) {
   ConfigureSecureContext(sc);
@@ -2703,6 +3066,7 @@ void CipherBase::Initialize(Environment* env, Local<Object> target) {
   env->SetProtoMethod(t, "init", Init);
   env->SetProtoMethod(t, "initiv", InitIv);
   env->SetProtoMethod(t, "update", Update);
+  env->SetProtoMethod(t, "updateInto", UpdateInto);
   env->SetProtoMethod(t, "final", Final);
   env->SetProtoMethod(t, "setAutoPadding", SetAutoPadding);
   env->SetProtoMethodNoSideEffect(t, "getAuthTag", GetAuthTag);
@@ -3118,13 +3482,11 @@ void CipherBase::SetAAD(const FunctionCallbackInfo<Value>& args) {
 }
 
 
-CipherBase::UpdateResult CipherBase::Update(const char* data,
-                                            int len,
-                                            unsigned char** out,
-                                            int* out_len) {
+CipherBase::UpdateResult CipherBase::PrepareUpdate(const char* data,
+                                                   int len,
+                                                   int* buff_len) {
   if (!ctx_)
     return kErrorState;
-  MarkPopErrorOnReturn mark_pop_error_on_return;
 
   const int mode = EVP_CIPHER_CTX_mode(ctx_.get());
 
@@ -3139,22 +3501,29 @@ CipherBase::UpdateResult CipherBase::Update(const char* data,
     CHECK(MaybePassAuthTagToOpenSSL());
   }
 
-  *out_len = 0;
-  int buff_len = len + EVP_CIPHER_CTX_block_size(ctx_.get());
+  *buff_len = len + EVP_CIPHER_CTX_block_size(ctx_.get());
   // For key wrapping algorithms, get output size by calling
   // EVP_CipherUpdate() with null output.
   if (kind_ == kCipher && mode == EVP_CIPH_WRAP_MODE &&
       EVP_CipherUpdate(ctx_.get(),
                        nullptr,
-                       &buff_len,
+                       buff_len,
                        reinterpret_cast<const unsigned char*>(data),
                        len) != 1) {
     return kErrorState;
   }
 
-  *out = Malloc<unsigned char>(buff_len);
+  return kSuccess;
+}
+
+
+CipherBase::UpdateResult CipherBase::DoUpdate(const char* data,
+                                              int len,
+                                              unsigned char* out,
+                                              int buff_len,
+                                              int* out_len) {
   int r = EVP_CipherUpdate(ctx_.get(),
-                           *out,
+                           out,
                            out_len,
                            reinterpret_cast<const unsigned char*>(data),
                            len);
@@ -3163,7 +3532,8 @@ CipherBase::UpdateResult CipherBase::Update(const char* data,
 
   // When in CCM mode, EVP_CipherUpdate will fail if the authentication tag is
   // invalid. In that case, remember the error and throw in final().
-  if (!r && kind_ == kDecipher && mode == EVP_CIPH_CCM_MODE) {
+  if (!r && kind_ == kDecipher &&
+      EVP_CIPHER_CTX_mode(ctx_.get()) == EVP_CIPH_CCM_MODE) {
     pending_auth_failed_ = true;
     return kSuccess;
   }
@@ -3171,6 +3541,47 @@ CipherBase::UpdateResult CipherBase::Update(const char* data,
 }
 
 
+CipherBase::UpdateResult CipherBase::Update(const char* data,
+                                            int len,
+                                            unsigned char** out,
+                                            int* out_len) {
+  MarkPopErrorOnReturn mark_pop_error_on_return;
+
+  *out_len = 0;
+  int buff_len;
+  const UpdateResult r = PrepareUpdate(data, len, &buff_len);
+  if (r != kSuccess)
+    return r;
+
+  *out = Malloc<unsigned char>(buff_len);
+  return DoUpdate(data, len, *out, buff_len, out_len);
+}
+
+
+CipherBase::UpdateResult CipherBase::UpdateInto(const char* data,
+                                                int len,
+                                                unsigned char* out,
+                                                size_t out_size,
+                                                int* out_len) {
+  MarkPopErrorOnReturn mark_pop_error_on_return;
+
+  *out_len = 0;
+  int buff_len;
+  const UpdateResult r = PrepareUpdate(data, len, &buff_len);
+  if (r != kSuccess)
+    return r;
+
+  // OpenSSL may write up to a block more than it was given, and does not know
+  // where the output ends. Ciphers with a block size of 1 never do, so they
+  // can work in place on a buffer of the same size.
+  if (EVP_CIPHER_CTX_block_size(ctx_.get()) == 1)
+    buff_len = len;
+  if (static_cast<size_t>(buff_len) > out_size)
+    return kErrorOutputSize;
+  return DoUpdate(data, len, out, buff_len, out_len);
+}
+
+
 void CipherBase::Update(const FunctionCallbackInfo<Value>& args) {
   Environment* env = Environment::GetCurrent(args);
 
@@ -3211,6 +3622,43 @@ void CipherBase::Update(const FunctionCallbackInfo<Value>& args) {
 }
 
 
+// updateInto(data, output, offset)
+// Writes the output for `data` to `output`, starting at `offset`, and returns
+// the number of bytes written, or -1 if there is not enough room.
+void CipherBase::UpdateInto(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+
+  CipherBase* cipher;
+  ASSIGN_OR_RETURN_UNWRAP(&cipher, args.Holder());
+
+  CHECK(args[0]->IsArrayBufferView());
+  CHECK(args[1]->IsArrayBufferView());
+  CHECK(args[2]->IsUint32());
+  const size_t out_size = Buffer::Length(args[1]);
+  const size_t offset = args[2].As<Uint32>()->Value();
+  CHECK_LE(offset, out_size);
+
+  unsigned char* out =
+      reinterpret_cast<unsigned char*>(Buffer::Data(args[1])) + offset;
+  int out_len = 0;
+  const UpdateResult r = cipher->UpdateInto(Buffer::Data(args[0]),
+                                            Buffer::Length(args[0]),
+                                            out,
+                                            out_size - offset,
+                                            &out_len);
+  if (r == kErrorOutputSize)
+    return args.GetReturnValue().Set(-1);
+  if (r == kErrorState) {
+    return ThrowCryptoError(env, ERR_get_error(),
+                            "Trying to add data in unsupported state");
+  }
+  if (r != kSuccess)
+    return;
+
+  args.GetReturnValue().Set(out_len);
+}
+
+
 bool CipherBase::SetAutoPadding(bool auto_padding) {
   if (!ctx_)
     return false;
@@ -3306,14 +3754,179 @@ void CipherBase::Final(const FunctionCallbackInfo<Value>& args) {
 }
 
 
-void Hmac::Initialize(Environment* env, Local<Object> target) {
-  Local<FunctionTemplate> t = env->NewFunctionTemplate(New);
+// aeadCipher(encrypt, algorithm, key, iv, input, aad, authTag, authTagLength,
+//            output, offset)
+// Encrypts `input` and appends the authentication tag, or decrypts it and
+// verifies `authTag`, in a single call without a CipherBase. The result is
+// written to `output` at `offset`, which must have room for it, and its length
+// is returned. `output` may overlap `input` exactly for in-place operation.
+void AEADCipher(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(args[0]->IsBoolean());  // encrypt
+  CHECK(args[1]->IsString());  // algorithm
+  CHECK(args[2]->IsArrayBufferView());  // key
+  CHECK(args[3]->IsArrayBufferView());  // iv
+  CHECK(args[4]->IsArrayBufferView());  // input
+  CHECK(args[5]->IsArrayBufferView() || args[5]->IsUndefined());  // aad
+  CHECK(args[6]->IsArrayBufferView() || args[6]->IsUndefined());  // authTag
+  CHECK(args[7]->IsUint32());  // authTagLength
+  CHECK(args[8]->IsArrayBufferView());  // output
+  CHECK(args[9]->IsUint32());  // offset
 
-  t->InstanceTemplate()->SetInternalFieldCount(1);
+  MarkPopErrorOnReturn mark_pop_error_on_return;
 
-  env->SetProtoMethod(t, "init", HmacInit);
-  env->SetProtoMethod(t, "update", HmacUpdate);
-  env->SetProtoMethod(t, "digest", HmacDigest);
+  const bool encrypt = args[0]->IsTrue();
+  const node::Utf8Value algorithm(env->isolate(), args[1]);
+  const EVP_CIPHER* cipher = EVP_get_cipherbyname(*algorithm);
+  if (cipher == nullptr)
+    return env->ThrowError("Unknown cipher");
+  if (!IsSupportedAuthenticatedMode(cipher)) {
+    char msg[128];
+    snprintf(msg, sizeof(msg), "%s is not an authenticated cipher",
+             *algorithm);
+    return env->ThrowError(msg);
+  }
+
+  const int mode = EVP_CIPHER_mode(cipher);
+  const size_t input_len = Buffer::Length(args[4]);
+  CHECK_LE(input_len, INT_MAX);
+  unsigned int auth_tag_len = args[7].As<Uint32>()->Value();
+  unsigned char* auth_tag = nullptr;
+  if (!encrypt) {
+    CHECK(args[6]->IsArrayBufferView());
+    auth_tag = reinterpret_cast<unsigned char*>(Buffer::Data(args[6]));
+    auth_tag_len = Buffer::Length(args[6]);
+  }
+
+  const size_t out_len = input_len + (encrypt ? auth_tag_len : 0);
+  const size_t offset = args[9].As<Uint32>()->Value();
+  CHECK_LE(offset, Buffer::Length(args[8]));
+  CHECK_LE(out_len, Buffer::Length(args[8]) - offset);
+
+  // OpenSSL takes a null input or output to mean AAD or the end of the data,
+  // so empty views, which may not have any memory, must not pass one.
+  unsigned char empty[1];
+  const unsigned char* in =
+      reinterpret_cast<const unsigned char*>(Buffer::Data(args[4]));
+  if (in == nullptr)
+    in = empty;
+  unsigned char* out = reinterpret_cast<unsigned char*>(Buffer::Data(args[8]));
+  out = out != nullptr ? out + offset : empty;
+
+  DeleteFnPtr<EVP_CIPHER_CTX, EVP_CIPHER_CTX_free> ctx(EVP_CIPHER_CTX_new());
+  if (!ctx || !EVP_CipherInit_ex(ctx.get(), cipher, nullptr, nullptr, nullptr,
+                                 encrypt)) {
+    return ThrowCryptoError(env, ERR_get_error(),
+                            "Failed to initialize cipher");
+  }
+
+  if (!EVP_CIPHER_CTX_ctrl(ctx.get(), EVP_CTRL_AEAD_SET_IVLEN,
+                           Buffer::Length(args[3]), nullptr)) {
+    return env->ThrowError("Invalid IV length");
+  }
+
+  if (mode == EVP_CIPH_GCM_MODE) {
+    if (!IsValidGCMTagLength(auth_tag_len)) {
+      char msg[50];
+      snprintf(msg, sizeof(msg),
+          "Invalid authentication tag length: %u", auth_tag_len);
+      return env->ThrowError(msg);
+    }
+  } else {
+#ifdef NODE_FIPS_MODE
+    // TODO(tniessen) Support CCM decryption in FIPS mode
+    if (mode == EVP_CIPH_CCM_MODE && !encrypt && FIPS_mode())
+      return env->ThrowError("CCM decryption not supported in FIPS mode");
+#endif
+
+    // Tell OpenSSL about the desired length.
+    if (!EVP_CIPHER_CTX_ctrl(ctx.get(), EVP_CTRL_AEAD_SET_TAG, auth_tag_len,
+                             nullptr)) {
+      char msg[50];
+      snprintf(msg, sizeof(msg),
+          "Invalid authentication tag length: %u", auth_tag_len);
+      return env->ThrowError(msg);
+    }
+
+    if (mode == EVP_CIPH_CCM_MODE) {
+      // Restrict the message length to 2^(8*(15-iv_len))-1 bytes.
+      const size_t iv_len = Buffer::Length(args[3]);
+      CHECK(iv_len >= 7 && iv_len <= 13);
+      if ((iv_len == 12 && input_len > 16777215) ||
+          (iv_len == 13 && input_len > 65535)) {
+        return env->ThrowError("Message exceeds maximum size");
+      }
+    }
+  }
+
+  if (!EVP_CIPHER_CTX_set_key_length(ctx.get(), Buffer::Length(args[2])))
+    return env->ThrowError("Invalid key length");
+
+  if (!EVP_CipherInit_ex(
+          ctx.get(), nullptr, nullptr,
+          reinterpret_cast<const unsigned char*>(Buffer::Data(args[2])),
+          reinterpret_cast<const unsigned char*>(Buffer::Data(args[3])),
+          encrypt)) {
+    return ThrowCryptoError(env, ERR_get_error(),
+                            "Failed to initialize cipher");
+  }
+
+  int len;
+  // When decrypting, OpenSSL needs the authentication tag before the data in
+  // CCM mode, and before EVP_CipherFinal_ex() otherwise.
+  bool ok = encrypt ||
+            EVP_CIPHER_CTX_ctrl(ctx.get(), EVP_CTRL_AEAD_SET_TAG,
+                                auth_tag_len, auth_tag) == 1;
+  // In CCM mode, the message length must be known before the AAD.
+  if (ok && mode == EVP_CIPH_CCM_MODE) {
+    ok = EVP_CipherUpdate(ctx.get(), nullptr, &len, nullptr,
+                          input_len) == 1;
+  }
+  if (ok && args[5]->IsArrayBufferView() && Buffer::Length(args[5]) > 0) {
+    ok = EVP_CipherUpdate(
+        ctx.get(), nullptr, &len,
+        reinterpret_cast<const unsigned char*>(Buffer::Data(args[5])),
+        Buffer::Length(args[5])) == 1;
+  }
+
+  int written = 0;
+  if (ok) {
+    ok = EVP_CipherUpdate(ctx.get(), out, &written, in, input_len) == 1;
+  }
+  // In CCM mode, EVP_CipherUpdate() has already authenticated the data when
+  // decrypting, and EVP_CipherFinal_ex() must not be called.
+  if (ok && !(mode == EVP_CIPH_CCM_MODE && !encrypt)) {
+    ok = EVP_CipherFinal_ex(ctx.get(), out + written, &len) == 1;
+    written += len;
+  }
+
+  if (!ok) {
+    // Do not leave unauthenticated plaintext behind.
+    if (!encrypt)
+      OPENSSL_cleanse(out, input_len);
+    return ThrowCryptoError(env, ERR_get_error(),
+                            "Unsupported state or unable to authenticate data");
+  }
+
+  CHECK_EQ(static_cast<size_t>(written), input_len);
+  if (encrypt) {
+    CHECK_EQ(1, EVP_CIPHER_CTX_ctrl(ctx.get(), EVP_CTRL_AEAD_GET_TAG,
+                                    auth_tag_len, out + written));
+    written += auth_tag_len;
+  }
+
+  args.GetReturnValue().Set(written);
+}
+
+
+void Hmac::Initialize(Environment* env, Local<Object> target) {
+  Local<FunctionTemplate> t = env->NewFunctionTemplate(New);
+
+  t->InstanceTemplate()->SetInternalFieldCount(1);
+
+  env->SetProtoMethod(t, "init", HmacInit);
+  env->SetProtoMethod(t, "update", HmacUpdate);
+  env->SetProtoMethod(t, "digest", HmacDigest);
 
   target->Set(env->context(),
               FIXED_ONE_BYTE_STRING(env->isolate(), "Hmac"),
@@ -3455,8 +4068,28 @@ void Hash::New(const FunctionCallbackInfo<Value>& args) {
 }
 
 
+// EVP_get_digestbyname() takes a global lock and looks the name up in
+// OpenSSL's object table. The EVP_MD structures it returns are static, so the
+// lookups are cached for the lifetime of the process. Unknown names are not
+// cached, which keeps the cache bounded by the number of digests OpenSSL knows.
+static const EVP_MD* GetDigestByName(const char* name) {
+  static Mutex digest_cache_mutex;
+  static std::unordered_map<std::string, const EVP_MD*> digest_cache;
+  Mutex::ScopedLock lock(digest_cache_mutex);
+
+  auto it = digest_cache.find(name);
+  if (it != digest_cache.end())
+    return it->second;
+
+  const EVP_MD* md = EVP_get_digestbyname(name);
+  if (md != nullptr)
+    digest_cache.emplace(name, md);
+  return md;
+}
+
+
 bool Hash::HashInit(const char* hash_type) {
-  const EVP_MD* md = EVP_get_digestbyname(hash_type);
+  const EVP_MD* md = GetDigestByName(hash_type);
   if (md == nullptr)
     return false;
   mdctx_.reset(EVP_MD_CTX_new());
@@ -3534,6 +4167,46 @@ void Hash::HashDigest(const FunctionCallbackInfo<Value>& args) {
 }
 
 
+// TODO(addaleax): If there is an `AsyncWrap`, it currently has no access to
+// this object. This makes proper reporting of memory usage impossible.
+struct CryptoJob : public ThreadPoolWork {
+  Environment* const env;
+  std::unique_ptr<AsyncWrap> async_wrap;
+  inline explicit CryptoJob(Environment* env)
+      : ThreadPoolWork(env, threadpool::QUEUE_TYPE_CRYPTO), env(env) {}
+  inline void AfterThreadPoolWork(int status) final;
+  virtual void AfterThreadPoolWork() = 0;
+  static inline void Run(std::unique_ptr<CryptoJob> job, Local<Value> wrap);
+};
+
+
+void CryptoJob::AfterThreadPoolWork(int status) {
+  CHECK(status == 0 || status == UV_ECANCELED);
+  std::unique_ptr<CryptoJob> job(this);
+  if (status == UV_ECANCELED) return;
+  HandleScope handle_scope(env->isolate());
+  Context::Scope context_scope(env->context());
+  CHECK_EQ(false, async_wrap->persistent().IsWeak());
+  AfterThreadPoolWork();
+}
+
+
+void CryptoJob::Run(std::unique_ptr<CryptoJob> job, Local<Value> wrap) {
+  CHECK(wrap->IsObject());
+  CHECK_EQ(nullptr, job->async_wrap);
+  job->async_wrap.reset(Unwrap<AsyncWrap>(wrap.As<Object>()));
+  CHECK_EQ(false, job->async_wrap->persistent().IsWeak());
+  job->ScheduleWork();
+  job.release();  // Run free, little job!
+}
+
+
+inline void CopyBuffer(Local<Value> buf, std::vector<char>* vec) {
+  vec->clear();
+  if (auto p = Buffer::Data(buf)) vec->assign(p, p + Buffer::Length(buf));
+}
+
+
 SignBase::Error SignBase::Init(const char* sign_type) {
   CHECK_NULL(mdctx_);
   // Historically, "dss1" and "DSS1" were DSA aliases for SHA-1
@@ -3692,20 +4365,14 @@ static MallocedBuffer<unsigned char> Node_SignFinal(EVPMDPointer&& mdctx,
   return MallocedBuffer<unsigned char>();
 }
 
-Sign::SignResult Sign::SignFinal(
-    const char* key_pem,
-    int key_pem_len,
-    const char* passphrase,
-    int padding,
-    int salt_len) {
-  if (!mdctx_)
-    return SignResult(kSignNotInitialised);
-
-  EVPMDPointer mdctx = std::move(mdctx_);
-
+// Parses the PEM-encoded private key that a signature is created with.
+// Returns an empty pointer if the key is invalid or not allowed for signing.
+static EVPKeyPointer ParseSigningKey(const char* key_pem,
+                                     int key_pem_len,
+                                     const char* passphrase) {
   BIOPointer bp(BIO_new_mem_buf(const_cast<char*>(key_pem), key_pem_len));
   if (!bp)
-    return SignResult(kSignPrivateKey);
+    return EVPKeyPointer();
 
   EVPKeyPointer pkey(PEM_read_bio_PrivateKey(bp.get(),
                                              nullptr,
@@ -3716,7 +4383,7 @@ Sign::SignResult Sign::SignFinal(
   // without `pkey` being set to nullptr;
   // cf. the test of `test_bad_rsa_privkey.pem` for an example.
   if (!pkey || 0 != ERR_peek_error())
-    return SignResult(kSignPrivateKey);
+    return EVPKeyPointer();
 
 #ifdef NODE_FIPS_MODE
   /* Validate DSA2 parameters from FIPS 186-4 */
@@ -3735,11 +4402,40 @@ Sign::SignResult Sign::SignFinal(
       result = true;
 
     if (!result) {
-      return kSignPrivateKey;
+      return EVPKeyPointer();
     }
   }
 #endif  // NODE_FIPS_MODE
 
+  return pkey;
+}
+
+
+Sign::SignResult Sign::SignFinal(
+    const char* key_pem,
+    int key_pem_len,
+    const char* passphrase,
+    int padding,
+    int salt_len) {
+  if (!mdctx_)
+    return SignResult(kSignNotInitialised);
+
+  return SignFinal(std::move(mdctx_), key_pem, key_pem_len, passphrase,
+                   padding, salt_len);
+}
+
+
+Sign::SignResult Sign::SignFinal(
+    EVPMDPointer&& mdctx,
+    const char* key_pem,
+    int key_pem_len,
+    const char* passphrase,
+    int padding,
+    int salt_len) {
+  EVPKeyPointer pkey = ParseSigningKey(key_pem, key_pem_len, passphrase);
+  if (!pkey)
+    return SignResult(kSignPrivateKey);
+
   MallocedBuffer<unsigned char> buffer =
       Node_SignFinal(std::move(mdctx), pkey, padding, salt_len);
   Error error = buffer.is_empty() ? kSignPrivateKey : kSignOk;
@@ -3747,12 +4443,96 @@ Sign::SignResult Sign::SignFinal(
 }
 
 
+// Captures the OpenSSL errors of an operation that failed on the threadpool,
+// so that they can be passed to JS as an exception later. `fallback` becomes
+// the message if OpenSSL did not report anything, like CheckThrow() does.
+static void CaptureErrors(CryptoErrorVector* errors, const char* fallback) {
+  errors->Capture();
+  if (errors->empty() && fallback != nullptr)
+    errors->push_back(fallback);
+}
+
+
+struct SignJob : public CryptoJob {
+  EVPMDPointer mdctx;
+  std::vector<char> key;
+  std::vector<char> passphrase;  // Empty if there is none.
+  int padding;
+  int salt_len;
+  MallocedBuffer<unsigned char> signature;
+  CryptoErrorVector errors;
+
+  inline explicit SignJob(Environment* env) : CryptoJob(env) {}
+
+  inline ~SignJob() override {
+    OPENSSL_cleanse(passphrase.data(), passphrase.size());
+  }
+
+  inline void DoThreadPoolWork() override {
+    // Other work on this thread may have left errors behind.
+    ERR_clear_error();
+    ClearErrorOnReturn clear_error_on_return;
+    Sign::SignResult ret = Sign::SignFinal(
+        std::move(mdctx),
+        key.data(),
+        key.size(),
+        passphrase.empty() ? nullptr : passphrase.data(),
+        padding,
+        salt_len);
+    if (ret.error != SignBase::kSignOk)
+      return CaptureErrors(&errors, "PEM_read_bio_PrivateKey failed");
+    signature = std::move(ret.signature);
+  }
+
+  inline void AfterThreadPoolWork() override {
+    Local<Value> argv[] = {
+      Undefined(env->isolate()),
+      Undefined(env->isolate())
+    };
+    if (!errors.empty()) {
+      argv[0] = errors.ToException(env);
+    } else {
+      argv[1] = Buffer::New(env,
+                            reinterpret_cast<char*>(signature.release()),
+                            signature.size).ToLocalChecked();
+    }
+    async_wrap->MakeCallback(env->ondone_string(), arraysize(argv), argv);
+  }
+};
+
+
+// Copies a passphrase argument, which is null if there is none, into a
+// NUL-terminated buffer that a job can use on the threadpool.
+static void CopyPassphrase(Environment* env,
+                           Local<Value> value,
+                           std::vector<char>* passphrase) {
+  if (value->IsNull() || value->IsUndefined())
+    return;
+  node::Utf8Value utf8(env->isolate(), value);
+  passphrase->assign(*utf8, *utf8 + utf8.length() + 1);
+}
+
+
 void Sign::SignFinal(const FunctionCallbackInfo<Value>& args) {
   Environment* env = Environment::GetCurrent(args);
 
   Sign* sign;
   ASSIGN_OR_RETURN_UNWRAP(&sign, args.Holder());
 
+  if (args[4]->IsObject()) {  // Wrap object.
+    if (!sign->mdctx_)
+      return sign->CheckThrow(kSignNotInitialised);
+    CHECK(args[2]->IsInt32());
+    CHECK(args[3]->IsInt32());
+    std::unique_ptr<SignJob> job(new SignJob(env));
+    job->mdctx = std::move(sign->mdctx_);
+    CopyBuffer(args[0], &job->key);
+    CopyPassphrase(env, args[1], &job->passphrase);
+    job->padding = args[2].As<Int32>()->Value();
+    job->salt_len = args[3].As<Int32>()->Value();
+    return SignJob::Run(std::move(job), args[4]);
+  }
+
   unsigned int len = args.Length();
 
   node::Utf8Value passphrase(env->isolate(), args[1]);
@@ -3787,6 +4567,117 @@ void Sign::SignFinal(const FunctionCallbackInfo<Value>& args) {
   args.GetReturnValue().Set(rc);
 }
 
+struct SignBatchJob : public CryptoJob {
+  const EVP_MD* md;
+  std::vector<char> key;
+  std::vector<char> passphrase;  // Empty if there is none.
+  int padding;
+  int salt_len;
+  std::vector<std::vector<char>> payloads;
+  std::vector<MallocedBuffer<unsigned char>> signatures;
+  CryptoErrorVector errors;
+
+  inline explicit SignBatchJob(Environment* env) : CryptoJob(env) {}
+
+  inline ~SignBatchJob() override {
+    OPENSSL_cleanse(passphrase.data(), passphrase.size());
+  }
+
+  inline void DoThreadPoolWork() override {
+    // Other work on this thread may have left errors behind.
+    ERR_clear_error();
+    ClearErrorOnReturn clear_error_on_return;
+
+    // The key is only parsed once for all of the payloads.
+    EVPKeyPointer pkey = ParseSigningKey(
+        key.data(),
+        key.size(),
+        passphrase.empty() ? nullptr : passphrase.data());
+    if (!pkey)
+      return CaptureErrors(&errors, "PEM_read_bio_PrivateKey failed");
+
+    signatures.reserve(payloads.size());
+    for (const std::vector<char>& payload : payloads) {
+      EVPMDPointer mdctx(EVP_MD_CTX_new());
+      if (!mdctx ||
+          !EVP_DigestInit_ex(mdctx.get(), md, nullptr) ||
+          !EVP_DigestUpdate(mdctx.get(), payload.data(), payload.size())) {
+        return CaptureErrors(&errors, "EVP_SignUpdate failed");
+      }
+      MallocedBuffer<unsigned char> signature =
+          Node_SignFinal(std::move(mdctx), pkey, padding, salt_len);
+      if (signature.is_empty())
+        return CaptureErrors(&errors, "PEM_read_bio_PrivateKey failed");
+      signatures.emplace_back(std::move(signature));
+    }
+  }
+
+  inline void AfterThreadPoolWork() override {
+    Local<Value> argv[] = {
+      Undefined(env->isolate()),
+      Undefined(env->isolate())
+    };
+    if (!errors.empty()) {
+      argv[0] = errors.ToException(env);
+    } else {
+      Local<Array> results = Array::New(env->isolate(), signatures.size());
+      for (size_t i = 0; i < signatures.size(); i++) {
+        MallocedBuffer<unsigned char>& signature = signatures[i];
+        Local<Object> buffer =
+            Buffer::New(env,
+                        reinterpret_cast<char*>(signature.release()),
+                        signature.size).ToLocalChecked();
+        results->Set(env->context(), i, buffer).FromJust();
+      }
+      argv[1] = results;
+    }
+    async_wrap->MakeCallback(env->ondone_string(), arraysize(argv), argv);
+  }
+};
+
+
+// signBatch(algorithm, key, passphrase, padding, saltLength, payloads, wrap)
+// Signs every buffer in `payloads` with the same private key, in a single
+// job on the threadpool.
+void SignBatch(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(args[0]->IsString());  // algorithm
+  CHECK(args[1]->IsArrayBufferView());  // key
+  CHECK(args[3]->IsInt32());  // padding
+  CHECK(args[4]->IsInt32());  // saltLength
+  CHECK(args[5]->IsArray());  // payloads
+  CHECK(args[6]->IsObject());  // wrap object
+
+  node::Utf8Value algorithm(env->isolate(), args[0]);
+  const char* sign_type = *algorithm;
+  // Historically, "dss1" and "DSS1" were DSA aliases for SHA-1, see
+  // SignBase::Init().
+  if (strcmp(sign_type, "dss1") == 0 || strcmp(sign_type, "DSS1") == 0)
+    sign_type = "SHA1";
+
+  std::unique_ptr<SignBatchJob> job(new SignBatchJob(env));
+  job->md = GetDigestByName(sign_type);
+  if (job->md == nullptr)
+    return env->ThrowError("Unknown message digest");
+  CopyBuffer(args[1], &job->key);
+  CopyPassphrase(env, args[2], &job->passphrase);
+  job->padding = args[3].As<Int32>()->Value();
+  job->salt_len = args[4].As<Int32>()->Value();
+
+  Local<Array> payloads = args[5].As<Array>();
+  job->payloads.resize(payloads->Length());
+  for (uint32_t i = 0; i < payloads->Length(); i++) {
+    Local<Value> payload;
+    if (!payloads->Get(env->context(), i).ToLocal(&payload))
+      return;
+    CHECK(payload->IsArrayBufferView());
+    CopyBuffer(payload, &job->payloads[i]);
+  }
+
+  SignBatchJob::Run(std::move(job), args[6]);
+}
+
+
 enum ParsePublicKeyResult {
   kParsePublicOk,
   kParsePublicNotRecognized,
@@ -3906,11 +4797,23 @@ SignBase::Error Verify::VerifyFinal(const char* key_pem,
   if (!mdctx_)
     return kSignNotInitialised;
 
+  return VerifyFinal(std::move(mdctx_), key_pem, key_pem_len, sig, siglen,
+                     padding, saltlen, verify_result);
+}
+
+
+SignBase::Error Verify::VerifyFinal(EVPMDPointer&& mdctx,
+                                    const char* key_pem,
+                                    int key_pem_len,
+                                    const char* sig,
+                                    int siglen,
+                                    int padding,
+                                    int saltlen,
+                                    bool* verify_result) {
   EVPKeyPointer pkey;
   unsigned char m[EVP_MAX_MD_SIZE];
   unsigned int m_len;
   *verify_result = false;
-  EVPMDPointer mdctx = std::move(mdctx_);
 
   if (ParsePublicKey(&pkey, key_pem, key_pem_len) != kParsePublicOk)
     return kSignPublicKey;
@@ -3936,12 +4839,67 @@ SignBase::Error Verify::VerifyFinal(const char* key_pem,
 }
 
 
+struct VerifyJob : public CryptoJob {
+  EVPMDPointer mdctx;
+  std::vector<char> key;
+  std::vector<char> signature;
+  int padding;
+  int salt_len;
+  bool verify_result = false;
+  CryptoErrorVector errors;
+
+  inline explicit VerifyJob(Environment* env) : CryptoJob(env) {}
+
+  inline void DoThreadPoolWork() override {
+    // Other work on this thread may have left errors behind.
+    ERR_clear_error();
+    ClearErrorOnReturn clear_error_on_return;
+    SignBase::Error err = Verify::VerifyFinal(std::move(mdctx),
+                                              key.data(),
+                                              key.size(),
+                                              signature.data(),
+                                              signature.size(),
+                                              padding,
+                                              salt_len,
+                                              &verify_result);
+    if (err != SignBase::kSignOk)
+      CaptureErrors(&errors, "PEM_read_bio_PUBKEY failed");
+  }
+
+  inline void AfterThreadPoolWork() override {
+    Local<Value> argv[] = {
+      Undefined(env->isolate()),
+      Undefined(env->isolate())
+    };
+    if (!errors.empty())
+      argv[0] = errors.ToException(env);
+    else
+      argv[1] = Boolean::New(env->isolate(), verify_result);
+    async_wrap->MakeCallback(env->ondone_string(), arraysize(argv), argv);
+  }
+};
+
+
 void Verify::VerifyFinal(const FunctionCallbackInfo<Value>& args) {
   ClearErrorOnReturn clear_error_on_return;
 
   Verify* verify;
   ASSIGN_OR_RETURN_UNWRAP(&verify, args.Holder());
 
+  if (args[4]->IsObject()) {  // Wrap object.
+    if (!verify->mdctx_)
+      return verify->CheckThrow(kSignNotInitialised);
+    CHECK(args[2]->IsInt32());
+    CHECK(args[3]->IsInt32());
+    std::unique_ptr<VerifyJob> job(new VerifyJob(verify->env()));
+    job->mdctx = std::move(verify->mdctx_);
+    CopyBuffer(args[0], &job->key);
+    CopyBuffer(args[1], &job->signature);
+    job->padding = args[2].As<Int32>()->Value();
+    job->salt_len = args[3].As<Int32>()->Value();
+    return VerifyJob::Run(std::move(job), args[4]);
+  }
+
   char* kbuf = Buffer::Data(args[0]);
   ssize_t klen = Buffer::Length(args[0]);
 
@@ -4016,6 +4974,63 @@ bool PublicKeyCipher::Cipher(const char* key_pem,
 }
 
 
+template <PublicKeyCipher::Operation operation,
+          PublicKeyCipher::EVP_PKEY_cipher_init_t EVP_PKEY_cipher_init,
+          PublicKeyCipher::EVP_PKEY_cipher_t EVP_PKEY_cipher>
+struct PublicKeyCipherJob : public CryptoJob {
+  std::vector<char> key;
+  std::vector<char> passphrase;  // Empty if there is none.
+  int padding;
+  std::vector<char> data;
+  unsigned char* out = nullptr;
+  size_t out_len = 0;
+  CryptoErrorVector errors;
+
+  inline explicit PublicKeyCipherJob(Environment* env) : CryptoJob(env) {}
+
+  inline ~PublicKeyCipherJob() override {
+    OPENSSL_cleanse(passphrase.data(), passphrase.size());
+    free(out);
+  }
+
+  inline void DoThreadPoolWork() override {
+    // Other work on this thread may have left errors behind.
+    ERR_clear_error();
+    ClearErrorOnReturn clear_error_on_return;
+    bool r = PublicKeyCipher::Cipher<operation,
+                                     EVP_PKEY_cipher_init,
+                                     EVP_PKEY_cipher>(
+        key.data(),
+        key.size(),
+        passphrase.empty() ? nullptr : passphrase.data(),
+        padding,
+        reinterpret_cast<const unsigned char*>(data.data()),
+        data.size(),
+        &out,
+        &out_len);
+    if (!r)
+      CaptureErrors(&errors, nullptr);
+  }
+
+  inline void AfterThreadPoolWork() override {
+    Local<Value> argv[] = {
+      Undefined(env->isolate()),
+      Undefined(env->isolate())
+    };
+    if (!errors.empty()) {
+      argv[0] = errors.ToException(env);
+    } else if (out_len == 0) {
+      argv[1] = Buffer::New(env, 0).ToLocalChecked();
+    } else {
+      argv[1] = Buffer::New(env, reinterpret_cast<char*>(out), out_len)
+          .ToLocalChecked();
+      out = nullptr;
+    }
+    async_wrap->MakeCallback(env->ondone_string(), arraysize(argv), argv);
+  }
+};
+
+
 template <PublicKeyCipher::Operation operation,
           PublicKeyCipher::EVP_PKEY_cipher_init_t EVP_PKEY_cipher_init,
           PublicKeyCipher::EVP_PKEY_cipher_t EVP_PKEY_cipher>
@@ -4033,6 +5048,18 @@ void PublicKeyCipher::Cipher(const FunctionCallbackInfo<Value>& args) {
   uint32_t padding;
   if (!args[2]->Uint32Value(env->context()).To(&padding)) return;
 
+  if (args[4]->IsObject()) {  // Wrap object.
+    using Job = PublicKeyCipherJob<operation,
+                                   EVP_PKEY_cipher_init,
+                                   EVP_PKEY_cipher>;
+    std::unique_ptr<Job> job(new Job(env));
+    CopyBuffer(args[0], &job->key);
+    CopyPassphrase(env, args[3], &job->passphrase);
+    job->padding = padding;
+    CopyBuffer(args[1], &job->data);
+    return Job::Run(std::move(job), args[4]);
+  }
+
   String::Utf8Value passphrase(args.GetIsolate(), args[3]);
 
   unsigned char* out_value = nullptr;
@@ -4689,45 +5716,6 @@ bool ECDH::IsKeyPairValid() {
 }
 
 
-// TODO(addaleax): If there is an `AsyncWrap`, it currently has no access to
-// this object. This makes proper reporting of memory usage impossible.
-struct CryptoJob : public ThreadPoolWork {
-  Environment* const env;
-  std::unique_ptr<AsyncWrap> async_wrap;
-  inline explicit CryptoJob(Environment* env) : ThreadPoolWork(env), env(env) {}
-  inline void AfterThreadPoolWork(int status) final;
-  virtual void AfterThreadPoolWork() = 0;
-  static inline void Run(std::unique_ptr<CryptoJob> job, Local<Value> wrap);
-};
-
-
-void CryptoJob::AfterThreadPoolWork(int status) {
-  CHECK(status == 0 || status == UV_ECANCELED);
-  std::unique_ptr<CryptoJob> job(this);
-  if (status == UV_ECANCELED) return;
-  HandleScope handle_scope(env->isolate());
-  Context::Scope context_scope(env->context());
-  CHECK_EQ(false, async_wrap->persistent().IsWeak());
-  AfterThreadPoolWork();
-}
-
-
-void CryptoJob::Run(std::unique_ptr<CryptoJob> job, Local<Value> wrap) {
-  CHECK(wrap->IsObject());
-  CHECK_EQ(nullptr, job->async_wrap);
-  job->async_wrap.reset(Unwrap<AsyncWrap>(wrap.As<Object>()));
-  CHECK_EQ(false, job->async_wrap->persistent().IsWeak());
-  job->ScheduleWork();
-  job.release();  // Run free, little job!
-}
-
-
-inline void CopyBuffer(Local<Value> buf, std::vector<char>* vec) {
-  vec->clear();
-  if (auto p = Buffer::Data(buf)) vec->assign(p, p + Buffer::Length(buf));
-}
-
-
 struct RandomBytesJob : public CryptoJob {
   unsigned char* data;
   size_t size;
@@ -4935,6 +5923,524 @@ void Scrypt(const FunctionCallbackInfo<Value>& args) {
 #endif  // OPENSSL_NO_SCRYPT
 
 
+// A batch of PBKDF2 or scrypt derivations with the same parameters, spread
+// over the dedicated threads of the kdf queue. Every thread runs a
+// KDFBatchWork that takes tasks from the batch until none are left, and the
+// last one to finish calls back into JS. A task is one derivation or, when
+// there are fewer scrypt derivations than threads, one of their lanes.
+struct KDFBatchJob {
+  enum Algorithm { kPBKDF2, kScrypt };
+
+  struct Item {
+    std::vector<char> pass;
+    std::vector<char> salt;
+#ifndef OPENSSL_NO_SCRYPT
+    std::unique_ptr<ScryptLanes> lanes;
+    std::atomic<uint32_t> lanes_left { 0 };
+#endif  // OPENSSL_NO_SCRYPT
+
+    inline ~Item() {
+      Cleanse();
+    }
+
+    inline void Cleanse() {
+      OPENSSL_cleanse(pass.data(), pass.size());
+      OPENSSL_cleanse(salt.data(), salt.size());
+      pass.clear();
+      salt.clear();
+    }
+  };
+
+  Environment* const env;
+  std::unique_ptr<AsyncWrap> async_wrap;
+  const Algorithm algorithm;
+  unsigned char* keybuf_data = nullptr;
+  size_t keylen = 0;
+  std::unique_ptr<Item[]> items;
+  size_t item_count = 0;
+  // PBKDF2
+  uint32_t iteration_count;
+  const EVP_MD* digest;
+  // scrypt
+  uint32_t N;
+  uint32_t r;
+  uint32_t p;
+  uint32_t maxmem;
+  bool split_lanes = false;
+
+  size_t task_count = 0;
+  // The number of tasks that may run at the same time.
+  size_t max_concurrency = std::numeric_limits<size_t>::max();
+  std::atomic<size_t> next_task { 0 };
+  std::atomic<bool> failed { false };
+  Mutex errors_mutex;
+  CryptoErrorVector errors;
+  // Only accessed on the event loop thread.
+  size_t pending_work = 0;
+  bool cancelled = false;
+
+  inline KDFBatchJob(Environment* env, Algorithm algorithm)
+      : env(env), algorithm(algorithm) {}
+
+  // Copies the passwords and salts, and divides `keybuf` into one key per
+  // pair of them.
+  inline bool Init(Local<Value> keybuf,
+                   Local<Value> passwords,
+                   Local<Value> salts) {
+    Local<Array> pass_array = passwords.As<Array>();
+    Local<Array> salt_array = salts.As<Array>();
+    item_count = pass_array->Length();
+    CHECK_EQ(salt_array->Length(), item_count);
+    if (item_count == 0)
+      return true;
+    CHECK_EQ(Buffer::Length(keybuf) % item_count, 0);
+    keybuf_data = reinterpret_cast<unsigned char*>(Buffer::Data(keybuf));
+    keylen = Buffer::Length(keybuf) / item_count;
+    items.reset(new Item[item_count]);
+    for (uint32_t i = 0; i < item_count; i++) {
+      Local<Value> pass;
+      Local<Value> salt;
+      if (!pass_array->Get(env->context(), i).ToLocal(&pass) ||
+          !salt_array->Get(env->context(), i).ToLocal(&salt)) {
+        return false;
+      }
+      CHECK(pass->IsArrayBufferView());
+      CHECK(salt->IsArrayBufferView());
+      CopyBuffer(pass, &items[i].pass);
+      CopyBuffer(salt, &items[i].salt);
+    }
+    task_count = item_count;
+    return true;
+  }
+
+  inline void RunTasks() {
+    // Other work on this thread may have left errors behind.
+    ERR_clear_error();
+    ClearErrorOnReturn clear_error_on_return;
+
+    for (;;) {
+      const size_t task = next_task++;
+      if (task >= task_count || failed)
+        return;
+      if (!RunTask(task)) {
+        Mutex::ScopedLock lock(errors_mutex);
+        if (!failed.exchange(true))
+          errors.Capture();
+        return;
+      }
+    }
+  }
+
+  inline bool RunTask(size_t task) {
+#ifndef OPENSSL_NO_SCRYPT
+    if (split_lanes)
+      return RunLane(&items[task / p], task / p, task % p);
+#endif  // OPENSSL_NO_SCRYPT
+
+    Item* item = &items[task];
+    auto salt_data = reinterpret_cast<const unsigned char*>(item->salt.data());
+    unsigned char* key = keybuf_data + task * keylen;
+    bool ok = false;
+    if (algorithm == kPBKDF2) {
+      ok = PKCS5_PBKDF2_HMAC(item->pass.data(), item->pass.size(),
+                             salt_data, item->salt.size(),
+                             iteration_count, digest, keylen, key);
+#ifndef OPENSSL_NO_SCRYPT
+    } else {
+      ok = EVP_PBE_scrypt(item->pass.data(), item->pass.size(),
+                          salt_data, item->salt.size(),
+                          N, r, p, maxmem, key, keylen) == 1;
+#endif  // OPENSSL_NO_SCRYPT
+    }
+    item->Cleanse();
+    return ok;
+  }
+
+#ifndef OPENSSL_NO_SCRYPT
+  // Every lane allocates its own scratch space, which EVP_PBE_scrypt() would
+  // allocate only once. Returns how many lanes can run at the same time
+  // while the blocks of all derivations and the scratch space of those lanes
+  // stay within `maxmem`.
+  inline size_t MaxConcurrentLanes() const {
+    // EVP_PBE_scrypt() uses SCRYPT_MAX_MEM when maxmem is 0.
+    const uint64_t limit = maxmem != 0 ? maxmem : 32 * 1024 * 1024;
+    const uint64_t blocks_size =
+        static_cast<uint64_t>(128) * r * p * item_count;
+    const uint64_t lane_size = static_cast<uint64_t>(128) * r * (N + 2ULL);
+    if (blocks_size >= limit)
+      return 0;
+    return static_cast<size_t>(std::min<uint64_t>(
+        (limit - blocks_size) / lane_size, std::numeric_limits<size_t>::max()));
+  }
+
+  // Spreads the lanes of every scrypt derivation over the threads. The
+  // blocks that the lanes mix are prepared right away, which is cheap
+  // compared to mixing them.
+  inline bool SplitLanes() {
+    split_lanes = true;
+    task_count = item_count * p;
+    for (size_t i = 0; i < item_count; i++) {
+      Item* item = &items[i];
+      item->lanes.reset(new ScryptLanes(N, r, p));
+      item->lanes_left = p;
+      if (!item->lanes->Init(item->pass.data(), item->pass.size(),
+                             reinterpret_cast<const unsigned char*>(
+                                 item->salt.data()),
+                             item->salt.size())) {
+        errors.Capture();
+        return false;
+      }
+      // Only the password is needed to finish the derivation.
+      OPENSSL_cleanse(item->salt.data(), item->salt.size());
+    }
+    return true;
+  }
+
+  inline bool RunLane(Item* item, size_t index, uint32_t lane) {
+    if (!item->lanes->RunLane(lane))
+      return false;
+    if (--item->lanes_left != 0)
+      return true;
+    // The last lane to finish derives the key.
+    const bool ok = item->lanes->Finish(item->pass.data(), item->pass.size(),
+                                        keybuf_data + index * keylen, keylen);
+    item->lanes.reset();
+    item->Cleanse();
+    return ok;
+  }
+#endif  // OPENSSL_NO_SCRYPT
+
+  inline void AfterWork(int status) {
+    CHECK(status == 0 || status == UV_ECANCELED);
+    if (status == UV_ECANCELED)
+      cancelled = true;
+    if (--pending_work > 0)
+      return;
+    std::unique_ptr<KDFBatchJob> job(this);
+    if (cancelled) return;
+    HandleScope handle_scope(env->isolate());
+    Context::Scope context_scope(env->context());
+    CHECK_EQ(false, async_wrap->persistent().IsWeak());
+    Local<Value> arg = ToResult();
+    async_wrap->MakeCallback(env->ondone_string(), 1, &arg);
+  }
+
+  // undefined if every key has been derived, otherwise the error, or null
+  // if OpenSSL did not report one.
+  inline Local<Value> ToResult() const {
+    if (!failed) return Undefined(env->isolate());
+    if (errors.empty()) return Null(env->isolate());
+    return errors.ToException(env);
+  }
+
+  static inline void Run(std::unique_ptr<KDFBatchJob> job, Local<Value> wrap);
+};
+
+
+// One thread's share of a KDFBatchJob.
+class KDFBatchWork : public ThreadPoolWork {
+ public:
+  explicit KDFBatchWork(KDFBatchJob* job)
+      : ThreadPoolWork(job->env, threadpool::QUEUE_TYPE_KDF), job_(job) {}
+
+  void DoThreadPoolWork() override {
+    job_->RunTasks();
+  }
+
+  void AfterThreadPoolWork(int status) override {
+    std::unique_ptr<KDFBatchWork> self(this);
+    job_->AfterWork(status);
+  }
+
+ private:
+  KDFBatchJob* const job_;
+};
+
+
+void KDFBatchJob::Run(std::unique_ptr<KDFBatchJob> job, Local<Value> wrap) {
+  CHECK(wrap->IsObject());
+  job->async_wrap.reset(Unwrap<AsyncWrap>(wrap.As<Object>()));
+  CHECK_EQ(false, job->async_wrap->persistent().IsWeak());
+  CHECK_GT(job->task_count, 0);
+  job->pending_work = std::min<size_t>(
+      {static_cast<size_t>(
+           threadpool::QueueThreads(threadpool::QUEUE_TYPE_KDF)),
+       job->task_count, job->max_concurrency});
+  for (size_t i = 0; i < job->pending_work; i++)
+    (new KDFBatchWork(job.get()))->ScheduleWork();
+  job.release();
+}
+
+
+// pbkdf2Batch(keybuf, passwords, salts, iteration_count, digest_name, wrap)
+void PBKDF2Batch(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(args[0]->IsArrayBufferView());  // keybuf; wrap object retains ref.
+  CHECK(args[1]->IsArray());  // passwords
+  CHECK(args[2]->IsArray());  // salts
+  CHECK(args[3]->IsUint32());  // iteration_count
+  CHECK(args[4]->IsString());  // digest_name
+  // wrap object, undefined for an empty batch
+  CHECK(args[5]->IsObject() || args[5]->IsUndefined());
+  std::unique_ptr<KDFBatchJob> job(
+      new KDFBatchJob(env, KDFBatchJob::kPBKDF2));
+  job->iteration_count = args[3].As<Uint32>()->Value();
+  Utf8Value digest_name(args.GetIsolate(), args[4]);
+  job->digest = EVP_get_digestbyname(*digest_name);
+  if (job->digest == nullptr) return args.GetReturnValue().Set(-1);
+  // An empty batch is only validated.
+  if (!job->Init(args[0], args[1], args[2]) || job->item_count == 0) return;
+  KDFBatchJob::Run(std::move(job), args[5]);
+}
+
+
+#ifndef OPENSSL_NO_SCRYPT
+// scryptBatch(keybuf, passwords, salts, N, r, p, maxmem, wrap)
+void ScryptBatch(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(args[0]->IsArrayBufferView());  // keybuf; wrap object retains ref.
+  CHECK(args[1]->IsArray());  // passwords
+  CHECK(args[2]->IsArray());  // salts
+  CHECK(args[3]->IsUint32());  // N
+  CHECK(args[4]->IsUint32());  // r
+  CHECK(args[5]->IsUint32());  // p
+  CHECK(args[6]->IsUint32());  // maxmem
+  // wrap object, undefined for an empty batch
+  CHECK(args[7]->IsObject() || args[7]->IsUndefined());
+  std::unique_ptr<KDFBatchJob> job(
+      new KDFBatchJob(env, KDFBatchJob::kScrypt));
+  job->N = args[3].As<Uint32>()->Value();
+  job->r = args[4].As<Uint32>()->Value();
+  job->p = args[5].As<Uint32>()->Value();
+  job->maxmem = args[6].As<Uint32>()->Value();
+  // Like Scrypt(), return null for invalid parameters that OpenSSL did not
+  // report an error for.
+  if (1 != EVP_PBE_scrypt(nullptr, 0, nullptr, 0, job->N, job->r, job->p,
+                          job->maxmem, nullptr, 0)) {
+    job->errors.Capture();
+    job->failed = true;
+    return args.GetReturnValue().Set(job->ToResult());
+  }
+  if (!job->Init(args[0], args[1], args[2]) || job->item_count == 0) return;
+  // A single derivation with several lanes would otherwise leave all but one
+  // thread idle. Only as many lanes run at once as fit into maxmem together.
+  const size_t threads = threadpool::QueueThreads(threadpool::QUEUE_TYPE_KDF);
+  const size_t lanes = job->MaxConcurrentLanes();
+  if (job->p > 1 && job->item_count < threads && lanes > 1) {
+    job->max_concurrency = lanes;
+    if (!job->SplitLanes()) {
+      job->failed = true;
+      return args.GetReturnValue().Set(job->ToResult());
+    }
+  }
+  KDFBatchJob::Run(std::move(job), args[7]);
+}
+#endif  // OPENSSL_NO_SCRYPT
+
+
+struct HashJob : public CryptoJob {
+  const EVP_MD* md;
+  enum encoding encoding;
+  const char* data = nullptr;
+  size_t size = 0;
+  unsigned char md_value[EVP_MAX_MD_SIZE];
+  unsigned int md_len = 0;
+  CryptoErrorVector errors;
+
+  inline HashJob(Environment* env, const EVP_MD* md, enum encoding encoding)
+      : CryptoJob(env), md(md), encoding(encoding) {}
+
+  inline void DoThreadPoolWork() override {
+    // The job may have failed before it was started.
+    if (!errors.empty())
+      return;
+    if (1 != EVP_Digest(data, size, md_value, &md_len, md, nullptr))
+      Fail("Failed to compute the digest");
+  }
+
+  inline void AfterThreadPoolWork() override {
+    Local<Value> argv[2];
+    ToResult(&argv[0], &argv[1]);
+    async_wrap->MakeCallback(env->ondone_string(), arraysize(argv), argv);
+  }
+
+  // Records the OpenSSL error, or `message` if OpenSSL did not report one.
+  inline void Fail(const char* message) {
+    errors.Capture();
+    if (errors.empty())
+      errors.push_back(message);
+  }
+
+  // Sets `*err` to the exception if the digest could not be computed, and
+  // `*result` to the encoded digest otherwise. The other one is undefined.
+  inline virtual void ToResult(Local<Value>* err, Local<Value>* result) const {
+    *err = Undefined(env->isolate());
+    *result = Undefined(env->isolate());
+    if (!errors.empty()) {
+      *err = errors.ToException(env);
+      return;
+    }
+    Local<Value> error;
+    if (!StringBytes::Encode(env->isolate(),
+                             reinterpret_cast<const char*>(md_value),
+                             md_len,
+                             encoding,
+                             &error).ToLocal(result)) {
+      CHECK(!error.IsEmpty());
+      *err = error;
+      *result = Undefined(env->isolate());
+    }
+  }
+};
+
+
+// Reads the file in chunks of this size while hashing it.
+static constexpr size_t kHashFileChunkSize = 64 * 1024;
+
+struct HashFileJob : public HashJob {
+  std::string path;
+  int uv_error = 0;
+  const char* syscall = nullptr;
+
+  inline HashFileJob(Environment* env,
+                     const EVP_MD* md,
+                     enum encoding encoding,
+                     std::string&& path)
+      : HashJob(env, md, encoding), path(std::move(path)) {}
+
+  inline void DoThreadPoolWork() override {
+    if (!errors.empty())
+      return;
+    EVPMDPointer mdctx(EVP_MD_CTX_new());
+    if (!mdctx || EVP_DigestInit_ex(mdctx.get(), md, nullptr) <= 0) {
+      Fail("Failed to initialize the digest");
+      return;
+    }
+
+    uv_fs_t req;
+    const int fd = uv_fs_open(nullptr, &req, path.c_str(), O_RDONLY, 0,
+                              nullptr);
+    uv_fs_req_cleanup(&req);
+    if (fd < 0) {
+      uv_error = fd;
+      syscall = "open";
+      return;
+    }
+
+    std::unique_ptr<char[]> chunk(new char[kHashFileChunkSize]);
+    for (;;) {
+      uv_buf_t buf = uv_buf_init(chunk.get(), kHashFileChunkSize);
+      const int nread = uv_fs_read(nullptr, &req, fd, &buf, 1, -1, nullptr);
+      uv_fs_req_cleanup(&req);
+      if (nread < 0) {
+        uv_error = nread;
+        syscall = "read";
+        break;
+      }
+      if (nread == 0)
+        break;
+      if (EVP_DigestUpdate(mdctx.get(), chunk.get(), nread) <= 0) {
+        Fail("Failed to update the digest");
+        break;
+      }
+    }
+
+    uv_fs_close(nullptr, &req, fd, nullptr);
+    uv_fs_req_cleanup(&req);
+
+    if (uv_error == 0 && errors.empty() &&
+        EVP_DigestFinal_ex(mdctx.get(), md_value, &md_len) <= 0) {
+      Fail("Failed to finalize the digest");
+    }
+  }
+
+  inline void ToResult(Local<Value>* err,
+                       Local<Value>* result) const override {
+    if (uv_error == 0)
+      return HashJob::ToResult(err, result);
+    *err = UVException(env->isolate(), uv_error, syscall, nullptr,
+                       path.c_str());
+    *result = Undefined(env->isolate());
+  }
+};
+
+
+// hash(algorithm, data, outputEncoding, wrap)
+// Computes the digest of `data` in a single call, without a Hash object.
+// Without a wrap object, the digest is returned. With one, it is computed on
+// the threadpool and passed to the ondone callback of the wrap object, which
+// retains `data` while the request is in flight.
+void OneShotDigest(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(args[0]->IsString());  // algorithm
+  CHECK(args[1]->IsString() || args[1]->IsArrayBufferView());  // data
+  CHECK(args[3]->IsObject() || args[3]->IsUndefined());  // wrap object
+  CHECK(!(args[1]->IsString() && args[3]->IsObject()));
+
+  const node::Utf8Value algorithm(env->isolate(), args[0]);
+  const EVP_MD* md = GetDigestByName(*algorithm);
+  // With a wrap object, the error is passed to the callback instead.
+  if (md == nullptr && !args[3]->IsObject()) {
+    return ThrowCryptoError(env, ERR_get_error(),
+                            "Digest method not supported");
+  }
+  const enum encoding encoding =
+      ParseEncoding(env->isolate(), args[2], BUFFER);
+
+  std::unique_ptr<HashJob> job(new HashJob(env, md, encoding));
+  if (md == nullptr)
+    job->errors.push_back("Digest method not supported");
+  StringBytes::InlineDecoder decoder;
+  if (args[1]->IsString()) {
+    if (!decoder.Decode(env, args[1].As<String>(), Undefined(env->isolate()),
+                        UTF8).FromMaybe(false)) {
+      return;
+    }
+    job->data = decoder.out();
+    job->size = decoder.size();
+  } else {
+    job->data = Buffer::Data(args[1]);
+    job->size = Buffer::Length(args[1]);
+  }
+
+  if (args[3]->IsObject()) return HashJob::Run(std::move(job), args[3]);
+  job->DoThreadPoolWork();
+
+  Local<Value> err;
+  Local<Value> result;
+  job->ToResult(&err, &result);
+  if (!err->IsUndefined()) {
+    env->isolate()->ThrowException(err);
+    return;
+  }
+  args.GetReturnValue().Set(result);
+}
+
+
+// hashFile(algorithm, path, outputEncoding, wrap)
+// Reads the file at `path` and computes its digest on the threadpool, without
+// passing its contents through JavaScript. All errors, including an
+// unsupported algorithm, are passed to the ondone callback of the wrap object.
+void HashFile(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(args[0]->IsString());  // algorithm
+  CHECK(args[3]->IsObject());  // wrap object
+
+  const node::Utf8Value algorithm(env->isolate(), args[0]);
+  const EVP_MD* md = GetDigestByName(*algorithm);
+  BufferValue path(env->isolate(), args[1]);
+  CHECK_NOT_NULL(*path);
+  const enum encoding encoding =
+      ParseEncoding(env->isolate(), args[2], BUFFER);
+
+  std::unique_ptr<HashFileJob> job(
+      new HashFileJob(env, md, encoding, std::string(*path, path.length())));
+  if (md == nullptr)
+    job->errors.push_back("Digest method not supported");
+  HashFileJob::Run(std::move(job), args[3]);
+}
+
+
 class KeyPairGenerationConfig {
  public:
   virtual EVPKeyCtxPointer Setup() = 0;
@@ -5778,6 +7284,7 @@ void Initialize(Local<Object> target,
 
   Environment* env = Environment::GetCurrent(context);
   SecureContext::Initialize(env, target);
+  SessionCache::Initialize(env, target);
   CipherBase::Initialize(env, target);
   DiffieHellman::Initialize(env, target);
   ECDH::Initialize(env, target);
@@ -5804,6 +7311,11 @@ void Initialize(Local<Object> target,
 #endif
 
   env->SetMethod(target, "pbkdf2", PBKDF2);
+  env->SetMethod(target, "pbkdf2Batch", PBKDF2Batch);
+  env->SetMethod(target, "hash", OneShotDigest);
+  env->SetMethod(target, "aeadCipher", AEADCipher);
+  env->SetMethod(target, "signBatch", SignBatch);
+  env->SetMethod(target, "hashFile", HashFile);
   env->SetMethod(target, "generateKeyPairRSA", GenerateKeyPairRSA);
   env->SetMethod(target, "generateKeyPairDSA", GenerateKeyPairDSA);
   env->SetMethod(target, "generateKeyPairEC", GenerateKeyPairEC);
@@ -5839,6 +7351,7 @@ void Initialize(Local<Object> target,
                                          EVP_PKEY_verify_recover>);
 #ifndef OPENSSL_NO_SCRYPT
   env->SetMethod(target, "scrypt", Scrypt);
+  env->SetMethod(target, "scryptBatch", ScryptBatch);
 #endif  // OPENSSL_NO_SCRYPT
 }
 
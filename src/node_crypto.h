@@ -27,6 +27,12 @@
 #include "node.h"
 // ClientHelloParser
 #include "node_crypto_clienthello.h"
+// SessionCacheStore
+#include "node_crypto_session_cache.h"
+// PrivateKeyOperation
+#include "node_crypto_async_key.h"
+// PEMCache
+#include "node_crypto_pem_cache.h"
 
 #include "node_buffer.h"
 
@@ -36,6 +42,7 @@
 
 #include "v8.h"
 
+#include <openssl/async.h>
 #include <openssl/ssl.h>
 #include <openssl/ec.h>
 #include <openssl/ecdh.h>
@@ -53,6 +60,10 @@
 #include <openssl/rand.h>
 #include <openssl/pkcs12.h>
 
+#include <functional>
+#include <memory>
+#include <vector>
+
 namespace node {
 namespace crypto {
 
@@ -103,14 +114,15 @@ class SecureContext : public BaseObject {
 
   static void Initialize(Environment* env, v8::Local<v8::Object> target);
 
-  // TODO(joyeecheung): track the memory used by OpenSSL types
-  SET_NO_MEMORY_INFO()
+  void MemoryInfo(MemoryTracker* tracker) const override;
   SET_MEMORY_INFO_NAME(SecureContext)
   SET_SELF_SIZE(SecureContext)
 
   SSLCtxPointer ctx_;
   X509Pointer cert_;
   X509Pointer issuer_;
+  // The cached certificates and keys that the context uses.
+  std::vector<std::shared_ptr<const PEMCacheEntry>> pem_entries_;
 #ifndef OPENSSL_NO_ENGINE
   bool client_cert_engine_provided_ = false;
 #endif  // !OPENSSL_NO_ENGINE
@@ -128,8 +140,30 @@ class SecureContext : public BaseObject {
   unsigned char ticket_key_name_[16];
   unsigned char ticket_key_aes_[16];
   unsigned char ticket_key_hmac_[16];
+
+  // A ticket key derived from ticket_key_secret_ by RotateTicketKeys().
+  struct RotatingTicketKey {
+    int64_t epoch;
+    unsigned char name[16];
+    unsigned char aes[16];
+    unsigned char hmac[16];
+  };
+
+  // Set by EnableTicketKeyRotation(). The key for the current interval comes
+  // first, followed by the older ones that may still be inside their overlap
+  // window.
+  std::vector<unsigned char> ticket_key_secret_;
+  uint32_t ticket_key_interval_ = 0;
+  uint32_t ticket_key_overlap_ = 0;
+  std::vector<RotatingTicketKey> rotating_ticket_keys_;
 #endif
 
+  // Shared with the connections that are created from this context.
+  std::shared_ptr<SessionCacheStore> session_cache_;
+
+  // Set by EnableAsyncPrivateKey().
+  bool async_private_key_ = false;
+
  protected:
 #if OPENSSL_VERSION_NUMBER < 0x10100000L
   static const int64_t kExternalSize = sizeof(SSL_CTX);
@@ -154,6 +188,9 @@ class SecureContext : public BaseObject {
       const v8::FunctionCallbackInfo<v8::Value>& args);
   static void SetSessionTimeout(
       const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void SetSessionCache(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void EnableAsyncPrivateKey(
+      const v8::FunctionCallbackInfo<v8::Value>& args);
   static void Close(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void LoadPKCS12(const v8::FunctionCallbackInfo<v8::Value>& args);
 #ifndef OPENSSL_NO_ENGINE
@@ -162,6 +199,8 @@ class SecureContext : public BaseObject {
 #endif  // !OPENSSL_NO_ENGINE
   static void GetTicketKeys(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void SetTicketKeys(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void EnableTicketKeyRotation(
+      const v8::FunctionCallbackInfo<v8::Value>& args);
   static void SetFreeListLength(
       const v8::FunctionCallbackInfo<v8::Value>& args);
   static void EnableTicketKeyCallback(
@@ -185,6 +224,15 @@ class SecureContext : public BaseObject {
                                          EVP_CIPHER_CTX* ectx,
                                          HMAC_CTX* hctx,
                                          int enc);
+  static int RotatingTicketKeyCallback(SSL* ssl,
+                                       unsigned char* name,
+                                       unsigned char* iv,
+                                       EVP_CIPHER_CTX* ectx,
+                                       HMAC_CTX* hctx,
+                                       int enc);
+  // Derives the keys for the current interval if it has changed since the
+  // last call. Returns false if the keys could not be derived.
+  bool RotateTicketKeys();
 #endif
 
   SecureContext(Environment* env, v8::Local<v8::Object> wrap)
@@ -200,6 +248,8 @@ class SecureContext : public BaseObject {
     ctx_.reset();
     cert_.reset();
     issuer_.reset();
+    pem_entries_.clear();
+    session_cache_.reset();
   }
 };
 
@@ -221,7 +271,10 @@ class SSLWrap {
         new_session_wait_(false),
         cert_cb_(nullptr),
         cert_cb_arg_(nullptr),
-        cert_cb_running_(false) {
+        cert_cb_running_(false),
+        session_cache_(sc->session_cache_),
+        async_private_key_(sc->async_private_key_),
+        private_key_op_(nullptr) {
     ssl_.reset(SSL_new(sc->ctx_.get()));
     CHECK(ssl_);
     env_->isolate()->AdjustAmountOfExternalAllocatedMemory(kExternalSize);
@@ -310,8 +363,10 @@ class SSLWrap {
                                 void* arg);
   static int TLSExtStatusCallback(SSL* s, void* arg);
   static int SSLCertCallback(SSL* s, void* arg);
+  static void PrivateKeyOperationDone(void* arg);
 
   void DestroySSL();
+  bool AdvanceAsyncHandshake();
   void WaitForCertCb(CertCb cb, void* arg);
   void SetSNIContext(SecureContext* sc);
   int SetCACerts(SecureContext* sc);
@@ -334,6 +389,25 @@ class SSLWrap {
 
   ClientHelloParser hello_parser_;
 
+  // Used when there are no session callbacks into JS.
+  std::shared_ptr<SessionCacheStore> session_cache_;
+
+  // Callbacks that call into JS during a handshake go through this. JS cannot
+  // run on the small stack of an OpenSSL ASYNC job, so inside a job of
+  // AdvanceAsyncHandshake() the call is postponed until SSL_do_handshake()
+  // has returned.
+  template <typename Fn>
+  inline void RunOutsideAsyncJob(Fn&& fn) {
+    if (ASYNC_get_current_job() == nullptr)
+      return fn();
+    deferred_callbacks_.emplace_back(std::forward<Fn>(fn));
+  }
+
+  // See AdvanceAsyncHandshake().
+  bool async_private_key_;
+  PrivateKeyOperation* private_key_op_;
+  std::vector<std::function<void()>> deferred_callbacks_;
+
   Persistent<v8::Object> ocsp_response_;
   Persistent<v8::Value> sni_context_;
 
@@ -357,7 +431,8 @@ class CipherBase : public BaseObject {
   enum UpdateResult {
     kSuccess,
     kErrorMessageSize,
-    kErrorState
+    kErrorState,
+    kErrorOutputSize
   };
   enum AuthTagState {
     kAuthTagUnknown,
@@ -388,6 +463,10 @@ class CipherBase : public BaseObject {
   bool CheckCCMMessageLength(int message_len);
   UpdateResult Update(const char* data, int len, unsigned char** out,
                       int* out_len);
+  // Like Update(), but writes to a caller-provided buffer of |out_size| bytes,
+  // which may start at |data| for in-place operation.
+  UpdateResult UpdateInto(const char* data, int len, unsigned char* out,
+                          size_t out_size, int* out_len);
   bool Final(unsigned char** out, int* out_len);
   bool SetAutoPadding(bool auto_padding);
 
@@ -399,6 +478,7 @@ class CipherBase : public BaseObject {
   static void Init(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void InitIv(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void Update(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void UpdateInto(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void Final(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void SetAutoPadding(const v8::FunctionCallbackInfo<v8::Value>& args);
 
@@ -419,6 +499,10 @@ class CipherBase : public BaseObject {
   }
 
  private:
+  UpdateResult PrepareUpdate(const char* data, int len, int* buff_len);
+  UpdateResult DoUpdate(const char* data, int len, unsigned char* out,
+                        int buff_len, int* out_len);
+
   DeleteFnPtr<EVP_CIPHER_CTX, EVP_CIPHER_CTX_free> ctx_;
   const CipherKind kind_;
   AuthTagState auth_tag_state_;
@@ -534,6 +618,16 @@ class Sign : public SignBase {
       int padding,
       int saltlen);
 
+  // Like SignFinal(), but for a digest that is no longer owned by a Sign
+  // object. Does not touch the JS heap and may run on any thread.
+  static SignResult SignFinal(
+      EVPMDPointer&& mdctx,
+      const char* key_pem,
+      int key_pem_len,
+      const char* passphrase,
+      int padding,
+      int saltlen);
+
  protected:
   static void New(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void SignInit(const v8::FunctionCallbackInfo<v8::Value>& args);
@@ -557,6 +651,17 @@ class Verify : public SignBase {
                     int saltlen,
                     bool* verify_result);
 
+  // Like VerifyFinal(), but for a digest that is no longer owned by a Verify
+  // object. Does not touch the JS heap and may run on any thread.
+  static Error VerifyFinal(EVPMDPointer&& mdctx,
+                           const char* key_pem,
+                           int key_pem_len,
+                           const char* sig,
+                           int siglen,
+                           int padding,
+                           int saltlen,
+                           bool* verify_result);
+
  protected:
   static void New(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void VerifyInit(const v8::FunctionCallbackInfo<v8::Value>& args);
@@ -0,0 +1,240 @@
+#include "node_crypto_async_key.h"
+#include "env-inl.h"
+#include "util-inl.h"
+#include "uv.h"
+
+#include <openssl/async.h>
+#include <openssl/ec.h>
+#include <openssl/err.h>
+#include <openssl/rsa.h>
+
+namespace node {
+namespace crypto {
+
+namespace {
+
+uv_once_t init_once = UV_ONCE_INIT;
+uv_key_t current_scope;
+RSA_METHOD* async_rsa_method;
+EC_KEY_METHOD* async_ec_key_method;
+
+typedef int (*EcdsaSign)(int type,
+                         const unsigned char* dgst,
+                         int dlen,
+                         unsigned char* sig,
+                         unsigned int* siglen,
+                         const BIGNUM* kinv,
+                         const BIGNUM* r,
+                         EC_KEY* eckey);
+EcdsaSign default_ecdsa_sign;
+
+int AsyncRsaPrivateEncrypt(int flen,
+                           const unsigned char* from,
+                           unsigned char* to,
+                           RSA* rsa,
+                           int padding) {
+  return AsyncKeyScope::Run([=]() {
+    return RSA_meth_get_priv_enc(RSA_PKCS1_OpenSSL())(
+        flen, from, to, rsa, padding);
+  }, -1);
+}
+
+int AsyncRsaPrivateDecrypt(int flen,
+                           const unsigned char* from,
+                           unsigned char* to,
+                           RSA* rsa,
+                           int padding) {
+  return AsyncKeyScope::Run([=]() {
+    return RSA_meth_get_priv_dec(RSA_PKCS1_OpenSSL())(
+        flen, from, to, rsa, padding);
+  }, -1);
+}
+
+int AsyncEcdsaSign(int type,
+                   const unsigned char* dgst,
+                   int dlen,
+                   unsigned char* sig,
+                   unsigned int* siglen,
+                   const BIGNUM* kinv,
+                   const BIGNUM* r,
+                   EC_KEY* eckey) {
+  return AsyncKeyScope::Run([=]() {
+    return default_ecdsa_sign(type, dgst, dlen, sig, siglen, kinv, r, eckey);
+  }, 0);
+}
+
+void InitAsyncKeyMethods() {
+  CHECK_EQ(uv_key_create(&current_scope), 0);
+
+  async_rsa_method = RSA_meth_dup(RSA_PKCS1_OpenSSL());
+  CHECK_NOT_NULL(async_rsa_method);
+  RSA_meth_set_priv_enc(async_rsa_method, AsyncRsaPrivateEncrypt);
+  RSA_meth_set_priv_dec(async_rsa_method, AsyncRsaPrivateDecrypt);
+
+  int (*sign_setup)(EC_KEY*, BN_CTX*, BIGNUM**, BIGNUM**);
+  ECDSA_SIG* (*sign_sig)(const unsigned char*, int, const BIGNUM*,
+                         const BIGNUM*, EC_KEY*);
+  async_ec_key_method = EC_KEY_METHOD_new(EC_KEY_OpenSSL());
+  CHECK_NOT_NULL(async_ec_key_method);
+  EC_KEY_METHOD_get_sign(EC_KEY_OpenSSL(),
+                         &default_ecdsa_sign,
+                         &sign_setup,
+                         &sign_sig);
+  EC_KEY_METHOD_set_sign(async_ec_key_method,
+                         AsyncEcdsaSign,
+                         sign_setup,
+                         sign_sig);
+}
+
+}  // anonymous namespace
+
+
+PrivateKeyOperation::PrivateKeyOperation(Environment* env,
+                                         std::function<int()> fn,
+                                         DoneCb cb,
+                                         void* arg)
+    : ThreadPoolWork(env, threadpool::QUEUE_TYPE_CRYPTO),
+      fn_(std::move(fn)),
+      cb_(cb),
+      arg_(arg),
+      ssl_(nullptr) {}
+
+
+void PrivateKeyOperation::DoThreadPoolWork() {
+  ERR_clear_error();
+  result_ = fn_();
+  ERR_clear_error();
+}
+
+
+void PrivateKeyOperation::AfterThreadPoolWork(int status) {
+  CHECK(status == 0 || status == UV_ECANCELED);
+  done_ = true;
+
+  // The environment is being torn down, the job is not resumed.
+  if (status == UV_ECANCELED)
+    return;
+
+  // Resuming the job deletes this operation.
+  if (abandoned()) {
+    DeleteFnPtr<SSL, SSL_free> ssl = std::move(ssl_);
+    SSL_do_handshake(ssl.get());
+    ERR_clear_error();
+    return;
+  }
+
+  DoneCb cb = cb_;
+  cb(arg_);
+}
+
+
+void PrivateKeyOperation::Abandon(DeleteFnPtr<SSL, SSL_free> ssl) {
+  CHECK(!abandoned());
+  // The connection object is gone, nothing may call back into it.
+  SSL_set_info_callback(ssl.get(), nullptr);
+  SSL_set_app_data(ssl.get(), nullptr);
+  ssl_ = std::move(ssl);
+  cb_ = nullptr;
+  arg_ = nullptr;
+}
+
+
+AsyncKeyScope::AsyncKeyScope(Environment* env,
+                             PrivateKeyOperation** pending,
+                             PrivateKeyOperation::DoneCb cb,
+                             void* arg)
+    : env_(env),
+      pending_(pending),
+      cb_(cb),
+      arg_(arg) {
+  CHECK_NULL(*pending);
+  uv_once(&init_once, InitAsyncKeyMethods);
+  previous_ = static_cast<AsyncKeyScope*>(uv_key_get(&current_scope));
+  uv_key_set(&current_scope, this);
+}
+
+
+AsyncKeyScope::~AsyncKeyScope() {
+  uv_key_set(&current_scope, previous_);
+}
+
+
+int AsyncKeyScope::Run(std::function<int()> fn, int error_result) {
+  AsyncKeyScope* scope =
+      static_cast<AsyncKeyScope*>(uv_key_get(&current_scope));
+  if (scope == nullptr ||
+      *scope->pending_ != nullptr ||
+      ASYNC_get_current_job() == nullptr) {
+    return fn();
+  }
+
+  PrivateKeyOperation* op =
+      new PrivateKeyOperation(scope->env_, std::move(fn), scope->cb_,
+                              scope->arg_);
+  *scope->pending_ = op;
+  op->ScheduleWork();
+
+  // Pausing returns from SSL_do_handshake(), which also ends the scope. The
+  // completion callback calls it again, which returns here.
+  do {
+    CHECK_EQ(ASYNC_pause_job(), 1);
+  } while (!op->done());
+
+  int result = op->abandoned() ? error_result : op->result();
+  delete op;
+  return result;
+}
+
+
+EVP_PKEY* NewAsyncKey(EVP_PKEY* pkey) {
+  if (pkey == nullptr || !ASYNC_is_capable())
+    return nullptr;
+
+  uv_once(&init_once, InitAsyncKeyMethods);
+
+  switch (EVP_PKEY_base_id(pkey)) {
+    case EVP_PKEY_RSA: {
+      RSA* rsa = EVP_PKEY_get0_RSA(pkey);
+      if (RSA_get_method(rsa) == async_rsa_method)
+        break;
+      if (RSA_get_method(rsa) != RSA_PKCS1_OpenSSL())
+        return nullptr;
+      DeleteFnPtr<EVP_PKEY, EVP_PKEY_free> copy(EVP_PKEY_new());
+      DeleteFnPtr<RSA, RSA_free> rsa_copy(RSAPrivateKey_dup(rsa));
+      if (!copy ||
+          !rsa_copy ||
+          RSA_set_method(rsa_copy.get(), async_rsa_method) != 1 ||
+          EVP_PKEY_assign_RSA(copy.get(), rsa_copy.get()) != 1) {
+        return nullptr;
+      }
+      rsa_copy.release();
+      return copy.release();
+    }
+    case EVP_PKEY_EC: {
+      EC_KEY* ec = EVP_PKEY_get0_EC_KEY(pkey);
+      if (EC_KEY_get_method(ec) == async_ec_key_method)
+        break;
+      if (EC_KEY_get_method(ec) != EC_KEY_OpenSSL())
+        return nullptr;
+      DeleteFnPtr<EVP_PKEY, EVP_PKEY_free> copy(EVP_PKEY_new());
+      DeleteFnPtr<EC_KEY, EC_KEY_free> ec_copy(EC_KEY_dup(ec));
+      if (!copy ||
+          !ec_copy ||
+          EC_KEY_set_method(ec_copy.get(), async_ec_key_method) != 1 ||
+          EVP_PKEY_assign_EC_KEY(copy.get(), ec_copy.get()) != 1) {
+        return nullptr;
+      }
+      ec_copy.release();
+      return copy.release();
+    }
+    default:
+      return nullptr;
+  }
+
+  // The key already uses the method.
+  EVP_PKEY_up_ref(pkey);
+  return pkey;
+}
+
+}  // namespace crypto
+}  // namespace node
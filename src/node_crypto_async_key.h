@@ -0,0 +1,101 @@
+#ifndef SRC_NODE_CRYPTO_ASYNC_KEY_H_
+#define SRC_NODE_CRYPTO_ASYNC_KEY_H_
+
+#if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#include "node_internals.h"
+#include "util.h"
+
+#include <openssl/evp.h>
+#include <openssl/ssl.h>
+
+#include <functional>
+
+namespace node {
+
+class Environment;
+
+namespace crypto {
+
+// TLS handshakes can move the private key operations of a context's key, the
+// signature of the handshake and the decryption of an RSA key exchange, to
+// the threadpool.
+//
+// NewAsyncKey() copies the key with an RSA or EC key method that, when it is
+// called from an OpenSSL ASYNC job while an AsyncKeyScope is active, queues a
+// PrivateKeyOperation and pauses the job until the operation has completed.
+// The connection runs SSL_do_handshake() in SSL_MODE_ASYNC inside the scope,
+// which makes it return SSL_ERROR_WANT_ASYNC while the job is paused, and
+// calls it again from the completion callback to resume the job. Anywhere
+// else, the key method signs and decrypts right away.
+class PrivateKeyOperation : public ThreadPoolWork {
+ public:
+  typedef void (*DoneCb)(void* arg);
+
+  PrivateKeyOperation(Environment* env,
+                      std::function<int()> fn,
+                      DoneCb cb,
+                      void* arg);
+
+  void DoThreadPoolWork() override;
+  void AfterThreadPoolWork(int status) override;
+
+  // Called when the connection is destroyed while the operation is pending.
+  // The operation takes `ssl` over and, once it has completed, resumes the
+  // handshake job with a failed result so that the job can finish.
+  void Abandon(DeleteFnPtr<SSL, SSL_free> ssl);
+
+  bool done() const { return done_; }
+  bool abandoned() const { return cb_ == nullptr; }
+  int result() const { return result_; }
+
+ private:
+  std::function<int()> fn_;
+  DoneCb cb_;
+  void* arg_;
+  DeleteFnPtr<SSL, SSL_free> ssl_;
+  bool done_ = false;
+  int result_ = -1;
+};
+
+// Lets the key method of the current thread move private key operations to
+// the threadpool for as long as the scope exists. The operation is stored in
+// `*pending`, which must be nullptr, and `cb(arg)` is called once it has
+// completed.
+class AsyncKeyScope {
+ public:
+  AsyncKeyScope(Environment* env,
+                PrivateKeyOperation** pending,
+                PrivateKeyOperation::DoneCb cb,
+                void* arg);
+  ~AsyncKeyScope();
+
+  // Runs `fn`, a private key operation, on the threadpool if a scope is
+  // active and the thread is inside an ASYNC job, or right away otherwise.
+  // `error_result` is returned when the connection is destroyed before the
+  // operation has completed.
+  static int Run(std::function<int()> fn, int error_result);
+
+  AsyncKeyScope(const AsyncKeyScope&) = delete;
+  AsyncKeyScope& operator=(const AsyncKeyScope&) = delete;
+
+ private:
+  Environment* const env_;
+  PrivateKeyOperation** const pending_;
+  const PrivateKeyOperation::DoneCb cb_;
+  void* const arg_;
+  AsyncKeyScope* previous_;
+};
+
+// Returns a copy of `pkey` that uses the key method, which the caller must
+// free. Returns nullptr if the key is neither an RSA nor an EC key, has a
+// custom method, for example one of an engine, or OpenSSL cannot run ASYNC
+// jobs on this platform.
+EVP_PKEY* NewAsyncKey(EVP_PKEY* pkey);
+
+}  // namespace crypto
+}  // namespace node
+
+#endif  // defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#endif  // SRC_NODE_CRYPTO_ASYNC_KEY_H_
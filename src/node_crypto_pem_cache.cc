@@ -0,0 +1,115 @@
+#include "node_crypto_pem_cache.h"
+#include "node_mutex.h"
+#include "util-inl.h"
+
+#include <openssl/bio.h>
+
+#include <string.h>
+#include <unordered_map>
+
+namespace node {
+namespace crypto {
+
+namespace {
+
+Mutex cache_mutex;
+std::unordered_map<std::string, std::weak_ptr<const PEMCacheEntry>> cache;
+
+std::string Digest(PEMCache::Kind kind,
+                   const char* data,
+                   size_t length,
+                   const char* passphrase) {
+  const unsigned char prefix[] = {
+    static_cast<unsigned char>(kind),
+    static_cast<unsigned char>(passphrase != nullptr)
+  };
+  unsigned char md[EVP_MAX_MD_SIZE];
+  unsigned int md_len = 0;
+  DeleteFnPtr<EVP_MD_CTX, EVP_MD_CTX_free> ctx(EVP_MD_CTX_new());
+  CHECK(ctx);
+  CHECK_EQ(EVP_DigestInit_ex(ctx.get(), EVP_sha256(), nullptr), 1);
+  CHECK_EQ(EVP_DigestUpdate(ctx.get(), prefix, sizeof(prefix)), 1);
+  if (passphrase != nullptr) {
+    // The terminating NUL separates the passphrase from the input.
+    CHECK_EQ(EVP_DigestUpdate(ctx.get(), passphrase, strlen(passphrase) + 1),
+             1);
+  }
+  CHECK_EQ(EVP_DigestUpdate(ctx.get(), data, length), 1);
+  CHECK_EQ(EVP_DigestFinal_ex(ctx.get(), md, &md_len), 1);
+  return std::string(reinterpret_cast<const char*>(md), md_len);
+}
+
+}  // anonymous namespace
+
+
+PEMCacheEntry::~PEMCacheEntry() {
+  for (X509* cert : certs_)
+    X509_free(cert);
+  EVP_PKEY_free(key_);
+}
+
+
+void PEMCacheEntry::AddCert(X509* cert) {
+  certs_.push_back(cert);
+  size_ += i2d_X509(cert, nullptr);
+}
+
+
+void PEMCacheEntry::SetKey(EVP_PKEY* key) {
+  CHECK_NULL(key_);
+  key_ = key;
+  size_ += i2d_PrivateKey(key, nullptr);
+}
+
+
+void PEMCache::Delete(const PEMCacheEntry* entry) {
+  {
+    Mutex::ScopedLock lock(cache_mutex);
+    // Another thread may have replaced the entry since its last reference
+    // was dropped.
+    auto it = cache.find(entry->digest_);
+    if (it != cache.end() && it->second.expired())
+      cache.erase(it);
+  }
+  delete entry;
+}
+
+
+std::shared_ptr<const PEMCacheEntry> PEMCache::Get(Kind kind,
+                                                   const char* data,
+                                                   size_t length,
+                                                   const char* passphrase,
+                                                   const ParseFn& parse) {
+  std::string digest = Digest(kind, data, length, passphrase);
+
+  {
+    Mutex::ScopedLock lock(cache_mutex);
+    auto it = cache.find(digest);
+    if (it != cache.end()) {
+      if (std::shared_ptr<const PEMCacheEntry> entry = it->second.lock())
+        return entry;
+    }
+  }
+
+  // Parse without holding the lock. If another thread parses the same input
+  // meanwhile, the entry that is inserted first wins.
+  PEMCacheEntry* entry = new PEMCacheEntry();
+  entry->digest_ = digest;
+  DeleteFnPtr<BIO, BIO_free_all> bio(
+      BIO_new_mem_buf(data, static_cast<int>(length)));
+  if (!bio || !parse(bio.get(), entry)) {
+    delete entry;
+    return nullptr;
+  }
+  std::shared_ptr<const PEMCacheEntry> result(entry, Delete);
+
+  Mutex::ScopedLock lock(cache_mutex);
+  std::weak_ptr<const PEMCacheEntry>& slot = cache[digest];
+  if (std::shared_ptr<const PEMCacheEntry> existing = slot.lock())
+    return existing;
+  slot = result;
+  return result;
+}
+
+}  // namespace crypto
+}  // namespace node
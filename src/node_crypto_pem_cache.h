@@ -0,0 +1,83 @@
+#ifndef SRC_NODE_CRYPTO_PEM_CACHE_H_
+#define SRC_NODE_CRYPTO_PEM_CACHE_H_
+
+#if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#include "memory_tracker.h"
+
+#include <openssl/evp.h>
+#include <openssl/x509.h>
+
+#include <stddef.h>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace node {
+namespace crypto {
+
+// The certificates or the private key parsed from one PEM input. Entries are
+// immutable once they are in the cache, and may be used by the SecureContexts
+// of several threads at once.
+class PEMCacheEntry : public MemoryRetainer {
+ public:
+  ~PEMCacheEntry() override;
+
+  // Takes ownership of `cert`.
+  void AddCert(X509* cert);
+  // Takes ownership of `key`.
+  void SetKey(EVP_PKEY* key);
+
+  const std::vector<X509*>& certs() const { return certs_; }
+  EVP_PKEY* key() const { return key_; }
+
+  SET_NO_MEMORY_INFO()
+  SET_MEMORY_INFO_NAME(PEMCacheEntry)
+  size_t SelfSize() const override { return size_; }
+
+ private:
+  friend class PEMCache;
+
+  std::string digest_;
+  std::vector<X509*> certs_;
+  EVP_PKEY* key_ = nullptr;
+  // The DER size of the objects, which is a lower bound of the memory they
+  // use once they are parsed.
+  size_t size_ = sizeof(*this);
+};
+
+// A process-wide cache of parsed certificates and private keys, so that the
+// SecureContexts that are created from the same input, by any server or
+// Worker, parse it only once and share the resulting objects. An entry is
+// looked up by the SHA-256 digest of its kind, the input and the passphrase,
+// and is freed together with the last SecureContext that uses it.
+class PEMCache {
+ public:
+  enum Kind {
+    kCertChain,
+    kCACerts,
+    kPrivateKey
+  };
+
+  typedef std::function<bool(BIO* bio, PEMCacheEntry* entry)> ParseFn;
+
+  // Returns the entry for the input, which `parse` fills in if it is not
+  // cached yet. Returns nullptr if `parse` fails, in which case nothing is
+  // cached and OpenSSL's error queue is left as `parse` left it.
+  static std::shared_ptr<const PEMCacheEntry> Get(Kind kind,
+                                                  const char* data,
+                                                  size_t length,
+                                                  const char* passphrase,
+                                                  const ParseFn& parse);
+
+ private:
+  static void Delete(const PEMCacheEntry* entry);
+};
+
+}  // namespace crypto
+}  // namespace node
+
+#endif  // defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#endif  // SRC_NODE_CRYPTO_PEM_CACHE_H_
@@ -0,0 +1,162 @@
+#include "node_crypto_scrypt.h"
+#include "util-inl.h"
+
+#ifndef OPENSSL_NO_SCRYPT
+
+#include <openssl/crypto.h>
+#include <openssl/err.h>
+
+#include <string.h>
+
+namespace node {
+namespace crypto {
+
+namespace {
+
+inline uint32_t Rotate(uint32_t value, int bits) {
+  return (value << bits) | (value >> (32 - bits));
+}
+
+// The Salsa20/8 core, applied in place.
+void Salsa208(uint32_t inout[16]) {
+  uint32_t x[16];
+  memcpy(x, inout, sizeof(x));
+  for (int i = 8; i > 0; i -= 2) {
+    x[4] ^= Rotate(x[0] + x[12], 7);
+    x[8] ^= Rotate(x[4] + x[0], 9);
+    x[12] ^= Rotate(x[8] + x[4], 13);
+    x[0] ^= Rotate(x[12] + x[8], 18);
+    x[9] ^= Rotate(x[5] + x[1], 7);
+    x[13] ^= Rotate(x[9] + x[5], 9);
+    x[1] ^= Rotate(x[13] + x[9], 13);
+    x[5] ^= Rotate(x[1] + x[13], 18);
+    x[14] ^= Rotate(x[10] + x[6], 7);
+    x[2] ^= Rotate(x[14] + x[10], 9);
+    x[6] ^= Rotate(x[2] + x[14], 13);
+    x[10] ^= Rotate(x[6] + x[2], 18);
+    x[3] ^= Rotate(x[15] + x[11], 7);
+    x[7] ^= Rotate(x[3] + x[15], 9);
+    x[11] ^= Rotate(x[7] + x[3], 13);
+    x[15] ^= Rotate(x[11] + x[7], 18);
+    x[1] ^= Rotate(x[0] + x[3], 7);
+    x[2] ^= Rotate(x[1] + x[0], 9);
+    x[3] ^= Rotate(x[2] + x[1], 13);
+    x[0] ^= Rotate(x[3] + x[2], 18);
+    x[6] ^= Rotate(x[5] + x[4], 7);
+    x[7] ^= Rotate(x[6] + x[5], 9);
+    x[4] ^= Rotate(x[7] + x[6], 13);
+    x[5] ^= Rotate(x[4] + x[7], 18);
+    x[11] ^= Rotate(x[10] + x[9], 7);
+    x[8] ^= Rotate(x[11] + x[10], 9);
+    x[9] ^= Rotate(x[8] + x[11], 13);
+    x[10] ^= Rotate(x[9] + x[8], 18);
+    x[12] ^= Rotate(x[15] + x[14], 7);
+    x[13] ^= Rotate(x[12] + x[15], 9);
+    x[14] ^= Rotate(x[13] + x[12], 13);
+    x[15] ^= Rotate(x[14] + x[13], 18);
+  }
+  for (int i = 0; i < 16; i++)
+    inout[i] += x[i];
+  OPENSSL_cleanse(x, sizeof(x));
+}
+
+// scryptBlockMix, from `in` into `out`. Both are 32 * r words long.
+void BlockMix(uint32_t* out, const uint32_t* in, uint64_t r) {
+  uint32_t x[16];
+  memcpy(x, in + (r * 2 - 1) * 16, sizeof(x));
+  for (uint64_t i = 0; i < r * 2; i++) {
+    for (int j = 0; j < 16; j++)
+      x[j] ^= *in++;
+    Salsa208(x);
+    memcpy(out + (i / 2 + (i & 1) * r) * 16, x, sizeof(x));
+  }
+  OPENSSL_cleanse(x, sizeof(x));
+}
+
+// scryptROMix, applied in place to the 128 * r bytes of `block`. `x` and `t`
+// are 32 * r words long, `v` 32 * r * N words.
+void ROMix(unsigned char* block,
+           uint64_t r,
+           uint64_t N,
+           uint32_t* x,
+           uint32_t* t,
+           uint32_t* v) {
+  const unsigned char* in = block;
+  uint32_t* pv = v;
+  for (uint64_t i = 0; i < 32 * r; i++, in += 4) {
+    *pv++ = static_cast<uint32_t>(in[0]) |
+            static_cast<uint32_t>(in[1]) << 8 |
+            static_cast<uint32_t>(in[2]) << 16 |
+            static_cast<uint32_t>(in[3]) << 24;
+  }
+
+  for (uint64_t i = 1; i < N; i++, pv += 32 * r)
+    BlockMix(pv, pv - 32 * r, r);
+
+  BlockMix(x, v + (N - 1) * 32 * r, r);
+
+  for (uint64_t i = 0; i < N; i++) {
+    const uint32_t* vj = v + 32 * r * (x[16 * (2 * r - 1)] % N);
+    for (uint64_t k = 0; k < 32 * r; k++)
+      t[k] = x[k] ^ vj[k];
+    BlockMix(x, t, r);
+  }
+
+  unsigned char* out = block;
+  for (uint64_t i = 0; i < 32 * r; i++, out += 4) {
+    out[0] = x[i] & 0xff;
+    out[1] = (x[i] >> 8) & 0xff;
+    out[2] = (x[i] >> 16) & 0xff;
+    out[3] = (x[i] >> 24) & 0xff;
+  }
+}
+
+}  // anonymous namespace
+
+
+ScryptLanes::ScryptLanes(uint32_t N, uint32_t r, uint32_t p)
+    : N_(N), r_(r), p_(p) {}
+
+
+ScryptLanes::~ScryptLanes() {
+  OPENSSL_cleanse(blocks_.data(), blocks_.size());
+}
+
+
+bool ScryptLanes::Init(const char* pass,
+                       size_t pass_len,
+                       const unsigned char* salt,
+                       size_t salt_len) {
+  blocks_.resize(p_ * 128 * r_);
+  return PKCS5_PBKDF2_HMAC(pass, pass_len, salt, salt_len, 1, EVP_sha256(),
+                           blocks_.size(), blocks_.data()) == 1;
+}
+
+
+bool ScryptLanes::RunLane(uint32_t lane) {
+  CHECK_LT(lane, p_);
+  // The scratch space that EVP_PBE_scrypt() allocates for its lanes.
+  const size_t words = 32 * r_ * (N_ + 2);
+  uint32_t* x = static_cast<uint32_t*>(OPENSSL_malloc(words * sizeof(*x)));
+  if (x == nullptr) {
+    EVPerr(EVP_F_EVP_PBE_SCRYPT, ERR_R_MALLOC_FAILURE);
+    return false;
+  }
+  ROMix(&blocks_[lane * 128 * r_], r_, N_, x, x + 32 * r_, x + 64 * r_);
+  OPENSSL_clear_free(x, words * sizeof(*x));
+  return true;
+}
+
+
+bool ScryptLanes::Finish(const char* pass,
+                         size_t pass_len,
+                         unsigned char* key,
+                         size_t key_len) {
+  return PKCS5_PBKDF2_HMAC(pass, pass_len, blocks_.data(), blocks_.size(), 1,
+                           EVP_sha256(), key_len, key) == 1;
+}
+
+}  // namespace crypto
+}  // namespace node
+
+#endif  // !OPENSSL_NO_SCRYPT
@@ -0,0 +1,57 @@
+#ifndef SRC_NODE_CRYPTO_SCRYPT_H_
+#define SRC_NODE_CRYPTO_SCRYPT_H_
+
+#if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#include <openssl/evp.h>
+
+#ifndef OPENSSL_NO_SCRYPT
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+namespace node {
+namespace crypto {
+
+// Computes an scrypt derivation in steps, so that its p lanes, which are
+// independent of each other, can run on different threads (RFC 7914, section
+// 6). The result is the same as that of EVP_PBE_scrypt(), and the parameters
+// must have been validated with it.
+//
+// Init() expands the password and salt into p blocks, RunLane() mixes one of
+// them, and Finish() derives the key once every lane has run.
+class ScryptLanes {
+ public:
+  ScryptLanes(uint32_t N, uint32_t r, uint32_t p);
+  ~ScryptLanes();
+
+  bool Init(const char* pass,
+            size_t pass_len,
+            const unsigned char* salt,
+            size_t salt_len);
+  // May be called from several threads at once, for different lanes.
+  bool RunLane(uint32_t lane);
+  bool Finish(const char* pass,
+              size_t pass_len,
+              unsigned char* key,
+              size_t key_len);
+
+  ScryptLanes(const ScryptLanes&) = delete;
+  ScryptLanes& operator=(const ScryptLanes&) = delete;
+
+ private:
+  const uint64_t N_;
+  const uint64_t r_;
+  const uint32_t p_;
+  std::vector<unsigned char> blocks_;
+};
+
+}  // namespace crypto
+}  // namespace node
+
+#endif  // !OPENSSL_NO_SCRYPT
+
+#endif  // defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#endif  // SRC_NODE_CRYPTO_SCRYPT_H_
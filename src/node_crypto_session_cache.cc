@@ -0,0 +1,524 @@
+#include "node_crypto_session_cache.h"
+#include "base_object-inl.h"
+#include "env-inl.h"
+#include "util-inl.h"
+#include "uv.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <string.h>
+#include <time.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>  // NOLINT(build/c++11)
+#include <thread>  // NOLINT(build/c++11)
+
+namespace node {
+
+using v8::Float64Array;
+using v8::FunctionCallbackInfo;
+using v8::FunctionTemplate;
+using v8::Integer;
+using v8::Local;
+using v8::Object;
+using v8::String;
+using v8::Uint32;
+using v8::Value;
+
+namespace crypto {
+
+namespace {
+
+// "NSC" followed by the layout version.
+constexpr uint32_t kMagic = 0x4e534301;
+// TLS session IDs are at most 32 bytes long.
+constexpr size_t kMaxIdLength = 32;
+// How often LockBucket() tries to take a lock before it gives up, and after
+// how many attempts it starts yielding the CPU in between.
+constexpr int kLockAttempts = 4096;
+constexpr int kLockSpins = 64;
+// How long Open() waits for another process to initialize a new file.
+constexpr int kInitAttempts = 1000;
+
+enum InitState : uint32_t {
+  kUninitialized,
+  kInitializing,
+  kReady
+};
+
+inline uint32_t HashId(const unsigned char* id, size_t id_length) {
+  // FNV-1a, with the finalizer of MurmurHash3 so that the low bits, which
+  // select the bucket, depend on all of the input.
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i < id_length; i++) {
+    hash ^= id[i];
+    hash *= 16777619u;
+  }
+  hash ^= hash >> 16;
+  hash *= 0x85ebca6bu;
+  hash ^= hash >> 13;
+  hash *= 0xc2b2ae35u;
+  hash ^= hash >> 16;
+  return hash;
+}
+
+}  // anonymous namespace
+
+// The region starts with a Header, followed by the buckets. A file is zero
+// filled when it is created, which is a valid state for all of the fields;
+// the process that moves `state` from kUninitialized to kInitializing fills
+// in the rest.
+struct SessionCacheStore::Header {
+  std::atomic<uint32_t> state;
+  uint32_t magic;
+  uint32_t slot_size;
+  uint32_t buckets;
+  std::atomic<uint64_t> clock;
+  std::atomic<uint64_t> stats[kStatsFieldCount];
+};
+
+struct SessionCacheStore::Slot {
+  // A tick of Header::clock, or 0 if the slot is empty.
+  uint64_t last_used;
+  // In seconds since the epoch.
+  int64_t expires;
+  uint32_t length;
+  uint32_t id_length;
+  unsigned char id[kMaxIdLength];
+  unsigned char data[kMaxSessionSize];
+};
+
+namespace {
+
+constexpr size_t kHeaderSize = 128;
+constexpr size_t kBucketLockSize = 64;
+
+template <typename T>
+constexpr size_t BucketSize() {
+  return kBucketLockSize + SessionCacheStore::kWays * sizeof(T);
+}
+
+}  // anonymous namespace
+
+
+SessionCacheStore::SessionCacheStore(char* base,
+                                     size_t size,
+                                     bool mapped,
+                                     uint32_t ttl)
+    : base_(base), size_(size), mapped_(mapped), ttl_(ttl) {
+  static_assert(sizeof(Header) <= kHeaderSize, "Header is too large");
+  static_assert(sizeof(std::atomic<uint32_t>) <= kBucketLockSize,
+                "Bucket lock is too large");
+}
+
+
+SessionCacheStore::~SessionCacheStore() {
+  if (!mapped_) {
+    free(base_);
+    return;
+  }
+#ifdef _WIN32
+  UnmapViewOfFile(base_);
+#else
+  munmap(base_, size_);
+#endif
+}
+
+
+#ifdef _WIN32
+// Maps the file at `path`, giving it `size` bytes if it is new. The file has
+// to consist of a header and whole buckets of `bucket_size` bytes.
+static char* MapFile(const char* path,
+                     size_t size,
+                     size_t bucket_size,
+                     size_t* mapped,
+                     int* err) {
+  int length = MultiByteToWideChar(CP_UTF8, 0, path, -1, nullptr, 0);
+  if (length == 0) {
+    *err = uv_translate_sys_error(GetLastError());
+    return nullptr;
+  }
+  MaybeStackBuffer<wchar_t> wpath(length);
+  MultiByteToWideChar(CP_UTF8, 0, path, -1, *wpath, length);
+
+  HANDLE file = CreateFileW(*wpath,
+                            GENERIC_READ | GENERIC_WRITE,
+                            FILE_SHARE_READ | FILE_SHARE_WRITE,
+                            nullptr,
+                            OPEN_ALWAYS,
+                            FILE_ATTRIBUTE_NORMAL,
+                            nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    *err = uv_translate_sys_error(GetLastError());
+    return nullptr;
+  }
+
+  char* base = nullptr;
+  LARGE_INTEGER file_size;
+  HANDLE mapping = nullptr;
+  if (!GetFileSizeEx(file, &file_size))
+    goto fail;
+  if (file_size.QuadPart == 0) {
+    file_size.QuadPart = size;
+    if (!SetFilePointerEx(file, file_size, nullptr, FILE_BEGIN) ||
+        !SetEndOfFile(file)) {
+      goto fail;
+    }
+  }
+  if (static_cast<size_t>(file_size.QuadPart) < kHeaderSize + bucket_size ||
+      (file_size.QuadPart - kHeaderSize) % bucket_size != 0) {
+    SetLastError(ERROR_INVALID_DATA);
+    goto fail;
+  }
+  mapping = CreateFileMappingW(file, nullptr, PAGE_READWRITE, 0, 0, nullptr);
+  if (mapping == nullptr)
+    goto fail;
+  base = static_cast<char*>(
+      MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, 0));
+  if (base == nullptr)
+    goto fail;
+  CloseHandle(mapping);
+  CloseHandle(file);
+  *mapped = static_cast<size_t>(file_size.QuadPart);
+  return base;
+
+ fail:
+  *err = uv_translate_sys_error(GetLastError());
+  if (mapping != nullptr)
+    CloseHandle(mapping);
+  CloseHandle(file);
+  return nullptr;
+}
+#else
+static char* MapFile(const char* path,
+                     size_t size,
+                     size_t bucket_size,
+                     size_t* mapped,
+                     int* err) {
+  // The file holds session secrets: never follow a symlink to it, and only
+  // use a file that nobody else could have written to.
+  int fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC | O_NOFOLLOW, 0600);
+  if (fd == -1) {
+    *err = uv_translate_sys_error(errno);
+    return nullptr;
+  }
+
+  struct stat st;
+  void* base = MAP_FAILED;
+  if (fstat(fd, &st) != 0)
+    goto done;
+  if (!S_ISREG(st.st_mode) || st.st_uid != geteuid() ||
+      (st.st_mode & 077) != 0) {
+    errno = EACCES;
+    goto done;
+  }
+  // Only the process that creates the file decides how large it is. After
+  // that, it has to be exactly as large as a header and whole buckets.
+  if (st.st_size == 0) {
+    if (ftruncate(fd, size) != 0 || fstat(fd, &st) != 0)
+      goto done;
+  }
+  if (static_cast<size_t>(st.st_size) < kHeaderSize + bucket_size ||
+      (st.st_size - kHeaderSize) % bucket_size != 0) {
+    errno = EINVAL;
+    goto done;
+  }
+  base = mmap(nullptr, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+ done:
+  if (base == MAP_FAILED)
+    *err = uv_translate_sys_error(errno);
+  close(fd);
+  if (base == MAP_FAILED)
+    return nullptr;
+  *mapped = st.st_size;
+  return static_cast<char*>(base);
+}
+#endif
+
+
+std::shared_ptr<SessionCacheStore> SessionCacheStore::Open(
+    const char* path, uint32_t max_entries, uint32_t ttl, int* err) {
+  const uint32_t buckets = std::max((max_entries + kWays - 1) / kWays, 1u);
+  const size_t size = kHeaderSize + buckets * BucketSize<Slot>();
+
+  char* base;
+  size_t mapped_size = size;
+  if (path == nullptr) {
+    base = UncheckedCalloc(size);
+    if (base == nullptr) {
+      *err = UV_ENOMEM;
+      return nullptr;
+    }
+  } else {
+    base = MapFile(path, size, BucketSize<Slot>(), &mapped_size, err);
+    if (base == nullptr)
+      return nullptr;
+  }
+
+  std::shared_ptr<SessionCacheStore> store(
+      new SessionCacheStore(base, mapped_size, path != nullptr, ttl));
+  Header* header = store->header();
+
+  uint32_t state = kUninitialized;
+  if (mapped_size >= kHeaderSize &&
+      header->state.compare_exchange_strong(state, kInitializing)) {
+    header->magic = kMagic;
+    header->slot_size = sizeof(Slot);
+    header->buckets = (mapped_size - kHeaderSize) / BucketSize<Slot>();
+    header->state.store(kReady, std::memory_order_release);
+  } else {
+    for (int i = 0; mapped_size >= kHeaderSize && i < kInitAttempts; i++) {
+      // Anything other than kInitializing means that there is nothing to wait
+      // for, whether the file is ready or not a session cache at all.
+      if (header->state.load(std::memory_order_acquire) != kInitializing)
+        break;
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+
+  if (mapped_size < kHeaderSize ||
+      header->state.load(std::memory_order_acquire) != kReady ||
+      header->magic != kMagic ||
+      header->slot_size != sizeof(Slot) ||
+      header->buckets == 0 ||
+      kHeaderSize + header->buckets * BucketSize<Slot>() != mapped_size) {
+    // Not a session cache, or one written by an incompatible version.
+    *err = UV_EINVAL;
+    return nullptr;
+  }
+
+  return store;
+}
+
+
+SessionCacheStore::Header* SessionCacheStore::header() const {
+  return reinterpret_cast<Header*>(base_);
+}
+
+
+SessionCacheStore::Slot* SessionCacheStore::slot(uint32_t index) const {
+  const uint32_t bucket = index / kWays;
+  char* start = base_ + kHeaderSize + bucket * BucketSize<Slot>() +
+                kBucketLockSize;
+  return reinterpret_cast<Slot*>(start) + index % kWays;
+}
+
+
+uint32_t SessionCacheStore::BucketOf(const unsigned char* id,
+                                     size_t id_length) const {
+  return HashId(id, id_length) % header()->buckets;
+}
+
+
+bool SessionCacheStore::LockBucket(uint32_t bucket) {
+  std::atomic<uint32_t>* lock = reinterpret_cast<std::atomic<uint32_t>*>(
+      base_ + kHeaderSize + bucket * BucketSize<Slot>());
+  for (int i = 0; i < kLockAttempts; i++) {
+    uint32_t expected = 0;
+    if (lock->compare_exchange_weak(expected, 1, std::memory_order_acquire))
+      return true;
+    if (i >= kLockSpins)
+      std::this_thread::yield();
+  }
+  return false;
+}
+
+
+void SessionCacheStore::UnlockBucket(uint32_t bucket) {
+  std::atomic<uint32_t>* lock = reinterpret_cast<std::atomic<uint32_t>*>(
+      base_ + kHeaderSize + bucket * BucketSize<Slot>());
+  lock->store(0, std::memory_order_release);
+}
+
+
+void SessionCacheStore::Count(StatsField field) {
+  header()->stats[field].fetch_add(1, std::memory_order_relaxed);
+}
+
+
+bool SessionCacheStore::Store(const unsigned char* id,
+                              size_t id_length,
+                              const unsigned char* data,
+                              size_t length,
+                              uint32_t timeout) {
+  if (id_length == 0 || id_length > kMaxIdLength ||
+      length == 0 || length > kMaxSessionSize) {
+    return false;
+  }
+
+  const int64_t now = time(nullptr);
+  const uint32_t bucket = BucketOf(id, id_length);
+  if (!LockBucket(bucket))
+    return false;
+
+  Slot* match = nullptr;
+  Slot* unused = nullptr;
+  Slot* oldest = nullptr;
+  for (uint32_t i = 0; i < kWays; i++) {
+    Slot* s = slot(bucket * kWays + i);
+    if (s->last_used == 0 || s->expires <= now) {
+      if (unused == nullptr)
+        unused = s;
+      continue;
+    }
+    if (s->id_length == id_length && memcmp(s->id, id, id_length) == 0) {
+      match = s;
+      break;
+    }
+    if (oldest == nullptr || s->last_used < oldest->last_used)
+      oldest = s;
+  }
+
+  Slot* target = match != nullptr ? match :
+                 unused != nullptr ? unused : oldest;
+  if (target == oldest)
+    Count(kEvictions);
+  target->expires = now + std::min(ttl_, timeout);
+  target->length = length;
+  target->id_length = id_length;
+  memcpy(target->id, id, id_length);
+  memcpy(target->data, data, length);
+  target->last_used = header()->clock.fetch_add(1) + 1;
+  UnlockBucket(bucket);
+
+  Count(kStores);
+  return true;
+}
+
+
+size_t SessionCacheStore::Lookup(const unsigned char* id,
+                                 size_t id_length,
+                                 unsigned char* data) {
+  size_t length = 0;
+  if (id_length == 0 || id_length > kMaxIdLength) {
+    Count(kMisses);
+    return length;
+  }
+
+  const int64_t now = time(nullptr);
+  const uint32_t bucket = BucketOf(id, id_length);
+  if (!LockBucket(bucket)) {
+    Count(kMisses);
+    return length;
+  }
+
+  for (uint32_t i = 0; i < kWays; i++) {
+    Slot* s = slot(bucket * kWays + i);
+    if (s->last_used == 0 || s->id_length != id_length ||
+        memcmp(s->id, id, id_length) != 0) {
+      continue;
+    }
+    if (s->expires <= now) {
+      s->last_used = 0;
+      break;
+    }
+    // Another process may have written anything to the slot.
+    if (s->length == 0 || s->length > kMaxSessionSize) {
+      s->last_used = 0;
+      break;
+    }
+    length = s->length;
+    memcpy(data, s->data, length);
+    s->last_used = header()->clock.fetch_add(1) + 1;
+    break;
+  }
+  UnlockBucket(bucket);
+
+  Count(length > 0 ? kHits : kMisses);
+  return length;
+}
+
+
+void SessionCacheStore::GetStats(double* fields) const {
+  for (int i = 0; i < kStatsFieldCount; i++)
+    fields[i] = header()->stats[i].load(std::memory_order_relaxed);
+}
+
+
+uint32_t SessionCacheStore::max_entries() const {
+  return header()->buckets * kWays;
+}
+
+
+SessionCache::SessionCache(Environment* env,
+                           Local<Object> wrap,
+                           std::shared_ptr<SessionCacheStore> store)
+    : BaseObject(env, wrap), store_(std::move(store)) {
+  MakeWeak();
+}
+
+
+void SessionCache::Initialize(Environment* env, Local<Object> target) {
+  Local<FunctionTemplate> t = env->NewFunctionTemplate(New);
+  t->InstanceTemplate()->SetInternalFieldCount(1);
+  Local<String> session_cache_string =
+      FIXED_ONE_BYTE_STRING(env->isolate(), "SessionCache");
+  t->SetClassName(session_cache_string);
+
+  env->SetProtoMethodNoSideEffect(t, "getStats", GetStats);
+  env->SetProtoMethodNoSideEffect(t, "getMaxEntries", GetMaxEntries);
+
+  target->Set(env->context(), session_cache_string,
+              t->GetFunction(env->context()).ToLocalChecked()).FromJust();
+}
+
+
+// new SessionCache(path, maxEntries, ttl)
+void SessionCache::New(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(args.IsConstructCall());
+  CHECK(args[0]->IsUndefined() || args[0]->IsString());
+  CHECK(args[1]->IsUint32());
+  CHECK(args[2]->IsUint32());
+
+  const uint32_t max_entries = args[1].As<Uint32>()->Value();
+  const uint32_t ttl = args[2].As<Uint32>()->Value();
+
+  int err = 0;
+  std::shared_ptr<SessionCacheStore> store;
+  if (args[0]->IsString()) {
+    node::Utf8Value path(env->isolate(), args[0]);
+    store = SessionCacheStore::Open(*path, max_entries, ttl, &err);
+    if (!store)
+      return env->ThrowUVException(err, "open", nullptr, *path);
+  } else {
+    store = SessionCacheStore::Open(nullptr, max_entries, ttl, &err);
+    if (!store)
+      return env->ThrowUVException(err, "malloc");
+  }
+
+  new SessionCache(env, args.This(), std::move(store));
+}
+
+
+void SessionCache::GetStats(const FunctionCallbackInfo<Value>& args) {
+  SessionCache* cache;
+  ASSIGN_OR_RETURN_UNWRAP(&cache, args.Holder());
+  CHECK(args[0]->IsFloat64Array());
+  Local<Float64Array> array = args[0].As<Float64Array>();
+  CHECK_EQ(array->Length(), SessionCacheStore::kStatsFieldCount);
+  char* data = static_cast<char*>(array->Buffer()->GetContents().Data());
+  cache->store_->GetStats(
+      reinterpret_cast<double*>(data + array->ByteOffset()));
+}
+
+
+void SessionCache::GetMaxEntries(const FunctionCallbackInfo<Value>& args) {
+  SessionCache* cache;
+  ASSIGN_OR_RETURN_UNWRAP(&cache, args.Holder());
+  args.GetReturnValue().Set(
+      Integer::NewFromUnsigned(args.GetIsolate(),
+                               cache->store_->max_entries()));
+}
+
+}  // namespace crypto
+}  // namespace node
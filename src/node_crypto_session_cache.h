@@ -0,0 +1,128 @@
+#ifndef SRC_NODE_CRYPTO_SESSION_CACHE_H_
+#define SRC_NODE_CRYPTO_SESSION_CACHE_H_
+
+#if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#include "base_object.h"
+#include "v8.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <memory>
+
+namespace node {
+
+class Environment;
+
+namespace crypto {
+
+// A cache of serialized TLS server sessions, keyed by session ID. The entries
+// live in a single memory region that is either private to the process, or a
+// file that is mapped by every process and thread that opens the same path,
+// so that a session established by one cluster worker can be resumed by any
+// other.
+//
+// The region is a set-associative hash table: a session ID selects a bucket
+// of kWays slots, and the least recently used slot of a full bucket is
+// evicted. Every bucket has its own spinlock. The lock is only ever held for
+// a copy of one slot, and a caller that cannot take it after a bounded number
+// of attempts gives up instead of blocking, so a process that dies while
+// holding a lock makes that bucket miss rather than hang the others.
+class SessionCacheStore {
+ public:
+  static constexpr uint32_t kWays = 8;
+  // Sessions larger than this, usually ones that carry a long client
+  // certificate chain, are not cached.
+  static constexpr size_t kMaxSessionSize = 2048 - 64;
+
+  // Fields reported by GetStats(), in this order. The counters are shared by
+  // every user of a file-backed cache.
+  enum StatsField {
+    kHits,
+    kMisses,
+    kStores,
+    kEvictions,
+    kStatsFieldCount
+  };
+
+  // Opens the cache backed by the file at `path`, creating it if necessary,
+  // or a private in-memory cache if `path` is nullptr. `max_entries` is
+  // rounded up to a multiple of kWays, and is ignored when the file already
+  // holds a cache. Returns nullptr and sets `*err` to a libuv error code on
+  // failure.
+  static std::shared_ptr<SessionCacheStore> Open(const char* path,
+                                                 uint32_t max_entries,
+                                                 uint32_t ttl,
+                                                 int* err);
+
+  ~SessionCacheStore();
+
+  // Stores `data` under `id`. The entry expires after the cache's TTL or
+  // `timeout` seconds, whichever comes first.
+  bool Store(const unsigned char* id, size_t id_length,
+             const unsigned char* data, size_t length,
+             uint32_t timeout);
+
+  // Copies the entry for `id` into `data`, which must be able to hold
+  // kMaxSessionSize bytes, and returns its length, or 0 if there is no
+  // entry that has not expired.
+  size_t Lookup(const unsigned char* id, size_t id_length,
+                unsigned char* data);
+
+  void GetStats(double* fields) const;
+
+  uint32_t max_entries() const;
+  uint32_t ttl() const { return ttl_; }
+
+  SessionCacheStore(const SessionCacheStore&) = delete;
+  SessionCacheStore& operator=(const SessionCacheStore&) = delete;
+
+ private:
+  struct Header;
+  struct Slot;
+
+  SessionCacheStore(char* base, size_t size, bool mapped, uint32_t ttl);
+
+  Header* header() const;
+  Slot* slot(uint32_t index) const;
+  uint32_t BucketOf(const unsigned char* id, size_t id_length) const;
+  bool LockBucket(uint32_t bucket);
+  void UnlockBucket(uint32_t bucket);
+  void Count(StatsField field);
+
+  char* const base_;
+  const size_t size_;
+  const bool mapped_;
+  const uint32_t ttl_;
+};
+
+// JS handle for a SessionCacheStore. SecureContext::SetSessionCache() shares
+// the store with every connection that is created from the context.
+class SessionCache : public BaseObject {
+ public:
+  static void Initialize(Environment* env, v8::Local<v8::Object> target);
+
+  const std::shared_ptr<SessionCacheStore>& store() const { return store_; }
+
+  SET_NO_MEMORY_INFO()
+  SET_MEMORY_INFO_NAME(SessionCache)
+  SET_SELF_SIZE(SessionCache)
+
+ private:
+  SessionCache(Environment* env,
+               v8::Local<v8::Object> wrap,
+               std::shared_ptr<SessionCacheStore> store);
+
+  static void New(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void GetStats(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void GetMaxEntries(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+  std::shared_ptr<SessionCacheStore> store_;
+};
+
+}  // namespace crypto
+}  // namespace node
+
+#endif  // defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#endif  // SRC_NODE_CRYPTO_SESSION_CACHE_H_
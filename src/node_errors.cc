@@ -1,6 +1,9 @@
 #include <stdarg.h>
+#include <atomic>
 #include "node_errors.h"
 #include "node_internals.h"
+#include "tracing/agent.h"
+#include "tracing/trace_event.h"
 
 namespace node {
 
@@ -151,9 +154,21 @@ void AppendExceptionLine(Environment* env,
             .FromMaybe(false));
 }
 
+static void DumpFlightRecorder() {
+  // Do not try again if dumping the trace buffer is what failed.
+  static std::atomic_bool dumping { false };
+  tracing::Agent* agent = tracing::TraceEventHelper::GetAgent();
+  if (agent == nullptr || agent->buffer_mode() != tracing::Agent::kRingBuffer)
+    return;
+  if (dumping.exchange(true))
+    return;
+  agent->DumpTraceBuffer();
+}
+
 [[noreturn]] void Abort() {
   DumpBacktrace(stderr);
   fflush(stderr);
+  DumpFlightRecorder();
   ABORT_NO_BACKTRACE();
 }
 
@@ -397,6 +412,7 @@ void FatalException(Isolate* isolate,
 
     } else if (caught.ToLocalChecked()->IsFalse()) {
       ReportException(env, error, message);
+      profiler::EndStartedProfilers(env);
 
       // fatal_exception_function call before may have set a new exit code ->
       // read it again, otherwise use default for uncaughtException 1
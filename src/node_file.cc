@@ -1208,7 +1208,7 @@ static void RMDir(const FunctionCallbackInfo<Value>& args) {
 }
 
 int MKDirpSync(uv_loop_t* loop, uv_fs_t* req, const std::string& path, int mode,
-               uv_fs_cb cb = nullptr) {
+               uv_fs_cb cb) {
   FSContinuationData continuation_data(req, mode, cb);
   continuation_data.PushPath(std::move(path));
 
@@ -29,6 +29,7 @@
 #include "node_binding.h"
 #include "node_mutex.h"
 #include "node_persistent.h"
+#include "node_threadpool.h"
 #include "tracing/trace_event.h"
 #include "util-inl.h"
 #include "uv.h"
@@ -120,6 +121,9 @@ void GetSockOrPeerName(const v8::FunctionCallbackInfo<v8::Value>& args) {
 }
 
 void SignalExit(int signo);
+// Returns the number of the signal called `name`, e.g. "SIGUSR2", or 0 if
+// there is no such signal.
+int signo_from_string(const std::string& name);
 #ifdef __POSIX__
 void RegisterSignalHandler(int signal,
                            void (*handler)(int signal),
@@ -290,16 +294,21 @@ v8::MaybeLocal<v8::Value> InternalMakeCallback(
     const v8::Local<v8::Function> callback,
     int argc,
     v8::Local<v8::Value> argv[],
-    async_context asyncContext);
+    async_context asyncContext,
+    v8::Local<v8::Value> context_frame = v8::Local<v8::Value>());
 
 class InternalCallbackScope {
  public:
   // Tell the constructor whether its `object` parameter may be empty or not.
   enum ResourceExpectation { kRequireResource, kAllowEmptyResource };
+  // If `context_frame` is empty, the callback inherits the current context
+  // frame instead of switching to the resource's one.
   InternalCallbackScope(Environment* env,
                         v8::Local<v8::Object> object,
                         const async_context& asyncContext,
-                        ResourceExpectation expect = kRequireResource);
+                        ResourceExpectation expect = kRequireResource,
+                        v8::Local<v8::Value> context_frame =
+                            v8::Local<v8::Value>());
   // Utility that can be used by AsyncWrap classes.
   explicit InternalCallbackScope(AsyncWrap* async_wrap);
   ~InternalCallbackScope();
@@ -320,43 +329,35 @@ class InternalCallbackScope {
 
 class ThreadPoolWork {
  public:
-  explicit inline ThreadPoolWork(Environment* env) : env_(env) {
+  inline ThreadPoolWork(Environment* env, threadpool::QueueType queue)
+      : env_(env), queue_(queue) {
     CHECK_NOT_NULL(env);
   }
   inline virtual ~ThreadPoolWork() = default;
 
-  inline void ScheduleWork();
-  inline int CancelWork();
+  void ScheduleWork();
+  int CancelWork();
 
   virtual void DoThreadPoolWork() = 0;
   virtual void AfterThreadPoolWork(int status) = 0;
 
  private:
+  friend class threadpool::CompletionQueue;
+  friend class threadpool::Queue;
+
+  // Called on the thread that runs the work.
+  void RunWork();
+  // Called on the event loop thread once the work has run or was cancelled.
+  void FinishWork(int status);
+
   Environment* env_;
+  threadpool::QueueType queue_;
+  uint64_t queued_at_ = 0;
+  uint64_t started_at_ = 0;
+  uint64_t finished_at_ = 0;
   uv_work_t work_req_;
 };
 
-void ThreadPoolWork::ScheduleWork() {
-  env_->IncreaseWaitingRequestCounter();
-  int status = uv_queue_work(
-      env_->event_loop(),
-      &work_req_,
-      [](uv_work_t* req) {
-        ThreadPoolWork* self = ContainerOf(&ThreadPoolWork::work_req_, req);
-        self->DoThreadPoolWork();
-      },
-      [](uv_work_t* req, int status) {
-        ThreadPoolWork* self = ContainerOf(&ThreadPoolWork::work_req_, req);
-        self->env_->DecreaseWaitingRequestCounter();
-        self->AfterThreadPoolWork(status);
-      });
-  CHECK_EQ(status, 0);
-}
-
-int ThreadPoolWork::CancelWork() {
-  return uv_cancel(reinterpret_cast<uv_req_t*>(&work_req_));
-}
-
 tracing::AgentWriterHandle* GetTracingAgentWriter();
 
 static inline const char* errno_string(int errorno) {
@@ -737,6 +738,15 @@ namespace credentials {
 bool SafeGetenv(const char* key, std::string* text);
 }  // namespace credentials
 
+namespace heap {
+// Takes a heap snapshot and streams it to `path` while it is being
+// serialized. Returns 0 or a libuv error code, and the name of the failing
+// call.
+int WriteSnapshot(v8::Isolate* isolate,
+                  const std::string& path,
+                  const char** syscall);
+}  // namespace heap
+
 void DefineZlibConstants(v8::Local<v8::Object> target);
 
 }  // namespace node
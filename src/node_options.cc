@@ -1,4 +1,5 @@
 #include <errno.h>
+#include <limits.h>
 #include "node_internals.h"
 #include "node_options-inl.h"
 
@@ -24,6 +25,14 @@ void PerProcessOptions::CheckOptions(std::vector<std::string>* errors) {
                       "used, not both");
   }
 #endif
+  if (trace_event_format != "json" && trace_event_format != "protobuf") {
+    errors->push_back("invalid value for --trace-event-format");
+  }
+  for (const std::string& queue : threadpool_queues) {
+    std::string error;
+    if (!threadpool::ValidateQueueOption(queue, &error))
+      errors->push_back(error);
+  }
   per_isolate->CheckOptions(errors);
 }
 
@@ -44,6 +53,49 @@ void EnvironmentOptions::CheckOptions(std::vector<std::string>* errors) {
     errors->push_back("invalid value for --http-parser");
   }
 
+  if (!cpu_prof) {
+    if (!cpu_prof_dir.empty())
+      errors->push_back("--cpu-prof-dir must be used with --cpu-prof");
+    if (!cpu_prof_name.empty())
+      errors->push_back("--cpu-prof-name must be used with --cpu-prof");
+    if (!cpu_prof_signal.empty())
+      errors->push_back("--cpu-prof-signal must be used with --cpu-prof");
+  }
+
+  if (cpu_prof_interval == 0 || cpu_prof_interval > INT_MAX) {
+    errors->push_back("invalid value for --cpu-prof-interval");
+  }
+
+  if (!cpu_prof_signal.empty() && signo_from_string(cpu_prof_signal) == 0) {
+    errors->push_back("invalid value for --cpu-prof-signal");
+  }
+
+  if (!heap_prof) {
+    if (!heap_prof_dir.empty())
+      errors->push_back("--heap-prof-dir must be used with --heap-prof");
+    if (!heap_prof_name.empty())
+      errors->push_back("--heap-prof-name must be used with --heap-prof");
+    if (!heap_prof_signal.empty())
+      errors->push_back("--heap-prof-signal must be used with --heap-prof");
+  }
+
+  if (heap_prof_interval == 0) {
+    errors->push_back("invalid value for --heap-prof-interval");
+  }
+
+  if (heap_prof_stack_depth == 0 || heap_prof_stack_depth > INT_MAX) {
+    errors->push_back("invalid value for --heap-prof-stack-depth");
+  }
+
+  if (!heap_prof_signal.empty() && signo_from_string(heap_prof_signal) == 0) {
+    errors->push_back("invalid value for --heap-prof-signal");
+  }
+
+  if (!heapsnapshot_signal.empty() &&
+      signo_from_string(heapsnapshot_signal) == 0) {
+    errors->push_back("invalid value for --heapsnapshot-signal");
+  }
+
 #if HAVE_INSPECTOR
   debug_options_.CheckOptions(errors);
 #endif  // HAVE_INSPECTOR
@@ -92,6 +144,30 @@ const DebugOptionsParser DebugOptionsParser::instance;
 #endif  // HAVE_INSPECTOR
 
 EnvironmentOptionsParser::EnvironmentOptionsParser() {
+  AddOption("--cpu-prof",
+            "start the V8 CPU profiler on start up, and write the CPU profile "
+            "to disk before exit",
+            &EnvironmentOptions::cpu_prof,
+            kAllowedInEnvironment);
+  AddOption("--cpu-prof-dir",
+            "directory where the CPU profiles generated by --cpu-prof will "
+            "be placed (default: the current working directory)",
+            &EnvironmentOptions::cpu_prof_dir,
+            kAllowedInEnvironment);
+  AddOption("--cpu-prof-interval",
+            "sampling interval in microseconds for the CPU profiles "
+            "generated by --cpu-prof (default: 1000)",
+            &EnvironmentOptions::cpu_prof_interval,
+            kAllowedInEnvironment);
+  AddOption("--cpu-prof-name",
+            "file name of the CPU profile generated by --cpu-prof",
+            &EnvironmentOptions::cpu_prof_name,
+            kAllowedInEnvironment);
+  AddOption("--cpu-prof-signal",
+            "write the CPU profile generated by --cpu-prof to disk and "
+            "start a new one when the given signal is received",
+            &EnvironmentOptions::cpu_prof_signal,
+            kAllowedInEnvironment);
   AddOption("--experimental-modules",
             "experimental ES Module support and caching modules",
             &EnvironmentOptions::experimental_modules,
@@ -109,6 +185,39 @@ EnvironmentOptionsParser::EnvironmentOptionsParser() {
             &EnvironmentOptions::experimental_worker,
             kAllowedInEnvironment);
   AddOption("--expose-internals", "", &EnvironmentOptions::expose_internals);
+  AddOption("--heap-prof",
+            "start the V8 sampling heap profiler on start up, and write the "
+            "heap profile to disk before exit",
+            &EnvironmentOptions::heap_prof,
+            kAllowedInEnvironment);
+  AddOption("--heap-prof-dir",
+            "directory where the heap profiles generated by --heap-prof will "
+            "be placed (default: the current working directory)",
+            &EnvironmentOptions::heap_prof_dir,
+            kAllowedInEnvironment);
+  AddOption("--heap-prof-interval",
+            "average sampling interval in bytes for the heap profiles "
+            "generated by --heap-prof (default: 512 * 1024)",
+            &EnvironmentOptions::heap_prof_interval,
+            kAllowedInEnvironment);
+  AddOption("--heap-prof-name",
+            "file name of the heap profile generated by --heap-prof",
+            &EnvironmentOptions::heap_prof_name,
+            kAllowedInEnvironment);
+  AddOption("--heap-prof-signal",
+            "write the heap profile generated by --heap-prof to disk when "
+            "the given signal is received",
+            &EnvironmentOptions::heap_prof_signal,
+            kAllowedInEnvironment);
+  AddOption("--heap-prof-stack-depth",
+            "maximum number of stack frames that are recorded for each "
+            "allocation by --heap-prof (default: 16)",
+            &EnvironmentOptions::heap_prof_stack_depth,
+            kAllowedInEnvironment);
+  AddOption("--heapsnapshot-signal",
+            "write a heap snapshot to disk when the given signal is received",
+            &EnvironmentOptions::heapsnapshot_signal,
+            kAllowedInEnvironment);
   AddOption("--http-parser",
             "Select which HTTP parser to use; either 'legacy' or 'llhttp' "
             "(default: llhttp).",
@@ -257,12 +366,27 @@ PerProcessOptionsParser::PerProcessOptionsParser() {
             "data, it supports ${rotation} and ${pid}.",
             &PerProcessOptions::trace_event_file_pattern,
             kAllowedInEnvironment);
+  AddOption("--trace-event-format",
+            "format of the trace-events data, 'json' (default) or "
+            "'protobuf'",
+            &PerProcessOptions::trace_event_format,
+            kAllowedInEnvironment);
+  AddOption("--trace-event-flight-recorder",
+            "keep the most recent trace events in memory and only write "
+            "them out on a fatal error or on request",
+            &PerProcessOptions::trace_event_flight_recorder,
+            kAllowedInEnvironment);
   AddAlias("--trace-events-enabled", {
     "--trace-event-categories", "v8,node,node.async_hooks" });
   AddOption("--max-http-header-size",
             "set the maximum size of HTTP headers (default: 8KB)",
             &PerProcessOptions::max_http_header_size,
             kAllowedInEnvironment);
+  AddOption("--threadpool-queue",
+            "run a class of threadpool work (fs, crypto, kdf, zlib or napi) "
+            "on dedicated threads, as <queue>:<threads>[:<priority>]",
+            &PerProcessOptions::threadpool_queues,
+            kAllowedInEnvironment);
   AddOption("--v8-pool-size",
             "set V8's thread pool size",
             &PerProcessOptions::v8_thread_pool_size,
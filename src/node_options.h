@@ -92,11 +92,23 @@ class DebugOptions : public Options {
 class EnvironmentOptions : public Options {
  public:
   bool abort_on_uncaught_exception = false;
+  bool cpu_prof = false;
+  std::string cpu_prof_dir;
+  uint64_t cpu_prof_interval = 1000;
+  std::string cpu_prof_name;
+  std::string cpu_prof_signal;
   bool experimental_modules = false;
   bool experimental_repl_await = false;
   bool experimental_vm_modules = false;
   bool experimental_worker = false;
   bool expose_internals = false;
+  bool heap_prof = false;
+  std::string heap_prof_dir;
+  uint64_t heap_prof_interval = 512 * 1024;
+  std::string heap_prof_name;
+  std::string heap_prof_signal;
+  uint64_t heap_prof_stack_depth = 16;
+  std::string heapsnapshot_signal;
   std::string http_parser = "llhttp";
   bool no_deprecation = false;
   bool no_force_async_hooks_checks = false;
@@ -151,8 +163,11 @@ class PerProcessOptions : public Options {
   std::string title;
   std::string trace_event_categories;
   std::string trace_event_file_pattern = "node_trace.${rotation}.log";
+  std::string trace_event_format = "json";
+  bool trace_event_flight_recorder = false;
   uint64_t max_http_header_size = 8 * 1024;
   int64_t v8_thread_pool_size = 4;
+  std::vector<std::string> threadpool_queues;
   bool zero_fill_all_buffers = false;
 
   std::vector<std::string> security_reverts;
@@ -0,0 +1,638 @@
+#include "node_profiler.h"
+#include "async_wrap-inl.h"
+#include "env-inl.h"
+#include "node_file.h"
+#include "node_internals.h"
+#include "util-inl.h"
+
+#include <fcntl.h>
+#include <time.h>
+
+#include <atomic>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace node {
+namespace profiler {
+
+using v8::AllocationProfile;
+using v8::Context;
+using v8::CpuProfile;
+using v8::CpuProfileNode;
+using v8::CpuProfiler;
+using v8::FunctionCallbackInfo;
+using v8::HandleScope;
+using v8::HeapProfiler;
+using v8::Isolate;
+using v8::Local;
+using v8::NewStringType;
+using v8::Null;
+using v8::Object;
+using v8::String;
+using v8::Uint32;
+using v8::Value;
+
+namespace {
+
+// The title of the profile started through --cpu-prof. JS titles always
+// start with the name of the API that created them, so they cannot clash.
+const char kCliProfileTitle[] = "--cpu-prof";
+
+#ifdef _WIN32
+constexpr char kPathSeparator = '\\';
+const char* const kPathSeparators = "\\/";
+#else
+constexpr char kPathSeparator = '/';
+const char* const kPathSeparators = "/";
+#endif
+
+Local<String> ToV8String(Isolate* isolate, const std::string& str) {
+  return String::NewFromUtf8(isolate, str.data(), NewStringType::kNormal,
+                             str.size()).ToLocalChecked();
+}
+
+void AppendJSONString(std::string* out, const char* str) {
+  static const char hex[] = "0123456789abcdef";
+  out->push_back('"');
+  for (const char* p = str; *p != '\0'; p++) {
+    const unsigned char c = static_cast<unsigned char>(*p);
+    if (c == '"' || c == '\\') {
+      out->push_back('\\');
+      out->push_back(c);
+    } else if (c < 0x20) {
+      out->append("\\u00");
+      out->push_back(hex[c >> 4]);
+      out->push_back(hex[c & 0xf]);
+    } else {
+      out->push_back(c);
+    }
+  }
+  out->push_back('"');
+}
+
+void AppendCallFrame(std::string* out,
+                     const char* function_name,
+                     int script_id,
+                     const char* url,
+                     int line_number,
+                     int column_number) {
+  *out += "\"callFrame\":{\"functionName\":";
+  AppendJSONString(out, function_name);
+  *out += ",\"scriptId\":\"";
+  *out += std::to_string(script_id);
+  *out += "\",\"url\":";
+  AppendJSONString(out, url);
+  // V8 counts lines and columns from 1, DevTools from 0.
+  *out += ",\"lineNumber\":";
+  *out += std::to_string(line_number - 1);
+  *out += ",\"columnNumber\":";
+  *out += std::to_string(column_number - 1);
+  out->push_back('}');
+}
+
+void AppendNode(std::string* out,
+                const CpuProfileNode* node,
+                std::vector<CpuProfileNode::LineTick>* line_ticks) {
+  *out += "{\"id\":";
+  *out += std::to_string(node->GetNodeId());
+  out->push_back(',');
+  AppendCallFrame(out,
+                  node->GetFunctionNameStr(),
+                  node->GetScriptId(),
+                  node->GetScriptResourceNameStr(),
+                  node->GetLineNumber(),
+                  node->GetColumnNumber());
+  *out += ",\"hitCount\":";
+  *out += std::to_string(node->GetHitCount());
+
+  const int children = node->GetChildrenCount();
+  if (children > 0) {
+    *out += ",\"children\":[";
+    for (int i = 0; i < children; i++) {
+      if (i > 0) out->push_back(',');
+      *out += std::to_string(node->GetChild(i)->GetNodeId());
+    }
+    out->push_back(']');
+  }
+
+  const char* deopt_reason = node->GetBailoutReason();
+  if (deopt_reason != nullptr && deopt_reason[0] != '\0') {
+    *out += ",\"deoptReason\":";
+    AppendJSONString(out, deopt_reason);
+  }
+
+  const unsigned int lines = node->GetHitLineCount();
+  line_ticks->resize(lines);
+  if (lines > 0 && node->GetLineTicks(line_ticks->data(), lines)) {
+    *out += ",\"positionTicks\":[";
+    for (unsigned int i = 0; i < lines; i++) {
+      if (i > 0) out->push_back(',');
+      *out += "{\"line\":";
+      *out += std::to_string((*line_ticks)[i].line);
+      *out += ",\"ticks\":";
+      *out += std::to_string((*line_ticks)[i].hit_count);
+      out->push_back('}');
+    }
+    out->push_back(']');
+  }
+
+  out->push_back('}');
+}
+
+// Writes `data` to `path`, creating the parent directory if needed.
+// Returns 0 or a libuv error code, and the name of the failing call.
+int WriteProfile(const std::string& data,
+                 const std::string& path,
+                 const char** syscall) {
+  uv_fs_t req;
+  int err;
+
+  const size_t separator = path.find_last_of(kPathSeparators);
+  if (separator != std::string::npos && separator > 0) {
+    *syscall = "mkdir";
+    err = fs::MKDirpSync(nullptr, &req, path.substr(0, separator), 0777);
+    uv_fs_req_cleanup(&req);
+    if (err < 0)
+      return err;
+  }
+
+  *syscall = "open";
+  const int fd = uv_fs_open(nullptr, &req, path.c_str(),
+                            O_WRONLY | O_CREAT | O_TRUNC, 0644, nullptr);
+  uv_fs_req_cleanup(&req);
+  if (fd < 0)
+    return fd;
+
+  *syscall = "write";
+  size_t offset = 0;
+  err = 0;
+  while (offset < data.size()) {
+    uv_buf_t buf = uv_buf_init(const_cast<char*>(data.data()) + offset,
+                               data.size() - offset);
+    err = uv_fs_write(nullptr, &req, fd, &buf, 1, -1, nullptr);
+    uv_fs_req_cleanup(&req);
+    if (err < 0)
+      break;
+    offset += err;
+    err = 0;
+  }
+
+  uv_fs_close(nullptr, &req, fd, nullptr);
+  uv_fs_req_cleanup(&req);
+  return err;
+}
+
+void PrintWriteError(const char* kind,
+                     const std::string& path,
+                     const char* syscall,
+                     int err) {
+  fprintf(stderr, "Could not write %s %s: %s: %s\n",
+          kind, path.c_str(), syscall, uv_strerror(err));
+  fflush(stderr);
+}
+
+int WriteProfileSync(const std::string& data,
+                     const std::string& path,
+                     const char* kind) {
+  const char* syscall;
+  const int err = WriteProfile(data, path, &syscall);
+  if (err != 0)
+    PrintWriteError(kind, path, syscall, err);
+  return err;
+}
+
+// Writes a profile on the thread pool. CPU profiles are passed as a stopped
+// `cpu_profile`, which is serialized on the thread pool as well and deleted
+// afterwards on the Environment's thread, because deleting it touches the
+// profiler. Other profiles are passed as already serialized `data`.
+// If there is an `async_wrap`, its `ondone(err, path)` method is called once
+// the file has been written, otherwise errors are printed to stderr.
+class ProfileWriteJob : public ThreadPoolWork {
+ public:
+  ProfileWriteJob(Environment* env,
+                  CpuProfile* cpu_profile,
+                  std::string&& data,
+                  const std::string& path,
+                  const char* kind,
+                  AsyncWrap* async_wrap)
+      : ThreadPoolWork(env, threadpool::QUEUE_TYPE_FS),
+        env_(env),
+        cpu_profile_(cpu_profile),
+        data_(std::move(data)),
+        path_(path),
+        kind_(kind),
+        async_wrap_(async_wrap) {}
+
+  void DoThreadPoolWork() override {
+    if (cpu_profile_ != nullptr)
+      data_ = SerializeCpuProfile(cpu_profile_);
+    err_ = WriteProfile(data_, path_, &syscall_);
+  }
+
+  void AfterThreadPoolWork(int status) override {
+    std::unique_ptr<ProfileWriteJob> job(this);
+    if (cpu_profile_ != nullptr)
+      cpu_profile_->Delete();
+    if (status == UV_ECANCELED)
+      return;
+    CHECK_EQ(status, 0);
+
+    if (!async_wrap_) {
+      if (err_ != 0)
+        PrintWriteError(kind_, path_, syscall_, err_);
+      return;
+    }
+    if (!env_->can_call_into_js())
+      return;
+
+    Isolate* isolate = env_->isolate();
+    HandleScope handle_scope(isolate);
+    Context::Scope context_scope(env_->context());
+    Local<Value> argv[] = {
+      Null(isolate),
+      ToV8String(isolate, path_)
+    };
+    if (err_ != 0)
+      argv[0] = UVException(isolate, err_, syscall_, nullptr, path_.c_str());
+    async_wrap_->MakeCallback(env_->ondone_string(), arraysize(argv), argv);
+  }
+
+ private:
+  Environment* const env_;
+  CpuProfile* const cpu_profile_;
+  std::string data_;
+  const std::string path_;
+  const char* const kind_;
+  std::unique_ptr<AsyncWrap> async_wrap_;
+  int err_ = 0;
+  const char* syscall_ = nullptr;
+};
+
+// Calls `callback` whenever `signo` is received, for the profiles started
+// through --cpu-prof-signal and --heap-prof-signal. The handle does not keep
+// the event loop alive and is closed together with the Environment.
+class ProfileSignal {
+ public:
+  typedef void (*Callback)(Environment* env);
+
+  ProfileSignal(Environment* env, int signo, Callback callback)
+      : env_(env), callback_(callback) {
+    CHECK_EQ(0, uv_signal_init(env->event_loop(), &handle_));
+    handle_.data = this;
+    CHECK_EQ(0, uv_signal_start(&handle_, OnSignal, signo));
+    uv_unref(reinterpret_cast<uv_handle_t*>(&handle_));
+    env->RegisterHandleCleanup(
+        reinterpret_cast<uv_handle_t*>(&handle_),
+        [](Environment* env, uv_handle_t* handle, void* arg) {
+          env->CloseHandle(handle, [](uv_handle_t* handle) {
+            delete static_cast<ProfileSignal*>(handle->data);
+          });
+        },
+        nullptr);
+  }
+
+ private:
+  static void OnSignal(uv_signal_t* handle, int signo) {
+    ProfileSignal* self = static_cast<ProfileSignal*>(handle->data);
+    HandleScope handle_scope(self->env_->isolate());
+    self->callback_(self->env_);
+  }
+
+  Environment* const env_;
+  const Callback callback_;
+  uv_signal_t handle_;
+};
+
+// Restarts the --cpu-prof profile and writes the part that has been recorded
+// so far.
+void OnCpuProfileSignal(Environment* env) {
+  CpuProfileRecorder* recorder = env->cpu_profile_recorder();
+  CpuProfile* profile = recorder->Stop(kCliProfileTitle);
+  if (profile == nullptr)
+    return;
+  recorder->Start(kCliProfileTitle, env->options()->cpu_prof_interval);
+  ProfileWriteJob* job = new ProfileWriteJob(
+      env, profile, std::string(), GetCpuProfilePath(env), "CPU profile",
+      nullptr);
+  job->ScheduleWork();
+}
+
+// Returns the allocations that the sampling heap profiler has recorded so far
+// in serialized form, or an empty string if it is not running.
+std::string TakeHeapProfile(Isolate* isolate) {
+  std::unique_ptr<AllocationProfile> profile(
+      isolate->GetHeapProfiler()->GetAllocationProfile());
+  if (!profile)
+    return std::string();
+  return SerializeHeapProfile(isolate, profile.get());
+}
+
+// Writes the allocations that are still alive out of the --heap-prof profile
+// and keeps on sampling.
+void OnHeapProfileSignal(Environment* env) {
+  std::string data = TakeHeapProfile(env->isolate());
+  if (data.empty())
+    return;
+  ProfileWriteJob* job = new ProfileWriteJob(
+      env, nullptr, std::move(data), GetHeapProfilePath(env), "heap profile",
+      nullptr);
+  job->ScheduleWork();
+}
+
+// Writes a heap snapshot of `env` to the current working directory.
+void OnHeapSnapshotSignal(Environment* env) {
+  const std::string path = GetHeapSnapshotPath(env);
+  const char* syscall;
+  const int err = heap::WriteSnapshot(env->isolate(), path, &syscall);
+  if (err != 0)
+    PrintWriteError("heap snapshot", path, syscall, err);
+}
+
+std::string GetProfilePath(Environment* env,
+                           const std::string& dir,
+                           const std::string& name,
+                           const char* prefix,
+                           const char* extension) {
+  static std::atomic<int> sequence { 0 };
+  std::string path = name;
+  if (path.empty()) {
+    time_t now = time(nullptr);
+    struct tm tm_struct;
+#ifdef _WIN32
+    localtime_s(&tm_struct, &now);
+#else
+    localtime_r(&now, &tm_struct);
+#endif
+    char timestamp[32];
+    strftime(timestamp, sizeof(timestamp), "%Y%m%d.%H%M%S", &tm_struct);
+    path = std::string(prefix) + "." + timestamp +
+           "." + std::to_string(uv_os_getpid()) +
+           "." + std::to_string(env->thread_id()) +
+           "." + std::to_string(++sequence) + extension;
+  }
+  if (dir.empty())
+    return path;
+  return dir + kPathSeparator + path;
+}
+
+void StartCpuProfiling(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(args[0]->IsString());
+  CHECK(args[1]->IsUint32());
+  Utf8Value title(env->isolate(), args[0]);
+  const bool started = env->cpu_profile_recorder()->Start(
+      *title, args[1].As<Uint32>()->Value());
+  args.GetReturnValue().Set(started);
+}
+
+void StopCpuProfiling(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(args[0]->IsString());
+  CHECK(args[1]->IsString() || args[1]->IsUndefined());
+  CHECK(args[2]->IsObject());
+  Utf8Value title(env->isolate(), args[0]);
+  CpuProfile* profile = env->cpu_profile_recorder()->Stop(*title);
+  if (profile == nullptr)
+    return args.GetReturnValue().Set(false);
+
+  const std::string path = args[1]->IsString() ?
+      std::string(*Utf8Value(env->isolate(), args[1])) :
+      GetCpuProfilePath(env);
+  ProfileWriteJob* job = new ProfileWriteJob(
+      env, profile, std::string(), path, "CPU profile",
+      Unwrap<AsyncWrap>(args[2].As<Object>()));
+  job->ScheduleWork();
+  args.GetReturnValue().Set(true);
+}
+
+void StartHeapProfiling(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(args[0]->IsUint32());
+  CHECK(args[1]->IsUint32());
+  // There is only one sampling heap profiler per isolate, so this fails while
+  // --heap-prof or another capture is using it.
+  const bool started =
+      env->isolate()->GetHeapProfiler()->StartSamplingHeapProfiler(
+          args[0].As<Uint32>()->Value(), args[1].As<Uint32>()->Value());
+  args.GetReturnValue().Set(started);
+}
+
+void StopHeapProfiling(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(args[0]->IsString() || args[0]->IsUndefined());
+  CHECK(args[1]->IsObject());
+  // The profile refers to the names of functions and scripts through handles,
+  // so unlike CPU profiles it has to be serialized on this thread.
+  std::string data = TakeHeapProfile(env->isolate());
+  if (data.empty())
+    return args.GetReturnValue().Set(false);
+  env->isolate()->GetHeapProfiler()->StopSamplingHeapProfiler();
+
+  const std::string path = args[0]->IsString() ?
+      std::string(*Utf8Value(env->isolate(), args[0])) :
+      GetHeapProfilePath(env);
+  ProfileWriteJob* job = new ProfileWriteJob(
+      env, nullptr, std::move(data), path, "heap profile",
+      Unwrap<AsyncWrap>(args[1].As<Object>()));
+  job->ScheduleWork();
+  args.GetReturnValue().Set(true);
+}
+
+void Initialize(Local<Object> target,
+                Local<Value> unused,
+                Local<Context> context,
+                void* priv) {
+  Environment* env = Environment::GetCurrent(context);
+  env->SetMethod(target, "startCpuProfiling", StartCpuProfiling);
+  env->SetMethod(target, "stopCpuProfiling", StopCpuProfiling);
+  env->SetMethod(target, "startHeapProfiling", StartHeapProfiling);
+  env->SetMethod(target, "stopHeapProfiling", StopHeapProfiling);
+}
+
+}  // anonymous namespace
+
+CpuProfileRecorder::CpuProfileRecorder(Environment* env) : env_(env) {}
+
+CpuProfileRecorder::~CpuProfileRecorder() {
+  if (profiler_ == nullptr)
+    return;
+  HandleScope handle_scope(env_->isolate());
+  for (const std::string& title : titles_)
+    profiler_->StopProfiling(ToV8String(env_->isolate(), title))->Delete();
+  profiler_->Dispose();
+}
+
+bool CpuProfileRecorder::Start(const std::string& title, int interval_us) {
+  if (titles_.count(title) > 0)
+    return false;
+  if (profiler_ == nullptr)
+    profiler_ = CpuProfiler::New(env_->isolate());
+  // The interval can only be changed while the sampler is not running.
+  if (titles_.empty())
+    profiler_->SetSamplingInterval(interval_us);
+  titles_.insert(title);
+  profiler_->StartProfiling(ToV8String(env_->isolate(), title), true);
+  return true;
+}
+
+CpuProfile* CpuProfileRecorder::Stop(const std::string& title) {
+  if (titles_.erase(title) == 0)
+    return nullptr;
+  return profiler_->StopProfiling(ToV8String(env_->isolate(), title));
+}
+
+int CpuProfileRecorder::WriteSync(CpuProfile* profile,
+                                  const std::string& path) {
+  const int err =
+      WriteProfileSync(SerializeCpuProfile(profile), path, "CPU profile");
+  profile->Delete();
+  return err;
+}
+
+std::string SerializeCpuProfile(const CpuProfile* profile) {
+  std::string out = "{\"nodes\":[";
+  std::vector<CpuProfileNode::LineTick> line_ticks;
+  // Walk the tree iteratively, deep call stacks must not exhaust the stack of
+  // the thread that does the serialization.
+  std::vector<const CpuProfileNode*> pending = { profile->GetTopDownRoot() };
+  bool first = true;
+  while (!pending.empty()) {
+    const CpuProfileNode* node = pending.back();
+    pending.pop_back();
+    if (!first) out.push_back(',');
+    first = false;
+    AppendNode(&out, node, &line_ticks);
+    for (int i = node->GetChildrenCount() - 1; i >= 0; i--)
+      pending.push_back(node->GetChild(i));
+  }
+
+  const int64_t start_time = profile->GetStartTime();
+  out += "],\"startTime\":";
+  out += std::to_string(start_time);
+  out += ",\"endTime\":";
+  out += std::to_string(profile->GetEndTime());
+
+  const int samples = profile->GetSamplesCount();
+  out += ",\"samples\":[";
+  for (int i = 0; i < samples; i++) {
+    if (i > 0) out.push_back(',');
+    out += std::to_string(profile->GetSample(i)->GetNodeId());
+  }
+  out += "],\"timeDeltas\":[";
+  int64_t last_time = start_time;
+  for (int i = 0; i < samples; i++) {
+    if (i > 0) out.push_back(',');
+    const int64_t time = profile->GetSampleTimestamp(i);
+    out += std::to_string(time - last_time);
+    last_time = time;
+  }
+  out += "]}";
+  return out;
+}
+
+std::string SerializeHeapProfile(Isolate* isolate,
+                                 AllocationProfile* profile) {
+  std::string out = "{\"head\":";
+  // Nodes are nested in the heap profile format, so keep track of the next
+  // child to visit for every node on the current path instead of recursing.
+  std::vector<std::pair<const AllocationProfile::Node*, size_t>> pending;
+  pending.emplace_back(profile->GetRootNode(), 0);
+  int next_id = 1;
+  bool enter = true;
+  while (!pending.empty()) {
+    const AllocationProfile::Node* node = pending.back().first;
+    if (enter) {
+      size_t self_size = 0;
+      for (const AllocationProfile::Allocation& allocation : node->allocations)
+        self_size += allocation.size * allocation.count;
+      Utf8Value function_name(isolate, node->name);
+      Utf8Value url(isolate, node->script_name);
+      out.push_back('{');
+      AppendCallFrame(&out, *function_name, node->script_id, *url,
+                      node->line_number, node->column_number);
+      out += ",\"selfSize\":";
+      out += std::to_string(self_size);
+      out += ",\"id\":";
+      out += std::to_string(next_id++);
+      out += ",\"children\":[";
+    }
+
+    const size_t child = pending.back().second++;
+    if (child < node->children.size()) {
+      if (child > 0) out.push_back(',');
+      pending.emplace_back(node->children[child], 0);
+      enter = true;
+    } else {
+      out += "]}";
+      pending.pop_back();
+      enter = false;
+    }
+  }
+  out += "}";
+  return out;
+}
+
+std::string GetCpuProfilePath(Environment* env) {
+  const EnvironmentOptions* options = env->options().get();
+  return GetProfilePath(env, options->cpu_prof_dir, options->cpu_prof_name,
+                        "CPU", ".cpuprofile");
+}
+
+std::string GetHeapProfilePath(Environment* env) {
+  const EnvironmentOptions* options = env->options().get();
+  return GetProfilePath(env, options->heap_prof_dir, options->heap_prof_name,
+                        "Heap", ".heapprofile");
+}
+
+std::string GetHeapSnapshotPath(Environment* env) {
+  return GetProfilePath(env, std::string(), std::string(),
+                        "Heap", ".heapsnapshot");
+}
+
+void StartProfilers(Environment* env) {
+  const EnvironmentOptions* options = env->options().get();
+  HandleScope handle_scope(env->isolate());
+  if (options->cpu_prof) {
+    env->cpu_profile_recorder()->Start(kCliProfileTitle,
+                                       options->cpu_prof_interval);
+    if (!options->cpu_prof_signal.empty()) {
+      new ProfileSignal(env, signo_from_string(options->cpu_prof_signal),
+                        OnCpuProfileSignal);
+    }
+  }
+  if (options->heap_prof) {
+    env->isolate()->GetHeapProfiler()->StartSamplingHeapProfiler(
+        options->heap_prof_interval, options->heap_prof_stack_depth);
+    if (!options->heap_prof_signal.empty()) {
+      new ProfileSignal(env, signo_from_string(options->heap_prof_signal),
+                        OnHeapProfileSignal);
+    }
+  }
+  if (!options->heapsnapshot_signal.empty()) {
+    new ProfileSignal(env, signo_from_string(options->heapsnapshot_signal),
+                      OnHeapSnapshotSignal);
+  }
+}
+
+void EndStartedProfilers(Environment* env) {
+  const EnvironmentOptions* options = env->options().get();
+  HandleScope handle_scope(env->isolate());
+  if (options->cpu_prof) {
+    CpuProfile* profile = env->cpu_profile_recorder()->Stop(kCliProfileTitle);
+    if (profile != nullptr)
+      CpuProfileRecorder::WriteSync(profile, GetCpuProfilePath(env));
+  }
+  if (options->heap_prof) {
+    const std::string data = TakeHeapProfile(env->isolate());
+    if (!data.empty()) {
+      env->isolate()->GetHeapProfiler()->StopSamplingHeapProfiler();
+      WriteProfileSync(data, GetHeapProfilePath(env), "heap profile");
+    }
+  }
+}
+
+}  // namespace profiler
+}  // namespace node
+
+NODE_MODULE_CONTEXT_AWARE_INTERNAL(profiler, node::profiler::Initialize)
@@ -0,0 +1,80 @@
+#ifndef SRC_NODE_PROFILER_H_
+#define SRC_NODE_PROFILER_H_
+
+#if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#include "v8-profiler.h"
+#include "uv.h"
+
+#include <set>
+#include <string>
+
+namespace node {
+
+class Environment;
+
+namespace profiler {
+
+// Records sampling CPU profiles of one Environment's isolate using the
+// in-process v8::CpuProfiler, without going through the inspector.
+//
+// Several profiles can be recorded at the same time as long as they have
+// different titles. They share one sampler, so the sampling interval that is
+// passed when the first of them is started applies to all of them.
+class CpuProfileRecorder {
+ public:
+  explicit CpuProfileRecorder(Environment* env);
+  ~CpuProfileRecorder();
+
+  // Returns false if a profile with this title is already being recorded.
+  bool Start(const std::string& title, int interval_us);
+  // Returns nullptr if no profile with this title is being recorded. The
+  // returned profile has to be released with v8::CpuProfile::Delete().
+  v8::CpuProfile* Stop(const std::string& title);
+
+  // Writes `profile` to `path` and deletes it, on the calling thread.
+  // Returns 0 or a libuv error code.
+  static int WriteSync(v8::CpuProfile* profile, const std::string& path);
+
+ private:
+  CpuProfileRecorder(const CpuProfileRecorder&) = delete;
+  CpuProfileRecorder& operator=(const CpuProfileRecorder&) = delete;
+
+  Environment* env_;
+  v8::CpuProfiler* profiler_ = nullptr;
+  std::set<std::string> titles_;
+};
+
+// Serializes `profile` into the .cpuprofile JSON format that is understood by
+// Chrome DevTools. Only reads data owned by the profile itself, so this can
+// run on any thread as long as the profile is not deleted in the meantime.
+std::string SerializeCpuProfile(const v8::CpuProfile* profile);
+
+// Serializes `profile` into the .heapprofile JSON format that is understood
+// by Chrome DevTools. This has to run on the isolate's thread.
+std::string SerializeHeapProfile(v8::Isolate* isolate,
+                                 v8::AllocationProfile* profile);
+
+// Return the paths that the next CPU or heap profile of `env` is written to
+// if no file name is given, based on --cpu-prof-dir and --cpu-prof-name, or
+// --heap-prof-dir and --heap-prof-name.
+std::string GetCpuProfilePath(Environment* env);
+std::string GetHeapProfilePath(Environment* env);
+// Returns the path that the next heap snapshot of `env` is written to if no
+// file name is given.
+std::string GetHeapSnapshotPath(Environment* env);
+
+// Starts the profiles requested through --cpu-prof and --heap-prof, if any,
+// and installs the handler for --heapsnapshot-signal.
+void StartProfilers(Environment* env);
+// Stops the profiles started through --cpu-prof and --heap-prof and writes
+// them out. This is called when the Environment exits and may be called more
+// than once.
+void EndStartedProfilers(Environment* env);
+
+}  // namespace profiler
+}  // namespace node
+
+#endif  // defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#endif  // SRC_NODE_PROFILER_H_
@@ -0,0 +1,468 @@
+#include "env-inl.h"
+#include "node_internals.h"
+#include "util-inl.h"
+#include "v8.h"
+
+#include <string>
+#include <vector>
+
+namespace node {
+namespace querystring {
+
+using v8::Array;
+using v8::Context;
+using v8::FunctionCallbackInfo;
+using v8::Isolate;
+using v8::Local;
+using v8::NewStringType;
+using v8::Number;
+using v8::Object;
+using v8::String;
+using v8::Value;
+
+namespace {
+
+// The characters that querystring.escape() leaves as they are: A-Z a-z 0-9
+// and ! ' ( ) * - . _ ~
+const uint8_t kNoEscape[128] = {
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // 0 - 15
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // 16 - 31
+  0, 1, 0, 0, 0, 0, 0, 1, 1, 1, 1, 0, 0, 1, 1, 0,  // 32 - 47
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0,  // 48 - 63
+  0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,  // 64 - 79
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 1,  // 80 - 95
+  0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,  // 96 - 111
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 1, 0   // 112 - 127
+};
+
+const char kHexDigits[] = "0123456789ABCDEF";
+
+const size_t kNone = static_cast<size_t>(-1);
+
+inline int HexValue(uint16_t ch) {
+  if (ch >= '0' && ch <= '9')
+    return ch - '0';
+  if (ch >= 'A' && ch <= 'F')
+    return ch - 'A' + 10;
+  if (ch >= 'a' && ch <= 'f')
+    return ch - 'a' + 10;
+  return -1;
+}
+
+// Returns the byte that the two hex digits at `p` encode, or -1.
+template <typename Char>
+inline int DecodeByte(const Char* p, const Char* end) {
+  if (end - p < 2)
+    return -1;
+  const int high = HexValue(p[0]);
+  const int low = HexValue(p[1]);
+  if (high < 0 || low < 0)
+    return -1;
+  return high * 16 + low;
+}
+
+// Appends the characters between `p` and `end` to `out`, with '+' as a space
+// and percent-encoded UTF-8 decoded like decodeURIComponent() does. Returns
+// false where decodeURIComponent() would throw.
+template <typename Char>
+bool Decode(const Char* p, const Char* end, std::u16string* out) {
+  while (p < end) {
+    const Char ch = *p++;
+    if (ch == '+') {
+      out->push_back(' ');
+      continue;
+    }
+    if (ch != '%') {
+      out->push_back(ch);
+      continue;
+    }
+
+    const int byte = DecodeByte(p, end);
+    if (byte < 0)
+      return false;
+    p += 2;
+    if (byte < 0x80) {
+      out->push_back(byte);
+      continue;
+    }
+
+    size_t continuation_bytes;
+    char32_t code_point;
+    char32_t min_code_point;
+    if ((byte & 0xe0) == 0xc0) {
+      continuation_bytes = 1;
+      code_point = byte & 0x1f;
+      min_code_point = 0x80;
+    } else if ((byte & 0xf0) == 0xe0) {
+      continuation_bytes = 2;
+      code_point = byte & 0x0f;
+      min_code_point = 0x800;
+    } else if ((byte & 0xf8) == 0xf0) {
+      continuation_bytes = 3;
+      code_point = byte & 0x07;
+      min_code_point = 0x10000;
+    } else {
+      return false;
+    }
+    for (; continuation_bytes > 0; continuation_bytes--) {
+      if (p == end || *p != '%')
+        return false;
+      const int next = DecodeByte(p + 1, end);
+      if (next < 0 || (next & 0xc0) != 0x80)
+        return false;
+      p += 3;
+      code_point = (code_point << 6) | (next & 0x3f);
+    }
+    // Overlong encodings, surrogates and code points past U+10FFFF.
+    if (code_point < min_code_point || code_point > 0x10ffff ||
+        (code_point >= 0xd800 && code_point <= 0xdfff)) {
+      return false;
+    }
+
+    if (code_point < 0x10000) {
+      out->push_back(code_point);
+    } else {
+      code_point -= 0x10000;
+      out->push_back(0xd800 + (code_point >> 10));
+      out->push_back(0xdc00 + (code_point & 0x3ff));
+    }
+  }
+  return true;
+}
+
+inline Local<String> NewString(Isolate* isolate,
+                               const uint8_t* data,
+                               size_t length,
+                               NewStringType type = NewStringType::kNormal) {
+  return String::NewFromOneByte(isolate, data, type, length).ToLocalChecked();
+}
+
+inline Local<String> NewString(Isolate* isolate,
+                               const uint16_t* data,
+                               size_t length,
+                               NewStringType type = NewStringType::kNormal) {
+  // V8 stores the string as one-byte if it can.
+  return String::NewFromTwoByte(isolate, data, type, length).ToLocalChecked();
+}
+
+inline Local<String> NewString(Isolate* isolate,
+                               const std::u16string& str,
+                               NewStringType type = NewStringType::kNormal) {
+  return NewString(isolate,
+                   reinterpret_cast<const uint16_t*>(str.data()),
+                   str.length(),
+                   type);
+}
+
+// Splits a query string into its key/value pairs, the way querystring.parse()
+// does with its default decoder and single character separators. The values
+// of repeated keys are collected in the order they appear.
+class Parser {
+ public:
+  Parser(Isolate* isolate, uint16_t sep, uint16_t eq)
+      : isolate_(isolate), sep_(sep), eq_(eq) {
+    special_['%'] = special_['+'] = special_[sep] = special_[eq] = true;
+  }
+
+  // Returns false if a key or value cannot be decoded, which leaves the
+  // input to the JS implementation and its fallback decoder.
+  template <typename Char>
+  bool Parse(const Char* data, size_t length, double max_keys) {
+    const Char* p = data;
+    const Char* const end = data + length;
+    for (;;) {
+      const Char* const start = p;
+      const Char* eq = nullptr;
+      bool key_plain = true;
+      bool value_plain = true;
+      for (; p < end; p++) {
+        const Char ch = *p;
+        if (ch >= arraysize(special_) || !special_[ch])
+          continue;
+        if (ch == sep_)
+          break;
+        if (ch == eq_) {
+          if (eq == nullptr)
+            eq = p;
+        } else if (eq == nullptr) {
+          key_plain = false;
+        } else {
+          value_plain = false;
+        }
+      }
+
+      const bool last = p == end;
+      // Empty pairs are skipped, but count towards `max_keys`.
+      if (p > start) {
+        const Char* const key_end = eq != nullptr ? eq : p;
+        const Char* const value_start = eq != nullptr ? eq + 1 : p;
+        if (!Add(start, key_end, key_plain, value_start, p, value_plain))
+          return false;
+      }
+      if (last || --max_keys == 0)
+        return true;
+      p++;
+    }
+  }
+
+  Local<Array> ToArray() {
+    std::vector<Local<Value>> pairs;
+    pairs.reserve(entries_.size() * 2);
+    for (const Entry& entry : entries_) {
+      pairs.push_back(entry.key);
+      if (entry.repeated == kNone) {
+        pairs.push_back(entry.value);
+      } else {
+        std::vector<Local<Value>>& values = repeated_[entry.repeated];
+        pairs.push_back(Array::New(isolate_, values.data(), values.size()));
+      }
+    }
+    return Array::New(isolate_, pairs.data(), pairs.size());
+  }
+
+ private:
+  // Up to this many keys, they are looked up by comparing them one by one.
+  static const size_t kMaxLinearSearch = 16;
+
+  struct Entry {
+    Local<String> key;
+    Local<Value> value;
+    size_t repeated;
+  };
+
+  // Returns the index of the entry for `key`, or adds an entry for it and
+  // returns kNone.
+  size_t FindOrAdd(Local<String> key, Local<Value> value) {
+    if (index_.empty()) {
+      for (size_t i = 0; i < entries_.size(); i++) {
+        if (entries_[i].key == key)
+          return i;
+      }
+      entries_.push_back(Entry { key, value, kNone });
+      if (entries_.size() > kMaxLinearSearch)
+        Rehash(4 * kMaxLinearSearch);
+      return kNone;
+    }
+
+    const size_t mask = index_.size() - 1;
+    for (size_t slot = key->GetIdentityHash() & mask;;
+         slot = (slot + 1) & mask) {
+      const size_t i = index_[slot];
+      if (i == kNone) {
+        index_[slot] = entries_.size();
+        entries_.push_back(Entry { key, value, kNone });
+        if (2 * entries_.size() > index_.size())
+          Rehash(2 * index_.size());
+        return kNone;
+      }
+      if (entries_[i].key == key)
+        return i;
+    }
+  }
+
+  void Rehash(size_t size) {
+    index_.assign(size, kNone);
+    const size_t mask = size - 1;
+    for (size_t i = 0; i < entries_.size(); i++) {
+      size_t slot = entries_[i].key->GetIdentityHash() & mask;
+      while (index_[slot] != kNone)
+        slot = (slot + 1) & mask;
+      index_[slot] = i;
+    }
+  }
+
+  template <typename Char>
+  bool Add(const Char* key_start,
+           const Char* key_end,
+           bool key_plain,
+           const Char* value_start,
+           const Char* value_end,
+           bool value_plain) {
+    // Keys are internalized, which makes equal keys the same string and
+    // saves the work when they become property names.
+    Local<String> key;
+    if (key_plain) {
+      key = NewString(isolate_, key_start, key_end - key_start,
+                      NewStringType::kInternalized);
+    } else {
+      scratch_.clear();
+      if (!Decode(key_start, key_end, &scratch_))
+        return false;
+      key = NewString(isolate_, scratch_, NewStringType::kInternalized);
+    }
+
+    Local<Value> value;
+    if (value_start == value_end) {
+      value = String::Empty(isolate_);
+    } else if (value_plain) {
+      value = NewString(isolate_, value_start, value_end - value_start);
+    } else {
+      scratch_.clear();
+      if (!Decode(value_start, value_end, &scratch_))
+        return false;
+      value = NewString(isolate_, scratch_);
+    }
+
+    const size_t i = FindOrAdd(key, value);
+    if (i == kNone)
+      return true;
+
+    Entry& entry = entries_[i];
+    if (entry.repeated == kNone) {
+      entry.repeated = repeated_.size();
+      repeated_.push_back({ entry.value });
+    }
+    repeated_[entry.repeated].push_back(value);
+    return true;
+  }
+
+  Isolate* const isolate_;
+  const uint16_t sep_;
+  const uint16_t eq_;
+  bool special_[128] = {};
+  std::u16string scratch_;
+  // An open addressing hash table of indices into `entries_`, once there are
+  // too many keys to compare them one by one.
+  std::vector<size_t> index_;
+  std::vector<Entry> entries_;
+  std::vector<std::vector<Local<Value>>> repeated_;
+};
+
+// parse(qs, sepCode, eqCode, maxKeys) returns the key/value pairs of `qs` as
+// a flat array with one entry per key, or undefined if the JS implementation
+// has to parse it.
+void Parse(const FunctionCallbackInfo<Value>& args) {
+  Isolate* isolate = args.GetIsolate();
+  CHECK(args[0]->IsString());
+  CHECK(args[1]->IsUint32());
+  CHECK(args[2]->IsUint32());
+  CHECK(args[3]->IsNumber());
+  Local<String> qs = args[0].As<String>();
+  const uint32_t sep = args[1].As<v8::Uint32>()->Value();
+  const uint32_t eq = args[2].As<v8::Uint32>()->Value();
+  const double max_keys = args[3].As<Number>()->Value();
+
+  // Separators that could be part of a percent-encoded byte are matched in
+  // ways that only the JS implementation reproduces.
+  if (sep == eq || sep >= 0x80 || eq >= 0x80 ||
+      HexValue(sep) >= 0 || HexValue(eq) >= 0 ||
+      sep == '%' || sep == '+' || eq == '%' || eq == '+') {
+    return;
+  }
+
+  Parser parser(isolate, sep, eq);
+  bool parsed;
+  if (qs->IsOneByte()) {
+    MaybeStackBuffer<uint8_t> data(qs->Length());
+    qs->WriteOneByte(isolate, *data, 0, qs->Length(),
+                     String::NO_NULL_TERMINATION);
+    parsed = parser.Parse(*data, qs->Length(), max_keys);
+  } else {
+    TwoByteValue data(isolate, qs);
+    parsed = parser.Parse(*data, data.length(), max_keys);
+  }
+  if (parsed)
+    args.GetReturnValue().Set(parser.ToArray());
+}
+
+template <typename Char>
+size_t EscapedLength(const Char* data, size_t length) {
+  size_t escaped_length = 0;
+  for (size_t i = 0; i < length; i++) {
+    const Char ch = data[i];
+    if (ch < 0x80) {
+      escaped_length += kNoEscape[ch] ? 1 : 3;
+    } else if (ch < 0x800) {
+      escaped_length += 6;
+    } else if (ch < 0xd800 || ch >= 0xe000) {
+      escaped_length += 9;
+    } else {
+      // A surrogate pair, as long as it is not cut off.
+      if (++i == length)
+        return 0;
+      escaped_length += 12;
+    }
+  }
+  return escaped_length;
+}
+
+inline char* AppendByte(char* out, uint32_t byte) {
+  out[0] = '%';
+  out[1] = kHexDigits[byte >> 4];
+  out[2] = kHexDigits[byte & 0xf];
+  return out + 3;
+}
+
+template <typename Char>
+void EscapeInto(const Char* data, size_t length, char* out) {
+  for (size_t i = 0; i < length; i++) {
+    uint32_t ch = data[i];
+    if (ch < 0x80) {
+      if (kNoEscape[ch]) {
+        *out++ = ch;
+      } else {
+        out = AppendByte(out, ch);
+      }
+    } else if (ch < 0x800) {
+      out = AppendByte(out, 0xc0 | (ch >> 6));
+      out = AppendByte(out, 0x80 | (ch & 0x3f));
+    } else if (ch < 0xd800 || ch >= 0xe000) {
+      out = AppendByte(out, 0xe0 | (ch >> 12));
+      out = AppendByte(out, 0x80 | ((ch >> 6) & 0x3f));
+      out = AppendByte(out, 0x80 | (ch & 0x3f));
+    } else {
+      // Like encodeStr(), this does not check that the second half of the
+      // pair is a low surrogate.
+      ch = 0x10000 + (((ch & 0x3ff) << 10) | (data[++i] & 0x3ff));
+      out = AppendByte(out, 0xf0 | (ch >> 18));
+      out = AppendByte(out, 0x80 | ((ch >> 12) & 0x3f));
+      out = AppendByte(out, 0x80 | ((ch >> 6) & 0x3f));
+      out = AppendByte(out, 0x80 | (ch & 0x3f));
+    }
+  }
+}
+
+// escape(str) returns `str` percent-encoded like querystring.escape(), or
+// undefined if it ends with half of a surrogate pair.
+void Escape(const FunctionCallbackInfo<Value>& args) {
+  Isolate* isolate = args.GetIsolate();
+  CHECK(args[0]->IsString());
+  Local<String> str = args[0].As<String>();
+  const size_t length = str->Length();
+
+  size_t escaped_length;
+  MaybeStackBuffer<char> escaped;
+  if (str->IsOneByte()) {
+    MaybeStackBuffer<uint8_t> data(length);
+    str->WriteOneByte(isolate, *data, 0, length, String::NO_NULL_TERMINATION);
+    escaped_length = EscapedLength(*data, length);
+    if (escaped_length == length)
+      return args.GetReturnValue().Set(str);
+    escaped.AllocateSufficientStorage(escaped_length);
+    EscapeInto(*data, length, *escaped);
+  } else {
+    TwoByteValue data(isolate, str);
+    escaped_length = EscapedLength(*data, length);
+    if (escaped_length == 0)
+      return;
+    escaped.AllocateSufficientStorage(escaped_length);
+    EscapeInto(*data, length, *escaped);
+  }
+  args.GetReturnValue().Set(
+      OneByteString(isolate, *escaped, escaped_length));
+}
+
+void Initialize(Local<Object> target,
+                Local<Value> unused,
+                Local<Context> context,
+                void* priv) {
+  Environment* env = Environment::GetCurrent(context);
+  env->SetMethodNoSideEffect(target, "parse", Parse);
+  env->SetMethodNoSideEffect(target, "escape", Escape);
+}
+
+}  // anonymous namespace
+}  // namespace querystring
+}  // namespace node
+
+NODE_MODULE_CONTEXT_AWARE_INTERNAL(querystring, node::querystring::Initialize)
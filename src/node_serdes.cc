@@ -3,6 +3,8 @@
 #include "node_errors.h"
 #include "base_object-inl.h"
 
+#include <algorithm>
+
 namespace node {
 
 using v8::Array;
@@ -21,6 +23,7 @@ using v8::Nothing;
 using v8::Object;
 using v8::SharedArrayBuffer;
 using v8::String;
+using v8::Uint8Array;
 using v8::Value;
 using v8::ValueDeserializer;
 using v8::ValueSerializer;
@@ -93,6 +96,45 @@ class DeserializerContext : public BaseObject,
   ValueDeserializer deserializer_;
 };
 
+// Splits a byte stream into frames that consist of a 4-byte big endian
+// length followed by that many bytes of payload, as used by the 'advanced'
+// serialization mode of the child_process IPC channel.
+//
+// Frames that are contained in a single chunk are returned as views into the
+// chunk's ArrayBuffer. Frames that span several chunks are copied once into
+// a buffer of the right size, which is allocated as soon as the length is
+// known, so nothing is scanned or copied more than once.
+class FrameParser : public BaseObject {
+ public:
+  FrameParser(Environment* env, Local<Object> wrap);
+  ~FrameParser() override;
+
+  static void New(const FunctionCallbackInfo<Value>& args);
+  // push(arrayBuffer, byteOffset, byteLength) returns an array of the frames
+  // that have been completed by this chunk.
+  static void Push(const FunctionCallbackInfo<Value>& args);
+  // Returns the number of bytes that belong to incomplete frames.
+  static void PendingBytes(const FunctionCallbackInfo<Value>& args);
+
+  void MemoryInfo(MemoryTracker* tracker) const override {
+    tracker->TrackFieldWithSize("frame", frame_ != nullptr ? frame_length_ : 0);
+  }
+  SET_MEMORY_INFO_NAME(FrameParser)
+  SET_SELF_SIZE(FrameParser)
+
+  static const size_t kHeaderSize = 4;
+
+ private:
+  // Returns false if an exception has been thrown.
+  bool StartFrame(uint32_t length);
+
+  uint8_t header_[kHeaderSize];
+  size_t header_bytes_ = 0;
+  char* frame_ = nullptr;
+  size_t frame_length_ = 0;
+  size_t frame_bytes_ = 0;
+};
+
 SerializerContext::SerializerContext(Environment* env, Local<Object> wrap)
   : BaseObject(env, wrap),
     serializer_(env->isolate(), this) {
@@ -438,6 +480,125 @@ void DeserializerContext::ReadRawBytes(
   args.GetReturnValue().Set(offset);
 }
 
+const size_t FrameParser::kHeaderSize;
+
+FrameParser::FrameParser(Environment* env, Local<Object> wrap)
+  : BaseObject(env, wrap) {
+  MakeWeak();
+}
+
+FrameParser::~FrameParser() {
+  free(frame_);
+}
+
+void FrameParser::New(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  new FrameParser(env, args.This());
+}
+
+inline uint32_t ReadFrameLength(const uint8_t* data) {
+  return (static_cast<uint32_t>(data[0]) << 24) |
+         (static_cast<uint32_t>(data[1]) << 16) |
+         (static_cast<uint32_t>(data[2]) << 8) |
+         static_cast<uint32_t>(data[3]);
+}
+
+bool FrameParser::StartFrame(uint32_t length) {
+  if (length > Buffer::kMaxLength) {
+    THROW_ERR_BUFFER_TOO_LARGE(env(), "IPC message is too large");
+    return false;
+  }
+  // This always allocates at least one byte, so that `frame_` being set
+  // means that a frame is in progress, even if it is empty.
+  frame_ = UncheckedMalloc(length);
+  if (frame_ == nullptr) {
+    THROW_ERR_MEMORY_ALLOCATION_FAILED(env());
+    return false;
+  }
+  frame_length_ = length;
+  frame_bytes_ = 0;
+  return true;
+}
+
+void FrameParser::Push(const FunctionCallbackInfo<Value>& args) {
+  FrameParser* parser;
+  ASSIGN_OR_RETURN_UNWRAP(&parser, args.Holder());
+  Environment* env = parser->env();
+  CHECK(args[0]->IsArrayBuffer());
+  CHECK(args[1]->IsUint32());
+  CHECK(args[2]->IsUint32());
+
+  Local<ArrayBuffer> ab = args[0].As<ArrayBuffer>();
+  const size_t offset = args[1].As<v8::Uint32>()->Value();
+  const size_t length = args[2].As<v8::Uint32>()->Value();
+  CHECK_LE(offset + length, ab->ByteLength());
+  const uint8_t* const data =
+      static_cast<const uint8_t*>(ab->GetContents().Data());
+
+  std::vector<Local<Value>> frames;
+  size_t pos = offset;
+  const size_t end = offset + length;
+  while (pos < end) {
+    if (parser->frame_ == nullptr) {
+      if (parser->header_bytes_ == 0 && end - pos >= kHeaderSize) {
+        const uint32_t frame_length = ReadFrameLength(data + pos);
+        if (end - pos - kHeaderSize >= frame_length) {
+          // Fast path: the whole frame is part of this chunk.
+          Local<Uint8Array> frame;
+          if (!Buffer::New(env, ab, pos + kHeaderSize, frame_length)
+                  .ToLocal(&frame)) {
+            return;
+          }
+          frames.push_back(frame);
+          pos += kHeaderSize + frame_length;
+          continue;
+        }
+        pos += kHeaderSize;
+        if (!parser->StartFrame(frame_length))
+          return;
+      } else {
+        const size_t n =
+            std::min(kHeaderSize - parser->header_bytes_, end - pos);
+        memcpy(parser->header_ + parser->header_bytes_, data + pos, n);
+        parser->header_bytes_ += n;
+        pos += n;
+        if (parser->header_bytes_ < kHeaderSize)
+          break;
+        parser->header_bytes_ = 0;
+        if (!parser->StartFrame(ReadFrameLength(parser->header_)))
+          return;
+      }
+    }
+
+    const size_t n =
+        std::min(parser->frame_length_ - parser->frame_bytes_, end - pos);
+    memcpy(parser->frame_ + parser->frame_bytes_, data + pos, n);
+    parser->frame_bytes_ += n;
+    pos += n;
+    if (parser->frame_bytes_ < parser->frame_length_)
+      break;
+
+    // The Buffer takes over the memory of the frame.
+    char* frame_data = parser->frame_;
+    parser->frame_ = nullptr;
+    Local<Object> frame;
+    if (!Buffer::New(env, frame_data, parser->frame_length_).ToLocal(&frame))
+      return;
+    frames.push_back(frame);
+  }
+
+  args.GetReturnValue().Set(
+      Array::New(env->isolate(), frames.data(), frames.size()));
+}
+
+void FrameParser::PendingBytes(const FunctionCallbackInfo<Value>& args) {
+  FrameParser* parser;
+  ASSIGN_OR_RETURN_UNWRAP(&parser, args.Holder());
+  const size_t pending = parser->header_bytes_ +
+      (parser->frame_ != nullptr ? kHeaderSize + parser->frame_bytes_ : 0);
+  args.GetReturnValue().Set(static_cast<double>(pending));
+}
+
 void Initialize(Local<Object> target,
                 Local<Value> unused,
                 Local<Context> context,
@@ -493,6 +654,22 @@ void Initialize(Local<Object> target,
   target->Set(env->context(),
               deserializerString,
               des->GetFunction(env->context()).ToLocalChecked()).FromJust();
+
+  Local<FunctionTemplate> parser =
+      env->NewFunctionTemplate(FrameParser::New);
+
+  parser->InstanceTemplate()->SetInternalFieldCount(1);
+
+  env->SetProtoMethod(parser, "push", FrameParser::Push);
+  env->SetProtoMethodNoSideEffect(parser, "pendingBytes",
+                                  FrameParser::PendingBytes);
+
+  Local<String> parserString =
+      FIXED_ONE_BYTE_STRING(env->isolate(), "FrameParser");
+  parser->SetClassName(parserString);
+  target->Set(env->context(),
+              parserString,
+              parser->GetFunction(env->context()).ToLocalChecked()).FromJust();
 }
 
 }  // anonymous namespace
@@ -0,0 +1,705 @@
+#include "node_threadpool.h"
+#include "base_object-inl.h"
+#include "env-inl.h"
+#include "node_internals.h"
+#include "node_options.h"
+#include "util-inl.h"
+#include "uv.h"
+#include "v8.h"
+
+#include <stdlib.h>
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <errno.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace node {
+
+using v8::Array;
+using v8::Context;
+using v8::Float64Array;
+using v8::FunctionCallbackInfo;
+using v8::FunctionTemplate;
+using v8::Local;
+using v8::Object;
+using v8::String;
+using v8::Value;
+
+namespace threadpool {
+
+namespace {
+
+const char* const kQueueNames[] = {
+#define V(_, name) name,
+  THREADPOOL_QUEUE_TYPES(V)
+#undef V
+};
+
+const char* const kWorkTypeNames[] = {
+#define V(_, name) name,
+  THREADPOOL_WORK_TYPES(V)
+#undef V
+};
+
+// Every queue is reported as the work type of the same name.
+const WorkType kQueueWorkTypes[] = {
+#define V(type, _) WORK_TYPE_##type,
+  THREADPOOL_QUEUE_TYPES(V)
+#undef V
+};
+
+// The same limits that libuv applies to UV_THREADPOOL_SIZE.
+constexpr int kDefaultThreads = 4;
+constexpr int kMaxThreads = 128;
+
+struct QueueOptions {
+  QueueType type;
+  int threads;
+  QueuePriority priority;
+};
+
+// Updated from the event loop threads and the threads that run the work.
+// Times are in nanoseconds.
+struct QueueCounters {
+  std::atomic<uint64_t> pending { 0 };
+  std::atomic<uint64_t> running { 0 };
+  std::atomic<uint64_t> completed { 0 };
+  std::atomic<uint64_t> wait_time { 0 };
+  std::atomic<uint64_t> run_time { 0 };
+};
+
+QueueCounters counters[QUEUE_TYPE_COUNT];
+
+std::vector<std::string> SplitOption(const std::string& value) {
+  std::vector<std::string> parts;
+  size_t start = 0;
+  for (;;) {
+    size_t end = value.find(':', start);
+    parts.push_back(value.substr(start, end - start));
+    if (end == std::string::npos)
+      return parts;
+    start = end + 1;
+  }
+}
+
+bool ParseQueueOption(const std::string& value,
+                      QueueOptions* options,
+                      std::string* error) {
+  std::vector<std::string> parts = SplitOption(value);
+  if (parts.size() < 2 || parts.size() > 3) {
+    *error = "--threadpool-queue must be <queue>:<threads>[:<priority>]";
+    return false;
+  }
+
+  int type = 0;
+  while (type < QUEUE_TYPE_COUNT && parts[0] != kQueueNames[type])
+    type++;
+  if (type == QUEUE_TYPE_COUNT) {
+    *error = "unknown --threadpool-queue name '" + parts[0] + "'";
+    return false;
+  }
+  options->type = static_cast<QueueType>(type);
+
+  char* end;
+  long threads = strtol(parts[1].c_str(), &end, 10);  // NOLINT(runtime/int)
+  if (parts[1].empty() || *end != '\0' || threads < 1 ||
+      threads > kMaxThreads) {
+    *error = "--threadpool-queue thread count must be between 1 and " +
+             std::to_string(kMaxThreads);
+    return false;
+  }
+  options->threads = static_cast<int>(threads);
+
+  options->priority = QueuePriority::kNormal;
+  if (parts.size() == 3) {
+    if (parts[2] == "low") {
+      options->priority = QueuePriority::kLow;
+    } else if (parts[2] == "high") {
+      options->priority = QueuePriority::kHigh;
+    } else if (parts[2] != "normal") {
+      *error = "--threadpool-queue priority must be low, normal or high";
+      return false;
+    }
+  }
+  return true;
+}
+
+// The size of libuv's own threadpool, computed the same way libuv does it.
+int LibuvThreadpoolSize() {
+  std::string value;
+  if (!credentials::SafeGetenv("UV_THREADPOOL_SIZE", &value))
+    return kDefaultThreads;
+  int threads = atoi(value.c_str());
+  if (threads < 1) return 1;
+  if (threads > kMaxThreads) return kMaxThreads;
+  return threads;
+}
+
+}  // anonymous namespace
+
+// Hands ThreadPoolWork that ran on a dedicated Queue back to the event loop
+// of the Environment that scheduled it.
+class CompletionQueue {
+ public:
+  // Must be called on the event loop thread of `env`.
+  static CompletionQueue* Get(Environment* env) {
+    CompletionQueue* queue = env->threadpool_completion_queue();
+    if (queue == nullptr) {
+      queue = new CompletionQueue(env);
+      env->set_threadpool_completion_queue(queue);
+      env->AddCleanupHook(Close, queue);
+    }
+    return queue;
+  }
+
+  // Keeps the event loop alive until the work has been handed back.
+  void Ref() {
+    if (outstanding_++ == 0)
+      uv_ref(reinterpret_cast<uv_handle_t*>(&async_));
+  }
+
+  // May be called from any thread.
+  void Push(ThreadPoolWork* work, int status) {
+    Mutex::ScopedLock lock(mutex_);
+    completed_.emplace_back(work, status);
+    // Send while holding the lock, so that Close() cannot free the handle
+    // while another thread is still using it.
+    CHECK_EQ(0, uv_async_send(&async_));
+  }
+
+ private:
+  explicit CompletionQueue(Environment* env) : env_(env) {
+    CHECK_EQ(0, uv_async_init(env->event_loop(), &async_, OnCompletion));
+    uv_unref(reinterpret_cast<uv_handle_t*>(&async_));
+  }
+
+  static void OnCompletion(uv_async_t* async) {
+    CompletionQueue* queue = ContainerOf(&CompletionQueue::async_, async);
+    std::vector<std::pair<ThreadPoolWork*, int>> completed;
+    {
+      Mutex::ScopedLock lock(queue->mutex_);
+      completed.swap(queue->completed_);
+    }
+
+    for (const auto& entry : completed) {
+      if (--queue->outstanding_ == 0)
+        uv_unref(reinterpret_cast<uv_handle_t*>(&queue->async_));
+      entry.first->FinishWork(entry.second);
+    }
+
+    if (queue->closing_ && queue->outstanding_ == 0)
+      queue->CloseHandle();
+  }
+
+  // Runs as a cleanup hook. Those usually only run once all pending
+  // requests have finished, but another hook may have scheduled new work.
+  static void Close(void* arg) {
+    CompletionQueue* queue = static_cast<CompletionQueue*>(arg);
+    queue->closing_ = true;
+    if (queue->outstanding_ == 0)
+      queue->CloseHandle();
+  }
+
+  void CloseHandle() {
+    env_->set_threadpool_completion_queue(nullptr);
+    // Wait for any thread that is still inside Push().
+    { Mutex::ScopedLock lock(mutex_); }
+    env_->CloseHandle(&async_, [](uv_async_t* async) {
+      CompletionQueue* queue = ContainerOf(&CompletionQueue::async_, async);
+      delete queue;
+    });
+  }
+
+  Environment* env_;
+  uv_async_t async_;
+  Mutex mutex_;
+  std::vector<std::pair<ThreadPoolWork*, int>> completed_;
+  size_t outstanding_ = 0;
+  bool closing_ = false;
+};
+
+// A set of threads that only runs ThreadPoolWork of a single queue type.
+// Threads are started on first use and live until the process exits.
+class Queue {
+ public:
+  explicit Queue(const QueueOptions& options) : options_(options) {}
+
+  void Push(ThreadPoolWork* work) {
+    Mutex::ScopedLock lock(mutex_);
+    if (threads_.empty())
+      StartThreads();
+    pending_.push_back(work);
+    work_available_.Signal(lock);
+  }
+
+  // Removes `work` if no thread has picked it up yet.
+  bool Cancel(ThreadPoolWork* work) {
+    Mutex::ScopedLock lock(mutex_);
+    for (auto it = pending_.begin(); it != pending_.end(); ++it) {
+      if (*it == work) {
+        pending_.erase(it);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  int threads() const { return options_.threads; }
+  QueuePriority priority() const { return options_.priority; }
+
+ private:
+  void StartThreads() {
+    for (int i = 0; i < options_.threads; i++) {
+      uv_thread_t thread;
+      CHECK_EQ(0, uv_thread_create(&thread, Run, this));
+      threads_.push_back(thread);
+    }
+  }
+
+  void ApplyPriority() {
+    if (options_.priority == QueuePriority::kNormal)
+      return;
+#ifdef __linux__
+    // The nice value is a per-thread attribute on Linux. Raising the
+    // priority needs privileges; failing to do so is not an error.
+    const int tid = static_cast<int>(syscall(SYS_gettid));
+    errno = 0;
+    const int nice_value = getpriority(PRIO_PROCESS, tid);
+    if (nice_value == -1 && errno != 0)
+      return;
+    USE(setpriority(PRIO_PROCESS, tid,
+                    nice_value +
+                        (options_.priority == QueuePriority::kLow ? 10 : -5)));
+#elif defined(_WIN32)
+    USE(SetThreadPriority(GetCurrentThread(),
+                          options_.priority == QueuePriority::kLow ?
+                              THREAD_PRIORITY_BELOW_NORMAL :
+                              THREAD_PRIORITY_ABOVE_NORMAL));
+#endif
+  }
+
+  static void Run(void* arg) {
+    Queue* queue = static_cast<Queue*>(arg);
+    queue->ApplyPriority();
+
+    Mutex::ScopedLock lock(queue->mutex_);
+    for (;;) {
+      while (queue->pending_.empty())
+        queue->work_available_.Wait(lock);
+      ThreadPoolWork* work = queue->pending_.front();
+      queue->pending_.pop_front();
+
+      Mutex::ScopedUnlock unlock(lock);
+      work->RunWork();
+      work->env_->threadpool_completion_queue()->Push(work, 0);
+    }
+  }
+
+  const QueueOptions options_;
+  Mutex mutex_;
+  ConditionVariable work_available_;
+  std::deque<ThreadPoolWork*> pending_;
+  std::vector<uv_thread_t> threads_;
+};
+
+namespace {
+
+uv_once_t init_once = UV_ONCE_INIT;
+Queue* queues[QUEUE_TYPE_COUNT];
+
+// One thread per CPU, within the limits of --threadpool-queue.
+int DefaultKdfThreads() {
+  uv_cpu_info_t* cpu_infos;
+  int count;
+  if (uv_cpu_info(&cpu_infos, &count) != 0)
+    return kDefaultThreads;
+  uv_free_cpu_info(cpu_infos, count);
+  return std::max(1, std::min(count, kMaxThreads));
+}
+
+// Queues are created from the command line options once and never freed,
+// so that their threads can keep running while the process exits.
+void InitializeQueues() {
+  // Batches of key derivations keep every thread of their queue busy for a
+  // long time, so they never share libuv's threadpool.
+  queues[QUEUE_TYPE_KDF] = new Queue(
+      { QUEUE_TYPE_KDF, DefaultKdfThreads(), QueuePriority::kNormal });
+  for (const std::string& value : per_process_opts->threadpool_queues) {
+    QueueOptions options;
+    std::string error;
+    // The options have already been validated during startup.
+    CHECK(ParseQueueOption(value, &options, &error));
+    // The last value for a queue wins.
+    delete queues[options.type];
+    queues[options.type] = new Queue(options);
+  }
+}
+
+Queue* GetQueue(QueueType type) {
+  uv_once(&init_once, InitializeQueues);
+  return queues[type];
+}
+
+}  // anonymous namespace
+
+bool ValidateQueueOption(const std::string& value, std::string* error) {
+  QueueOptions options;
+  return ParseQueueOption(value, &options, error);
+}
+
+int QueueThreads(QueueType type) {
+  const Queue* queue = GetQueue(type);
+  return queue != nullptr ? queue->threads() : LibuvThreadpoolSize();
+}
+
+// Each Monitor keeps three histograms per work type. Times are recorded in
+// nanoseconds, in buckets that are spaced logarithmically with 8 linear
+// sub-buckets per power of two, so percentiles derived from them are within
+// 12.5% of the exact value from nanoseconds up to several hours.
+enum MonitorHistogram {
+  kWaitHistogram,
+  kRunHistogram,
+  kLatencyHistogram,
+  kHistogramsPerWorkType
+};
+
+constexpr int kSubBucketBits = 3;
+constexpr int kSubBuckets = 1 << kSubBucketBits;
+
+enum HistogramField {
+  kHistogramCount,
+  kHistogramMin,
+  kHistogramMax,
+  kHistogramSum,
+  kHistogramSumOfSquares,
+  kHistogramFirstBucket,
+  kHistogramBucketCount = 44 * kSubBuckets,
+  kHistogramFieldCount = kHistogramFirstBucket + kHistogramBucketCount
+};
+
+constexpr size_t kMonitorFieldCount =
+    WORK_TYPE_COUNT * kHistogramsPerWorkType * kHistogramFieldCount;
+
+inline int BucketIndex(uint64_t value) {
+  if (value < kSubBuckets)
+    return static_cast<int>(value);
+  int exponent = kSubBucketBits;
+  while ((value >> (exponent + 1)) != 0)
+    exponent++;
+  const int sub_bucket =
+      static_cast<int>(value >> (exponent - kSubBucketBits)) &
+      (kSubBuckets - 1);
+  return std::min((exponent - kSubBucketBits + 1) * kSubBuckets + sub_bucket,
+                  static_cast<int>(kHistogramBucketCount) - 1);
+}
+
+// Backs a perf_hooks ThreadPoolMonitor. While enabled, it is part of its
+// Environment's list of monitors, and records work as it is handed back to
+// the event loop. Nothing is recorded for Environments without an enabled
+// monitor.
+class Monitor : public BaseObject {
+ public:
+  Monitor(Environment* env, Local<Object> wrap)
+      : BaseObject(env, wrap),
+        fields_(kMonitorFieldCount) {
+    MakeWeak();
+  }
+
+  ~Monitor() override {
+    StopRecording();
+  }
+
+  void Record(WorkType type, MonitorHistogram histogram, uint64_t value) {
+    double* fields = &fields_[(type * kHistogramsPerWorkType + histogram) *
+                              kHistogramFieldCount];
+    const double ns = static_cast<double>(value);
+    if (fields[kHistogramCount] == 0 || ns < fields[kHistogramMin])
+      fields[kHistogramMin] = ns;
+    if (ns > fields[kHistogramMax])
+      fields[kHistogramMax] = ns;
+    fields[kHistogramCount]++;
+    fields[kHistogramSum] += ns;
+    fields[kHistogramSumOfSquares] += ns * ns;
+    fields[kHistogramFirstBucket + BucketIndex(value)]++;
+  }
+
+  static void New(const FunctionCallbackInfo<Value>& args) {
+    CHECK(args.IsConstructCall());
+    Environment* env = Environment::GetCurrent(args);
+    new Monitor(env, args.This());
+  }
+
+  static void Enable(const FunctionCallbackInfo<Value>& args) {
+    Monitor* monitor;
+    ASSIGN_OR_RETURN_UNWRAP(&monitor, args.Holder());
+    args.GetReturnValue().Set(monitor->StartRecording());
+  }
+
+  static void Disable(const FunctionCallbackInfo<Value>& args) {
+    Monitor* monitor;
+    ASSIGN_OR_RETURN_UNWRAP(&monitor, args.Holder());
+    args.GetReturnValue().Set(monitor->StopRecording());
+  }
+
+  static void Reset(const FunctionCallbackInfo<Value>& args) {
+    Monitor* monitor;
+    ASSIGN_OR_RETURN_UNWRAP(&monitor, args.Holder());
+    std::fill(monitor->fields_.begin(), monitor->fields_.end(), 0);
+  }
+
+  // Copies the histograms of one work type into a Float64Array.
+  static void Read(const FunctionCallbackInfo<Value>& args) {
+    Monitor* monitor;
+    ASSIGN_OR_RETURN_UNWRAP(&monitor, args.Holder());
+    CHECK(args[0]->IsUint32());
+    CHECK(args[1]->IsFloat64Array());
+    const uint32_t type = args[0].As<v8::Uint32>()->Value();
+    CHECK_LT(type, WORK_TYPE_COUNT);
+    Local<Float64Array> array = args[1].As<Float64Array>();
+    CHECK_EQ(array->Length(), kHistogramsPerWorkType * kHistogramFieldCount);
+    double* out = reinterpret_cast<double*>(
+        static_cast<char*>(array->Buffer()->GetContents().Data()) +
+        array->ByteOffset());
+    std::copy_n(
+        &monitor->fields_[type * kHistogramsPerWorkType * kHistogramFieldCount],
+        kHistogramsPerWorkType * kHistogramFieldCount,
+        out);
+  }
+
+  SET_NO_MEMORY_INFO()
+  SET_MEMORY_INFO_NAME(ThreadPoolMonitor)
+  SET_SELF_SIZE(Monitor)
+
+ private:
+  bool StartRecording() {
+    if (enabled_)
+      return false;
+    enabled_ = true;
+    env()->threadpool_monitors()->push_back(this);
+    return true;
+  }
+
+  bool StopRecording() {
+    if (!enabled_)
+      return false;
+    enabled_ = false;
+    std::vector<Monitor*>* monitors = env()->threadpool_monitors();
+    monitors->erase(std::find(monitors->begin(), monitors->end(), this));
+    return true;
+  }
+
+  bool enabled_ = false;
+  std::vector<double> fields_;
+};
+
+bool IsTracing() {
+  bool enabled;
+  TRACE_EVENT_CATEGORY_GROUP_ENABLED(TRACING_CATEGORY_NODE1(threadpool),
+                                     &enabled);
+  return enabled;
+}
+
+void RecordWork(Environment* env,
+                WorkType type,
+                const void* id,
+                uint64_t queued_at,
+                uint64_t started_at,
+                uint64_t finished_at) {
+  const uint64_t now = uv_hrtime();
+
+  for (Monitor* monitor : *env->threadpool_monitors()) {
+    if (started_at != 0) {
+      monitor->Record(type, kWaitHistogram, started_at - queued_at);
+      monitor->Record(type, kRunHistogram, finished_at - started_at);
+    }
+    monitor->Record(type, kLatencyHistogram, now - queued_at);
+  }
+
+  if (!IsTracing())
+    return;
+  const char* name = kWorkTypeNames[type];
+  TRACE_EVENT_NESTABLE_ASYNC_BEGIN_WITH_TIMESTAMP0(
+      TRACING_CATEGORY_NODE1(threadpool), name, id, queued_at / 1000);
+  if (started_at != 0) {
+    TRACE_EVENT_NESTABLE_ASYNC_BEGIN_WITH_TIMESTAMP0(
+        TRACING_CATEGORY_NODE1(threadpool), "run", id, started_at / 1000);
+    TRACE_EVENT_NESTABLE_ASYNC_END_WITH_TIMESTAMP0(
+        TRACING_CATEGORY_NODE1(threadpool), "run", id, finished_at / 1000);
+  }
+  TRACE_EVENT_NESTABLE_ASYNC_END_WITH_TIMESTAMP0(
+      TRACING_CATEGORY_NODE1(threadpool), name, id, now / 1000);
+}
+
+static void GetQueueStats(const FunctionCallbackInfo<Value>& args) {
+  CHECK(args[0]->IsFloat64Array());
+  Local<Float64Array> array = args[0].As<Float64Array>();
+  CHECK_EQ(array->Length(), QUEUE_TYPE_COUNT * kQueueStatsFieldCount);
+  double* fields = reinterpret_cast<double*>(
+      static_cast<char*>(array->Buffer()->GetContents().Data()) +
+      array->ByteOffset());
+
+  for (int type = 0; type < QUEUE_TYPE_COUNT; type++) {
+    const Queue* queue = GetQueue(static_cast<QueueType>(type));
+    const QueueCounters& c = counters[type];
+    double* out = fields + type * kQueueStatsFieldCount;
+    out[kQueueThreads] = QueueThreads(static_cast<QueueType>(type));
+    out[kQueueDedicated] = queue != nullptr ? 1 : 0;
+    out[kQueuePriority] = static_cast<double>(
+        queue != nullptr ? queue->priority() : QueuePriority::kNormal);
+    out[kQueuePending] = c.pending;
+    out[kQueueRunning] = c.running;
+    out[kQueueCompleted] = c.completed;
+    out[kQueueWaitTime] = c.wait_time;
+    out[kQueueRunTime] = c.run_time;
+  }
+}
+
+static void Initialize(Local<Object> target,
+                       Local<Value> unused,
+                       Local<Context> context,
+                       void* priv) {
+  Environment* env = Environment::GetCurrent(context);
+
+  env->SetMethod(target, "getQueueStats", GetQueueStats);
+
+  Local<Array> names = Array::New(env->isolate(), QUEUE_TYPE_COUNT);
+  for (int type = 0; type < QUEUE_TYPE_COUNT; type++) {
+    names->Set(context, type,
+               OneByteString(env->isolate(), kQueueNames[type])).FromJust();
+  }
+  target->Set(context,
+              FIXED_ONE_BYTE_STRING(env->isolate(), "queueNames"),
+              names).FromJust();
+
+  Local<FunctionTemplate> monitor =
+      env->NewFunctionTemplate(Monitor::New);
+  monitor->InstanceTemplate()->SetInternalFieldCount(1);
+  env->SetProtoMethod(monitor, "enable", Monitor::Enable);
+  env->SetProtoMethod(monitor, "disable", Monitor::Disable);
+  env->SetProtoMethod(monitor, "reset", Monitor::Reset);
+  env->SetProtoMethod(monitor, "read", Monitor::Read);
+  Local<String> monitor_string =
+      FIXED_ONE_BYTE_STRING(env->isolate(), "ThreadPoolMonitor");
+  monitor->SetClassName(monitor_string);
+  target->Set(context,
+              monitor_string,
+              monitor->GetFunction(context).ToLocalChecked()).FromJust();
+
+  Local<Array> work_types = Array::New(env->isolate(), WORK_TYPE_COUNT);
+  for (int type = 0; type < WORK_TYPE_COUNT; type++) {
+    work_types->Set(context, type,
+                    OneByteString(env->isolate(),
+                                  kWorkTypeNames[type])).FromJust();
+  }
+  target->Set(context,
+              FIXED_ONE_BYTE_STRING(env->isolate(), "workTypes"),
+              work_types).FromJust();
+
+  Local<Object> constants = Object::New(env->isolate());
+  NODE_DEFINE_CONSTANT(constants, kQueueThreads);
+  NODE_DEFINE_CONSTANT(constants, kQueueDedicated);
+  NODE_DEFINE_CONSTANT(constants, kQueuePriority);
+  NODE_DEFINE_CONSTANT(constants, kQueuePending);
+  NODE_DEFINE_CONSTANT(constants, kQueueRunning);
+  NODE_DEFINE_CONSTANT(constants, kQueueCompleted);
+  NODE_DEFINE_CONSTANT(constants, kQueueWaitTime);
+  NODE_DEFINE_CONSTANT(constants, kQueueRunTime);
+  NODE_DEFINE_CONSTANT(constants, kQueueStatsFieldCount);
+  NODE_DEFINE_CONSTANT(constants, kWaitHistogram);
+  NODE_DEFINE_CONSTANT(constants, kRunHistogram);
+  NODE_DEFINE_CONSTANT(constants, kLatencyHistogram);
+  NODE_DEFINE_CONSTANT(constants, kHistogramsPerWorkType);
+  NODE_DEFINE_CONSTANT(constants, kSubBucketBits);
+  NODE_DEFINE_CONSTANT(constants, kHistogramCount);
+  NODE_DEFINE_CONSTANT(constants, kHistogramMin);
+  NODE_DEFINE_CONSTANT(constants, kHistogramMax);
+  NODE_DEFINE_CONSTANT(constants, kHistogramSum);
+  NODE_DEFINE_CONSTANT(constants, kHistogramSumOfSquares);
+  NODE_DEFINE_CONSTANT(constants, kHistogramFirstBucket);
+  NODE_DEFINE_CONSTANT(constants, kHistogramBucketCount);
+  NODE_DEFINE_CONSTANT(constants, kHistogramFieldCount);
+  target->Set(context,
+              env->constants_string(),
+              constants).FromJust();
+}
+
+}  // namespace threadpool
+
+void ThreadPoolWork::ScheduleWork() {
+  env_->IncreaseWaitingRequestCounter();
+  queued_at_ = uv_hrtime();
+  started_at_ = 0;
+  threadpool::counters[queue_].pending++;
+
+  threadpool::Queue* queue = threadpool::GetQueue(queue_);
+  if (queue != nullptr) {
+    threadpool::CompletionQueue::Get(env_)->Ref();
+    queue->Push(this);
+    return;
+  }
+
+  int status = uv_queue_work(
+      env_->event_loop(),
+      &work_req_,
+      [](uv_work_t* req) {
+        ThreadPoolWork* self = ContainerOf(&ThreadPoolWork::work_req_, req);
+        self->RunWork();
+      },
+      [](uv_work_t* req, int status) {
+        ThreadPoolWork* self = ContainerOf(&ThreadPoolWork::work_req_, req);
+        self->FinishWork(status);
+      });
+  CHECK_EQ(status, 0);
+}
+
+int ThreadPoolWork::CancelWork() {
+  threadpool::Queue* queue = threadpool::GetQueue(queue_);
+  if (queue == nullptr)
+    return uv_cancel(reinterpret_cast<uv_req_t*>(&work_req_));
+
+  if (!queue->Cancel(this))
+    return UV_EBUSY;
+  // Like libuv, report the cancellation asynchronously.
+  env_->threadpool_completion_queue()->Push(this, UV_ECANCELED);
+  return 0;
+}
+
+void ThreadPoolWork::RunWork() {
+  threadpool::QueueCounters& c = threadpool::counters[queue_];
+  started_at_ = uv_hrtime();
+  c.pending--;
+  c.running++;
+  c.wait_time += started_at_ - queued_at_;
+
+  DoThreadPoolWork();
+
+  finished_at_ = uv_hrtime();
+  c.run_time += finished_at_ - started_at_;
+  c.running--;
+  c.completed++;
+}
+
+void ThreadPoolWork::FinishWork(int status) {
+  // Work that was cancelled before it ran is still counted as pending.
+  if (started_at_ == 0) {
+    threadpool::counters[queue_].pending--;
+  } else if (!env_->threadpool_monitors()->empty() || threadpool::IsTracing()) {
+    threadpool::RecordWork(env_, threadpool::kQueueWorkTypes[queue_], this,
+                           queued_at_, started_at_, finished_at_);
+  }
+  env_->DecreaseWaitingRequestCounter();
+  AfterThreadPoolWork(status);
+}
+
+}  // namespace node
+
+NODE_MODULE_CONTEXT_AWARE_INTERNAL(threadpool, node::threadpool::Initialize)
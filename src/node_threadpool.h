@@ -0,0 +1,105 @@
+#ifndef SRC_NODE_THREADPOOL_H_
+#define SRC_NODE_THREADPOOL_H_
+
+#if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#include <stdint.h>
+#include <string>
+
+namespace node {
+
+class Environment;
+
+namespace threadpool {
+
+// The classes of work that Node.js hands off to a thread pool. Every class
+// is a named queue with its own statistics. By default all of them but `kdf`
+// feed libuv's threadpool; a queue that has been given a size with
+// --threadpool-queue gets dedicated threads of its own instead. The `kdf`
+// queue, which runs batches of key derivations, always has dedicated threads,
+// one per CPU unless configured otherwise.
+#define THREADPOOL_QUEUE_TYPES(V)                                             \
+  V(FS, "fs")                                                                 \
+  V(CRYPTO, "crypto")                                                         \
+  V(KDF, "kdf")                                                               \
+  V(ZLIB, "zlib")                                                             \
+  V(NAPI, "napi")
+
+enum QueueType {
+#define V(type, _) QUEUE_TYPE_##type,
+  THREADPOOL_QUEUE_TYPES(V)
+#undef V
+  QUEUE_TYPE_COUNT
+};
+
+// The kinds of work that perf_hooks.monitorThreadPool() reports on: every
+// queue, plus the DNS requests that libuv runs on its threadpool directly.
+// File system requests that libuv runs are reported as `fs` work.
+#define THREADPOOL_WORK_TYPES(V)                                              \
+  V(FS, "fs")                                                                 \
+  V(DNS, "dns")                                                               \
+  V(CRYPTO, "crypto")                                                         \
+  V(KDF, "kdf")                                                               \
+  V(ZLIB, "zlib")                                                             \
+  V(NAPI, "napi")
+
+enum WorkType {
+#define V(type, _) WORK_TYPE_##type,
+  THREADPOOL_WORK_TYPES(V)
+#undef V
+  WORK_TYPE_COUNT
+};
+
+// Applied to the threads of a dedicated queue. The OS scheduler still decides
+// how that maps to CPU time; this is a best-effort hint that is only honored
+// on Linux and Windows.
+enum class QueuePriority { kLow, kNormal, kHigh };
+
+// Fields reported for each queue by the binding's getQueueStats(), in this
+// order.
+enum QueueStatsField {
+  kQueueThreads,
+  kQueueDedicated,
+  kQueuePriority,
+  kQueuePending,
+  kQueueRunning,
+  kQueueCompleted,
+  kQueueWaitTime,
+  kQueueRunTime,
+  kQueueStatsFieldCount
+};
+
+// Parses a single --threadpool-queue value of the form
+// `<queue>:<threads>[:<priority>]`. Returns false and sets `*error` if the
+// value is malformed.
+bool ValidateQueueOption(const std::string& value, std::string* error);
+
+// The number of threads that run work from the queue `type`. For queues
+// without dedicated threads, this is the size of libuv's threadpool.
+int QueueThreads(QueueType type);
+
+// Records the timings of a finished piece of work for the monitors that are
+// enabled in `env`, and as trace events in the `node.threadpool` category.
+// All times are uv_hrtime() values. `started_at` and `finished_at` are 0 for
+// requests that libuv schedules itself, for which only the total latency is
+// known. Must be called on the event loop thread of `env`.
+void RecordWork(Environment* env,
+                WorkType type,
+                const void* id,
+                uint64_t queued_at,
+                uint64_t started_at,
+                uint64_t finished_at);
+
+// Whether the `node.threadpool` trace event category is enabled.
+bool IsTracing();
+
+class CompletionQueue;
+class Monitor;
+class Queue;
+
+}  // namespace threadpool
+}  // namespace node
+
+#endif  // defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#endif  // SRC_NODE_THREADPOOL_H_
@@ -102,6 +102,10 @@ void GetEnabledCategories(const FunctionCallbackInfo<Value>& args) {
   }
 }
 
+void DumpTraceBuffer(const FunctionCallbackInfo<Value>& args) {
+  GetTracingAgentWriter()->agent()->DumpTraceBuffer();
+}
+
 void NodeCategorySet::Initialize(Local<Object> target,
                 Local<Value> unused,
                 Local<Context> context,
@@ -109,6 +113,7 @@ void NodeCategorySet::Initialize(Local<Object> target,
   Environment* env = Environment::GetCurrent(context);
 
   env->SetMethod(target, "getEnabledCategories", GetEnabledCategories);
+  env->SetMethod(target, "dumpTraceBuffer", DumpTraceBuffer);
 
   Local<FunctionTemplate> category_set =
       env->NewFunctionTemplate(NodeCategorySet::New);
@@ -3,10 +3,14 @@
 #include "node_errors.h"
 #include "node_i18n.h"
 #include "node_internals.h"
+#include "node_mutex.h"
 
+#include <list>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include <stdio.h>
+#include <string.h>
 #include <cmath>
 
 namespace node {
@@ -19,6 +23,7 @@ using v8::Function;
 using v8::FunctionCallbackInfo;
 using v8::HandleScope;
 using v8::Int32;
+using v8::Int32Array;
 using v8::Integer;
 using v8::Isolate;
 using v8::Local;
@@ -1173,6 +1178,61 @@ bool ParseHost(const std::string& input,
   return true;
 }
 
+// A small LRU cache of the hosts of URLs that FindComponents() accepts. Most
+// URLs that a process parses share a few hosts, which then skip the percent
+// decoding, IDNA processing and IPv4 parsing in URLHost.
+class HostCache {
+ public:
+  bool Parse(const char* input, size_t length, std::string* output);
+
+ private:
+  static const size_t kCapacity = 64;
+
+  Mutex mutex_;
+  // The input and parsed host of each entry, the most recently used first.
+  std::list<std::pair<std::string, std::string>> entries_;
+  std::unordered_map<std::string, decltype(entries_)::iterator> index_;
+};
+
+bool HostCache::Parse(const char* input,
+                      size_t length,
+                      std::string* output) {
+  std::string key(input, length);
+  {
+    Mutex::ScopedLock lock(mutex_);
+    auto it = index_.find(key);
+    if (it != index_.end()) {
+      entries_.splice(entries_.begin(), entries_, it->second);
+      *output = it->second->second;
+      return true;
+    }
+  }
+
+  // Parse without holding the lock. Hosts that fail to parse are not cached,
+  // their URLs fail in URL::Parse() anyway.
+  if (!ParseHost(key, output, true))
+    return false;
+
+  Mutex::ScopedLock lock(mutex_);
+  if (index_.find(key) == index_.end()) {
+    entries_.emplace_front(key, *output);
+    index_.emplace(std::move(key), entries_.begin());
+    if (entries_.size() > kCapacity) {
+      index_.erase(entries_.back().first);
+      entries_.pop_back();
+    }
+  }
+  return true;
+}
+
+// The cache is shared by every Environment and thread, which is why HostCache
+// locks its state. It is never destroyed, so that threads that still parse
+// URLs while the process exits cannot use it after its destructor ran.
+static HostCache* GetHostCache() {
+  static HostCache* const cache = new HostCache();
+  return cache;
+}
+
 inline std::vector<std::string> FromJSStringArray(Environment* env,
                                                   Local<Array> array) {
   std::vector<std::string> vec;
@@ -1353,8 +1413,167 @@ inline void ShortenUrlPath(struct url_data* url) {
   url->path.pop_back();
 }
 
+// Whether the path segment between `start` and `end` would be removed or
+// would remove the segment before it.
+inline bool IsDotSegment(const char* start, const char* end) {
+  const size_t length = end - start;
+  if (length == 0 || length > 6 || (start[0] != '.' && start[0] != '%'))
+    return false;
+  const std::string segment(start, length);
+  return IsSingleDotSegment(segment) || IsDoubleDotSegment(segment);
+}
+
+// https://infra.spec.whatwg.org/#ascii-code-point, without C0 controls,
+// space and U+007F DELETE.
+inline bool IsPrintableASCII(const char ch) {
+  return ch > ' ' && ch < '\x7f';
+}
+
+inline void SetComponents(const char* input,
+                          size_t len,
+                          const int32_t components[kComponentCount],
+                          std::string&& host,
+                          struct url_data* url) {
+  url->flags |= components[kComponentFlags];
+  url->port = components[kComponentPort];
+  url->scheme.assign(input, components[kComponentSchemeEnd]);
+  url->host = std::move(host);
+
+  // Special URLs always have a path, even if it is empty.
+  const char* segment = input + components[kComponentPathStart];
+  const char* const path_end = input + components[kComponentPathEnd];
+  if (segment == path_end) {
+    url->path.emplace_back("");
+  } else {
+    // Skip the slash in front of each segment.
+    while (segment++ < path_end) {
+      const char* end =
+          static_cast<const char*>(memchr(segment, '/', path_end - segment));
+      if (end == nullptr)
+        end = path_end;
+      url->path.emplace_back(segment, end - segment);
+      segment = end;
+    }
+  }
+
+  if (url->flags & URL_FLAGS_HAS_QUERY) {
+    url->query.assign(input + components[kComponentQueryStart],
+                      components[kComponentQueryEnd] -
+                          components[kComponentQueryStart]);
+  }
+  if (url->flags & URL_FLAGS_HAS_FRAGMENT) {
+    url->fragment.assign(input + components[kComponentFragmentStart],
+                         len - components[kComponentFragmentStart]);
+  }
+}
+
 }  // anonymous namespace
 
+bool URL::FindComponents(const char* input,
+                         size_t len,
+                         int32_t components[kComponentCount],
+                         std::string* host) {
+  const char* const end = input + len;
+  const char* p;
+  bool https = false;
+  if (len >= 7 && memcmp(input, "http://", 7) == 0) {
+    p = input + 7;
+  } else if (len >= 8 && memcmp(input, "https://", 8) == 0) {
+    p = input + 8;
+    https = true;
+  } else {
+    return false;
+  }
+  const char* const scheme_end = p - 2;
+  int32_t flags = URL_FLAGS_SPECIAL | URL_FLAGS_HAS_HOST | URL_FLAGS_HAS_PATH;
+
+  // Userinfo, IPv6 addresses and backslashes, which Parse() takes as slashes,
+  // are left to Parse(), as are code points that it would strip or escape
+  // anywhere in the URL.
+  const char* const host_start = p;
+  for (; p < end; p++) {
+    const char ch = *p;
+    if (ch == ':' || ch == '/' || ch == '?' || ch == '#')
+      break;
+    if (ch == '@' || ch == '[' || ch == '\\' || !IsPrintableASCII(ch))
+      return false;
+  }
+  const char* const host_end = p;
+  if (host_end == host_start)
+    return false;
+
+  int port = -1;
+  if (p < end && *p == ':') {
+    const char* const port_start = ++p;
+    unsigned value = 0;
+    for (; p < end && IsASCIIDigit(*p); p++) {
+      value = value * 10 + (*p - '0');
+      if (value > 0xffff)
+        return false;
+    }
+    if (p < end && *p != '/' && *p != '?' && *p != '#')
+      return false;
+    if (p > port_start) {
+      port = NormalizePort(https ? "https:" : "http:", value);
+      if (port == -1)
+        flags |= URL_FLAGS_IS_DEFAULT_SCHEME_PORT;
+    }
+  }
+
+  const char* const path_start = p;
+  if (p < end && *p == '/') {
+    for (;;) {
+      const char* const segment = ++p;
+      for (; p < end && *p != '/' && *p != '?' && *p != '#'; p++) {
+        if (*p == '\\' || BitAt(PATH_ENCODE_SET, *p))
+          return false;
+      }
+      if (IsDotSegment(segment, p))
+        return false;
+      if (p == end || *p != '/')
+        break;
+    }
+  }
+  const char* const path_end = p;
+
+  const char* query_start = p;
+  if (p < end && *p == '?') {
+    flags |= URL_FLAGS_HAS_QUERY;
+    query_start = ++p;
+    for (; p < end && *p != '#'; p++) {
+      if (BitAt(QUERY_ENCODE_SET_SPECIAL, *p))
+        return false;
+    }
+  }
+  const char* const query_end = p;
+
+  const char* fragment_start = p;
+  if (p < end) {
+    CHECK_EQ(*p, '#');
+    flags |= URL_FLAGS_HAS_FRAGMENT;
+    fragment_start = ++p;
+    for (; p < end; p++) {
+      if (BitAt(FRAGMENT_ENCODE_SET, *p))
+        return false;
+    }
+  }
+
+  if (!GetHostCache()->Parse(host_start, host_end - host_start, host))
+    return false;
+
+  components[kComponentFlags] = flags;
+  components[kComponentPort] = port;
+  components[kComponentSchemeEnd] = scheme_end - input;
+  components[kComponentHostStart] = host_start - input;
+  components[kComponentHostEnd] = host_end - input;
+  components[kComponentPathStart] = path_start - input;
+  components[kComponentPathEnd] = path_end - input;
+  components[kComponentQueryStart] = query_start - input;
+  components[kComponentQueryEnd] = query_end - input;
+  components[kComponentFragmentStart] = fragment_start - input;
+  return true;
+}
+
 void URL::Parse(const char* input,
                 size_t len,
                 enum url_parse_state state_override,
@@ -1362,6 +1581,17 @@ void URL::Parse(const char* input,
                 bool has_url,
                 const struct url_data* base,
                 bool has_base) {
+  // Most URLs are http: or https: URLs that need no changes, which can skip
+  // the state machine.
+  if (!has_url && state_override == kUnknownState) {
+    int32_t components[kComponentCount];
+    std::string host;
+    if (FindComponents(input, len, components, &host)) {
+      SetComponents(input, len, components, std::move(host), url);
+      return;
+    }
+  }
+
   const char* p = input;
   const char* end = input + len;
 
@@ -2210,6 +2440,44 @@ static void Parse(const FunctionCallbackInfo<Value>& args) {
         args[5]);
 }
 
+// findComponents(input, components)
+// Fills the Int32Array `components` in for URL::FindComponents(), so that JS
+// can take the components out of `input` itself. Returns false if `input` has
+// to go through parse() instead, or the host if it differs from the one in
+// `input`.
+static void FindComponents(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(args[0]->IsString());  // input
+  CHECK(args[1]->IsInt32Array());  // components
+
+  // The offsets would not match a two-byte string, and such a URL is rarely
+  // ASCII anyway.
+  if (!args[0].As<String>()->IsOneByte())
+    return args.GetReturnValue().Set(false);
+
+  Local<Int32Array> array = args[1].As<Int32Array>();
+  CHECK_EQ(array->Length(), kComponentCount);
+  int32_t* components = reinterpret_cast<int32_t*>(
+      static_cast<char*>(array->Buffer()->GetContents().Data()) +
+      array->ByteOffset());
+
+  Utf8Value input(env->isolate(), args[0]);
+  std::string host;
+  if (!URL::FindComponents(*input, input.length(), components, &host))
+    return args.GetReturnValue().Set(false);
+
+  const char* host_start = *input + components[kComponentHostStart];
+  const size_t host_length =
+      components[kComponentHostEnd] - components[kComponentHostStart];
+  if (host.length() == host_length &&
+      memcmp(host.data(), host_start, host_length) == 0) {
+    return;
+  }
+  args.GetReturnValue().Set(OneByteString(env->isolate(),
+                                          host.data(),
+                                          host.length()));
+}
+
 static void EncodeAuthSet(const FunctionCallbackInfo<Value>& args) {
   Environment* env = Environment::GetCurrent(args);
   CHECK_GE(args.Length(), 1);
@@ -2433,6 +2701,7 @@ static void Initialize(Local<Object> target,
                        void* priv) {
   Environment* env = Environment::GetCurrent(context);
   env->SetMethod(target, "parse", Parse);
+  env->SetMethod(target, "findComponents", FindComponents);
   env->SetMethodNoSideEffect(target, "encodeAuth", EncodeAuthSet);
   env->SetMethodNoSideEffect(target, "toUSVString", ToUSVString);
   env->SetMethodNoSideEffect(target, "domainToASCII", DomainToASCII);
@@ -2445,6 +2714,7 @@ static void Initialize(Local<Object> target,
 
 #define XX(name) NODE_DEFINE_CONSTANT(target, name);
   PARSESTATES(XX)
+  COMPONENTS(XX)
 #undef XX
 }
 }  // namespace url
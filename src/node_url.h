@@ -53,6 +53,21 @@ using v8::Value;
   XX(URL_FLAGS_HAS_FRAGMENT, 0x400)                                           \
   XX(URL_FLAGS_IS_DEFAULT_SCHEME_PORT, 0x800)                                 \
 
+// Indices into the array that URL::FindComponents() fills in. Offsets are
+// byte offsets into the input.
+#define COMPONENTS(XX)                                                        \
+  XX(kComponentFlags)                                                         \
+  XX(kComponentPort)                                                          \
+  XX(kComponentSchemeEnd)                                                     \
+  XX(kComponentHostStart)                                                     \
+  XX(kComponentHostEnd)                                                       \
+  XX(kComponentPathStart)                                                     \
+  XX(kComponentPathEnd)                                                       \
+  XX(kComponentQueryStart)                                                    \
+  XX(kComponentQueryEnd)                                                      \
+  XX(kComponentFragmentStart)                                                 \
+  XX(kComponentCount)  // This one has to be last.
+
 enum url_parse_state {
   kUnknownState = -1,
 #define XX(name) name,
@@ -66,6 +81,12 @@ enum url_flags {
 #undef XX
 };
 
+enum url_components {
+#define XX(name) name,
+  COMPONENTS(XX)
+#undef XX
+};
+
 struct url_data {
   int32_t flags = URL_FLAGS_NONE;
   int port = -1;
@@ -88,6 +109,15 @@ class URL {
                     const struct url_data* base,
                     bool has_base);
 
+  // Finds the components of `input` without copying them, if it is an ASCII
+  // http: or https: URL that Parse() would take over unchanged, apart from its
+  // host. The parsed host is stored in `host`. Returns false for any other
+  // input, which has to go through Parse().
+  static bool FindComponents(const char* input,
+                             size_t len,
+                             int32_t components[kComponentCount],
+                             std::string* host);
+
   URL(const char* input, const size_t len) {
     Parse(input, len, kUnknownState, &context_, false, nullptr, false);
   }
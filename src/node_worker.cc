@@ -183,6 +183,7 @@ void Worker::Run() {
         inspector_started = true;
 
         HandleScope handle_scope(isolate_);
+        profiler::StartProfilers(env_.get());
         Environment::AsyncCallbackScope callback_scope(env_.get());
         env_->async_hooks()->push_async_ids(1, 0);
         // This loads the Node bootstrapping code.
@@ -246,6 +247,7 @@ void Worker::Run() {
 
     {
       Context::Scope context_scope(env_->context());
+      profiler::EndStartedProfilers(env_.get());
       child_port->Close();
       env_->stop_sub_worker_contexts();
       env_->RunCleanup();
@@ -22,6 +22,7 @@
 #include "node.h"
 #include "node_buffer.h"
 #include "node_internals.h"
+#include "node_mutex.h"
 
 #include "async_wrap-inl.h"
 #include "env-inl.h"
@@ -34,7 +35,9 @@
 #include <stdlib.h>
 #include <string.h>
 #include <sys/types.h>
+#include <algorithm>
 #include <atomic>
+#include <memory>
 
 namespace node {
 
@@ -48,10 +51,12 @@ using v8::HandleScope;
 using v8::Int32;
 using v8::Integer;
 using v8::Local;
+using v8::MaybeLocal;
 using v8::Object;
 using v8::String;
 using v8::Uint32;
 using v8::Uint32Array;
+using v8::Undefined;
 using v8::Value;
 
 namespace {
@@ -143,15 +148,69 @@ class ZlibContext : public MemoryRetainer {
 
   z_stream strm_;
 
+  friend class ParallelDeflate;
+
   DISALLOW_COPY_AND_ASSIGN(ZlibContext);
 };
 
+// Compresses a one-shot input in independent blocks that can be processed on
+// several threads at once, the way pigz does. Each block is deflated as a raw
+// stream that uses the end of the previous block as its dictionary and that
+// ends in a sync flush, so that the compressed blocks concatenate into a
+// single deflate stream. The zlib or gzip header and trailer are written
+// around it, with the checksums of the blocks combined into one.
+class ParallelDeflate {
+ public:
+  static constexpr size_t kBlockSize = 128 * 1024;
+
+  // Uses the parameters of `ctx`, which must be a deflate context without a
+  // dictionary. `in` must stay valid until the job is destroyed.
+  ParallelDeflate(const ZlibContext& ctx, const char* in, size_t in_len);
+
+  size_t block_count() const { return blocks_.size(); }
+
+  // Compresses blocks until none are left. Can be called on several threads
+  // at once; the output is complete once all of them have returned.
+  void Run();
+
+  CompressionError GetErrorInfo() const;
+  size_t OutputLength() const;
+  void CopyOutput(char* out) const;
+
+ private:
+  struct Block {
+    size_t offset;
+    size_t length;
+    MallocedBuffer<char> out;
+    uLong check = 0;
+  };
+
+  int CompressBlock(z_stream* strm, size_t index);
+  void SetError(int err, const char* message);
+  size_t HeaderLength() const;
+  size_t TrailerLength() const;
+
+  node_zlib_mode mode_;
+  int level_;
+  int mem_level_;
+  int strategy_;
+  int window_bits_;
+  const char* in_;
+  size_t in_len_;
+  std::vector<Block> blocks_;
+  std::atomic<size_t> next_block_{0};
+  std::atomic<int> err_{Z_OK};
+  const char* message_ = nullptr;
+
+  DISALLOW_COPY_AND_ASSIGN(ParallelDeflate);
+};
+
 template <typename CompressionContext>
 class CompressionStream : public AsyncWrap, public ThreadPoolWork {
  public:
   CompressionStream(Environment* env, Local<Object> wrap)
       : AsyncWrap(env, wrap, AsyncWrap::PROVIDER_ZLIB),
-        ThreadPoolWork(env),
+        ThreadPoolWork(env, threadpool::QUEUE_TYPE_ZLIB),
         write_result_(nullptr) {
     MakeWeak();
   }
@@ -241,14 +300,7 @@ class CompressionStream : public AsyncWrap, public ThreadPoolWork {
              char* in, uint32_t in_len,
              char* out, uint32_t out_len) {
     AllocScope alloc_scope(this);
-
-    CHECK(init_done_ && "write before init");
-    CHECK(!closed_ && "already finalized");
-
-    CHECK_EQ(false, write_in_progress_);
-    CHECK_EQ(false, pending_close_);
-    write_in_progress_ = true;
-    Ref();
+    BeginWrite();
 
     ctx_.SetBuffers(in, in_len, out, out_len);
     ctx_.SetFlush(flush);
@@ -355,6 +407,25 @@ class CompressionStream : public AsyncWrap, public ThreadPoolWork {
     init_done_ = true;
   }
 
+  // Marks a write as in progress, which keeps the stream alive and defers
+  // Close() until the matching EndWrite().
+  void BeginWrite() {
+    CHECK(init_done_ && "write before init");
+    CHECK(!closed_ && "already finalized");
+
+    CHECK_EQ(false, write_in_progress_);
+    CHECK_EQ(false, pending_close_);
+    write_in_progress_ = true;
+    Ref();
+  }
+
+  void EndWrite() {
+    write_in_progress_ = false;
+    Unref();
+    if (pending_close_)
+      Close();
+  }
+
   // Allocation functions provided to zlib itself. We store the real size of
   // the allocated memory chunk just before the "payload" memory we return
   // to zlib.
@@ -535,11 +606,737 @@ class ZlibStream : public CompressionStream<ZlibContext> {
       wrap->EmitError(err);
   }
 
+  // parallelWrite(in, threads, callback), parallelWriteSync(in, threads)
+  // Compresses all of `in` in one go, splitting it up across up to `threads`
+  // threads. The result is passed to `callback` or returned; it is undefined
+  // if the output would exceed the maximum Buffer size.
+  template <bool async>
+  static void ParallelWrite(const FunctionCallbackInfo<Value>& args) {
+    Environment* env = Environment::GetCurrent(args);
+    CHECK(Buffer::HasInstance(args[0]));
+    CHECK(args[1]->IsUint32());
+    CHECK_GT(Buffer::Length(args[0]), 0);
+
+    ZlibStream* wrap;
+    ASSIGN_OR_RETURN_UNWRAP(&wrap, args.Holder());
+
+    wrap->BeginWrite();
+    wrap->parallel_.reset(new ParallelDeflate(*wrap->context(),
+                                              Buffer::Data(args[0]),
+                                              Buffer::Length(args[0])));
+    const size_t threads = std::min<size_t>(args[1].As<Uint32>()->Value(),
+                                            wrap->parallel_->block_count());
+
+    if (!async) {
+      env->PrintSyncTrace();
+      OnScopeLeave on_scope_leave([&]() { wrap->EndWrite(); });
+
+      // The calling thread takes part as well. If a helper thread cannot be
+      // started, the blocks are simply spread over fewer threads.
+      std::vector<uv_thread_t> helpers(threads - 1);
+      size_t started = 0;
+      for (; started < helpers.size(); started++) {
+        if (uv_thread_create(&helpers[started], [](void* arg) {
+              static_cast<ParallelDeflate*>(arg)->Run();
+            }, wrap->parallel_.get()) != 0) {
+          break;
+        }
+      }
+      wrap->parallel_->Run();
+      for (size_t i = 0; i < started; i++)
+        CHECK_EQ(uv_thread_join(&helpers[i]), 0);
+
+      Local<Value> result;
+      if (wrap->FinishParallelWrite().ToLocal(&result))
+        args.GetReturnValue().Set(result);
+      return;
+    }
+
+    CHECK(args[2]->IsFunction());
+    wrap->parallel_callback_.Reset(env->isolate(), args[2].As<Function>());
+    wrap->parallel_pending_ = threads;
+    for (size_t i = 0; i < threads; i++)
+      (new ParallelDeflateWork(wrap))->ScheduleWork();
+  }
+
   SET_MEMORY_INFO_NAME(ZlibStream)
   SET_SELF_SIZE(ZlibStream)
+
+ private:
+  // One thread's share of a parallelWrite() call. All of them pull blocks
+  // from the same ParallelDeflate job.
+  class ParallelDeflateWork : public ThreadPoolWork {
+   public:
+    explicit ParallelDeflateWork(ZlibStream* stream)
+        : ThreadPoolWork(stream->env(), threadpool::QUEUE_TYPE_ZLIB),
+          stream_(stream) {}
+
+    void DoThreadPoolWork() override {
+      stream_->parallel_->Run();
+    }
+
+    void AfterThreadPoolWork(int status) override {
+      std::unique_ptr<ParallelDeflateWork> self(this);
+      stream_->AfterParallelWork(status);
+    }
+
+   private:
+    ZlibStream* stream_;
+  };
+
+  void AfterParallelWork(int status) {
+    if (status == UV_ECANCELED)
+      parallel_cancelled_ = true;
+    if (--parallel_pending_ > 0)
+      return;
+
+    OnScopeLeave on_scope_leave([&]() { EndWrite(); });
+    HandleScope handle_scope(env()->isolate());
+    Context::Scope context_scope(env()->context());
+
+    // Take a real handle; parallel_callback_ is reset before it is called.
+    Local<Function> cb = Local<Function>::New(env()->isolate(),
+                                              parallel_callback_);
+    parallel_callback_.Reset();
+
+    if (parallel_cancelled_) {
+      parallel_cancelled_ = false;
+      parallel_.reset();
+      Close();
+      return;
+    }
+
+    Local<Value> result;
+    if (FinishParallelWrite().ToLocal(&result))
+      MakeCallback(cb, 1, &result);
+  }
+
+  // Returns the output of the finished parallel_ job, or an empty handle
+  // if an error has been emitted instead.
+  MaybeLocal<Value> FinishParallelWrite() {
+    std::unique_ptr<ParallelDeflate> job = std::move(parallel_);
+
+    const CompressionError err = job->GetErrorInfo();
+    if (err.IsError()) {
+      EmitError(err);
+      return MaybeLocal<Value>();
+    }
+
+    const size_t length = job->OutputLength();
+    if (length > Buffer::kMaxLength)
+      return Undefined(env()->isolate());
+
+    char* data = UncheckedMalloc(length);
+    if (data == nullptr) {
+      EmitError(CompressionError("Out of memory", "Z_MEM_ERROR", Z_MEM_ERROR));
+      return MaybeLocal<Value>();
+    }
+    job->CopyOutput(data);
+
+    Local<Object> buffer;
+    if (!Buffer::New(env(), data, length).ToLocal(&buffer))
+      return MaybeLocal<Value>();
+    return buffer;
+  }
+
+  std::unique_ptr<ParallelDeflate> parallel_;
+  Persistent<Function> parallel_callback_;
+  size_t parallel_pending_ = 0;
+  bool parallel_cancelled_ = false;
+};
+
+
+// The allocator of a single zlib context of a ZlibPool. zlib allocates all
+// memory of a context when it is initialized, apart from the inflate window
+// that is allocated on first use, and keeps it until the context is ended.
+// Since the contexts of a pool are reset rather than ended between messages,
+// including after an error, a bump allocator that hands its memory back only
+// when the context is destroyed does not grow after the first message.
+class ZlibArena {
+ public:
+  ZlibArena() = default;
+
+  static void* Alloc(void* data, uInt items, uInt size) {
+    ZlibArena* arena = static_cast<ZlibArena*>(data);
+    const size_t length =
+        (MultiplyWithOverflowCheck(static_cast<size_t>(items),
+                                   static_cast<size_t>(size)) +
+         kAlignment - 1) & ~(kAlignment - 1);
+
+    if (arena->chunks_.empty() ||
+        arena->used_ + length > arena->chunks_.back().size) {
+      const size_t chunk_size = std::max(length, kChunkSize);
+      char* chunk = UncheckedMalloc(chunk_size);
+      if (UNLIKELY(chunk == nullptr)) return nullptr;
+      arena->chunks_.emplace_back(chunk, chunk_size);
+      arena->used_ = 0;
+      arena->size_ += chunk_size;
+    }
+
+    void* memory = arena->chunks_.back().data + arena->used_;
+    arena->used_ += length;
+    return memory;
+  }
+
+  static void Free(void* data, void* pointer) {}
+
+  size_t size() const { return size_; }
+
+ private:
+  static constexpr size_t kChunkSize = 64 * 1024;
+  static constexpr size_t kAlignment = 16;
+
+  std::vector<MallocedBuffer<char>> chunks_;
+  size_t used_ = 0;
+  size_t size_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(ZlibArena);
+};
+
+constexpr size_t ZlibArena::kChunkSize;
+constexpr size_t ZlibArena::kAlignment;
+
+// A set of zlib contexts with the same parameters and dictionary, for
+// processing many small, independent messages. A batch() call takes an idle
+// context, or initializes a new one, and processes all of its messages with it
+// in a single threadpool job, resetting the context in between. The context is
+// then kept for the next batch, so a pool holds as many contexts as it has had
+// batches running at the same time. A context that failed is reset and kept as
+// well; only one that cannot be reset is ended, together with its memory.
+class ZlibPool : public AsyncWrap {
+ public:
+  ZlibPool(Environment* env,
+           Local<Object> wrap,
+           node_zlib_mode mode,
+           int window_bits,
+           int level,
+           int mem_level,
+           int strategy,
+           std::vector<unsigned char>&& dictionary)
+      : AsyncWrap(env, wrap, AsyncWrap::PROVIDER_ZLIB),
+        mode_(mode),
+        window_bits_(window_bits),
+        level_(level),
+        mem_level_(mem_level),
+        strategy_(strategy),
+        dictionary_(std::move(dictionary)) {
+    MakeWeak();
+  }
+
+  ~ZlibPool() override {
+    CHECK_EQ(busy_, 0);
+    Close();
+  }
+
+  // new ZlibPool(mode, windowBits, level, memLevel, strategy, dictionary)
+  static void New(const FunctionCallbackInfo<Value>& args) {
+    Environment* env = Environment::GetCurrent(args);
+    CHECK(args.IsConstructCall());
+    CHECK(args[0]->IsInt32());
+    CHECK(args[1]->IsInt32());
+    CHECK(args[2]->IsInt32());
+    CHECK(args[3]->IsInt32());
+    CHECK(args[4]->IsInt32());
+
+    std::vector<unsigned char> dictionary;
+    if (Buffer::HasInstance(args[5])) {
+      unsigned char* data =
+          reinterpret_cast<unsigned char*>(Buffer::Data(args[5]));
+      dictionary.assign(data, data + Buffer::Length(args[5]));
+    }
+
+    new ZlibPool(env, args.This(),
+                 static_cast<node_zlib_mode>(args[0].As<Int32>()->Value()),
+                 args[1].As<Int32>()->Value(),
+                 args[2].As<Int32>()->Value(),
+                 args[3].As<Int32>()->Value(),
+                 args[4].As<Int32>()->Value(),
+                 std::move(dictionary));
+  }
+
+  // batch(inputs, ends, done), batchSync(inputs, ends, done)
+  // Compresses or decompresses every buffer in `inputs`. `done` is called
+  // with a Buffer that holds all of the results, each of which ends at the
+  // offset stored at its index in `ends`, or with
+  // (undefined, message, errno, code) if one of them failed.
+  template <bool async>
+  static void Batch(const FunctionCallbackInfo<Value>& args) {
+    Environment* env = Environment::GetCurrent(args);
+    CHECK(args[0]->IsArray());
+    CHECK(args[1]->IsUint32Array());
+    CHECK(args[2]->IsFunction());
+
+    ZlibPool* pool;
+    ASSIGN_OR_RETURN_UNWRAP(&pool, args.Holder());
+    CHECK(!pool->closed_);
+
+    Local<Array> inputs = args[0].As<Array>();
+    Local<Uint32Array> ends = args[1].As<Uint32Array>();
+    CHECK_EQ(ends->Length(), inputs->Length());
+
+    std::unique_ptr<BatchJob> job(
+        new BatchJob(pool, inputs, ends, args[2].As<Function>()));
+    job->ends_ = reinterpret_cast<uint32_t*>(
+        static_cast<char*>(ends->Buffer()->GetContents().Data()) +
+        ends->ByteOffset());
+    for (uint32_t i = 0; i < inputs->Length(); i++) {
+      Local<Value> input;
+      if (!inputs->Get(env->context(), i).ToLocal(&input))
+        return;
+      CHECK(input->IsArrayBufferView());
+      job->inputs_.emplace_back(Buffer::Data(input), Buffer::Length(input));
+    }
+
+    pool->Acquire(job.get());
+
+    if (!async) {
+      env->PrintSyncTrace();
+      job->DoThreadPoolWork();
+      job->Finish();
+      return;
+    }
+
+    job.release()->ScheduleWork();
+  }
+
+  static void Close(const FunctionCallbackInfo<Value>& args) {
+    ZlibPool* pool;
+    ASSIGN_OR_RETURN_UNWRAP(&pool, args.Holder());
+    pool->Close();
+  }
+
+  void MemoryInfo(MemoryTracker* tracker) const override {
+    tracker->TrackField("dictionary", dictionary_);
+    tracker->TrackFieldWithSize("arenas", arena_size_);
+  }
+
+  SET_MEMORY_INFO_NAME(ZlibPool)
+  SET_SELF_SIZE(ZlibPool)
+
+ private:
+  // A zlib context and the memory that it allocates.
+  struct PooledContext {
+    ZlibArena arena;
+    ZlibContext context;
+    // Whether Init() succeeded, so that the context can be reset.
+    bool initialized = false;
+    // The size of the arena that is included in arena_size_.
+    size_t accounted_size = 0;
+  };
+
+  // The work of a single batch() call.
+  class BatchJob : public ThreadPoolWork {
+   public:
+    BatchJob(ZlibPool* pool,
+             Local<Array> inputs,
+             Local<Uint32Array> ends,
+             Local<Function> done)
+        : ThreadPoolWork(pool->env(), threadpool::QUEUE_TYPE_ZLIB),
+          pool_(pool),
+          inputs_ref_(pool->env()->isolate(), inputs),
+          ends_ref_(pool->env()->isolate(), ends),
+          done_(pool->env()->isolate(), done) {}
+
+    void DoThreadPoolWork() override {
+      // Initializing the context may have failed already.
+      if (error_.IsError())
+        return;
+      for (size_t i = 0; i < inputs_.size(); i++) {
+        error_ = Process(inputs_[i].first, inputs_[i].second);
+        if (error_.IsError())
+          return;
+        ends_[i] = static_cast<uint32_t>(out_length_);
+      }
+    }
+
+    void AfterThreadPoolWork(int status) override {
+      std::unique_ptr<BatchJob> job(this);
+      if (status == UV_ECANCELED) {
+        pool_->Release(std::move(ctx_));
+        return;
+      }
+      CHECK_EQ(status, 0);
+
+      HandleScope handle_scope(pool_->env()->isolate());
+      Context::Scope context_scope(pool_->env()->context());
+      Finish();
+    }
+
+    // Hands the result to JS and the context back to the pool.
+    void Finish() {
+      Environment* env = pool_->env();
+      OnScopeLeave on_scope_leave([&]() { pool_->Release(std::move(ctx_)); });
+      Local<Function> done = PersistentToLocal::Default(env->isolate(), done_);
+
+      if (error_.IsError()) {
+        Local<Value> argv[] = {
+          Undefined(env->isolate()),
+          OneByteString(env->isolate(), error_.message),
+          Integer::New(env->isolate(), error_.err),
+          OneByteString(env->isolate(), error_.code)
+        };
+        pool_->MakeCallback(done, arraysize(argv), argv);
+        return;
+      }
+
+      Local<Object> output;
+      MaybeLocal<Object> maybe_output = out_length_ == 0 ?
+          Buffer::New(env, 0) :
+          Buffer::New(env, out_.release(), out_length_);
+      if (!maybe_output.ToLocal(&output))
+        return;
+      Local<Value> argv[] = { output };
+      pool_->MakeCallback(done, arraysize(argv), argv);
+    }
+
+   private:
+    CompressionError Process(char* in, size_t in_len) {
+      ZlibContext* ctx = &ctx_->context;
+      CompressionError err = ctx->ResetStream();
+      if (err.IsError())
+        return err;
+
+      uint32_t avail_in = static_cast<uint32_t>(in_len);
+      for (;;) {
+        if (out_length_ == out_.size) {
+          err = Grow();
+          if (err.IsError())
+            return err;
+        }
+
+        const uint32_t avail_out = out_.size - out_length_;
+        uint32_t avail_in_after;
+        uint32_t avail_out_after;
+        ctx->SetBuffers(in, avail_in, out_.data + out_length_, avail_out);
+        ctx->SetFlush(Z_FINISH);
+        ctx->DoThreadPoolWork();
+        ctx->GetAfterWriteOffsets(&avail_in_after, &avail_out_after);
+        in += avail_in - avail_in_after;
+        avail_in = avail_in_after;
+        out_length_ += avail_out - avail_out_after;
+
+        err = ctx->GetErrorInfo();
+        if (err.IsError() || avail_out_after != 0)
+          return err;
+      }
+    }
+
+    // All results go into a single allocation, which starts out as large
+    // as the input and doubles whenever it runs full.
+    CompressionError Grow() {
+      size_t size = out_.size * 2;
+      if (size == 0) {
+        for (const auto& input : inputs_)
+          size += input.second;
+        size = std::max<size_t>(size, 1024);
+      }
+      size = std::min<size_t>(size, Buffer::kMaxLength);
+      if (size <= out_.size) {
+        return CompressionError("Cannot create a Buffer larger than "
+                                "buffer.kMaxLength", "ERR_BUFFER_TOO_LARGE",
+                                Z_BUF_ERROR);
+      }
+
+      char* data = UncheckedRealloc(out_.data, size);
+      if (data == nullptr)
+        return CompressionError("Out of memory", "Z_MEM_ERROR", Z_MEM_ERROR);
+      out_.release();
+      out_ = MallocedBuffer<char>(data, size);
+      return CompressionError {};
+    }
+
+    ZlibPool* pool_;
+    // Keep the memory that the thread pool reads from and writes to alive.
+    Persistent<Array> inputs_ref_;
+    Persistent<Uint32Array> ends_ref_;
+    Persistent<Function> done_;
+    std::unique_ptr<PooledContext> ctx_;
+    std::vector<std::pair<char*, size_t>> inputs_;
+    uint32_t* ends_ = nullptr;
+    MallocedBuffer<char> out_;
+    size_t out_length_ = 0;
+    CompressionError error_;
+
+    friend class ZlibPool;
+  };
+
+  // Gives `job` a context to work with, or sets its error.
+  void Acquire(BatchJob* job) {
+    if (++busy_ == 1)
+      ClearWeak();
+
+    if (!idle_.empty()) {
+      job->ctx_ = std::move(idle_.back());
+      idle_.pop_back();
+      return;
+    }
+
+    std::unique_ptr<PooledContext> ctx(new PooledContext());
+    ctx->context.SetMode(mode_);
+    ctx->context.SetAllocationFunctions(
+        ZlibArena::Alloc, ZlibArena::Free, &ctx->arena);
+    std::vector<unsigned char> dictionary(dictionary_);
+    job->error_ = ctx->context.Init(level_, window_bits_, mem_level_,
+                                    strategy_, std::move(dictionary));
+    ctx->initialized = !job->error_.IsError();
+    job->ctx_ = std::move(ctx);
+  }
+
+  void Release(std::unique_ptr<PooledContext> ctx) {
+    arena_size_ += ctx->arena.size() - ctx->accounted_size;
+    ctx->accounted_size = ctx->arena.size();
+
+    bool reusable = !closed_ && ctx->initialized;
+    if (reusable && ctx->context.GetErrorInfo().IsError())
+      reusable = !ctx->context.ResetStream().IsError();
+
+    if (reusable)
+      idle_.emplace_back(std::move(ctx));
+    else
+      End(std::move(ctx));
+
+    if (--busy_ == 0)
+      MakeWeak();
+    AdjustAmountOfExternalAllocatedMemory();
+  }
+
+  // Ends all idle contexts. The busy ones are ended when they are released.
+  void Close() {
+    closed_ = true;
+    for (auto& ctx : idle_)
+      End(std::move(ctx));
+    idle_.clear();
+    AdjustAmountOfExternalAllocatedMemory();
+  }
+
+  // Ends a context and frees its memory.
+  void End(std::unique_ptr<PooledContext> ctx) {
+    ctx->context.Close();
+    arena_size_ -= ctx->accounted_size;
+  }
+
+  void AdjustAmountOfExternalAllocatedMemory() {
+    const size_t size = arena_size_;
+    if (size == reported_memory_)
+      return;
+    env()->isolate()->AdjustAmountOfExternalAllocatedMemory(
+        static_cast<int64_t>(size) - static_cast<int64_t>(reported_memory_));
+    reported_memory_ = size;
+  }
+
+  const node_zlib_mode mode_;
+  const int window_bits_;
+  const int level_;
+  const int mem_level_;
+  const int strategy_;
+  const std::vector<unsigned char> dictionary_;
+  std::vector<std::unique_ptr<PooledContext>> idle_;
+  size_t busy_ = 0;
+  bool closed_ = false;
+  // The memory of all contexts, as of when they were last released.
+  size_t arena_size_ = 0;
+  size_t reported_memory_ = 0;
 };
 
 
+constexpr size_t ParallelDeflate::kBlockSize;
+
+
+ParallelDeflate::ParallelDeflate(const ZlibContext& ctx,
+                                 const char* in,
+                                 size_t in_len)
+    : mode_(ctx.mode_),
+      level_(ctx.level_),
+      mem_level_(ctx.mem_level_),
+      strategy_(ctx.strategy_),
+      in_(in),
+      in_len_(in_len) {
+  CHECK(mode_ == DEFLATE || mode_ == GZIP || mode_ == DEFLATERAW);
+  CHECK(ctx.dictionary_.empty());
+
+  // Undo the adjustments that ZlibContext::Init() makes for the format, and
+  // that deflateInit2() makes for a window size of 256 bytes.
+  window_bits_ = ctx.window_bits_;
+  if (mode_ == GZIP)
+    window_bits_ -= 16;
+  else if (mode_ == DEFLATERAW)
+    window_bits_ = -window_bits_;
+  window_bits_ = std::max(window_bits_, 9);
+
+  for (size_t offset = 0; offset < in_len_; offset += kBlockSize) {
+    blocks_.emplace_back();
+    blocks_.back().offset = offset;
+    blocks_.back().length = std::min(kBlockSize, in_len_ - offset);
+  }
+}
+
+
+void ParallelDeflate::Run() {
+  z_stream strm;
+  memset(&strm, 0, sizeof(strm));
+  int err = deflateInit2(&strm, level_, Z_DEFLATED, -window_bits_, mem_level_,
+                         strategy_);
+  if (err != Z_OK)
+    return SetError(err, strm.msg);
+
+  while (err_.load() == Z_OK) {
+    const size_t index = next_block_++;
+    if (index >= blocks_.size())
+      break;
+    err = CompressBlock(&strm, index);
+    if (err != Z_OK) {
+      SetError(err, strm.msg);
+      break;
+    }
+  }
+
+  deflateEnd(&strm);
+}
+
+
+int ParallelDeflate::CompressBlock(z_stream* strm, size_t index) {
+  Block* block = &blocks_[index];
+  const bool last = index == blocks_.size() - 1;
+  const Bytef* in = reinterpret_cast<const Bytef*>(in_) + block->offset;
+
+  int err = deflateReset(strm);
+  if (err != Z_OK)
+    return err;
+
+  // Prime the window with the preceding input, so that matches across the
+  // block boundary are found as if the input had not been split up.
+  if (index > 0) {
+    const size_t dictionary_length =
+        std::min(block->offset, size_t{1} << window_bits_);
+    err = deflateSetDictionary(strm, in - dictionary_length,
+                               dictionary_length);
+    if (err != Z_OK)
+      return err;
+  }
+
+  // A sync flush appends an empty stored block, which deflateBound() does
+  // not account for.
+  const size_t out_length = deflateBound(strm, block->length) + 8;
+  char* out = UncheckedMalloc(out_length);
+  if (out == nullptr)
+    return Z_MEM_ERROR;
+  block->out = MallocedBuffer<char>(out, out_length);
+
+  strm->next_in = const_cast<Bytef*>(in);
+  strm->avail_in = block->length;
+  strm->next_out = reinterpret_cast<Bytef*>(out);
+  strm->avail_out = out_length;
+  err = deflate(strm, last ? Z_FINISH : Z_SYNC_FLUSH);
+  if (last ? err != Z_STREAM_END : (err != Z_OK || strm->avail_out == 0))
+    return err == Z_OK || err == Z_STREAM_END ? Z_BUF_ERROR : err;
+  block->out.Truncate(out_length - strm->avail_out);
+
+  if (mode_ == GZIP)
+    block->check = crc32(crc32(0, Z_NULL, 0), in, block->length);
+  else if (mode_ == DEFLATE)
+    block->check = adler32(adler32(0, Z_NULL, 0), in, block->length);
+  return Z_OK;
+}
+
+
+void ParallelDeflate::SetError(int err, const char* message) {
+  int expected = Z_OK;
+  if (err_.compare_exchange_strong(expected, err))
+    message_ = message;
+}
+
+
+CompressionError ParallelDeflate::GetErrorInfo() const {
+  const int err = err_.load();
+  if (err == Z_OK)
+    return CompressionError {};
+  return CompressionError {
+    message_ != nullptr ? message_ : "Zlib error", ZlibStrerror(err), err
+  };
+}
+
+
+size_t ParallelDeflate::HeaderLength() const {
+  return mode_ == GZIP ? 10 : mode_ == DEFLATE ? 2 : 0;
+}
+
+
+size_t ParallelDeflate::TrailerLength() const {
+  return mode_ == GZIP ? 8 : mode_ == DEFLATE ? 4 : 0;
+}
+
+
+size_t ParallelDeflate::OutputLength() const {
+  size_t length = HeaderLength() + TrailerLength();
+  for (const Block& block : blocks_)
+    length += block.out.size;
+  return length;
+}
+
+
+void ParallelDeflate::CopyOutput(char* out) const {
+  unsigned char* p = reinterpret_cast<unsigned char*>(out);
+  const int level = level_ == Z_DEFAULT_COMPRESSION ? 6 : level_;
+
+  // These match the headers that deflate() writes when it is not given a
+  // gzip header or a dictionary.
+  if (mode_ == GZIP) {
+    const unsigned char header[] = {
+      GZIP_HEADER_ID1, GZIP_HEADER_ID2, Z_DEFLATED, 0, 0, 0, 0, 0,
+      static_cast<unsigned char>(
+          level == 9 ? 2 : strategy_ >= Z_HUFFMAN_ONLY || level < 2 ? 4 : 0),
+#if defined(_WIN32)
+      10
+#elif defined(__APPLE__)
+      19
+#else
+      3
+#endif
+    };
+    memcpy(p, header, sizeof(header));
+    p += sizeof(header);
+  } else if (mode_ == DEFLATE) {
+    unsigned int level_flags;
+    if (strategy_ >= Z_HUFFMAN_ONLY || level < 2)
+      level_flags = 0;
+    else if (level < 6)
+      level_flags = 1;
+    else if (level == 6)
+      level_flags = 2;
+    else
+      level_flags = 3;
+    unsigned int header = (Z_DEFLATED + ((window_bits_ - 8) << 4)) << 8;
+    header |= level_flags << 6;
+    header += 31 - (header % 31);
+    *p++ = header >> 8;
+    *p++ = header & 0xff;
+  }
+
+  uLong check = mode_ == GZIP ? crc32(0, Z_NULL, 0) : adler32(0, Z_NULL, 0);
+  for (const Block& block : blocks_) {
+    memcpy(p, block.out.data, block.out.size);
+    p += block.out.size;
+    if (mode_ == GZIP)
+      check = crc32_combine(check, block.check, block.length);
+    else if (mode_ == DEFLATE)
+      check = adler32_combine(check, block.check, block.length);
+  }
+
+  if (mode_ == GZIP) {
+    const uint32_t length = static_cast<uint32_t>(in_len_);
+    for (int i = 0; i < 4; i++)
+      *p++ = (check >> (8 * i)) & 0xff;
+    for (int i = 0; i < 4; i++)
+      *p++ = (length >> (8 * i)) & 0xff;
+  } else if (mode_ == DEFLATE) {
+    for (int i = 3; i >= 0; i--)
+      *p++ = (check >> (8 * i)) & 0xff;
+  }
+
+  CHECK_EQ(reinterpret_cast<char*>(p), out + OutputLength());
+}
+
+
 void ZlibContext::Close() {
   CHECK_LE(mode_, UNZIP);
 
@@ -893,6 +1690,22 @@ void Initialize(Local<Object> target,
   env->SetProtoMethod(z, "init", ZlibStream::Init);
   env->SetProtoMethod(z, "params", ZlibStream::Params);
   env->SetProtoMethod(z, "reset", ZlibStream::Reset);
+  env->SetProtoMethod(z, "parallelWrite", ZlibStream::ParallelWrite<true>);
+  env->SetProtoMethod(z, "parallelWriteSync",
+                      ZlibStream::ParallelWrite<false>);
+
+  Local<FunctionTemplate> pool = env->NewFunctionTemplate(ZlibPool::New);
+  pool->InstanceTemplate()->SetInternalFieldCount(1);
+  pool->Inherit(AsyncWrap::GetConstructorTemplate(env));
+  env->SetProtoMethod(pool, "batch", ZlibPool::Batch<true>);
+  env->SetProtoMethod(pool, "batchSync", ZlibPool::Batch<false>);
+  env->SetProtoMethod(pool, "close", ZlibPool::Close);
+  Local<String> poolString =
+      FIXED_ONE_BYTE_STRING(env->isolate(), "ZlibPool");
+  pool->SetClassName(poolString);
+  target->Set(env->context(),
+              poolString,
+              pool->GetFunction(env->context()).ToLocalChecked()).FromJust();
 
   Local<String> zlibString = FIXED_ONE_BYTE_STRING(env->isolate(), "Zlib");
   z->SetClassName(zlibString);
@@ -903,6 +1716,12 @@ void Initialize(Local<Object> target,
   target->Set(env->context(),
               FIXED_ONE_BYTE_STRING(env->isolate(), "ZLIB_VERSION"),
               FIXED_ONE_BYTE_STRING(env->isolate(), ZLIB_VERSION)).FromJust();
+
+  target->Set(env->context(),
+              FIXED_ONE_BYTE_STRING(env->isolate(), "PARALLEL_BLOCK_SIZE"),
+              Integer::NewFromUnsigned(env->isolate(),
+                                       ParallelDeflate::kBlockSize))
+      .FromJust();
 }
 
 }  // anonymous namespace
@@ -6,6 +6,7 @@
 #include "req_wrap.h"
 #include "async_wrap-inl.h"
 #include "env-inl.h"
+#include "node_threadpool.h"
 #include "util-inl.h"
 #include "uv.h"
 
@@ -51,6 +52,28 @@ void ReqWrap<T>::Cancel() {
     uv_cancel(reinterpret_cast<uv_req_t*>(&req_));
 }
 
+// The work type that perf_hooks.monitorThreadPool() reports requests of type
+// T as. Only requests that libuv may run on its threadpool are reported.
+template <typename T>
+struct ThreadPoolWorkType {
+  static constexpr int value = -1;
+};
+
+template <>
+struct ThreadPoolWorkType<uv_fs_t> {
+  static constexpr int value = threadpool::WORK_TYPE_FS;
+};
+
+template <>
+struct ThreadPoolWorkType<uv_getaddrinfo_t> {
+  static constexpr int value = threadpool::WORK_TYPE_DNS;
+};
+
+template <>
+struct ThreadPoolWorkType<uv_getnameinfo_t> {
+  static constexpr int value = threadpool::WORK_TYPE_DNS;
+};
+
 // Below is dark template magic designed to invoke libuv functions that
 // initialize uv_req_t instances in a unified fashion, to allow easier
 // tracking of active/inactive requests.
@@ -118,6 +141,13 @@ struct MakeLibuvRequestCallback<ReqT, void(*)(ReqT*, Args...)> {
   static void Wrapper(ReqT* req, Args... args) {
     ReqWrap<ReqT>* req_wrap = ContainerOf(&ReqWrap<ReqT>::req_, req);
     req_wrap->env()->DecreaseWaitingRequestCounter();
+    if (req_wrap->dispatched_at_ != 0) {
+      threadpool::RecordWork(
+          req_wrap->env(),
+          static_cast<threadpool::WorkType>(ThreadPoolWorkType<ReqT>::value),
+          req_wrap, req_wrap->dispatched_at_, 0, 0);
+      req_wrap->dispatched_at_ = 0;
+    }
     F original_callback = reinterpret_cast<F>(req_wrap->original_callback_);
     original_callback(req, args...);
   }
@@ -135,6 +165,11 @@ template <typename LibuvFunction, typename... Args>
 int ReqWrap<T>::Dispatch(LibuvFunction fn, Args... args) {
   Dispatched();
 
+  if (ThreadPoolWorkType<T>::value != -1 &&
+      (!env()->threadpool_monitors()->empty() || threadpool::IsTracing())) {
+    dispatched_at_ = uv_hrtime();
+  }
+
   // This expands as:
   //
   // int err = fn(env()->event_loop(), req(), arg1, arg2, Wrapper, arg3, ...)
@@ -156,6 +191,8 @@ int ReqWrap<T>::Dispatch(LibuvFunction fn, Args... args) {
       MakeLibuvRequestCallback<T, Args>::For(this, args)...);
   if (err >= 0)
     env()->IncreaseWaitingRequestCounter();
+  else
+    dispatched_at_ = 0;  // The request never reached the threadpool.
   return err;
 }
 
@@ -40,6 +40,9 @@ class ReqWrap : public AsyncWrap {
 
   typedef void (*callback_t)();
   callback_t original_callback_ = nullptr;
+  // Set while perf_hooks.monitorThreadPool() or tracing is recording
+  // requests of this type.
+  uint64_t dispatched_at_ = 0;
 
  protected:
   // req_wrap_queue_ needs to be at a fixed offset from the start of the class
@@ -31,7 +31,12 @@
 #include "stream_wrap.h"
 #include "util-inl.h"
 
+#include <errno.h>
 #include <stdlib.h>
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <unistd.h>  // close()
+#endif
 
 
 namespace node {
@@ -129,6 +134,7 @@ void TCPWrap::Initialize(Local<Object> target,
   NODE_DEFINE_CONSTANT(constants, SOCKET);
   NODE_DEFINE_CONSTANT(constants, SERVER);
   NODE_DEFINE_CONSTANT(constants, UV_TCP_IPV6ONLY);
+  NODE_DEFINE_CONSTANT(constants, TCP_REUSEPORT);
   target->Set(context,
               env->constants_string(),
               constants).FromJust();
@@ -225,6 +231,42 @@ void TCPWrap::Open(const FunctionCallbackInfo<Value>& args) {
   args.GetReturnValue().Set(err);
 }
 
+// Lets several processes bind and listen on the same address, with the
+// kernel spreading incoming connections evenly across their sockets. That
+// requires SO_REUSEPORT to be set before bind(), so the socket is created
+// here unless the handle already has one. Only enabled on platforms where
+// the kernel actually balances the load; elsewhere, e.g. on macOS, the last
+// socket to bind would get every connection.
+int TCPWrap::SetReusePort(uv_tcp_t* handle, int family) {
+#if defined(SO_REUSEPORT_LB) || \
+    (defined(SO_REUSEPORT) && (defined(__linux__) || defined(__DragonFly__)))
+  uv_os_fd_t fd;
+  if (uv_fileno(reinterpret_cast<uv_handle_t*>(handle), &fd) != 0) {
+    fd = socket(family, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd == -1)
+      return uv_translate_sys_error(errno);
+    int err = uv_tcp_open(handle, fd);
+    if (err != 0) {
+      close(fd);
+      return err;
+    }
+  }
+
+#ifdef SO_REUSEPORT_LB
+  const int option = SO_REUSEPORT_LB;
+#else
+  const int option = SO_REUSEPORT;
+#endif
+  int on = 1;
+  if (setsockopt(fd, SOL_SOCKET, option, &on, sizeof(on)) != 0)
+    return uv_translate_sys_error(errno);
+  return 0;
+#else
+  return UV_ENOTSUP;
+#endif
+}
+
+
 template <typename T>
 void TCPWrap::Bind(
     const FunctionCallbackInfo<Value>& args,
@@ -239,14 +281,22 @@ void TCPWrap::Bind(
   int port;
   unsigned int flags = 0;
   if (!args[1]->Int32Value(env->context()).To(&port)) return;
-  if (family == AF_INET6 &&
+  if (!args[2]->IsUndefined() &&
       !args[2]->Uint32Value(env->context()).To(&flags)) {
     return;
   }
+  // IPv6-only mode has no meaning for IPv4 sockets, ignore it like before.
+  if (family != AF_INET6)
+    flags &= ~UV_TCP_IPV6ONLY;
 
   T addr;
   int err = uv_ip_addr(*ip_address, port, &addr);
 
+  if (err == 0 && (flags & TCP_REUSEPORT)) {
+    flags &= ~TCP_REUSEPORT;
+    err = SetReusePort(&wrap->handle_, family);
+  }
+
   if (err == 0) {
     err = uv_tcp_bind(&wrap->handle_,
                       reinterpret_cast<const sockaddr*>(&addr),
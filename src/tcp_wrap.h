@@ -37,6 +37,12 @@ class TCPWrap : public ConnectionWrap<TCPWrap, uv_tcp_t> {
     SERVER
   };
 
+  // Flags for bind() and bind6() that TCPWrap handles on top of the
+  // uv_tcp_flags. Kept clear of the bits that libuv uses.
+  enum BindFlags {
+    TCP_REUSEPORT = 1 << 16
+  };
+
   static v8::Local<v8::Object> Instantiate(Environment* env,
                                            AsyncWrap* parent,
                                            SocketType type);
@@ -80,6 +86,7 @@ class TCPWrap : public ConnectionWrap<TCPWrap, uv_tcp_t> {
   static void Connect(const v8::FunctionCallbackInfo<v8::Value>& args,
       std::function<int(const char* ip_address, T* addr)> uv_ip_addr);
   static void Open(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static int SetReusePort(uv_tcp_t* handle, int family);
   template <typename T>
   static void Bind(
       const v8::FunctionCallbackInfo<v8::Value>& args,
@@ -0,0 +1,196 @@
+#include "timer_wheel.h"
+#include "util.h"
+
+#include <algorithm>
+
+namespace node {
+
+namespace {
+
+inline unsigned FirstSetBit(uint64_t bits) {
+#if defined(__GNUC__)
+  return __builtin_ctzll(bits);
+#else
+  unsigned index = 0;
+  while ((bits & 1) == 0) {
+    bits >>= 1;
+    index++;
+  }
+  return index;
+#endif
+}
+
+}  // anonymous namespace
+
+constexpr uint32_t TimerWheel::kInvalidId;
+constexpr uint64_t TimerWheel::kNoExpiry;
+
+TimerWheel::TimerWheel() {}
+
+bool TimerWheel::IsArmed(uint32_t id) const {
+  return id < entries_.size() && entries_[id].level != kNotArmed;
+}
+
+void TimerWheel::Insert(uint32_t id, uint64_t expiry) {
+  CHECK_NE(id, kInvalidId);
+  if (id >= entries_.size())
+    entries_.resize(id + 1);
+
+  if (entries_[id].level != kNotArmed)
+    Unlink(id);
+  else
+    size_++;
+
+  Entry& entry = entries_[id];
+  entry.expiry = expiry;
+  entry.sequence = next_sequence_++;
+  Link(id);
+}
+
+void TimerWheel::Remove(uint32_t id) {
+  if (!IsArmed(id))
+    return;
+  Unlink(id);
+  entries_[id].level = kNotArmed;
+  size_--;
+}
+
+void TimerWheel::Link(uint32_t id) {
+  Entry& entry = entries_[id];
+
+  // Timers that are already due go into the current level 0 slot. Timers
+  // that are further out than the wheel can represent are parked as far out
+  // as possible and cascaded back down until they fit.
+  uint64_t when = std::max(entry.expiry, elapsed_);
+  if (when - elapsed_ > kMaxDelay)
+    when = elapsed_ + kMaxDelay;
+
+  // The top level wraps around, so anything that does not fit below it
+  // ends up there even if its expiry has crossed into the next rotation.
+  unsigned level = 0;
+  for (uint64_t diff = (when ^ elapsed_) >> kSlotBits;
+       diff != 0 && level < kLevels - 1;
+       diff >>= kSlotBits) {
+    level++;
+  }
+  const unsigned index = (when >> (kSlotBits * level)) & (kSlotsPerLevel - 1);
+
+  Slot& slot = slots_[level][index];
+  entry.level = level;
+  entry.slot = index;
+  entry.prev = slot.tail;
+  entry.next = kInvalidId;
+  if (slot.tail == kInvalidId)
+    slot.head = id;
+  else
+    entries_[slot.tail].next = id;
+  slot.tail = id;
+  occupied_[level] |= uint64_t{1} << index;
+}
+
+void TimerWheel::Unlink(uint32_t id) {
+  const Entry& entry = entries_[id];
+  Slot& slot = slots_[entry.level][entry.slot];
+  if (entry.prev == kInvalidId)
+    slot.head = entry.next;
+  else
+    entries_[entry.prev].next = entry.next;
+  if (entry.next == kInvalidId)
+    slot.tail = entry.prev;
+  else
+    entries_[entry.next].prev = entry.prev;
+  if (slot.head == kInvalidId)
+    occupied_[entry.level] &= ~(uint64_t{1} << entry.slot);
+}
+
+bool TimerWheel::FindNext(unsigned* level,
+                          unsigned* slot,
+                          uint64_t* when) const {
+  // Every occupied slot on a level lies ahead of all occupied slots on the
+  // levels below it, so the first occupied slot of the lowest occupied level
+  // is always the next one to process.
+  for (unsigned l = 0; l < kLevels; l++) {
+    const unsigned shift = kSlotBits * l;
+    const unsigned current = (elapsed_ >> shift) & (kSlotsPerLevel - 1);
+    const uint64_t level_mask = (uint64_t{1} << (shift + kSlotBits)) - 1;
+    uint64_t base = elapsed_ & ~level_mask;
+    uint64_t bits = occupied_[l] & (~uint64_t{0} << current);
+    if (bits == 0 && l == kLevels - 1) {
+      bits = occupied_[l];
+      base += level_mask + 1;
+    }
+    if (bits == 0)
+      continue;
+    const unsigned index = FirstSetBit(bits);
+    *level = l;
+    *slot = index;
+    *when = std::max(elapsed_, base | (uint64_t{index} << shift));
+    return true;
+  }
+  return false;
+}
+
+uint64_t TimerWheel::NextExpiry() const {
+  if (expired_index_ < expired_.size())
+    return elapsed_;
+  unsigned level, slot;
+  uint64_t when;
+  if (!FindNext(&level, &slot, &when))
+    return kNoExpiry;
+  return when;
+}
+
+void TimerWheel::ExpireSlot(unsigned level, unsigned index) {
+  Slot& slot = slots_[level][index];
+  uint32_t id = slot.head;
+  slot.head = slot.tail = kInvalidId;
+  occupied_[level] &= ~(uint64_t{1} << index);
+
+  const size_t first_expired = expired_.size();
+  while (id != kInvalidId) {
+    Entry& entry = entries_[id];
+    const uint32_t next = entry.next;
+    if (level == 0 && entry.expiry <= elapsed_) {
+      entry.level = kNotArmed;
+      size_--;
+      expired_.push_back(id);
+    } else {
+      Link(id);
+    }
+    id = next;
+  }
+
+  // Cascading can interleave timers that were armed at different times, so
+  // restore the order in which they were armed. Sequence numbers may wrap.
+  auto armed_before = [&](uint32_t a, uint32_t b) {
+    return static_cast<int32_t>(entries_[a].sequence -
+                                entries_[b].sequence) < 0;
+  };
+  auto begin = expired_.begin() + first_expired;
+  if (!std::is_sorted(begin, expired_.end(), armed_before))
+    std::stable_sort(begin, expired_.end(), armed_before);
+}
+
+size_t TimerWheel::Poll(uint64_t now, uint32_t* out, size_t capacity) {
+  size_t count = 0;
+  while (count < capacity) {
+    if (expired_index_ < expired_.size()) {
+      out[count++] = expired_[expired_index_++];
+      continue;
+    }
+    expired_.clear();
+    expired_index_ = 0;
+
+    unsigned level, slot;
+    uint64_t when;
+    if (!FindNext(&level, &slot, &when) || when > now) {
+      elapsed_ = std::max(elapsed_, now);
+      break;
+    }
+    elapsed_ = when;
+    ExpireSlot(level, slot);
+  }
+  return count;
+}
+
+}  // namespace node
@@ -0,0 +1,95 @@
+#ifndef SRC_TIMER_WHEEL_H_
+#define SRC_TIMER_WHEEL_H_
+
+#if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+namespace node {
+
+// A hierarchical timing wheel with millisecond resolution.
+//
+// Timers are identified by small integer ids that are handed out by the
+// JS layer and index directly into `entries_`, so inserting, re-arming and
+// cancelling a timer are O(1) and never allocate once the id has been seen.
+//
+// Each level has kSlotsPerLevel slots. A timer lives on the lowest level at
+// which its expiry shares all higher-order slot bits with `elapsed_`, so the
+// slots of every level are visited in strictly increasing time order. When
+// `elapsed_` reaches an occupied slot above level 0, its timers are cascaded
+// down to the level that now matches them; timers on level 0 have expired.
+class TimerWheel {
+ public:
+  static constexpr uint32_t kInvalidId = 0xffffffff;
+  static constexpr uint64_t kNoExpiry = UINT64_MAX;
+
+  TimerWheel();
+
+  // Arms timer `id` to expire at `expiry` (in milliseconds), moving it if it
+  // is already armed.
+  void Insert(uint32_t id, uint64_t expiry);
+  // Disarms timer `id`. Does nothing if it is not armed.
+  void Remove(uint32_t id);
+  bool IsArmed(uint32_t id) const;
+
+  // Writes up to `capacity` ids of timers that have expired at `now` into
+  // `out` and returns how many were written. Expired timers are disarmed.
+  // Timers that expire in the same millisecond are returned in the order in
+  // which they were armed. Call again until it returns fewer than
+  // `capacity` ids to collect every expired timer.
+  size_t Poll(uint64_t now, uint32_t* out, size_t capacity);
+
+  // Returns the time at which `Poll()` needs to run next, or kNoExpiry if no
+  // timers are armed. This may be earlier than the first actual expiry when
+  // timers only need to be cascaded to a lower level.
+  uint64_t NextExpiry() const;
+
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+ private:
+  static constexpr unsigned kSlotBits = 6;
+  static constexpr unsigned kSlotsPerLevel = 1 << kSlotBits;
+  static constexpr unsigned kLevels = 6;
+  static constexpr uint8_t kNotArmed = 0xff;
+  static constexpr uint64_t kMaxDelay =
+      (uint64_t{kSlotsPerLevel - 1} << (kSlotBits * (kLevels - 1))) - 1;
+
+  struct Entry {
+    uint64_t expiry;
+    uint32_t sequence;
+    uint32_t prev;
+    uint32_t next;
+    uint8_t level = kNotArmed;
+    uint8_t slot;
+  };
+
+  struct Slot {
+    uint32_t head = kInvalidId;
+    uint32_t tail = kInvalidId;
+  };
+
+  bool FindNext(unsigned* level, unsigned* slot, uint64_t* when) const;
+  void Link(uint32_t id);
+  void Unlink(uint32_t id);
+  void ExpireSlot(unsigned level, unsigned slot);
+
+  std::vector<Entry> entries_;
+  Slot slots_[kLevels][kSlotsPerLevel];
+  uint64_t occupied_[kLevels] = {};
+  uint64_t elapsed_ = 0;
+  uint32_t next_sequence_ = 0;
+  size_t size_ = 0;
+
+  // Expired ids that have been taken off level 0 but not yet handed out.
+  std::vector<uint32_t> expired_;
+  size_t expired_index_ = 0;
+};
+
+}  // namespace node
+
+#endif  // defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#endif  // SRC_TIMER_WHEEL_H_
@@ -11,6 +11,7 @@ using v8::Function;
 using v8::FunctionCallbackInfo;
 using v8::Integer;
 using v8::Local;
+using v8::Number;
 using v8::Object;
 using v8::Value;
 
@@ -33,6 +34,19 @@ void ScheduleTimer(const FunctionCallbackInfo<Value>& args) {
   env->ScheduleTimer(args[0]->IntegerValue(env->context()).FromJust());
 }
 
+void FlushTimerOps(const FunctionCallbackInfo<Value>& args) {
+  Environment::GetCurrent(args)->timer_info()->FlushOps();
+}
+
+void PollExpiredTimers(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(args[0]->IsNumber());
+  const double now = args[0].As<Number>()->Value();
+  const size_t count =
+      env->timer_info()->PollExpired(static_cast<uint64_t>(now));
+  args.GetReturnValue().Set(static_cast<uint32_t>(count));
+}
+
 void ToggleTimerRef(const FunctionCallbackInfo<Value>& args) {
   Environment::GetCurrent(args)->ToggleTimerRef(args[0]->IsTrue());
 }
@@ -50,12 +64,23 @@ void Initialize(Local<Object> target,
   env->SetMethod(target, "getLibuvNow", GetLibuvNow);
   env->SetMethod(target, "setupTimers", SetupTimers);
   env->SetMethod(target, "scheduleTimer", ScheduleTimer);
+  env->SetMethod(target, "flushTimerOps", FlushTimerOps);
+  env->SetMethod(target, "pollExpiredTimers", PollExpiredTimers);
   env->SetMethod(target, "toggleTimerRef", ToggleTimerRef);
   env->SetMethod(target, "toggleImmediateRef", ToggleImmediateRef);
 
   target->Set(env->context(),
               FIXED_ONE_BYTE_STRING(env->isolate(), "immediateInfo"),
               env->immediate_info()->fields().GetJSArray()).FromJust();
+  target->Set(env->context(),
+              FIXED_ONE_BYTE_STRING(env->isolate(), "timerInfo"),
+              env->timer_info()->fields().GetJSArray()).FromJust();
+  target->Set(env->context(),
+              FIXED_ONE_BYTE_STRING(env->isolate(), "timerOps"),
+              env->timer_info()->ops().GetJSArray()).FromJust();
+  target->Set(env->context(),
+              FIXED_ONE_BYTE_STRING(env->isolate(), "expiredTimers"),
+              env->timer_info()->expired().GetJSArray()).FromJust();
 }
 
 
@@ -100,6 +100,17 @@ void TLSWrap::NewSessionDoneCb() {
 }
 
 
+void TLSWrap::PrivateKeyOperationDoneCb() {
+  HandleScope handle_scope(env()->isolate());
+  Context::Scope context_scope(env()->context());
+  crypto::ClearErrorOnReturn clear_error_on_return;
+
+  // Resume the handshake, then deliver what it has produced, or its error.
+  AdvanceAsyncHandshake();
+  Cycle();
+}
+
+
 void TLSWrap::InitSSL() {
   // Initialize SSL – OpenSSL takes ownership of these.
   enc_in_ = crypto::NodeBIO::New(env()).release();
@@ -207,31 +218,35 @@ void TLSWrap::SSLInfoCallback(const SSL* ssl_, int where, int ret) {
   // a non-const SSL* in OpenSSL <= 0.9.7e.
   SSL* ssl = const_cast<SSL*>(ssl_);
   TLSWrap* c = static_cast<TLSWrap*>(SSL_get_app_data(ssl));
-  Environment* env = c->env();
-  HandleScope handle_scope(env->isolate());
-  Context::Scope context_scope(env->context());
-  Local<Object> object = c->object();
 
-  if (where & SSL_CB_HANDSHAKE_START) {
-    Local<Value> callback;
+  if (where & SSL_CB_HANDSHAKE_DONE)
+    c->established_ = true;
 
-    if (object->Get(env->context(), env->onhandshakestart_string())
-          .ToLocal(&callback) && callback->IsFunction()) {
-      Local<Value> argv[] = { env->GetNow() };
-      c->MakeCallback(callback.As<Function>(), arraysize(argv), argv);
-    }
-  }
+  c->RunOutsideAsyncJob([c, where]() {
+    Environment* env = c->env();
+    HandleScope handle_scope(env->isolate());
+    Context::Scope context_scope(env->context());
+    Local<Object> object = c->object();
 
-  if (where & SSL_CB_HANDSHAKE_DONE) {
-    Local<Value> callback;
+    if (where & SSL_CB_HANDSHAKE_START) {
+      Local<Value> callback;
 
-    c->established_ = true;
+      if (object->Get(env->context(), env->onhandshakestart_string())
+            .ToLocal(&callback) && callback->IsFunction()) {
+        Local<Value> argv[] = { env->GetNow() };
+        c->MakeCallback(callback.As<Function>(), arraysize(argv), argv);
+      }
+    }
+
+    if (where & SSL_CB_HANDSHAKE_DONE) {
+      Local<Value> callback;
 
-    if (object->Get(env->context(), env->onhandshakedone_string())
-          .ToLocal(&callback) && callback->IsFunction()) {
-      c->MakeCallback(callback.As<Function>(), 0, nullptr);
+      if (object->Get(env->context(), env->onhandshakedone_string())
+            .ToLocal(&callback) && callback->IsFunction()) {
+        c->MakeCallback(callback.As<Function>(), 0, nullptr);
+      }
     }
-  }
+  });
 }
 
 
@@ -383,6 +398,10 @@ void TLSWrap::ClearOut() {
 
   crypto::MarkPopErrorOnReturn mark_pop_error_on_return;
 
+  // Wait for the private key operation of the handshake
+  if (!AdvanceAsyncHandshake())
+    return;
+
   char out[kClearOutChunkSize];
   int read;
   for (;;) {
@@ -450,11 +469,15 @@ bool TLSWrap::ClearIn() {
   if (ssl_ == nullptr)
     return false;
 
+  crypto::MarkPopErrorOnReturn mark_pop_error_on_return;
+
+  // Wait for the private key operation of the handshake
+  if (!pending_cleartext_input_.empty() && !AdvanceAsyncHandshake())
+    return false;
+
   std::vector<uv_buf_t> buffers;
   buffers.swap(pending_cleartext_input_);
 
-  crypto::MarkPopErrorOnReturn mark_pop_error_on_return;
-
   size_t i;
   int written = 0;
   for (i = 0; i < buffers.size(); ++i) {
@@ -599,6 +622,15 @@ int TLSWrap::DoWrite(WriteWrap* w,
 
   crypto::MarkPopErrorOnReturn mark_pop_error_on_return;
 
+  // Wait for the private key operation of the handshake
+  if (!AdvanceAsyncHandshake()) {
+    pending_cleartext_input_.insert(pending_cleartext_input_.end(),
+                                    &bufs[0],
+                                    &bufs[count]);
+    EncOut();
+    return 0;
+  }
+
   int written = 0;
   for (i = 0; i < count; i++) {
     written = SSL_write(ssl_.get(), bufs[i].base, bufs[i].len);
@@ -831,8 +863,12 @@ int TLSWrap::SelectSNIContextCallback(SSL* s, int* ad, void* arg) {
   Local<FunctionTemplate> cons = env->secure_context_constructor_template();
   if (!cons->HasInstance(ctx)) {
     // Failure: incorrect SNI context object
-    Local<Value> err = Exception::TypeError(env->sni_context_err_string());
-    p->MakeCallback(env->onerror_string(), 1, &err);
+    p->RunOutsideAsyncJob([p]() {
+      Environment* env = p->env();
+      HandleScope handle_scope(env->isolate());
+      Local<Value> err = Exception::TypeError(env->sni_context_err_string());
+      p->MakeCallback(env->onerror_string(), 1, &err);
+    });
     return SSL_TLSEXT_ERR_NOACK;
   }
 
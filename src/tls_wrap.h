@@ -76,6 +76,7 @@ class TLSWrap : public AsyncWrap,
   void ClearError() override;
 
   void NewSessionDoneCb();
+  void PrivateKeyOperationDoneCb();
 
   void MemoryInfo(MemoryTracker* tracker) const override;
 
@@ -49,7 +49,9 @@ using v8::platform::tracing::TraceConfig;
 using v8::platform::tracing::TraceWriter;
 using std::string;
 
-Agent::Agent() : tracing_controller_(new TracingController()) {
+Agent::Agent(BufferMode buffer_mode)
+    : buffer_mode_(buffer_mode),
+      tracing_controller_(new TracingController()) {
   tracing_controller_->Initialize(nullptr);
 
   CHECK_EQ(uv_loop_init(&tracing_loop_), 0);
@@ -87,8 +89,9 @@ void Agent::Start() {
   if (started_)
     return;
 
-  NodeTraceBuffer* trace_buffer_ = new NodeTraceBuffer(
-      NodeTraceBuffer::kBufferChunks, this, &tracing_loop_);
+  trace_buffer_ = new NodeTraceBuffer(
+      NodeTraceBuffer::kBufferChunks, this, &tracing_loop_,
+      buffer_mode_ == kRingBuffer);
   tracing_controller_->Initialize(trace_buffer_);
 
   // This thread should be created *after* async handles are created
@@ -145,6 +148,7 @@ void Agent::StopTracing() {
   // to flush the buffer again on destruction of the V8::Platform.
   tracing_controller_->StopTracing();
   tracing_controller_->Initialize(nullptr);
+  trace_buffer_ = nullptr;
   started_ = false;
 
   // Thread should finish when the tracing loop is stopped.
@@ -215,6 +219,17 @@ void Agent::Flush(bool blocking) {
     id_writer.second->Flush(blocking);
 }
 
+void Agent::DumpTraceBuffer() {
+  if (trace_buffer_ == nullptr)
+    return;
+  // A blocking flush waits for the tracing thread, so it would never finish
+  // if this is called on that thread, e.g. because it crashed.
+  uv_thread_t self = uv_thread_self();
+  if (uv_thread_equal(&self, &thread_))
+    return;
+  trace_buffer_->Dump();
+}
+
 void TracingController::AddMetadataEvent(
     const unsigned char* category_group_enabled,
     const char* name,
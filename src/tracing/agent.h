@@ -19,6 +19,7 @@ using v8::platform::tracing::TraceConfig;
 using v8::platform::tracing::TraceObject;
 
 class Agent;
+class NodeTraceBuffer;
 
 class AsyncTraceWriter {
  public:
@@ -77,9 +78,19 @@ class AgentWriterHandle {
 
 class Agent {
  public:
-  Agent();
+  enum BufferMode {
+    // Trace events are written out as soon as a buffer fills up.
+    kStreamingBuffer,
+    // Only the most recent trace events are kept in memory, and they are
+    // only written out by DumpTraceBuffer() (flight recorder mode).
+    kRingBuffer
+  };
+
+  explicit Agent(BufferMode buffer_mode = kStreamingBuffer);
   ~Agent();
 
+  BufferMode buffer_mode() const { return buffer_mode_; }
+
   TracingController* GetTracingController() {
     return tracing_controller_.get();
   }
@@ -109,6 +120,10 @@ class Agent {
   }
   // Flushes all writers registered through AddClient().
   void Flush(bool blocking);
+  // Writes out all buffered trace events and blocks until they have been
+  // written. Does nothing when tracing is not active, or when called from
+  // the tracing thread itself.
+  void DumpTraceBuffer();
 
   TraceConfig* CreateTraceConfig() const;
 
@@ -128,7 +143,10 @@ class Agent {
   uv_thread_t thread_;
   uv_loop_t tracing_loop_;
 
+  const BufferMode buffer_mode_;
   bool started_ = false;
+  // Owned by tracing_controller_ while tracing is started.
+  NodeTraceBuffer* trace_buffer_ = nullptr;
   class ScopedSuspendTracing;
 
   // Each individual Writer has one id.
@@ -13,18 +13,26 @@ InternalTraceBuffer::InternalTraceBuffer(size_t max_chunks, uint32_t id,
 TraceObject* InternalTraceBuffer::AddTraceEvent(uint64_t* handle) {
   Mutex::ScopedLock scoped_lock(mutex_);
   // Create new chunk if last chunk is full or there is no chunk.
-  if (total_chunks_ == 0 || chunks_[total_chunks_ - 1]->IsFull()) {
-    auto& chunk = chunks_[total_chunks_++];
+  if (total_chunks_ == 0 || chunks_[LastChunk()]->IsFull()) {
+    if (total_chunks_ == max_chunks_) {
+      // Drop the oldest chunk to make room. Its events can no longer be
+      // looked up because the chunk's sequence number changes below.
+      first_chunk_ = (first_chunk_ + 1) % max_chunks_;
+      total_chunks_--;
+    }
+    total_chunks_++;
+    auto& chunk = chunks_[LastChunk()];
     if (chunk) {
       chunk->Reset(current_chunk_seq_++);
     } else {
       chunk.reset(new TraceBufferChunk(current_chunk_seq_++));
     }
   }
-  auto& chunk = chunks_[total_chunks_ - 1];
+  const size_t chunk_index = LastChunk();
+  auto& chunk = chunks_[chunk_index];
   size_t event_index;
   TraceObject* trace_object = chunk->AddTraceEvent(&event_index);
-  *handle = MakeHandle(total_chunks_ - 1, chunk->seq(), event_index);
+  *handle = MakeHandle(chunk_index, chunk->seq(), event_index);
   return trace_object;
 }
 
@@ -37,7 +45,7 @@ TraceObject* InternalTraceBuffer::GetEventByHandle(uint64_t handle) {
   size_t chunk_index, event_index;
   uint32_t buffer_id, chunk_seq;
   ExtractHandle(handle, &buffer_id, &chunk_index, &chunk_seq, &event_index);
-  if (buffer_id != id_ || chunk_index >= total_chunks_) {
+  if (buffer_id != id_ || !IsChunkInUse(chunk_index)) {
     // Either the chunk belongs to the other buffer, or is outside the current
     // range of chunks loaded in memory (the latter being true suggests that
     // the chunk has already been flushed and is no longer in memory.)
@@ -57,7 +65,7 @@ void InternalTraceBuffer::Flush(bool blocking) {
     if (total_chunks_ > 0) {
       flushing_ = true;
       for (size_t i = 0; i < total_chunks_; ++i) {
-        auto& chunk = chunks_[i];
+        auto& chunk = chunks_[(first_chunk_ + i) % max_chunks_];
         for (size_t j = 0; j < chunk->size(); ++j) {
           TraceObject* trace_event = chunk->GetEventAt(j);
           // Another thread may have added a trace that is yet to be
@@ -68,6 +76,7 @@ void InternalTraceBuffer::Flush(bool blocking) {
           }
         }
       }
+      first_chunk_ = 0;
       total_chunks_ = 0;
       flushing_ = false;
     }
@@ -93,8 +102,9 @@ void InternalTraceBuffer::ExtractHandle(
 }
 
 NodeTraceBuffer::NodeTraceBuffer(size_t max_chunks,
-    Agent* agent, uv_loop_t* tracing_loop)
+    Agent* agent, uv_loop_t* tracing_loop, bool ring_buffer)
     : tracing_loop_(tracing_loop),
+      ring_buffer_(ring_buffer),
       buffer1_(max_chunks, 0, agent),
       buffer2_(max_chunks, 1, agent) {
   current_buf_.store(&buffer1_);
@@ -118,6 +128,9 @@ NodeTraceBuffer::~NodeTraceBuffer() {
 }
 
 TraceObject* NodeTraceBuffer::AddTraceEvent(uint64_t* handle) {
+  // A ring buffer never needs to be flushed, it overwrites its oldest events.
+  if (ring_buffer_)
+    return buffer1_.AddTraceEvent(handle);
   // If the buffer is full, attempt to perform a flush.
   if (!TryLoadAvailableBuffer()) {
     // Assign a value of zero as the trace event handle.
@@ -134,11 +147,20 @@ TraceObject* NodeTraceBuffer::GetEventByHandle(uint64_t handle) {
 }
 
 bool NodeTraceBuffer::Flush() {
-  buffer1_.Flush(true);
-  buffer2_.Flush(true);
+  // This is called whenever tracing is stopped, which includes changes to the
+  // set of enabled categories. A ring buffer keeps its contents until they are
+  // explicitly dumped.
+  if (!ring_buffer_)
+    Dump();
   return true;
 }
 
+void NodeTraceBuffer::Dump() {
+  buffer1_.Flush(true);
+  if (!ring_buffer_)
+    buffer2_.Flush(true);
+}
+
 // Attempts to set current_buf_ such that it references a buffer that can
 // write at least one trace event. If both buffers are unavailable this
 // method returns false; otherwise it returns true.
@@ -19,13 +19,15 @@ class NodeTraceBuffer;
 
 class InternalTraceBuffer {
  public:
+  // When the buffer is full, AddTraceEvent() overwrites the oldest chunk.
+  // Callers that do not want this have to check IsFull() first.
   InternalTraceBuffer(size_t max_chunks, uint32_t id, Agent* agent);
 
   TraceObject* AddTraceEvent(uint64_t* handle);
   TraceObject* GetEventByHandle(uint64_t handle);
   void Flush(bool blocking);
   bool IsFull() const {
-    return total_chunks_ == max_chunks_ && chunks_[total_chunks_ - 1]->IsFull();
+    return total_chunks_ == max_chunks_ && chunks_[LastChunk()]->IsFull();
   }
   bool IsFlushing() const {
     return flushing_;
@@ -37,12 +39,21 @@ class InternalTraceBuffer {
   void ExtractHandle(uint64_t handle, uint32_t* buffer_id, size_t* chunk_index,
                      uint32_t* chunk_seq, size_t* event_index) const;
   size_t Capacity() const { return max_chunks_ * TraceBufferChunk::kChunkSize; }
+  // Chunks are used as a ring, starting at first_chunk_.
+  size_t LastChunk() const {
+    return (first_chunk_ + total_chunks_ - 1) % max_chunks_;
+  }
+  bool IsChunkInUse(size_t chunk_index) const {
+    return (chunk_index + max_chunks_ - first_chunk_) % max_chunks_ <
+        total_chunks_;
+  }
 
   Mutex mutex_;
   bool flushing_;
   size_t max_chunks_;
   Agent* agent_;
   std::vector<std::unique_ptr<TraceBufferChunk>> chunks_;
+  size_t first_chunk_ = 0;
   size_t total_chunks_ = 0;
   uint32_t current_chunk_seq_ = 1;
   uint32_t id_;
@@ -50,12 +61,18 @@ class InternalTraceBuffer {
 
 class NodeTraceBuffer : public TraceBuffer {
  public:
-  NodeTraceBuffer(size_t max_chunks, Agent* agent, uv_loop_t* tracing_loop);
+  // In ring buffer mode, a single fixed-size buffer keeps the most recent
+  // trace events in memory and only writes them out when Dump() is called.
+  NodeTraceBuffer(size_t max_chunks, Agent* agent, uv_loop_t* tracing_loop,
+                  bool ring_buffer = false);
   ~NodeTraceBuffer();
 
   TraceObject* AddTraceEvent(uint64_t* handle) override;
   TraceObject* GetEventByHandle(uint64_t handle) override;
   bool Flush() override;
+  // Writes out all trace events that are currently buffered and blocks until
+  // they have been written, regardless of the mode of the buffer.
+  void Dump();
 
   static const size_t kBufferChunks = 1024;
 
@@ -65,6 +82,7 @@ class NodeTraceBuffer : public TraceBuffer {
   static void ExitSignalCb(uv_async_t* signal);
 
   uv_loop_t* tracing_loop_;
+  bool ring_buffer_;
   uv_async_t flush_signal_;
   uv_async_t exit_signal_;
   bool exited_ = false;
@@ -16,7 +16,13 @@ using v8::platform::tracing::TraceWriter;
 
 class NodeTraceWriter : public AsyncTraceWriter {
  public:
-  explicit NodeTraceWriter(const std::string& log_file_pattern);
+  enum Format {
+    kJSON,
+    kProtobuf
+  };
+
+  explicit NodeTraceWriter(const std::string& log_file_pattern,
+                           Format format = kJSON);
   ~NodeTraceWriter();
 
   void InitializeOnThread(uv_loop_t* loop) override;
@@ -62,8 +68,9 @@ class NodeTraceWriter : public AsyncTraceWriter {
   int total_traces_ = 0;
   int file_num_ = 0;
   std::string log_file_pattern_;
+  Format format_;
   std::ostringstream stream_;
-  std::unique_ptr<TraceWriter> json_trace_writer_;
+  std::unique_ptr<TraceWriter> trace_writer_;
   bool exited_ = false;
 };
 
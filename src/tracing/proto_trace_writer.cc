@@ -0,0 +1,273 @@
+#include "tracing/proto_trace_writer.h"
+
+#include <string.h>
+
+#include "tracing/trace_event.h"
+
+namespace node {
+namespace tracing {
+
+namespace {
+
+// Field numbers and enum values from the Perfetto trace protos in
+// protos/perfetto/trace/trace_packet.proto and
+// protos/perfetto/trace/track_event/.
+enum Field : uint32_t {
+  kTracePacket = 1,
+
+  kPacketTimestamp = 8,
+  kPacketSequenceId = 10,
+  kPacketTrackEvent = 11,
+  kPacketInternedData = 12,
+  kPacketSequenceFlags = 13,
+
+  kInternedEventCategories = 1,
+  kInternedEventNames = 2,
+  kInternedDebugAnnotationNames = 3,
+  kInternedIid = 1,
+  kInternedName = 2,
+
+  kTrackEventCategoryIids = 3,
+  kTrackEventDebugAnnotations = 4,
+  kTrackEventLegacyEvent = 6,
+  kTrackEventNameIid = 10,
+
+  kLegacyPhase = 2,
+  kLegacyDurationUs = 3,
+  kLegacyThreadDurationUs = 4,
+  kLegacyUnscopedId = 6,
+  kLegacyIdScope = 7,
+  kLegacyBindId = 8,
+  kLegacyLocalId = 10,
+  kLegacyGlobalId = 11,
+  kLegacyBindToEnclosing = 12,
+  kLegacyFlowDirection = 13,
+  kLegacyPidOverride = 18,
+  kLegacyTidOverride = 19,
+
+  kAnnotationNameIid = 1,
+  kAnnotationBoolValue = 2,
+  kAnnotationUintValue = 3,
+  kAnnotationIntValue = 4,
+  kAnnotationDoubleValue = 5,
+  kAnnotationStringValue = 6,
+  kAnnotationPointerValue = 7,
+  kAnnotationLegacyJsonValue = 9
+};
+
+enum SequenceFlags : uint32_t {
+  kIncrementalStateCleared = 1,
+  kNeedsIncrementalState = 2
+};
+
+enum FlowDirection : uint32_t {
+  kFlowIn = 1,
+  kFlowOut = 2,
+  kFlowInOut = 3
+};
+
+enum WireType : uint32_t {
+  kVarint = 0,
+  kFixed64 = 1,
+  kLengthDelimited = 2
+};
+
+inline const char* CategoryGroupName(TraceObject* trace_event) {
+  return v8::platform::tracing::TracingController::GetCategoryGroupName(
+      trace_event->category_enabled_flag());
+}
+
+inline void AppendVarint(std::string* out, uint64_t value) {
+  while (value >= 0x80) {
+    out->push_back(static_cast<char>((value & 0x7f) | 0x80));
+    value >>= 7;
+  }
+  out->push_back(static_cast<char>(value));
+}
+
+inline void AppendTag(std::string* out, uint32_t field, WireType type) {
+  AppendVarint(out, (field << 3) | type);
+}
+
+inline void AppendVarintField(std::string* out,
+                              uint32_t field,
+                              uint64_t value) {
+  AppendTag(out, field, kVarint);
+  AppendVarint(out, value);
+}
+
+inline void AppendBytesField(std::string* out,
+                             uint32_t field,
+                             const char* data,
+                             size_t length) {
+  AppendTag(out, field, kLengthDelimited);
+  AppendVarint(out, length);
+  out->append(data, length);
+}
+
+inline void AppendStringField(std::string* out,
+                              uint32_t field,
+                              const char* str) {
+  AppendBytesField(out, field, str, strlen(str));
+}
+
+inline void AppendMessageField(std::string* out,
+                               uint32_t field,
+                               const std::string& message) {
+  AppendBytesField(out, field, message.data(), message.size());
+}
+
+inline void AppendDoubleField(std::string* out, uint32_t field, double value) {
+  AppendTag(out, field, kFixed64);
+  uint64_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  for (int i = 0; i < 8; i++) {
+    out->push_back(static_cast<char>(bits & 0xff));
+    bits >>= 8;
+  }
+}
+
+}  // anonymous namespace
+
+ProtoTraceWriter::ProtoTraceWriter(std::ostream& stream) : stream_(stream) {}
+
+uint64_t ProtoTraceWriter::Intern(
+    std::unordered_map<std::string, uint64_t>* table,
+    uint32_t interned_data_field,
+    const char* name) {
+  auto it = table->find(name);
+  if (it != table->end())
+    return it->second;
+
+  // Interning ids start at 1, 0 means "not set".
+  const uint64_t iid = table->size() + 1;
+  table->emplace(name, iid);
+
+  std::string entry;
+  AppendVarintField(&entry, kInternedIid, iid);
+  AppendStringField(&entry, kInternedName, name);
+  AppendMessageField(&interned_data_, interned_data_field, entry);
+  return iid;
+}
+
+void ProtoTraceWriter::AppendArg(TraceObject* trace_event, int index) {
+  const TraceObject::ArgValue& value = trace_event->arg_values()[index];
+  annotation_.clear();
+  AppendVarintField(&annotation_, kAnnotationNameIid,
+                    Intern(&arg_names_, kInternedDebugAnnotationNames,
+                           trace_event->arg_names()[index]));
+
+  switch (trace_event->arg_types()[index]) {
+    case TRACE_VALUE_TYPE_BOOL:
+      AppendVarintField(&annotation_, kAnnotationBoolValue, value.as_bool);
+      break;
+    case TRACE_VALUE_TYPE_UINT:
+      AppendVarintField(&annotation_, kAnnotationUintValue, value.as_uint);
+      break;
+    case TRACE_VALUE_TYPE_INT:
+      AppendVarintField(&annotation_, kAnnotationIntValue,
+                        static_cast<uint64_t>(value.as_int));
+      break;
+    case TRACE_VALUE_TYPE_DOUBLE:
+      AppendDoubleField(&annotation_, kAnnotationDoubleValue, value.as_double);
+      break;
+    case TRACE_VALUE_TYPE_POINTER:
+      AppendVarintField(&annotation_, kAnnotationPointerValue,
+                        reinterpret_cast<uintptr_t>(value.as_pointer));
+      break;
+    case TRACE_VALUE_TYPE_STRING:
+    case TRACE_VALUE_TYPE_COPY_STRING:
+      AppendStringField(&annotation_, kAnnotationStringValue,
+                        value.as_string != nullptr ? value.as_string : "NULL");
+      break;
+    case TRACE_VALUE_TYPE_CONVERTABLE:
+      json_.clear();
+      trace_event->arg_convertables()[index]->AppendAsTraceFormat(&json_);
+      AppendMessageField(&annotation_, kAnnotationLegacyJsonValue, json_);
+      break;
+    default:
+      UNREACHABLE();
+  }
+
+  AppendMessageField(&track_event_, kTrackEventDebugAnnotations, annotation_);
+}
+
+void ProtoTraceWriter::AppendTraceEvent(TraceObject* trace_event) {
+  interned_data_.clear();
+  track_event_.clear();
+  legacy_event_.clear();
+
+  const unsigned int flags = trace_event->flags();
+  const char phase = trace_event->phase();
+
+  AppendVarintField(&track_event_, kTrackEventCategoryIids,
+                    Intern(&categories_, kInternedEventCategories,
+                           CategoryGroupName(trace_event)));
+  AppendVarintField(&track_event_, kTrackEventNameIid,
+                    Intern(&event_names_, kInternedEventNames,
+                           trace_event->name()));
+  for (int i = 0; i < trace_event->num_args(); i++)
+    AppendArg(trace_event, i);
+
+  AppendVarintField(&legacy_event_, kLegacyPhase, phase);
+  if (phase == TRACE_EVENT_PHASE_COMPLETE) {
+    AppendVarintField(&legacy_event_, kLegacyDurationUs,
+                      trace_event->duration());
+    if (trace_event->cpu_duration() != 0) {
+      AppendVarintField(&legacy_event_, kLegacyThreadDurationUs,
+                        trace_event->cpu_duration());
+    }
+  }
+  if (flags & TRACE_EVENT_FLAG_HAS_LOCAL_ID) {
+    AppendVarintField(&legacy_event_, kLegacyLocalId, trace_event->id());
+  } else if (flags & TRACE_EVENT_FLAG_HAS_GLOBAL_ID) {
+    AppendVarintField(&legacy_event_, kLegacyGlobalId, trace_event->id());
+  } else if (flags & TRACE_EVENT_FLAG_HAS_ID) {
+    AppendVarintField(&legacy_event_, kLegacyUnscopedId, trace_event->id());
+  }
+  if (flags & (TRACE_EVENT_FLAG_HAS_ID |
+               TRACE_EVENT_FLAG_HAS_LOCAL_ID |
+               TRACE_EVENT_FLAG_HAS_GLOBAL_ID)) {
+    if (trace_event->scope() != nullptr)
+      AppendStringField(&legacy_event_, kLegacyIdScope, trace_event->scope());
+    if (flags & TRACE_EVENT_FLAG_BIND_TO_ENCLOSING)
+      AppendVarintField(&legacy_event_, kLegacyBindToEnclosing, 1);
+  }
+  if (trace_event->bind_id() != 0)
+    AppendVarintField(&legacy_event_, kLegacyBindId, trace_event->bind_id());
+  const unsigned int flow =
+      flags & (TRACE_EVENT_FLAG_FLOW_IN | TRACE_EVENT_FLAG_FLOW_OUT);
+  if (flow != 0) {
+    AppendVarintField(&legacy_event_, kLegacyFlowDirection,
+                      flow == TRACE_EVENT_FLAG_FLOW_IN ? kFlowIn :
+                      flow == TRACE_EVENT_FLAG_FLOW_OUT ? kFlowOut :
+                      kFlowInOut);
+  }
+  AppendVarintField(&legacy_event_, kLegacyPidOverride, trace_event->pid());
+  AppendVarintField(&legacy_event_, kLegacyTidOverride, trace_event->tid());
+  AppendMessageField(&track_event_, kTrackEventLegacyEvent, legacy_event_);
+
+  packet_.clear();
+  AppendVarintField(&packet_, kPacketTimestamp,
+                    static_cast<uint64_t>(trace_event->ts()) * 1000);
+  AppendVarintField(&packet_, kPacketSequenceId, 1);
+  AppendVarintField(&packet_, kPacketSequenceFlags,
+                    first_packet_ ?
+                        kIncrementalStateCleared | kNeedsIncrementalState :
+                        kNeedsIncrementalState);
+  first_packet_ = false;
+  if (!interned_data_.empty())
+    AppendMessageField(&packet_, kPacketInternedData, interned_data_);
+  AppendMessageField(&packet_, kPacketTrackEvent, track_event_);
+
+  std::string header;
+  AppendTag(&header, kTracePacket, kLengthDelimited);
+  AppendVarint(&header, packet_.size());
+  stream_.write(header.data(), header.size());
+  stream_.write(packet_.data(), packet_.size());
+}
+
+void ProtoTraceWriter::Flush() {}
+
+}  // namespace tracing
+}  // namespace node
@@ -0,0 +1,57 @@
+#ifndef SRC_TRACING_PROTO_TRACE_WRITER_H_
+#define SRC_TRACING_PROTO_TRACE_WRITER_H_
+
+#include <ostream>
+#include <string>
+#include <unordered_map>
+
+#include "libplatform/v8-tracing.h"
+
+namespace node {
+namespace tracing {
+
+using v8::platform::tracing::TraceObject;
+using v8::platform::tracing::TraceWriter;
+
+// Serializes trace events into the protobuf based Perfetto trace format,
+// which can be loaded into https://ui.perfetto.dev and the Chrome trace
+// viewer. Every event becomes one TracePacket on a single packet sequence,
+// and category, event and argument names are interned so that each of them
+// is only written once per file.
+//
+// This writes the wire format directly so that no protobuf library is
+// needed. Each instance starts a new sequence with cleared incremental state,
+// so every file produced by a fresh instance can be decoded on its own.
+class ProtoTraceWriter : public TraceWriter {
+ public:
+  explicit ProtoTraceWriter(std::ostream& stream);
+
+  void AppendTraceEvent(TraceObject* trace_event) override;
+  void Flush() override;
+
+ private:
+  uint64_t Intern(std::unordered_map<std::string, uint64_t>* table,
+                  uint32_t interned_data_field,
+                  const char* name);
+  void AppendArg(TraceObject* trace_event, int index);
+
+  std::ostream& stream_;
+  bool first_packet_ = true;
+
+  std::unordered_map<std::string, uint64_t> categories_;
+  std::unordered_map<std::string, uint64_t> event_names_;
+  std::unordered_map<std::string, uint64_t> arg_names_;
+
+  // Scratch buffers that are reused for every event to avoid allocations.
+  std::string packet_;
+  std::string interned_data_;
+  std::string track_event_;
+  std::string legacy_event_;
+  std::string annotation_;
+  std::string json_;
+};
+
+}  // namespace tracing
+}  // namespace node
+
+#endif  // SRC_TRACING_PROTO_TRACE_WRITER_H_
@@ -12,7 +12,14 @@ const runBenchmark = require('../common/benchmark');
 
 runBenchmark('async_hooks',
              [
+               'benchmarker=test-double-http',
+               'connections=50',
+               'hooks=none',
                'method=trackingDisabled',
-               'n=10'
+               'n=10',
+               'storage=native',
+               'type=promise'
              ],
-             {});
+             {
+               NODEJS_BENCHMARK_ZERO_ALLOWED: 1
+             });
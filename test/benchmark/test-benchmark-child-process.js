@@ -11,5 +11,6 @@ runBenchmark('child_process',
                'len=1',
                'params=1',
                'methodName=execSync',
+               'serialization=json',
              ],
              { NODEJS_BENCHMARK_ZERO_ALLOWED: 1 });
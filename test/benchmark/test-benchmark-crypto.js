@@ -15,8 +15,15 @@ runBenchmark('crypto',
                'algo=sha256',
                'api=stream',
                'cipher=',
+               'concurrent=1',
+               'disableEntropyCache=0',
+               'filesize=1024',
+               'impl=seal',
+               'kdf=pbkdf2',
                'keylen=1024',
                'len=1',
+               'method=hash',
+               'mode=async',
                'n=1',
                'out=buffer',
                'type=buf',
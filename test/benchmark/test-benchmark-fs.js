@@ -12,6 +12,9 @@ runBenchmark('fs', [
   'dur=0.1',
   'len=1024',
   'concurrent=1',
+  'backend=threadpool',
+  'background=none',
+  'monitor=off',
   'pathType=relative',
   'statType=fstat',
   'statSyncType=fstatSync',
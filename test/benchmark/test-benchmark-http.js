@@ -26,6 +26,7 @@ runBenchmark('http',
                'key=""',
                'len=1',
                'method=write',
+               'mode=cluster',
                'n=1',
                'res=normal',
                'type=asc',
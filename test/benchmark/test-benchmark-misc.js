@@ -6,6 +6,7 @@ const runBenchmark = require('../common/benchmark');
 
 runBenchmark('misc', [
   'concat=0',
+  'format=json',
   'dur=0.1',
   'method=',
   'n=1',
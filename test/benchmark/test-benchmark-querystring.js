@@ -7,6 +7,8 @@ const runBenchmark = require('../common/benchmark');
 runBenchmark('querystring',
              [ 'n=1',
                'input="there is nothing to unescape here"',
-               'type=noencode'
+               'type=noencode',
+               'pairs=10',
+               'encoding=none'
              ],
              { NODEJS_BENCHMARK_ZERO_ALLOWED: 1 });
@@ -6,6 +6,7 @@ const runBenchmark = require('../common/benchmark');
 
 runBenchmark('timers',
              [
+               'active=1',
                'direction=start',
                'n=1',
                'type=depth',
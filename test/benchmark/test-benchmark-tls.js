@@ -16,9 +16,16 @@ const runBenchmark = require('../common/benchmark');
 
 runBenchmark('tls',
              [
+               'asyncPrivateKey=true',
+               'ca=true',
                'concurrency=1',
                'dur=0.1',
+               'key=rsa',
+               'metric=handshakes',
                'n=1',
+               'resumption=sessionid',
+               'servers=1',
+               'shared=true',
                'size=2',
                'securing=SecurePair',
                'type=asc'
@@ -20,6 +20,8 @@ runBenchmark('url',
                'prop=href',
                'n=1',
                'param=one',
-               'withBase=false'
+               'withBase=false',
+               'hosts=1',
+               'access=none'
              ],
              { NODEJS_BENCHMARK_ZERO_ALLOWED: 1 });
@@ -7,6 +7,9 @@ const runBenchmark = require('../common/benchmark');
 runBenchmark('zlib',
              [
                'method=deflate',
+               'api=batch',
+               'dictionary=true',
+               'parallel=1',
                'n=1',
                'options=true',
                'type=Deflate',
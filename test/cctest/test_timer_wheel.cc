@@ -0,0 +1,99 @@
+#include "timer_wheel.h"
+
+#include <stdint.h>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using node::TimerWheel;
+
+namespace {
+
+std::vector<uint32_t> PollAll(TimerWheel* wheel, uint64_t now) {
+  std::vector<uint32_t> expired;
+  uint32_t ids[2];
+  size_t count;
+  do {
+    count = wheel->Poll(now, ids, 2);
+    expired.insert(expired.end(), ids, ids + count);
+  } while (count == 2);
+  return expired;
+}
+
+}  // anonymous namespace
+
+TEST(TimerWheelTest, Empty) {
+  TimerWheel wheel;
+  EXPECT_TRUE(wheel.empty());
+  EXPECT_EQ(TimerWheel::kNoExpiry, wheel.NextExpiry());
+  EXPECT_TRUE(PollAll(&wheel, 1000).empty());
+}
+
+TEST(TimerWheelTest, ExpiresInOrder) {
+  TimerWheel wheel;
+  wheel.Insert(0, 300);
+  wheel.Insert(1, 5);
+  wheel.Insert(2, 100000);
+  wheel.Insert(3, 5);
+  wheel.Insert(4, 70);
+  EXPECT_EQ(5u, wheel.size());
+  EXPECT_EQ(5u, wheel.NextExpiry());
+
+  EXPECT_TRUE(PollAll(&wheel, 4).empty());
+  EXPECT_EQ(std::vector<uint32_t>({ 1, 3 }), PollAll(&wheel, 5));
+  EXPECT_EQ(std::vector<uint32_t>({ 4, 0 }), PollAll(&wheel, 99999));
+  EXPECT_FALSE(wheel.IsArmed(0));
+  EXPECT_TRUE(wheel.IsArmed(2));
+  EXPECT_EQ(std::vector<uint32_t>({ 2 }), PollAll(&wheel, 100000));
+  EXPECT_TRUE(wheel.empty());
+}
+
+TEST(TimerWheelTest, RearmAndRemove) {
+  TimerWheel wheel;
+  wheel.Insert(0, 10);
+  wheel.Insert(1, 10);
+  wheel.Insert(2, 10);
+  wheel.Insert(0, 20);
+  wheel.Remove(1);
+  wheel.Remove(1);
+  EXPECT_EQ(2u, wheel.size());
+
+  EXPECT_EQ(std::vector<uint32_t>({ 2 }), PollAll(&wheel, 15));
+  EXPECT_EQ(std::vector<uint32_t>({ 0 }), PollAll(&wheel, 20));
+  EXPECT_TRUE(wheel.empty());
+}
+
+TEST(TimerWheelTest, CascadedTimersKeepArmingOrder) {
+  TimerWheel wheel;
+  // Timer 0 starts out on a higher level than timer 1 but expires at the
+  // same time, so it has to be cascaded down behind timer 1.
+  wheel.Insert(0, 4100);
+  EXPECT_TRUE(PollAll(&wheel, 4090).empty());
+  wheel.Insert(1, 4100);
+  EXPECT_EQ(std::vector<uint32_t>({ 0, 1 }), PollAll(&wheel, 5000));
+}
+
+TEST(TimerWheelTest, LateTimersExpireImmediately) {
+  TimerWheel wheel;
+  EXPECT_TRUE(PollAll(&wheel, 1000).empty());
+  wheel.Insert(0, 500);
+  EXPECT_EQ(1000u, wheel.NextExpiry());
+  EXPECT_EQ(std::vector<uint32_t>({ 0 }), PollAll(&wheel, 1000));
+}
+
+TEST(TimerWheelTest, FarFutureTimers) {
+  TimerWheel wheel;
+  const uint64_t start = (uint64_t{1} << 36) - 100;
+  EXPECT_TRUE(PollAll(&wheel, start).empty());
+  // Crosses the range of the top level of the wheel.
+  wheel.Insert(0, start + 200);
+  // Further out than the wheel can represent at all.
+  wheel.Insert(1, start + (uint64_t{1} << 40));
+  EXPECT_LE(wheel.NextExpiry(), start + 200);
+  EXPECT_TRUE(PollAll(&wheel, start + 199).empty());
+  EXPECT_EQ(std::vector<uint32_t>({ 0 }), PollAll(&wheel, start + 200));
+  EXPECT_TRUE(PollAll(&wheel, start + (uint64_t{1} << 40) - 1).empty());
+  EXPECT_EQ(std::vector<uint32_t>({ 1 }),
+            PollAll(&wheel, start + (uint64_t{1} << 40)));
+  EXPECT_TRUE(wheel.empty());
+}
@@ -138,3 +138,54 @@ TEST_F(URLTest, FromFilePath) {
   EXPECT_EQ("/a/%25%25.js", file_url.path());
 #endif
 }
+
+TEST_F(URLTest, FindComponents) {
+  const char* input = "https://example.org:81/a/b/c?query#fragment";
+  int32_t components[node::url::kComponentCount];
+  std::string host;
+  ASSERT_TRUE(URL::FindComponents(input, strlen(input), components, &host));
+
+  EXPECT_EQ(host, "example.org");
+  EXPECT_EQ(components[node::url::kComponentPort], 81);
+  EXPECT_EQ(components[node::url::kComponentSchemeEnd], 6);
+  EXPECT_EQ(components[node::url::kComponentHostStart], 8);
+  EXPECT_EQ(components[node::url::kComponentHostEnd], 19);
+  EXPECT_EQ(components[node::url::kComponentPathStart], 22);
+  EXPECT_EQ(components[node::url::kComponentPathEnd], 28);
+  EXPECT_EQ(components[node::url::kComponentQueryStart], 29);
+  EXPECT_EQ(components[node::url::kComponentQueryEnd], 34);
+  EXPECT_EQ(components[node::url::kComponentFragmentStart], 35);
+
+  input = "http://0x7f.1:80";
+  ASSERT_TRUE(URL::FindComponents(input, strlen(input), components, &host));
+  EXPECT_EQ(host, "127.0.0.1");
+  EXPECT_EQ(components[node::url::kComponentPort], -1);
+  EXPECT_EQ(components[node::url::kComponentPathStart],
+            components[node::url::kComponentPathEnd]);
+}
+
+TEST_F(URLTest, FindComponentsFallback) {
+  // Inputs that the state machine has to parse, which must give the same
+  // results as they would without a fast path.
+#define T(input, expected_host, expected_path, expected_query)               \
+  do {                                                                        \
+    int32_t components[node::url::kComponentCount];                           \
+    std::string found;                                                        \
+    EXPECT_FALSE(URL::FindComponents(input, strlen(input), components,        \
+                                     &found));                                \
+    URL url(input);                                                           \
+    EXPECT_FALSE(url.flags() & URL_FLAGS_FAILED);                             \
+    EXPECT_EQ(url.host(), expected_host);                                     \
+    EXPECT_EQ(url.path(), expected_path);                                     \
+    EXPECT_EQ(url.query(), expected_query);                                   \
+  } while (0)
+  T("HTTP://example.org/", "example.org", "/", "");
+  T(" http://example.org/", "example.org", "/", "");
+  T("http://user@example.org/", "example.org", "/", "");
+  T("http://[::1]/", "[::1]", "/", "");
+  T("http://example.org\\a", "example.org", "/a", "");
+  T("http://example.org/a/./b/../c", "example.org", "/a/c", "");
+  T("http://example.org/%2e/a", "example.org", "/a", "");
+  T("http://example.org/a b?c d", "example.org", "/a%20b", "c%20d");
+#undef T
+}
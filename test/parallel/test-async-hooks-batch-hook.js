@@ -0,0 +1,73 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const fs = require('fs');
+const async_hooks = require('async_hooks');
+
+common.expectsError(() => async_hooks.createBatchHook(42), {
+  code: 'ERR_ASYNC_CALLBACK',
+  type: TypeError
+});
+
+common.expectsError(() => async_hooks.createBatchHook(() => {}, {
+  capacity: 0
+}), {
+  code: 'ERR_OUT_OF_RANGE',
+  type: RangeError
+});
+
+const events = new Map();
+const hook = async_hooks.createBatchHook(common.mustCallAtLeast((batch) => {
+  assert.strictEqual(batch.dropped, 0);
+  for (const event of batch) {
+    if (!events.has(event.asyncId))
+      events.set(event.asyncId, []);
+    events.get(event.asyncId).push(event);
+  }
+}), { capacity: 8 }).enable();
+
+let timeoutId;
+let fsReqId;
+setTimeout(common.mustCall(() => {
+  timeoutId = async_hooks.executionAsyncId();
+}), 1);
+
+fs.stat(__filename, common.mustCall(() => {
+  fsReqId = async_hooks.executionAsyncId();
+}));
+
+// A destroy is delivered after the resource's callbacks, as with other hooks,
+// even when it is emitted from inside of them.
+const resource = new async_hooks.AsyncResource('Batched');
+resource.runInAsyncScope(() => resource.emitDestroy());
+setImmediate(common.mustCall());
+
+// Enough resources to overflow the buffer, so that it is drained
+// synchronously at least once.
+for (let i = 0; i < 20; i++)
+  process.nextTick(() => {});
+
+process.on('exit', () => {
+  hook.disable();
+
+  const timeout = events.get(timeoutId).map((e) => e.type);
+  assert.deepStrictEqual(timeout.slice(0, 3), ['init', 'before', 'after']);
+  assert.strictEqual(events.get(timeoutId)[0].resourceType, 'Timeout');
+  assert.strictEqual(events.get(timeoutId)[0].triggerAsyncId, 1);
+
+  assert.deepStrictEqual(events.get(resource.asyncId()).map((e) => e.type),
+                         ['init', 'before', 'after', 'destroy']);
+
+  const fsReq = events.get(fsReqId);
+  assert.strictEqual(fsReq[0].type, 'init');
+  assert.strictEqual(fsReq[0].resourceType, 'FSREQCALLBACK');
+  assert.strictEqual(fsReq[1].resourceType, undefined);
+  assert.strictEqual(fsReq[1].triggerAsyncId, -1);
+
+  let ticks = 0;
+  for (const list of events.values()) {
+    if (list[0].resourceType === 'TickObject')
+      ticks++;
+  }
+  assert.strictEqual(ticks, 20);
+});
@@ -0,0 +1,44 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const { AsyncLocalStorage } = require('async_hooks');
+
+const storageA = new AsyncLocalStorage();
+const storageB = new AsyncLocalStorage();
+
+storageA.run('a', common.mustCall(() => {
+  storageB.run('b', common.mustCall(() => {
+    assert.strictEqual(storageA.getStore(), 'a');
+    assert.strictEqual(storageB.getStore(), 'b');
+
+    storageA.exit(common.mustCall(() => {
+      assert.strictEqual(storageA.getStore(), undefined);
+      assert.strictEqual(storageB.getStore(), 'b');
+    }));
+
+    setTimeout(common.mustCall(() => {
+      assert.strictEqual(storageA.getStore(), 'a');
+      assert.strictEqual(storageB.getStore(), 'b');
+    }), 1);
+  }));
+
+  assert.strictEqual(storageA.getStore(), 'a');
+  assert.strictEqual(storageB.getStore(), undefined);
+}));
+
+// The store is restored if the callback throws.
+assert.throws(() => {
+  storageA.run('x', () => { throw new Error('boom'); });
+}, /boom/);
+assert.strictEqual(storageA.getStore(), undefined);
+
+// enterWith() keeps the store for the rest of the synchronous execution.
+setImmediate(common.mustCall(() => {
+  storageA.enterWith('entered');
+  assert.strictEqual(storageA.getStore(), 'entered');
+  process.nextTick(common.mustCall(() => {
+    assert.strictEqual(storageA.getStore(), 'entered');
+    storageA.disable();
+    assert.strictEqual(storageA.getStore(), undefined);
+  }));
+}));
@@ -0,0 +1,48 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const fs = require('fs');
+const { AsyncLocalStorage } = require('async_hooks');
+
+// The store must follow every kind of async resource: JS timers and ticks,
+// native AsyncWraps and promise reactions.
+
+const asyncLocalStorage = new AsyncLocalStorage();
+
+assert.strictEqual(asyncLocalStorage.getStore(), undefined);
+
+asyncLocalStorage.run({ id: 1 }, common.mustCall(() => {
+  const store = asyncLocalStorage.getStore();
+  assert.deepStrictEqual(store, { id: 1 });
+
+  setTimeout(common.mustCall(() => {
+    assert.strictEqual(asyncLocalStorage.getStore(), store);
+  }), 1);
+
+  setImmediate(common.mustCall(() => {
+    assert.strictEqual(asyncLocalStorage.getStore(), store);
+  }));
+
+  process.nextTick(common.mustCall(() => {
+    assert.strictEqual(asyncLocalStorage.getStore(), store);
+  }));
+
+  fs.stat(__filename, common.mustCall(() => {
+    assert.strictEqual(asyncLocalStorage.getStore(), store);
+  }));
+
+  Promise.resolve().then(common.mustCall(() => {
+    assert.strictEqual(asyncLocalStorage.getStore(), store);
+  }));
+
+  (async () => {
+    await null;
+    assert.strictEqual(asyncLocalStorage.getStore(), store);
+  })().then(common.mustCall());
+}));
+
+// The store does not leak out of run().
+assert.strictEqual(asyncLocalStorage.getStore(), undefined);
+setImmediate(common.mustCall(() => {
+  assert.strictEqual(asyncLocalStorage.getStore(), undefined);
+}));
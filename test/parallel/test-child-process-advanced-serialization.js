@@ -0,0 +1,70 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const child_process = require('child_process');
+const net = require('net');
+
+if (process.argv[2] !== 'child') {
+  for (const value of [null, 42, 'v8', {}]) {
+    common.expectsError(() => {
+      child_process.spawn(process.execPath, [], { serialization: value });
+    }, {
+      code: 'ERR_INVALID_OPT_VALUE',
+      type: TypeError
+    });
+  }
+
+  const large = Buffer.alloc(1024 * 1024, 'x');
+  const messages = [
+    { foo: 'bar' },
+    42,
+    [1, 2, 3, 4n],
+    new Map([[1, 'a'], ['b', new Set([2])]]),
+    new Date(0),
+    /regexp/gi,
+    Buffer.from('hello'),
+    new Float64Array([1.5, -0]),
+    '',
+    { large }
+  ];
+
+  const child = child_process.fork(__filename, ['child'], {
+    serialization: 'advanced'
+  });
+  const received = [];
+  const onEcho = common.mustCall((message) => {
+    received.push(message);
+    if (received.length < messages.length)
+      return;
+
+    assert.deepStrictEqual(received, messages);
+    child.removeListener('message', onEcho);
+
+    // Handles are passed along with advanced messages as well.
+    const server = net.createServer();
+    server.listen(0, common.mustCall(() => {
+      child.once('message', common.mustCall((message) => {
+        assert.deepStrictEqual(message, { port: server.address().port });
+        server.close();
+        child.disconnect();
+      }));
+      child.send({ cmd: 'server', data: Buffer.from('s') }, server);
+    }));
+  }, messages.length);
+  child.on('message', onEcho);
+
+  for (const message of messages)
+    child.send(message);
+
+  child.on('exit', common.mustCall((code) => assert.strictEqual(code, 0)));
+} else {
+  process.on('message', (message, handle) => {
+    if (handle !== undefined) {
+      assert.deepStrictEqual(message.data, Buffer.from('s'));
+      process.send({ port: handle.address().port });
+      handle.close();
+      return;
+    }
+    process.send(message);
+  });
+}
@@ -0,0 +1,61 @@
+'use strict';
+
+const common = require('../common');
+if (!common.isLinux && !common.isFreeBSD)
+  common.skip('SO_REUSEPORT load balancing is not supported');
+
+const assert = require('assert');
+const cluster = require('cluster');
+const net = require('net');
+const Countdown = require('../common/countdown');
+
+// This test ensures that with the `SCHED_REUSEPORT` schedulingPolicy every
+// worker listens on a socket of its own, all of them bound to the same port,
+// and that connections are accepted without going through the master.
+cluster.schedulingPolicy = cluster.SCHED_REUSEPORT;
+const WORKER_COUNT = 3;
+const CONNECTION_COUNT = 20;
+
+if (cluster.isMaster) {
+  let port;
+
+  const connections = new Countdown(CONNECTION_COUNT, () => {
+    for (const id in cluster.workers)
+      cluster.workers[id].disconnect();
+  });
+
+  const listening = new Countdown(WORKER_COUNT, () => {
+    for (let i = 0; i < CONNECTION_COUNT; i += 1) {
+      net.connect(port, common.mustCall(function() {
+        let data = '';
+        this.setEncoding('utf8');
+        this.on('data', (chunk) => data += chunk);
+        this.on('end', common.mustCall(() => {
+          assert(data in cluster.workers, `unexpected worker id ${data}`);
+          connections.dec();
+        }));
+      }));
+    }
+  });
+
+  for (let i = 0; i < WORKER_COUNT; i += 1) {
+    cluster.fork().on('exit', common.mustCall((statusCode) => {
+      assert.strictEqual(statusCode, 0);
+    })).on('listening', common.mustCall((address) => {
+      if (port === undefined)
+        port = address.port;
+      else
+        assert.strictEqual(address.port, port);
+      listening.dec();
+    }));
+  }
+} else {
+  const server = net.createServer((socket) => {
+    socket.end(`${cluster.worker.id}`);
+  });
+  server.listen(0, common.mustCall(() => {
+    // A real TCP handle, not the faux handle used for round-robin.
+    assert.strictEqual(server._handle.constructor.name, 'TCP');
+    assert.notStrictEqual(server.address().port, 0);
+  }));
+}
@@ -0,0 +1,107 @@
+'use strict';
+
+// Tests the CPU profiles written by --cpu-prof and v8.captureCpuProfile().
+
+const common = require('../common');
+const assert = require('assert');
+const fs = require('fs');
+const path = require('path');
+const { spawnSync } = require('child_process');
+const v8 = require('v8');
+
+const tmpdir = require('../common/tmpdir');
+
+const fib = 'function fib(n) { return n < 2 ? n : fib(n - 1) + fib(n - 2); }';
+
+function verifyProfile(file) {
+  const profile = JSON.parse(fs.readFileSync(file, 'utf8'));
+  assert(Array.isArray(profile.nodes));
+  assert(profile.nodes.length > 0);
+  const ids = new Set(profile.nodes.map((node) => node.id));
+  assert.strictEqual(profile.nodes[0].callFrame.functionName, '(root)');
+  for (const node of profile.nodes) {
+    assert.strictEqual(typeof node.callFrame.scriptId, 'string');
+    assert.strictEqual(typeof node.hitCount, 'number');
+    for (const child of node.children || [])
+      assert(ids.has(child));
+  }
+  assert(profile.startTime <= profile.endTime);
+  assert.strictEqual(profile.samples.length, profile.timeDeltas.length);
+  for (const sample of profile.samples)
+    assert(ids.has(sample));
+  return profile;
+}
+
+function getProfiles(dir) {
+  return fs.readdirSync(dir)
+    .filter((file) => file.endsWith('.cpuprofile'))
+    .map((file) => path.join(dir, file));
+}
+
+function run(args, code) {
+  const output = spawnSync(process.execPath, [...args, '-e', code], {
+    cwd: tmpdir.path
+  });
+  assert.strictEqual(output.status, 0, output.stderr.toString());
+}
+
+// The profile is written when the process exits normally.
+{
+  tmpdir.refresh();
+  run(['--cpu-prof', '--cpu-prof-interval', '100'], `${fib} fib(25);`);
+  const profiles = getProfiles(tmpdir.path);
+  assert.strictEqual(profiles.length, 1);
+  const profile = verifyProfile(profiles[0]);
+  assert(profile.nodes.some((node) => node.callFrame.functionName === 'fib'));
+}
+
+// The profile is written when process.exit() is called.
+{
+  tmpdir.refresh();
+  const dir = path.join(tmpdir.path, 'prof');
+  run(['--cpu-prof', '--cpu-prof-dir', dir, '--cpu-prof-name', 'exit.prof'],
+      `${fib} fib(20); process.exit(0);`);
+  verifyProfile(path.join(dir, 'exit.prof'));
+}
+
+// Every Worker thread writes its own profile.
+{
+  tmpdir.refresh();
+  run(['--cpu-prof', '--experimental-worker', '--cpu-prof-dir', tmpdir.path],
+      `const { Worker } = require('worker_threads');
+       new Worker('${fib} fib(20)', { eval: true });`);
+  const profiles = getProfiles(tmpdir.path);
+  assert.strictEqual(profiles.length, 2);
+  profiles.forEach(verifyProfile);
+}
+
+// The --cpu-prof-* options require --cpu-prof.
+for (const option of ['--cpu-prof-dir', '--cpu-prof-name',
+                      '--cpu-prof-signal']) {
+  const output = spawnSync(process.execPath, [option, 'x', '-e', '0']);
+  assert.strictEqual(output.status, 9);
+  assert(output.stderr.toString().includes(`${option} must be used with ` +
+                                           '--cpu-prof'));
+}
+
+// v8.captureCpuProfile() writes the profile off the main thread.
+{
+  tmpdir.refresh();
+  const filename = path.join(tmpdir.path, 'capture.cpuprofile');
+  v8.captureCpuProfile({ duration: 50, interval: 100, filename },
+                       common.mustCall((err, file) => {
+                         assert.ifError(err);
+                         assert.strictEqual(file, filename);
+                         verifyProfile(file);
+                       }));
+
+  [{}, { duration: 0 }, { duration: 10, interval: 0 },
+   { duration: 10, filename: 1 }].forEach((options) => {
+    common.expectsError(() => v8.captureCpuProfile(options, () => {}), {
+      code: /^ERR_(INVALID_ARG_TYPE|OUT_OF_RANGE)$/
+    });
+  });
+  common.expectsError(() => v8.captureCpuProfile({ duration: 10 }), {
+    code: 'ERR_INVALID_CALLBACK'
+  });
+}
@@ -0,0 +1,134 @@
+'use strict';
+const common = require('../common');
+if (!common.hasCrypto)
+  common.skip('missing crypto');
+
+// This test ensures that crypto.aeadSeal() and crypto.aeadOpen() are
+// compatible with Cipheriv and Decipheriv objects, also when they write to a
+// caller-provided buffer or in place, and that they reject data that cannot
+// be authenticated.
+
+const assert = require('assert');
+const crypto = require('crypto');
+
+const ciphers = [
+  ['aes-128-gcm', 16, 12, 16],
+  ['aes-256-gcm', 32, 16, 12],
+  ['aes-192-ccm', 24, 12, 8],
+  ['aes-128-ocb', 16, 12, 16],
+  ['chacha20-poly1305', 32, 12, 16]
+].filter(([algorithm]) => crypto.getCiphers().includes(algorithm));
+
+for (const [algorithm, keyLength, ivLength, authTagLength] of ciphers) {
+  const key = crypto.randomBytes(keyLength);
+  const iv = crypto.randomBytes(ivLength);
+  const options = { authTagLength };
+
+  for (const length of [0, 1, 100]) {
+    const plaintext = crypto.randomBytes(length);
+    const aad = crypto.randomBytes(8);
+
+    const cipher = crypto.createCipheriv(algorithm, key, iv, options);
+    cipher.setAAD(aad, { plaintextLength: length });
+    const expected = Buffer.concat([cipher.update(plaintext), cipher.final(),
+                                    cipher.getAuthTag()]);
+
+    const sealed = crypto.aeadSeal(algorithm, key, iv, plaintext,
+                                   { aad, authTagLength });
+    assert.deepStrictEqual(sealed, expected);
+    assert.deepStrictEqual(
+      crypto.aeadOpen(algorithm, key, iv, sealed, { aad, authTagLength }),
+      plaintext);
+
+    const decipher = crypto.createDecipheriv(algorithm, key, iv, options);
+    decipher.setAuthTag(sealed.slice(length));
+    decipher.setAAD(aad, { plaintextLength: length });
+    assert.deepStrictEqual(
+      Buffer.concat([decipher.update(sealed.slice(0, length)),
+                     decipher.final()]),
+      plaintext);
+
+    // Tampering with the ciphertext, the tag or the AAD is detected, and no
+    // plaintext is left behind.
+    const tampered = [
+      [Buffer.from(sealed), aad],
+      [Buffer.from(sealed), Buffer.from('other')]
+    ];
+    tampered[0][0][sealed.length - 1] ^= 1;
+    for (const [data, otherAad] of tampered) {
+      const output = Buffer.alloc(length, 0x2a);
+      assert.throws(() => {
+        crypto.aeadOpen(algorithm, key, iv, data,
+                        { aad: otherAad, authTagLength, output });
+      }, /Unsupported state or unable to authenticate data/);
+      assert.deepStrictEqual(output, Buffer.alloc(length));
+    }
+
+    // In place, at an offset.
+    const buffer = Buffer.alloc(length + authTagLength + 8);
+    plaintext.copy(buffer, 5);
+    const inPlace = crypto.aeadSeal(
+      algorithm, key, iv, buffer.slice(5, 5 + length),
+      { aad, authTagLength, output: buffer, outputOffset: 5 });
+    assert.strictEqual(inPlace.buffer, buffer.buffer);
+    assert.deepStrictEqual(inPlace, expected);
+    const opened = crypto.aeadOpen(
+      algorithm, key, iv, new Uint8Array(buffer.buffer, 5, sealed.length),
+      { aad, authTagLength, output: buffer, outputOffset: 5 });
+    assert.strictEqual(opened.buffer, buffer.buffer);
+    assert.deepStrictEqual(opened, plaintext);
+  }
+}
+
+{
+  const key = Buffer.alloc(16);
+  const iv = Buffer.alloc(12);
+  const plaintext = Buffer.alloc(32);
+
+  common.expectsError(() => {
+    crypto.aeadSeal('aes-128-cbc', key, Buffer.alloc(16), plaintext);
+  }, {
+    type: Error,
+    message: 'aes-128-cbc is not an authenticated cipher'
+  });
+
+  common.expectsError(() => {
+    crypto.aeadSeal('aes-128-gcm', key, iv, plaintext, { authTagLength: 7 });
+  }, {
+    type: Error,
+    message: 'Invalid authentication tag length: 7'
+  });
+
+  common.expectsError(() => {
+    crypto.aeadSeal('aes-128-gcm', key, iv, 'plaintext');
+  }, {
+    code: 'ERR_INVALID_ARG_TYPE',
+    type: TypeError,
+    message: /The "plaintext" argument must be one of type Buffer/
+  });
+
+  common.expectsError(() => {
+    crypto.aeadOpen('aes-128-gcm', key, iv, Buffer.alloc(15));
+  }, {
+    code: 'ERR_INVALID_ARG_VALUE',
+    type: TypeError,
+    message: /The argument 'sealed' must contain the authentication tag/
+  });
+
+  common.expectsError(() => {
+    crypto.aeadSeal('aes-128-gcm', key, iv, plaintext,
+                    { output: Buffer.alloc(48), outputOffset: 1 });
+  }, {
+    code: 'ERR_BUFFER_OUT_OF_BOUNDS',
+    type: RangeError,
+    message: '"options.output" is outside of buffer bounds'
+  });
+
+  common.expectsError(() => {
+    crypto.aeadSeal('aes-128-gcm', key, iv, plaintext, { aad: 'aad' });
+  }, {
+    code: 'ERR_INVALID_ARG_TYPE',
+    type: TypeError,
+    message: /The "options\.aad" property must be one of type Buffer/
+  });
+}
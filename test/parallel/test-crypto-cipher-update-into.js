@@ -0,0 +1,118 @@
+'use strict';
+const common = require('../common');
+if (!common.hasCrypto)
+  common.skip('missing crypto');
+
+// This test ensures that cipher.updateInto() and decipher.updateInto() produce
+// the same output as update(), also in place, and that cipher streams, which
+// use it for Buffer chunks, still produce the right output.
+
+const assert = require('assert');
+const crypto = require('crypto');
+
+const key = crypto.randomBytes(32);
+const iv = crypto.randomBytes(16);
+const plaintext = crypto.randomBytes(1000);
+
+function updateAll(cipher, data) {
+  return Buffer.concat([cipher.update(data.slice(0, 100)),
+                        cipher.update(data.slice(100)),
+                        cipher.final()]);
+}
+
+for (const algorithm of ['aes-256-cbc', 'aes-256-ctr', 'aes-256-gcm']) {
+  const expected = updateAll(crypto.createCipheriv(algorithm, key, iv),
+                             plaintext);
+
+  const cipher = crypto.createCipheriv(algorithm, key, iv);
+  const output = Buffer.alloc(plaintext.length + 64);
+  let written = cipher.updateInto(plaintext.slice(0, 100), output, 3);
+  written += cipher.updateInto(plaintext.slice(100), output, 3 + written);
+  const final = cipher.final();
+  assert.deepStrictEqual(
+    Buffer.concat([output.slice(3, 3 + written), final]), expected);
+
+  const decipher = crypto.createDecipheriv(algorithm, key, iv);
+  if (algorithm === 'aes-256-gcm')
+    decipher.setAuthTag(cipher.getAuthTag());
+  const decrypted = new Uint8Array(expected.length + 16);
+  written = decipher.updateInto(expected, decrypted);
+  written += decipher.final().copy(decrypted, written);
+  assert.deepStrictEqual(Buffer.from(decrypted.buffer, 0, written), plaintext);
+}
+
+// Ciphers with a block size of 1 work in place.
+{
+  const data = Buffer.from(plaintext);
+  const cipher = crypto.createCipheriv('aes-256-gcm', key, iv);
+  assert.strictEqual(cipher.updateInto(data, data), data.length);
+  cipher.final();
+  assert.deepStrictEqual(data, updateAll(
+    crypto.createCipheriv('aes-256-gcm', key, iv), plaintext));
+
+  const decipher = crypto.createDecipheriv('aes-256-gcm', key, iv);
+  decipher.setAuthTag(cipher.getAuthTag());
+  assert.strictEqual(decipher.updateInto(data, data), data.length);
+  decipher.final();
+  assert.deepStrictEqual(data, plaintext);
+}
+
+// An output that is too small is rejected without updating the cipher.
+{
+  const cipher = crypto.createCipheriv('aes-256-cbc', key, iv);
+  const output = Buffer.alloc(plaintext.length + 16);
+  common.expectsError(() => cipher.updateInto(plaintext, output, 1), {
+    code: 'ERR_BUFFER_OUT_OF_BOUNDS',
+    type: RangeError,
+    message: '"output" is outside of buffer bounds'
+  });
+  const written = cipher.updateInto(plaintext, output);
+  assert.deepStrictEqual(
+    Buffer.concat([output.slice(0, written), cipher.final()]),
+    updateAll(crypto.createCipheriv('aes-256-cbc', key, iv), plaintext));
+}
+
+{
+  const cipher = crypto.createCipheriv('aes-256-ctr', key, iv);
+  for (const data of ['data', null, []]) {
+    common.expectsError(() => cipher.updateInto(data, Buffer.alloc(16)), {
+      code: 'ERR_INVALID_ARG_TYPE',
+      type: TypeError,
+      message: /The "data" argument must be one of type Buffer/
+    });
+    common.expectsError(() => cipher.updateInto(Buffer.alloc(16), data), {
+      code: 'ERR_INVALID_ARG_TYPE',
+      type: TypeError,
+      message: /The "output" argument must be one of type Buffer/
+    });
+  }
+  const output = Buffer.alloc(16);
+  common.expectsError(() => cipher.updateInto(plaintext, output, -1), {
+    code: 'ERR_OUT_OF_RANGE',
+    type: RangeError
+  });
+  common.expectsError(() => cipher.updateInto(plaintext, output, 17), {
+    code: 'ERR_BUFFER_OUT_OF_BOUNDS',
+    type: RangeError,
+    message: '"offset" is outside of buffer bounds'
+  });
+}
+
+// A stream does not hand out the same memory twice.
+{
+  const cipher = crypto.createCipheriv('aes-256-cbc', key, iv);
+  const decipher = crypto.createDecipheriv('aes-256-cbc', key, iv);
+  const chunks = [];
+  decipher.on('data', (chunk) => chunks.push(chunk));
+  decipher.on('end', common.mustCall(() => {
+    const expected = [];
+    for (let i = 0; i < 200; i++)
+      expected.push(plaintext.slice(0, i * 7));
+    expected.push(Buffer.from('a string'));
+    assert.deepStrictEqual(Buffer.concat(chunks), Buffer.concat(expected));
+  }));
+  cipher.pipe(decipher);
+  for (let i = 0; i < 200; i++)
+    cipher.write(plaintext.slice(0, i * 7));
+  cipher.end('a string', 'utf8');
+}
@@ -0,0 +1,129 @@
+'use strict';
+const common = require('../common');
+if (!common.hasCrypto)
+  common.skip('missing crypto');
+
+const assert = require('assert');
+const crypto = require('crypto');
+const { pathToFileURL } = require('url');
+
+const fixtures = require('../common/fixtures');
+
+// This test ensures that crypto.hash() and crypto.hashFile() compute the same
+// digests as a Hash object.
+
+function digest(algorithm, data, outputEncoding) {
+  return crypto.createHash(algorithm).update(data).digest(outputEncoding);
+}
+
+const small = 'Test123ü';
+// Large enough to be hashed on the threadpool by the asynchronous form.
+const large = Buffer.alloc(256 * 1024, 'b');
+
+for (const algorithm of ['md5', 'sha1', 'sha256', 'sha512', 'RSA-SHA256']) {
+  for (const data of [small, Buffer.from(small), new Uint16Array(4),
+                      new DataView(new ArrayBuffer(4)), large, '']) {
+    assert.deepStrictEqual(crypto.hash(algorithm, data),
+                           digest(algorithm, data));
+    assert.strictEqual(crypto.hash(algorithm, data, 'hex'),
+                       digest(algorithm, data, 'hex'));
+
+    crypto.hash(algorithm, data, common.mustCall((err, result) => {
+      assert.ifError(err);
+      assert.deepStrictEqual(result, digest(algorithm, data));
+    }));
+    crypto.hash(algorithm, data, 'base64', common.mustCall((err, result) => {
+      assert.ifError(err);
+      assert.strictEqual(result, digest(algorithm, data, 'base64'));
+    }));
+  }
+}
+
+// The async form calls back asynchronously for small inputs as well.
+{
+  let sync = true;
+  crypto.hash('sha256', small, common.mustCall(() => {
+    assert.strictEqual(sync, false);
+  }));
+  sync = false;
+}
+
+{
+  const file = fixtures.path('person.jpg');
+  const expected = digest('sha256', fixtures.readSync('person.jpg'), 'hex');
+  crypto.hashFile('sha256', file, 'hex', common.mustCall((err, result) => {
+    assert.ifError(err);
+    assert.strictEqual(result, expected);
+  }));
+  crypto.hashFile('sha256', pathToFileURL(file),
+                  common.mustCall((err, result) => {
+                    assert.ifError(err);
+                    assert.strictEqual(result.toString('hex'), expected);
+                  }));
+  crypto.hashFile('sha256', Buffer.from(file), 'hex',
+                  common.mustCall((err, result) => {
+                    assert.ifError(err);
+                    assert.strictEqual(result, expected);
+                  }));
+
+  const missing = fixtures.path('does-not-exist');
+  crypto.hashFile('sha256', missing, common.mustCall((err, result) => {
+    assert.strictEqual(err.code, 'ENOENT');
+    assert.strictEqual(err.syscall, 'open');
+    assert.strictEqual(err.path, missing);
+    assert.strictEqual(result, undefined);
+  }));
+
+  crypto.hashFile('sha256', fixtures.fixturesDir,
+                  common.mustCall((err, result) => {
+                    assert.strictEqual(err.code, 'EISDIR');
+                    assert.strictEqual(result, undefined);
+                  }));
+}
+
+// An unsupported algorithm is thrown by the synchronous form and passed to the
+// callback by the asynchronous ones.
+assert.throws(() => crypto.hash('xyzzy', small), /Digest method not supported/);
+for (const fn of [crypto.hash.bind(null, 'xyzzy', small),
+                  crypto.hash.bind(null, 'xyzzy', large),
+                  crypto.hashFile.bind(null, 'xyzzy', __filename)]) {
+  let sync = true;
+  fn(common.mustCall((err, result) => {
+    assert.strictEqual(sync, false);
+    assert(/Digest method not supported/.test(err.message), err.message);
+    assert.strictEqual(result, undefined);
+  }));
+  sync = false;
+}
+
+for (const fn of [crypto.hash, crypto.hashFile]) {
+  common.expectsError(() => fn(1, small, common.mustNotCall()), {
+    code: 'ERR_INVALID_ARG_TYPE',
+    type: TypeError
+  });
+  common.expectsError(() => fn('sha256', small, 'ucs2', common.mustNotCall()), {
+    code: 'ERR_CRYPTO_HASH_DIGEST_NO_UTF16',
+    type: Error
+  });
+  common.expectsError(() => fn('sha256', small, 'hex', 'not a function'), {
+    code: 'ERR_INVALID_CALLBACK',
+    type: TypeError
+  });
+}
+
+common.expectsError(() => crypto.hash('sha256', 42), {
+  code: 'ERR_INVALID_ARG_TYPE',
+  type: TypeError,
+  message: 'The "data" argument must be one of type string, TypedArray, or ' +
+           'DataView. Received type number'
+});
+
+common.expectsError(() => crypto.hashFile('sha256', 42, common.mustNotCall()), {
+  code: 'ERR_INVALID_ARG_TYPE',
+  type: TypeError
+});
+
+common.expectsError(() => crypto.hashFile('sha256', __filename), {
+  code: 'ERR_INVALID_CALLBACK',
+  type: TypeError
+});
@@ -0,0 +1,151 @@
+// Flags: --threadpool-queue=kdf:4
+'use strict';
+const common = require('../common');
+if (!common.hasCrypto)
+  common.skip('missing crypto');
+
+// This test ensures that crypto.pbkdf2Batch() and crypto.scryptBatch() derive
+// the same keys as one derivation at a time, whether the lanes of scrypt run
+// on separate threads or not, and that they run on the dedicated kdf queue.
+
+const assert = require('assert');
+const crypto = require('crypto');
+const { getThreadPoolStatistics } = require('perf_hooks');
+
+function getQueue(name) {
+  return getThreadPoolStatistics().find((queue) => queue.name === name);
+}
+
+{
+  const queue = getQueue('kdf');
+  assert.strictEqual(queue.dedicated, true);
+  assert.strictEqual(queue.threads, 4);
+}
+
+function makeItems(count) {
+  const items = [];
+  for (let i = 0; i < count; i++) {
+    items.push({
+      password: i % 2 ? `password${i}` : Buffer.from(`password${i}`),
+      salt: i % 3 ? crypto.randomBytes(16) : `salt${i}`
+    });
+  }
+  // Empty passwords and salts are valid.
+  items.push({ password: '', salt: '' });
+  return items;
+}
+
+{
+  const items = makeItems(10);
+  crypto.pbkdf2Batch(items, 1000, 32, 'sha256', common.mustCall((err, keys) => {
+    assert.ifError(err);
+    assert.strictEqual(keys.length, items.length);
+    items.forEach(({ password, salt }, i) => {
+      assert.deepStrictEqual(
+        keys[i], crypto.pbkdf2Sync(password, salt, 1000, 32, 'sha256'));
+    });
+  }));
+}
+
+// With fewer items than threads, the lanes of each derivation are spread over
+// the threads; with more, every derivation runs on a single thread. The lanes
+// that run at once, each with its own scratch space, must fit into maxmem
+// together, otherwise they are not spread or run on fewer threads.
+const laneSize = 128 * 8 * (1024 + 2);
+const blocksSize = 128 * 8 * 4 * 2;
+for (const [count, options] of [
+  [0, { N: 1024, p: 3 }],
+  [2, { N: 1024, p: 3 }],
+  [9, { N: 1024, p: 2 }],
+  [6, { cost: 512, blockSize: 4 }],
+  [1, { N: 1024, p: 4, maxmem: blocksSize + laneSize }],
+  [1, { N: 1024, p: 4, maxmem: blocksSize + 2 * laneSize }]
+]) {
+  const items = makeItems(count);
+  crypto.scryptBatch(items, 64, options, common.mustCall((err, keys) => {
+    assert.ifError(err);
+    assert.strictEqual(keys.length, items.length);
+    items.forEach(({ password, salt }, i) => {
+      assert.deepStrictEqual(keys[i],
+                             crypto.scryptSync(password, salt, 64, options));
+    });
+  }));
+}
+
+crypto.scryptBatch(makeItems(1), 16, common.mustCall((err, keys) => {
+  assert.ifError(err);
+  assert.strictEqual(keys.length, 2);
+  assert.deepStrictEqual(keys[1], crypto.scryptSync('', '', 16));
+}));
+
+for (const fn of [crypto.pbkdf2Batch.bind(null, [], 1, 1, 'sha256'),
+                  crypto.scryptBatch.bind(null, [], 1)]) {
+  let called = false;
+  fn(common.mustCall((err, keys) => {
+    assert.ifError(err);
+    assert.deepStrictEqual(keys, []);
+    called = true;
+  }));
+  assert.strictEqual(called, false);
+}
+
+for (const items of [undefined, 'items', { length: 1 }]) {
+  common.expectsError(() => {
+    crypto.pbkdf2Batch(items, 1, 1, 'sha256', common.mustNotCall());
+  }, {
+    code: 'ERR_INVALID_ARG_TYPE',
+    type: TypeError,
+    message: /The "items" argument must be of type Array/
+  });
+}
+
+for (const item of [null, 'password']) {
+  common.expectsError(() => {
+    crypto.scryptBatch([item], 1, common.mustNotCall());
+  }, {
+    code: 'ERR_INVALID_ARG_TYPE',
+    type: TypeError,
+    message: /The "items\[0\]" argument must be of type Object/
+  });
+}
+
+common.expectsError(() => {
+  crypto.pbkdf2Batch([{ password: 'a', salt: 'b' }, { password: 'a' }],
+                     1, 1, 'sha256', common.mustNotCall());
+}, {
+  code: 'ERR_INVALID_ARG_TYPE',
+  type: TypeError,
+  message: /The "items\[1\]\.salt" property must be one of type/
+});
+
+// Invalid parameters are reported even for an empty batch.
+for (const items of [[], makeItems(1)]) {
+  common.expectsError(() => {
+    crypto.pbkdf2Batch(items, 1, 1, 'md55', common.mustNotCall());
+  }, {
+    code: 'ERR_CRYPTO_INVALID_DIGEST',
+    type: TypeError,
+    message: 'Invalid digest: md55'
+  });
+
+  common.expectsError(() => {
+    crypto.scryptBatch(items, 1, { N: 3 }, common.mustNotCall());
+  }, {
+    code: 'ERR_CRYPTO_SCRYPT_INVALID_PARAMETER',
+    type: Error
+  });
+}
+
+common.expectsError(() => {
+  crypto.pbkdf2Batch([], 1, 1, 'sha256');
+}, {
+  code: 'ERR_INVALID_CALLBACK',
+  type: TypeError
+});
+
+common.expectsError(() => {
+  crypto.scryptBatch([], 1, {});
+}, {
+  code: 'ERR_INVALID_CALLBACK',
+  type: TypeError
+});
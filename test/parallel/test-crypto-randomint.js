@@ -0,0 +1,81 @@
+'use strict';
+
+const common = require('../common');
+if (!common.hasCrypto)
+  common.skip('missing crypto');
+
+const assert = require('assert');
+const { randomInt } = require('crypto');
+
+{
+  const counts = [0, 0, 0];
+  for (let i = 0; i < 3000; i++) {
+    const n = randomInt(3);
+    assert(Number.isSafeInteger(n));
+    counts[n]++;
+  }
+  // Each value is expected 1000 times.
+  for (const count of counts)
+    assert(count > 800 && count < 1200, `${counts}`);
+}
+
+for (let i = 0; i < 100; i++) {
+  const n = randomInt(-10, -5);
+  assert(n >= -10 && n < -5, `${n}`);
+  assert.strictEqual(randomInt(i, i + 1), i);
+}
+
+{
+  const max = 2 ** 48 - 1;
+  const n = randomInt(max);
+  assert(n >= 0 && n < max);
+  const m = randomInt(Number.MAX_SAFE_INTEGER - max,
+                      Number.MAX_SAFE_INTEGER);
+  assert(m >= Number.MAX_SAFE_INTEGER - max);
+}
+
+{
+  let sync = true;
+  randomInt(5, 10, common.mustCall((err, n) => {
+    assert.strictEqual(err, null);
+    assert(n >= 5 && n < 10);
+    assert.strictEqual(sync, false);
+  }));
+  randomInt(10, common.mustCall((err, n) => {
+    assert.strictEqual(err, null);
+    assert(n >= 0 && n < 10);
+  }));
+  sync = false;
+}
+
+[1.5, NaN, Infinity, 2 ** 53].forEach((value) => {
+  assert.throws(() => randomInt(value), { code: 'ERR_OUT_OF_RANGE' });
+  assert.throws(() => randomInt(0, value), { code: 'ERR_OUT_OF_RANGE' });
+  assert.throws(() => randomInt(value, 10), { code: 'ERR_OUT_OF_RANGE' });
+});
+
+['1', null, {}].forEach((value) => {
+  assert.throws(() => randomInt(value), { code: 'ERR_INVALID_ARG_TYPE' });
+  assert.throws(() => randomInt(0, value), { code: 'ERR_INVALID_ARG_TYPE' });
+});
+
+assert.throws(() => randomInt(0), {
+  code: 'ERR_OUT_OF_RANGE',
+  message: 'The value of "max" is out of range. It must be greater than ' +
+           'the value of "min" (0). Received 0'
+});
+assert.throws(() => randomInt(5, 5), { code: 'ERR_OUT_OF_RANGE' });
+assert.throws(() => randomInt(2 ** 48), {
+  code: 'ERR_OUT_OF_RANGE',
+  message: 'The value of "max" is out of range. It must be <= ' +
+           `${2 ** 48 - 1}. Received ${2 ** 48}`
+});
+assert.throws(() => randomInt(-1, 2 ** 48), {
+  code: 'ERR_OUT_OF_RANGE',
+  message: 'The value of "max - min" is out of range. It must be <= ' +
+           `${2 ** 48 - 1}. Received ${2 ** 48 + 1}`
+});
+
+[1, 'test', {}].forEach((cb) => {
+  assert.throws(() => randomInt(0, 10, cb), { code: 'ERR_INVALID_CALLBACK' });
+});
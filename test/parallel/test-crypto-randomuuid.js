@@ -0,0 +1,89 @@
+'use strict';
+
+const common = require('../common');
+if (!common.hasCrypto)
+  common.skip('missing crypto');
+
+const assert = require('assert');
+const async_hooks = require('async_hooks');
+const { randomBytes, randomFillSync, randomUUID } = require('crypto');
+
+const uuidPattern =
+  /^[0-9a-f]{8}-[0-9a-f]{4}-4[0-9a-f]{3}-[89ab][0-9a-f]{3}-[0-9a-f]{12}$/;
+
+// Enough UUIDs to use up several pools, interleaved with other pooled
+// requests.
+const uuids = new Set();
+for (let i = 0; i < 1000; i++) {
+  const uuid = randomUUID();
+  assert(uuidPattern.test(uuid), uuid);
+  uuids.add(uuid);
+  randomBytes(7);
+}
+assert.strictEqual(uuids.size, 1000);
+
+{
+  const uuid = randomUUID({ disableEntropyCache: true });
+  assert(uuidPattern.test(uuid), uuid);
+  assert(!uuids.has(uuid));
+}
+assert(uuidPattern.test(randomUUID({})));
+assert(uuidPattern.test(randomUUID({ disableEntropyCache: false })));
+
+[null, 1, 'test', true].forEach((options) => {
+  common.expectsError(() => randomUUID(options), {
+    code: 'ERR_INVALID_ARG_TYPE',
+    type: TypeError
+  });
+});
+
+[null, 1, 'test', {}].forEach((disableEntropyCache) => {
+  common.expectsError(() => randomUUID({ disableEntropyCache }), {
+    code: 'ERR_INVALID_ARG_TYPE',
+    type: TypeError
+  });
+});
+
+// Small synchronous requests are served from the pool, and must never repeat
+// bytes or expose the pool.
+{
+  const seen = new Set();
+  for (let i = 0; i < 1000; i++) {
+    const buf = randomBytes(16);
+    assert.strictEqual(buf.buffer.byteLength, 16);
+    seen.add(buf.toString('hex'));
+  }
+  assert.strictEqual(seen.size, 1000);
+
+  const pooled = randomBytes(256);
+  const unpooled = randomBytes(257);
+  assert.strictEqual(pooled.length, 256);
+  assert.strictEqual(unpooled.length, 257);
+}
+
+// randomFillSync() fills only the requested range, of any view.
+for (const ctor of [Uint8Array, Uint16Array, Float64Array, DataView]) {
+  const elementSize = ctor.BYTES_PER_ELEMENT || 1;
+  const bytes = new Uint8Array(8 + elementSize * 16 + 8);
+  const view = new ctor(bytes.buffer, 8,
+                        ctor === DataView ? elementSize * 16 : 16);
+  randomFillSync(view, 1, 8);
+  const start = 8 + elementSize;
+  const end = start + elementSize * 8;
+  assert(bytes.subarray(0, start).every((byte) => byte === 0));
+  assert(bytes.subarray(start, end).some((byte) => byte !== 0));
+  assert(bytes.subarray(end).every((byte) => byte === 0));
+}
+
+// Refilling the pool is synchronous as well, it creates no async resources.
+{
+  const hook = async_hooks.createHook({
+    init: common.mustNotCall()
+  }).enable();
+  for (let i = 0; i < 1000; i++) {
+    randomBytes(16);
+    randomFillSync(Buffer.alloc(16));
+    randomUUID();
+  }
+  hook.disable();
+}
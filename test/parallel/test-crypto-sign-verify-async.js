@@ -0,0 +1,210 @@
+'use strict';
+const common = require('../common');
+if (!common.hasCrypto)
+  common.skip('missing crypto');
+
+const assert = require('assert');
+const crypto = require('crypto');
+const fixtures = require('../common/fixtures');
+
+// This test ensures that the asynchronous forms of sign.sign(),
+// verify.verify(), crypto.signBatch() and the RSA encryption functions
+// produce the same results as the synchronous ones.
+
+const certPem = fixtures.readSync('test_cert.pem', 'ascii');
+const keyPem = fixtures.readSync('test_key.pem', 'ascii');
+const rsaPubPem = fixtures.readSync('test_rsa_pubkey.pem', 'ascii');
+const rsaKeyPem = fixtures.readSync('test_rsa_privkey.pem', 'ascii');
+const rsaKeyPemEncrypted = fixtures.readSync('test_rsa_privkey_encrypted.pem',
+                                             'ascii');
+const dsaPubPem = fixtures.readSync('test_dsa_pubkey.pem', 'ascii');
+const dsaKeyPem = fixtures.readSync('test_dsa_privkey.pem', 'ascii');
+
+const message = 'Test123';
+
+// Deterministic signatures are the same as the synchronous ones, and all of
+// them verify.
+for (const [algorithm, options] of [
+  ['SHA256', keyPem],
+  ['SHA1', { key: rsaKeyPemEncrypted, passphrase: 'password' }],
+  ['SHA512', { key: rsaKeyPem, padding: crypto.constants.RSA_PKCS1_PADDING }]
+]) {
+  const expected = crypto.createSign(algorithm).update(message).sign(options);
+
+  crypto.createSign(algorithm).update(message).sign(options, common.mustCall(
+    (err, signature) => {
+      assert.ifError(err);
+      assert.deepStrictEqual(signature, expected);
+    }));
+
+  const sign = crypto.createSign(algorithm).update(message);
+  sign.sign(options, 'hex', common.mustCall((err, signature) => {
+    assert.ifError(err);
+    assert.strictEqual(signature, expected.toString('hex'));
+  }));
+}
+
+for (const [algorithm, privateKey, publicKey, options] of [
+  ['SHA256', keyPem, certPem, {}],
+  ['SHA256', rsaKeyPem, rsaPubPem, {
+    padding: crypto.constants.RSA_PKCS1_PSS_PADDING,
+    saltLength: 16
+  }],
+  ['SHA1', dsaKeyPem, dsaPubPem, {}]
+]) {
+  const signature = crypto.createSign(algorithm)
+    .update(message)
+    .sign(Object.assign({ key: privateKey }, options));
+
+  crypto.createVerify(algorithm).update(message).verify(
+    Object.assign({ key: publicKey }, options), signature,
+    common.mustCall((err, result) => {
+      assert.ifError(err);
+      assert.strictEqual(result, true);
+    }));
+
+  crypto.createVerify(algorithm).update('Test124').verify(
+    Object.assign({ key: publicKey }, options), signature.toString('base64'),
+    'base64', common.mustCall((err, result) => {
+      assert.ifError(err);
+      assert.strictEqual(result, false);
+    }));
+
+  crypto.createSign(algorithm).update(message).sign(
+    Object.assign({ key: privateKey }, options),
+    common.mustCall((err, signature) => {
+      assert.ifError(err);
+      const verify = crypto.createVerify(algorithm).update(message);
+      assert.strictEqual(
+        verify.verify(Object.assign({ key: publicKey }, options), signature),
+        true);
+    }));
+}
+
+// Errors that happen on the threadpool are passed to the callback.
+crypto.createSign('SHA256').update(message).sign(
+  { key: rsaKeyPemEncrypted, passphrase: 'wrong' },
+  common.mustCall((err, signature) => {
+    assert.ok(err instanceof Error);
+    assert.strictEqual(signature, undefined);
+  }));
+
+crypto.createVerify('SHA256').update(message).verify(
+  'not a public key', Buffer.alloc(8), common.mustCall((err, result) => {
+    assert.ok(err instanceof Error);
+    assert.strictEqual(result, undefined);
+  }));
+
+// The object cannot be used again, whether it was finished synchronously or
+// asynchronously.
+{
+  const sign = crypto.createSign('SHA256').update(message);
+  sign.sign(keyPem, common.mustCall());
+  assert.throws(() => sign.sign(keyPem), /Not initialised/);
+  assert.throws(() => sign.sign(keyPem, common.mustNotCall()),
+                /Not initialised/);
+
+  const verify = crypto.createVerify('SHA256').update(message);
+  verify.verify(certPem, Buffer.alloc(8), common.mustCall());
+  assert.throws(() => verify.verify(certPem, Buffer.alloc(8)),
+                /Not initialised/);
+}
+
+// signBatch() produces one signature per payload, in order.
+{
+  const payloads = ['a', Buffer.from('b'), new Uint8Array([99]), ''];
+  crypto.signBatch('SHA256', payloads, keyPem, common.mustCall(
+    (err, signatures) => {
+      assert.ifError(err);
+      assert.strictEqual(signatures.length, payloads.length);
+      signatures.forEach((signature, i) => {
+        assert.deepStrictEqual(
+          signature,
+          crypto.createSign('SHA256').update(payloads[i]).sign(keyPem));
+      });
+    }));
+
+  crypto.signBatch('SHA256', payloads, {
+    key: rsaKeyPem,
+    padding: crypto.constants.RSA_PKCS1_PSS_PADDING
+  }, 'base64', common.mustCall((err, signatures) => {
+    assert.ifError(err);
+    signatures.forEach((signature, i) => {
+      const verify = crypto.createVerify('SHA256').update(payloads[i]);
+      assert.strictEqual(verify.verify({
+        key: rsaPubPem,
+        padding: crypto.constants.RSA_PKCS1_PSS_PADDING
+      }, signature, 'base64'), true);
+    });
+  }));
+
+  crypto.signBatch('SHA256', [], keyPem, common.mustCall((err, signatures) => {
+    assert.ifError(err);
+    assert.deepStrictEqual(signatures, []);
+  }));
+
+  crypto.signBatch('SHA256', payloads, {
+    key: rsaKeyPemEncrypted,
+    passphrase: 'wrong'
+  }, common.mustCall((err, signatures) => {
+    assert.ok(err instanceof Error);
+    assert.strictEqual(signatures, undefined);
+  }));
+
+  assert.throws(
+    () => crypto.signBatch('xyzzy', payloads, keyPem, common.mustNotCall()),
+    /Unknown message digest/);
+  common.expectsError(
+    () => crypto.signBatch('SHA256', 'a', keyPem, common.mustNotCall()), {
+      code: 'ERR_INVALID_ARG_TYPE',
+      type: TypeError
+    });
+  common.expectsError(
+    () => crypto.signBatch('SHA256', [1], keyPem, common.mustNotCall()), {
+      code: 'ERR_INVALID_ARG_TYPE',
+      type: TypeError
+    });
+  common.expectsError(() => crypto.signBatch('SHA256', payloads, keyPem), {
+    code: 'ERR_INVALID_CALLBACK',
+    type: TypeError
+  });
+}
+
+// RSA encryption and decryption.
+{
+  const input = Buffer.from('I AM THE WALRUS');
+
+  crypto.publicEncrypt(rsaPubPem, input, common.mustCall((err, encrypted) => {
+    assert.ifError(err);
+    assert.deepStrictEqual(crypto.privateDecrypt(rsaKeyPem, encrypted), input);
+
+    crypto.privateDecrypt({
+      key: rsaKeyPemEncrypted,
+      passphrase: 'password'
+    }, encrypted, common.mustCall((err, decrypted) => {
+      assert.ifError(err);
+      assert.deepStrictEqual(decrypted, input);
+    }));
+  }));
+
+  crypto.privateEncrypt(rsaKeyPem, input, common.mustCall((err, encrypted) => {
+    assert.ifError(err);
+    assert.deepStrictEqual(encrypted, crypto.privateEncrypt(rsaKeyPem, input));
+    crypto.publicDecrypt(rsaPubPem, encrypted, common.mustCall(
+      (err, decrypted) => {
+        assert.ifError(err);
+        assert.deepStrictEqual(decrypted, input);
+      }));
+  }));
+
+  crypto.privateDecrypt(rsaKeyPem, Buffer.alloc(128), common.mustCall(
+    (err, decrypted) => {
+      assert.ok(err instanceof Error);
+      assert.strictEqual(decrypted, undefined);
+    }));
+
+  common.expectsError(() => crypto.publicEncrypt(rsaPubPem, input, 'hex'), {
+    code: 'ERR_INVALID_CALLBACK',
+    type: TypeError
+  });
+}
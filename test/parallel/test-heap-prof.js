@@ -0,0 +1,123 @@
+'use strict';
+
+// Tests the heap profiles written by --heap-prof and v8.captureHeapProfile().
+
+const common = require('../common');
+const assert = require('assert');
+const fs = require('fs');
+const path = require('path');
+const { spawnSync } = require('child_process');
+const v8 = require('v8');
+
+const tmpdir = require('../common/tmpdir');
+
+const allocate = `
+  const retained = [];
+  function allocate() {
+    for (let i = 0; i < 1e5; i++)
+      retained.push({ i });
+  }
+  allocate();
+`;
+
+function verifyProfile(file) {
+  const profile = JSON.parse(fs.readFileSync(file, 'utf8'));
+  const ids = new Set();
+  const names = [];
+  const pending = [profile.head];
+  while (pending.length > 0) {
+    const node = pending.pop();
+    assert(!ids.has(node.id));
+    ids.add(node.id);
+    names.push(node.callFrame.functionName);
+    assert.strictEqual(typeof node.callFrame.scriptId, 'string');
+    assert.strictEqual(typeof node.selfSize, 'number');
+    pending.push(...node.children);
+  }
+  assert.strictEqual(profile.head.callFrame.functionName, '(root)');
+  return names;
+}
+
+function getProfiles(dir) {
+  return fs.readdirSync(dir)
+    .filter((file) => file.endsWith('.heapprofile'))
+    .map((file) => path.join(dir, file));
+}
+
+function run(args, code) {
+  const output = spawnSync(process.execPath, [...args, '-e', code], {
+    cwd: tmpdir.path
+  });
+  assert.strictEqual(output.status, 0, output.stderr.toString());
+}
+
+// The profile is written when the process exits normally.
+{
+  tmpdir.refresh();
+  run(['--heap-prof', '--heap-prof-interval', '128'], allocate);
+  const profiles = getProfiles(tmpdir.path);
+  assert.strictEqual(profiles.length, 1);
+  assert(verifyProfile(profiles[0]).includes('allocate'));
+}
+
+// The profile is written when process.exit() is called, and the stack depth
+// is limited.
+{
+  tmpdir.refresh();
+  const dir = path.join(tmpdir.path, 'prof');
+  run(['--heap-prof', '--heap-prof-dir', dir, '--heap-prof-name', 'exit.prof',
+       '--heap-prof-stack-depth', '1', '--heap-prof-interval', '128'],
+      `${allocate} process.exit(0);`);
+  const profile = JSON.parse(fs.readFileSync(path.join(dir, 'exit.prof')));
+  for (const child of profile.head.children)
+    assert.deepStrictEqual(child.children, []);
+}
+
+// Every Worker thread writes its own profile.
+{
+  tmpdir.refresh();
+  run(['--heap-prof', '--experimental-worker', '--heap-prof-dir', tmpdir.path],
+      `const { Worker } = require('worker_threads');
+       new Worker('${allocate.replace(/\n/g, ' ')}', { eval: true });`);
+  const profiles = getProfiles(tmpdir.path);
+  assert.strictEqual(profiles.length, 2);
+  profiles.forEach(verifyProfile);
+}
+
+// The --heap-prof-* options require --heap-prof.
+for (const option of ['--heap-prof-dir', '--heap-prof-name',
+                      '--heap-prof-signal']) {
+  const output = spawnSync(process.execPath, [option, 'x', '-e', '0']);
+  assert.strictEqual(output.status, 9);
+  assert(output.stderr.toString().includes(`${option} must be used with ` +
+                                           '--heap-prof'));
+}
+
+// v8.captureHeapProfile() writes the profile once the duration has passed.
+{
+  tmpdir.refresh();
+  const filename = path.join(tmpdir.path, 'capture.heapprofile');
+  const retained = [];
+  v8.captureHeapProfile({ duration: 50, samplingInterval: 128, filename },
+                        common.mustCall((err, file) => {
+                          assert.ifError(err);
+                          assert.strictEqual(file, filename);
+                          verifyProfile(file);
+                          assert(retained.length > 0);
+                        }));
+  for (let i = 0; i < 1e4; i++)
+    retained.push({ i });
+
+  // Only one sampling heap profile can be recorded at a time.
+  common.expectsError(() => {
+    v8.captureHeapProfile({ duration: 10 }, common.mustNotCall());
+  }, { code: 'ERR_HEAP_PROFILER_ACTIVE' });
+
+  [{}, { duration: 0 }, { duration: 10, samplingInterval: 0 },
+   { duration: 10, stackDepth: 0 }, { duration: 10, filename: 1 }]
+    .forEach((options) => {
+      common.expectsError(() => v8.captureHeapProfile(options, () => {}), {
+        code: /^ERR_(INVALID_ARG_TYPE|OUT_OF_RANGE)$/
+      });
+    });
+}
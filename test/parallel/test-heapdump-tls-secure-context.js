@@ -0,0 +1,37 @@
+// Flags: --expose-internals
+'use strict';
+const common = require('../common');
+
+if (!common.hasCrypto)
+  common.skip('missing crypto');
+
+const { validateSnapshotNodes } = require('../common/heap');
+const tls = require('tls');
+const fixtures = require('../common/fixtures');
+
+const options = {
+  key: fixtures.readKey('agent1-key.pem'),
+  cert: fixtures.readKey('agent1-cert.pem'),
+  ca: fixtures.readKey('ca1-cert.pem')
+};
+
+// The contexts share the parsed certificates and key.
+const contexts = [
+  tls.createSecureContext(options),
+  tls.createSecureContext(options)
+];
+
+validateSnapshotNodes('Node / SecureContext', [
+  {
+    children: [
+      { node_name: 'Node / SSL_CTX', edge_name: 'ctx' },
+      { node_name: 'Node / PEMCacheEntry', edge_name: 'pem' },
+      // `Node / SecureContext` (C++) -> `SecureContext` (JS)
+      { node_name: 'SecureContext', edge_name: 'wrapped' }
+    ]
+  }
+], { loose: true });
+validateSnapshotNodes('Node / PEMCacheEntry', [{}, {}, {}]);
+
+for (const { context } of contexts)
+  context.close();
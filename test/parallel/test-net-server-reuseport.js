@@ -0,0 +1,64 @@
+// Flags: --experimental-worker
+'use strict';
+
+const common = require('../common');
+if (!common.isLinux && !common.isFreeBSD)
+  common.skip('SO_REUSEPORT load balancing is not supported');
+
+const assert = require('assert');
+const net = require('net');
+const { Worker, isMainThread, parentPort, workerData } =
+  require('worker_threads');
+
+// This test ensures that servers listening with `reusePort` can share a
+// port, both within one thread and with servers in Worker threads.
+
+if (!isMainThread) {
+  const server = net.createServer((socket) => socket.end('worker'));
+  server.listen({ port: workerData.port, reusePort: true }, () => {
+    parentPort.postMessage(server.address().port);
+    parentPort.once('message', () => server.close());
+  });
+  return;
+}
+
+const first = net.createServer(common.mustNotCall());
+first.listen({ port: 0, reusePort: true }, common.mustCall(() => {
+  const { port } = first.address();
+
+  // Servers that don't set reusePort still cannot bind to the port.
+  const plain = net.createServer(common.mustNotCall());
+  plain.on('error', common.mustCall((err) => {
+    assert.strictEqual(err.code, 'EADDRINUSE');
+
+    const second = net.createServer(common.mustNotCall());
+    second.listen({ port, reusePort: true }, common.mustCall(() => {
+      assert.strictEqual(second.address().port, port);
+      second.close();
+      startWorker(port);
+    }));
+  }));
+  plain.listen(port);
+}));
+
+function startWorker(port) {
+  const worker = new Worker(__filename, { workerData: { port } });
+  worker.once('message', common.mustCall((workerPort) => {
+    assert.strictEqual(workerPort, port);
+
+    // Once the main thread stops listening, the Worker accepts every
+    // connection.
+    first.close(common.mustCall(() => {
+      net.connect(port, common.mustCall(function() {
+        let data = '';
+        this.setEncoding('utf8');
+        this.on('data', (chunk) => data += chunk);
+        this.on('end', common.mustCall(() => {
+          assert.strictEqual(data, 'worker');
+          worker.postMessage('close');
+        }));
+      }));
+    }));
+  }));
+  worker.on('exit', common.mustCall());
+}
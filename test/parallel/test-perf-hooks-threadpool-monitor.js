@@ -0,0 +1,88 @@
+'use strict';
+
+const common = require('../common');
+if (!common.hasCrypto)
+  common.skip('missing crypto');
+
+const assert = require('assert');
+const crypto = require('crypto');
+const fs = require('fs');
+const { monitorThreadPool } = require('perf_hooks');
+
+// This test ensures that a threadpool monitor only records while it is
+// enabled, and that it records wait, run and latency times per work type.
+
+const monitor = monitorThreadPool();
+
+for (const type of ['fs', 'dns', 'crypto', 'kdf', 'zlib', 'napi']) {
+  const { wait, run, latency } = monitor.get(type);
+  for (const histogram of [wait, run, latency]) {
+    assert.strictEqual(histogram.count, 0);
+    assert.strictEqual(histogram.mean, 0);
+    assert.strictEqual(histogram.stddev, 0);
+    assert.strictEqual(histogram.percentile(50), 0);
+  }
+}
+
+common.expectsError(() => monitor.get('http'), {
+  code: 'ERR_INVALID_ARG_VALUE',
+  type: TypeError
+});
+
+{
+  const { run } = monitor.get('crypto');
+  common.expectsError(() => run.percentile('50'), {
+    code: 'ERR_INVALID_ARG_TYPE',
+    type: TypeError
+  });
+  for (const percentile of [0, -1, 101, NaN]) {
+    common.expectsError(() => run.percentile(percentile), {
+      code: 'ERR_INVALID_ARG_VALUE',
+      type: RangeError
+    });
+  }
+}
+
+assert.strictEqual(monitor.enable(), true);
+assert.strictEqual(monitor.enable(), false);
+
+const JOBS = 4;
+let remaining = JOBS;
+for (let i = 0; i < JOBS; i++) {
+  crypto.pbkdf2('secret', 'salt', 1000, 32, 'sha256', common.mustCall((err) => {
+    assert.ifError(err);
+    if (--remaining === 0)
+      onCryptoDone();
+  }));
+}
+
+function onCryptoDone() {
+  const { wait, run, latency } = monitor.get('crypto');
+  assert.strictEqual(wait.count, JOBS);
+  assert.strictEqual(run.count, JOBS);
+  assert.strictEqual(latency.count, JOBS);
+  assert.ok(run.min > 0);
+  assert.ok(run.min <= run.mean && run.mean <= run.max);
+  assert.ok(run.stddev >= 0);
+  assert.ok(run.percentile(50) >= run.min);
+  assert.strictEqual(run.percentile(100), run.max);
+  assert.ok(latency.max >= run.max);
+
+  // File system requests that libuv runs itself only report their latency.
+  fs.stat(__filename, common.mustCall((err) => {
+    assert.ifError(err);
+    const { wait, run, latency } = monitor.get('fs');
+    assert.strictEqual(wait.count, 0);
+    assert.strictEqual(run.count, 0);
+    assert.strictEqual(latency.count, 1);
+
+    monitor.reset();
+    assert.strictEqual(monitor.get('crypto').run.count, 0);
+
+    assert.strictEqual(monitor.disable(), true);
+    assert.strictEqual(monitor.disable(), false);
+    crypto.pbkdf2('secret', 'salt', 1, 32, 'sha256', common.mustCall(() => {
+      assert.strictEqual(monitor.get('crypto').run.count, 0);
+    }));
+  }));
+}
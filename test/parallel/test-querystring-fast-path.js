@@ -0,0 +1,93 @@
+'use strict';
+const common = require('../common');
+
+// This test ensures that querystring.parse() and querystring.escape() give the
+// same results whether the input is handled in C++ or has to be handled by the
+// JS implementation: with separators that could be part of an escape, custom
+// decoders, escapes that decodeURIComponent() rejects or short strings.
+
+const assert = require('assert');
+const qs = require('querystring');
+
+function check(actual, expected) {
+  assert.deepStrictEqual(actual, Object.assign(Object.create(null), expected));
+}
+
+// Repeated keys, also when they are only equal once decoded.
+check(qs.parse('a=1&b=2&a=3&%61=4&b=5'), { a: ['1', '3', '4'], b: ['2', '5'] });
+check(qs.parse('a&a=&a=x=y&=&='), { 'a': ['', '', 'x=y'], '': ['', ''] });
+check(qs.parse('__proto__=1&constructor=2&0=3&1=4&0=5'),
+      { ['__proto__']: '1', 'constructor': '2', '0': ['3', '5'], '1': '4' });
+
+// More keys than fit the table of keys that is searched linearly.
+{
+  const input = [];
+  const expected = {};
+  for (let i = 0; i < 100; i++) {
+    input.push(`k${i}=${i}`);
+    expected[`k${i}`] = [`${i}`];
+  }
+  for (let i = 0; i < 100; i += 3) {
+    input.push(`k${i}=x`);
+    expected[`k${i}`].push('x');
+  }
+  for (const key of Object.keys(expected)) {
+    if (expected[key].length === 1)
+      expected[key] = expected[key][0];
+  }
+  check(qs.parse(input.join('&'), null, null, { maxKeys: 0 }), expected);
+}
+
+// Decoding.
+check(qs.parse('a+b=c+d&%2B=%26%3D&e=%C3%A9%E2%82%AC%F0%9F%98%80'),
+      { 'a b': 'c d', '+': '&=', 'e': 'é€😀' });
+check(qs.parse('é=€&😀=%C3%A9'), { 'é': '€', '😀': 'é' });
+check(qs.parse('%c3%a9=%e2%82%ac'), { 'é': '€' });
+
+// Escapes that decodeURIComponent() rejects leave the keys and values that have
+// no valid escapes as they are.
+check(qs.parse('a=%&b=%zz&c=%4&d=%C3'),
+      { a: '%', b: '%zz', c: '%4', d: '�' });
+check(qs.parse('a=%C0%80&b=%ED%A0%80&c=%F4%90%80%80&d=%E2%82'),
+      { a: '��', b: '���',
+        c: '����', d: '�' });
+check(qs.parse('a=%41&b=%'), { a: 'A', b: '%' });
+
+// Empty pairs count towards maxKeys.
+check(qs.parse('a=1&&b=2&c=3', null, null, { maxKeys: 2 }), { a: '1' });
+check(qs.parse('a=1&b=2&c=3', null, null, { maxKeys: 2 }), { a: '1', b: '2' });
+check(qs.parse('a=1&b=2&c=3', null, null, { maxKeys: 1.5 }),
+      { a: '1', b: '2', c: '3' });
+check(qs.parse('&&a=1&&', null, null, { maxKeys: -1 }), { a: '1' });
+
+// Single character separators.
+check(qs.parse('a:1;b:2;a:3', ';', ':'), { a: ['1', '3'], b: '2' });
+check(qs.parse('a1b2a3c', 'a', 'b'), { '1': '2', '3c': '' });
+check(qs.parse('a=1%b=2', '%'), { a: '1', b: '2' });
+check(qs.parse('a=1+b=2', '+'), { a: '1', b: '2' });
+check(qs.parse('a=1&b', '&', '&'), { 'a=1': '', 'b': '' });
+check(qs.parse('aĀbāc', 'Ā', 'ā'), { a: '', b: 'c' });
+
+// A custom decoder sees the raw keys and values.
+check(qs.parse('a+b=%41', null, null, {
+  decodeURIComponent: common.mustCall((str) => str.toUpperCase(), 2)
+}), { 'A%20B': '%41' });
+
+// querystring.escape() on strings long enough to be escaped in C++.
+assert.strictEqual(qs.escape('abcdefghijklmnopqrstuvwxyz'),
+                   'abcdefghijklmnopqrstuvwxyz');
+assert.strictEqual(qs.escape('a b&c=d!\'()*-._~'),
+                   'a%20b%26c%3Dd!\'()*-._~');
+assert.strictEqual(qs.escape('\u0080߿ࠀ￿😀abc'),
+                   '%C2%80%DF%BF%E0%A0%80%EF%BF%BF%F0%9F%98%80abc');
+// Like encodeURIComponent(), except that the second half of a surrogate pair
+// is not checked.
+assert.strictEqual(qs.escape('\ud83dxabcdefgh'), '%F0%9F%91%B8abcdefgh');
+common.expectsError(() => qs.escape('abcdefgh\ud83d'), {
+  code: 'ERR_INVALID_URI',
+  type: URIError,
+  message: 'URI malformed'
+});
+
+assert.strictEqual(qs.stringify({ 'long key with spaces': 'é'.repeat(10) }),
+                   `long%20key%20with%20spaces=${'%C3%A9'.repeat(10)}`);
@@ -0,0 +1,72 @@
+// Flags: --threadpool-queue=crypto:2:low
+'use strict';
+
+const common = require('../common');
+if (!common.hasCrypto)
+  common.skip('missing crypto');
+
+const assert = require('assert');
+const { spawnSync } = require('child_process');
+const crypto = require('crypto');
+const zlib = require('zlib');
+const { getThreadPoolStatistics } = require('perf_hooks');
+
+// This test ensures that --threadpool-queue moves a class of work onto
+// dedicated threads, and that every queue reports its statistics.
+
+function getQueue(name) {
+  return getThreadPoolStatistics().find((queue) => queue.name === name);
+}
+
+assert.deepStrictEqual(getThreadPoolStatistics().map((queue) => queue.name),
+                       ['fs', 'crypto', 'kdf', 'zlib', 'napi']);
+
+{
+  const queue = getQueue('crypto');
+  assert.strictEqual(queue.dedicated, true);
+  assert.strictEqual(queue.threads, 2);
+  assert.strictEqual(queue.priority, 'low');
+  assert.strictEqual(queue.completed, 0);
+}
+
+{
+  const queue = getQueue('zlib');
+  assert.strictEqual(queue.dedicated, false);
+  assert.strictEqual(queue.priority, 'normal');
+  assert.ok(queue.threads >= 1);
+}
+
+const JOBS = 4;
+let remaining = JOBS;
+for (let i = 0; i < JOBS; i++) {
+  crypto.pbkdf2('secret', 'salt', 1000, 32, 'sha256', common.mustCall((err) => {
+    assert.ifError(err);
+    if (--remaining !== 0)
+      return;
+
+    const queue = getQueue('crypto');
+    assert.strictEqual(queue.pending, 0);
+    assert.strictEqual(queue.running, 0);
+    assert.strictEqual(queue.completed, JOBS);
+    assert.ok(queue.waitTime >= 0);
+    assert.ok(queue.runTime > 0);
+  }));
+}
+
+// Work on queues that share the libuv threadpool is counted as well.
+zlib.gzip('hello', common.mustCall((err) => {
+  assert.ifError(err);
+  assert.ok(getQueue('zlib').completed >= 1);
+}));
+
+for (const [value, message] of [
+  ['dns:2', /unknown --threadpool-queue name 'dns'/],
+  ['zlib', /must be <queue>:<threads>\[:<priority>\]/],
+  ['zlib:0', /thread count must be between 1 and 128/],
+  ['zlib:2:urgent', /priority must be low, normal or high/]
+]) {
+  const child = spawnSync(process.execPath,
+                          [`--threadpool-queue=${value}`, '-e', '']);
+  assert.strictEqual(child.status, 9);
+  assert.ok(message.test(child.stderr.toString()), child.stderr.toString());
+}
@@ -15,8 +15,6 @@ legitTimers.forEach(function(legit) {
   // active() should mutate these objects
   assert.strictEqual(legit._idleTimeout, savedTimeout);
   assert(Number.isInteger(legit._idleStart));
-  assert(legit._idleNext);
-  assert(legit._idlePrev);
 });
 
 
@@ -0,0 +1,50 @@
+// Flags: --expose-internals
+'use strict';
+
+// Checks that many timers which are constantly re-armed or cancelled only
+// fire once their full duration has passed since they were last armed, and
+// that every timer that is not cancelled fires exactly once.
+
+const common = require('../common');
+const assert = require('assert');
+const { internalBinding } = require('internal/test/binding');
+const { getLibuvNow } = internalBinding('timers');
+
+const N = 3000;
+const timers = [];
+const armedAt = [];
+
+function onTimeout(i) {
+  const duration = this._idleTimeout;
+  assert(getLibuvNow() >= armedAt[i] + duration,
+         `timer ${i} fired early`);
+}
+
+// Creating the callbacks takes a while, so do it before any timer is armed.
+const callbacks = [];
+for (let i = 0; i < N; i++) {
+  callbacks.push(i % 3 === 2 ?
+    common.mustNotCall() : common.mustCall(onTimeout));
+}
+
+// The interval is armed first, so that it runs before any of the timers even
+// if arming them takes longer than their duration.
+let rounds = 0;
+const interval = setInterval(common.mustCall(() => {
+  for (let i = 0; i < N; i += 3) {
+    armedAt[i] = getLibuvNow();
+    timers[i].refresh();
+  }
+  if (++rounds === 1) {
+    for (let i = 2; i < N; i += 3)
+      clearTimeout(timers[i]);
+  }
+  if (rounds === 5)
+    clearInterval(interval);
+}, 5), 5);
+
+for (let i = 0; i < N; i++) {
+  const duration = 50 + i % 50;
+  armedAt[i] = getLibuvNow();
+  timers.push(setTimeout(callbacks[i], duration, i));
+}
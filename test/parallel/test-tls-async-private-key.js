@@ -0,0 +1,126 @@
+'use strict';
+const common = require('../common');
+if (!common.hasCrypto)
+  common.skip('missing crypto');
+
+// This test ensures that handshakes succeed when the private key operations
+// of the server and the client run on the threadpool, that the handshake
+// callbacks into JS still work, and that destroying connections while an
+// operation is pending is safe.
+
+const assert = require('assert');
+const tls = require('tls');
+const { SSL_OP_NO_TICKET } = require('crypto').constants;
+const fixtures = require('../common/fixtures');
+
+const rsa = {
+  key: fixtures.readKey('agent1-key.pem'),
+  cert: fixtures.readKey('agent1-cert.pem')
+};
+const ec = {
+  key: fixtures.readKey('ec-key.pem'),
+  cert: fixtures.readKey('ec-cert.pem')
+};
+const ca = fixtures.readKey('ca1-cert.pem');
+
+function listen(options, onSocket = (socket) => socket.end('hello')) {
+  const server = tls.createServer(Object.assign({ asyncPrivateKey: true },
+                                                options),
+                                  onSocket);
+  return new Promise((resolve) => server.listen(0, () => resolve(server)));
+}
+
+function connect(server, options = {}) {
+  return new Promise((resolve, reject) => {
+    const client = tls.connect(Object.assign({
+      port: server.address().port,
+      rejectUnauthorized: false
+    }, options), () => {
+      // The cipher is gone along with the handle by the time 'end' is emitted.
+      const cipher = client.getCipher();
+      let data = '';
+      client.setEncoding('utf8');
+      client.on('data', (chunk) => data += chunk);
+      client.on('end', () => resolve({ cipher, data }));
+    });
+    client.on('error', reject);
+  });
+}
+
+async function testKeyTypes() {
+  for (const [credentials, ciphers] of [
+    [rsa, 'ECDHE-RSA-AES128-GCM-SHA256'],
+    // RSA key exchange decrypts with the private key.
+    [rsa, 'AES128-GCM-SHA256'],
+    [ec, 'ECDHE-ECDSA-AES128-GCM-SHA256']
+  ]) {
+    const server = await listen(Object.assign({ ciphers }, credentials));
+    const { cipher, data } = await connect(server);
+    assert.strictEqual(data, 'hello');
+    assert.strictEqual(cipher.name, ciphers);
+    server.close();
+  }
+}
+
+async function testCallbacks() {
+  const server = await listen(Object.assign({
+    secureOptions: SSL_OP_NO_TICKET,
+    requestCert: true,
+    ca,
+    SNICallback: common.mustCall((servername, callback) => {
+      assert.strictEqual(servername, 'agent1');
+      callback(null, tls.createSecureContext(
+        Object.assign({ asyncPrivateKey: true, ca }, rsa)));
+    })
+  }, ec), (socket) => {
+    assert.strictEqual(socket.servername, 'agent1');
+    assert.strictEqual(socket.getPeerCertificate().subject.CN, 'agent1');
+    socket.end('hello');
+  });
+  server.on('newSession', common.mustCall((id, data, callback) => {
+    callback();
+  }));
+
+  // The client signs with its certificate on the threadpool, too.
+  const { data } = await connect(server, Object.assign({
+    servername: 'agent1',
+    asyncPrivateKey: true
+  }, rsa));
+  assert.strictEqual(data, 'hello');
+  server.close();
+}
+
+async function testDestroy() {
+  const server = await listen(rsa, common.mustCall((socket) => {
+    socket.end('hello');
+  }));
+  server.on('tlsClientError', () => {});
+
+  // The server sockets are destroyed while their handshakes may be waiting
+  // for the signature.
+  await Promise.all(Array.from({ length: 20 }, () => new Promise((resolve) => {
+    const client = tls.connect({
+      port: server.address().port,
+      rejectUnauthorized: false
+    }, common.mustNotCall());
+    client.on('error', () => {});
+    client.on('close', resolve);
+    client.once('connect', () => setImmediate(() => client.destroy()));
+  })));
+
+  const { data } = await connect(server);
+  assert.strictEqual(data, 'hello');
+  server.close();
+}
+
+(async function() {
+  await testKeyTypes();
+  await testCallbacks();
+  await testDestroy();
+})().then(common.mustCall());
+
+// The option is ignored for keys that do not support it.
+{
+  const context = tls.createSecureContext({ asyncPrivateKey: true });
+  assert.strictEqual(context.context.enableAsyncPrivateKey(), false);
+}
@@ -0,0 +1,107 @@
+'use strict';
+const common = require('../common');
+if (!common.hasCrypto)
+  common.skip('missing crypto');
+
+// This test ensures that secure contexts that are created from the same
+// certificates and keys, which share the parsed objects, behave like contexts
+// with their own copies, and that server.addContext() creates the context for
+// a name only when a client asks for it.
+
+const assert = require('assert');
+const tls = require('tls');
+const fixtures = require('../common/fixtures');
+
+const key = fixtures.readKey('agent1-key.pem');
+const cert = fixtures.readKey('agent1-cert.pem');
+const ca = fixtures.readKey('ca1-cert.pem');
+const passKey = fixtures.readSync('pass-key.pem');
+const passCert = fixtures.readSync('pass-cert.pem');
+
+// A cached key is only used with the passphrase it was parsed with.
+tls.createSecureContext({ key: passKey, cert: passCert,
+                          passphrase: 'passphrase' });
+for (const passphrase of [undefined, 'invalid']) {
+  assert.throws(() => {
+    tls.createSecureContext({ key: passKey, cert: passCert, passphrase });
+  }, /bad decrypt/);
+}
+tls.createSecureContext({ key: passKey, cert: passCert,
+                          passphrase: 'passphrase' });
+
+// Invalid input is not cached, it fails every time.
+for (let i = 0; i < 2; i++) {
+  assert.throws(() => tls.createSecureContext({ cert: 'invalid' }),
+                /no start line/);
+  assert.throws(() => tls.createSecureContext({ key: 'invalid' }),
+                /no start line/);
+}
+
+// The same input as a string and as a Buffer.
+for (const input of [{ key, cert }, { key: key.toString(),
+                                      cert: cert.toString() }]) {
+  const context = tls.createSecureContext(input);
+  assert.strictEqual(context.context.getCertificate().toString('hex'),
+                     tls.createSecureContext({ key, cert }).context
+                       .getCertificate().toString('hex'));
+}
+
+// The key must still match the certificate of each context.
+assert.throws(() => {
+  tls.createSecureContext({ key: fixtures.readKey('agent2-key.pem'), cert });
+}, /key values mismatch/);
+
+const server = tls.createServer({ key, cert, ca, requestCert: true },
+                                (socket) => socket.end(socket.servername));
+
+// The server's own context is created by tls.createServer(), only count the
+// ones that are created after that.
+let created = 0;
+const createSecureContext = tls.createSecureContext;
+tls.createSecureContext = function(options) {
+  created++;
+  return createSecureContext.call(this, options);
+};
+for (let i = 0; i < 100; i++)
+  server.addContext(`host${i}.example.com`, { key, cert, ca });
+server.addContext('invalid.example.com', { key: 'invalid', cert });
+server.on('tlsClientError', common.mustCall((err) => {
+  assert(/no start line/.test(err.message));
+}, 2));
+assert.strictEqual(created, 0);
+
+function connect(servername) {
+  return new Promise((resolve, reject) => {
+    const client = tls.connect({
+      port: server.address().port,
+      servername,
+      key,
+      cert,
+      ca,
+      checkServerIdentity: () => {}
+    }, () => {
+      let data = '';
+      client.setEncoding('utf8');
+      client.on('data', (chunk) => data += chunk);
+      client.on('end', () => resolve(data));
+    });
+    client.on('error', reject);
+  });
+}
+
+async function test() {
+  // Each client creates a context, too.
+  created = 0;
+  assert.strictEqual(await connect('host1.example.com'), 'host1.example.com');
+  assert.strictEqual(await connect('host1.example.com'), 'host1.example.com');
+  assert.strictEqual(await connect('host2.example.com'), 'host2.example.com');
+  assert.strictEqual(created, 3 + 2);
+
+  // A context that cannot be created fails the handshake, every time.
+  for (let i = 0; i < 2; i++) {
+    await assert.rejects(connect('invalid.example.com'), Error);
+  }
+  server.close();
+}
+
+server.listen(0, () => test().then(common.mustCall()));
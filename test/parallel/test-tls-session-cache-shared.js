@@ -0,0 +1,215 @@
+'use strict';
+const common = require('../common');
+if (!common.hasCrypto)
+  common.skip('missing crypto');
+
+// This test ensures that servers can resume each other's sessions when they
+// share a file-backed tls.SessionCache, or the secret of ticketKeyRotation.
+
+const assert = require('assert');
+const fs = require('fs');
+const path = require('path');
+const tls = require('tls');
+const { SSL_OP_NO_TICKET } = require('crypto').constants;
+const fixtures = require('../common/fixtures');
+const tmpdir = require('../common/tmpdir');
+
+tmpdir.refresh();
+
+const key = fixtures.readKey('agent2-key.pem');
+const cert = fixtures.readKey('agent2-cert.pem');
+
+function listen(options) {
+  const server = tls.createServer(Object.assign({ key, cert }, options),
+                                  (socket) => socket.end());
+  return new Promise((resolve) => server.listen(0, () => resolve(server)));
+}
+
+function connect(server, session) {
+  return new Promise((resolve, reject) => {
+    const client = tls.connect({
+      port: server.address().port,
+      rejectUnauthorized: false,
+      session
+    }, () => {
+      const reused = client.isSessionReused();
+      const session = client.getSession();
+      client.on('close', () => resolve({ reused, session }));
+      client.resume();
+    });
+    client.on('error', reject);
+  });
+}
+
+function sleep(ms) {
+  return new Promise((resolve) => setTimeout(resolve, ms));
+}
+
+async function testMemoryCache() {
+  const sessionCache = tls.createSessionCache();
+  assert.strictEqual(sessionCache.maxEntries, 10240);
+  const server = await listen({
+    sessionCache,
+    secureOptions: SSL_OP_NO_TICKET
+  });
+
+  const first = await connect(server);
+  assert.strictEqual(first.reused, false);
+  const second = await connect(server, first.session);
+  assert.strictEqual(second.reused, true);
+  assert.deepStrictEqual(sessionCache.getStats(),
+                         { hits: 1, misses: 0, stores: 1, evictions: 0 });
+
+  server.close();
+}
+
+async function testFileCache() {
+  const file = path.join(tmpdir.path, 'sessions');
+  // The first cache decides how large the file is.
+  const cacheA = tls.createSessionCache({ path: file, maxEntries: 10 });
+  const cacheB = tls.createSessionCache({ path: file, maxEntries: 1000 });
+  assert.strictEqual(cacheA.maxEntries, 16);
+  assert.strictEqual(cacheB.maxEntries, 16);
+
+  const secureOptions = SSL_OP_NO_TICKET;
+  const serverA = await listen({ sessionCache: cacheA, secureOptions });
+  const serverB = await listen({ sessionCache: cacheB, secureOptions });
+  const serverC = await listen({ secureOptions });
+
+  const { session } = await connect(serverA);
+  assert.strictEqual((await connect(serverB, session)).reused, true);
+  assert.strictEqual((await connect(serverA, session)).reused, true);
+  assert.strictEqual((await connect(serverC, session)).reused, false);
+
+  // Both caches report the operations of either server.
+  assert.deepStrictEqual(cacheA.getStats(), cacheB.getStats());
+  assert.strictEqual(cacheA.getStats().hits, 2);
+
+  // A server with 'resumeSession' listeners does not use the cache.
+  serverB.on('resumeSession', common.mustCall((id, callback) => {
+    callback(null, null);
+  }));
+  assert.strictEqual((await connect(serverB, session)).reused, false);
+
+  serverA.close();
+  serverB.close();
+  serverC.close();
+}
+
+async function testTicketKeyRotation() {
+  const secret = Buffer.alloc(32, 'secret');
+  const serverA = await listen({ ticketKeyRotation: { secret } });
+  const serverB = await listen({ ticketKeyRotation: { secret } });
+  const serverC = await listen({ ticketKeyRotation: true });
+  assert.deepStrictEqual(serverA.getTicketKeys(), serverB.getTicketKeys());
+  assert.notDeepStrictEqual(serverA.getTicketKeys(), serverC.getTicketKeys());
+
+  const { session } = await connect(serverA);
+  assert.strictEqual((await connect(serverB, session)).reused, true);
+  assert.strictEqual((await connect(serverC, session)).reused, false);
+
+  // Fixed keys replace the rotating ones.
+  const keys = Buffer.alloc(48, 'keys');
+  serverC.setTicketKeys(keys);
+  assert.deepStrictEqual(serverC.getTicketKeys(), keys);
+
+  serverA.close();
+  serverB.close();
+  serverC.close();
+}
+
+async function testTicketKeyOverlap() {
+  const server = await listen({
+    ticketKeyRotation: { interval: 1, overlap: 10 }
+  });
+  const keys = server.getTicketKeys();
+  const { session } = await connect(server);
+  await sleep(1100);
+  assert.notDeepStrictEqual(server.getTicketKeys(), keys);
+  assert.strictEqual((await connect(server, session)).reused, true);
+  server.close();
+}
+
+(async function() {
+  await testMemoryCache();
+  await testFileCache();
+  await testTicketKeyRotation();
+  await testTicketKeyOverlap();
+})().then(common.mustCall());
+
+{
+  // Neither a file of the wrong size nor one of the right size that does not
+  // hold a cache is used.
+  const cache = path.join(tmpdir.path, 'one-bucket');
+  tls.createSessionCache({ path: cache, maxEntries: 1 });
+  for (const size of [4096, fs.statSync(cache).size]) {
+    const file = path.join(tmpdir.path, `not-a-cache-${size}`);
+    fs.writeFileSync(file, 'x'.repeat(size), { mode: 0o600 });
+    common.expectsError(() => tls.createSessionCache({ path: file }), {
+      code: 'EINVAL',
+      syscall: 'open'
+    });
+  }
+}
+
+if (!common.isWindows) {
+  // Nor is a file that someone else could have written to, or a symlink.
+  const file = path.join(tmpdir.path, 'shared-sessions');
+  tls.createSessionCache({ path: file });
+  assert.strictEqual(fs.statSync(file).mode & 0o777, 0o600);
+  fs.chmodSync(file, 0o640);
+  common.expectsError(() => tls.createSessionCache({ path: file }), {
+    code: 'EACCES',
+    syscall: 'open'
+  });
+
+  const link = path.join(tmpdir.path, 'linked-sessions');
+  fs.chmodSync(file, 0o600);
+  fs.symlinkSync(file, link);
+  common.expectsError(() => tls.createSessionCache({ path: link }), {
+    code: 'ELOOP',
+    syscall: 'open'
+  });
+}
+
+common.expectsError(() => tls.createSessionCache({ path: 1 }), {
+  code: 'ERR_INVALID_ARG_TYPE',
+  type: TypeError
+});
+
+common.expectsError(() => tls.createSessionCache({ maxEntries: 0 }), {
+  code: 'ERR_OUT_OF_RANGE',
+  type: RangeError
+});
+
+common.expectsError(() => tls.createSessionCache({ ttl: -1 }), {
+  code: 'ERR_OUT_OF_RANGE',
+  type: RangeError
+});
+
+common.expectsError(() => tls.createServer({ sessionCache: {} }), {
+  code: 'ERR_INVALID_ARG_TYPE',
+  type: TypeError
+});
+
+common.expectsError(() => tls.createServer({
+  ticketKeys: Buffer.alloc(48),
+  ticketKeyRotation: true
+}), {
+  code: 'ERR_INCOMPATIBLE_OPTION_PAIR',
+  type: TypeError
+});
+
+common.expectsError(() => tls.createServer({
+  ticketKeyRotation: { secret: Buffer.alloc(16) }
+}), {
+  code: 'ERR_INVALID_ARG_VALUE',
+  type: TypeError
+});
+
+common.expectsError(() => tls.createServer({
+  ticketKeyRotation: { interval: 0 }
+}), {
+  code: 'ERR_OUT_OF_RANGE',
+  type: RangeError
+});
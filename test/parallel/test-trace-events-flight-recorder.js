@@ -0,0 +1,40 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const cp = require('child_process');
+const fs = require('fs');
+const path = require('path');
+
+// With --trace-event-flight-recorder, trace events are only written out when
+// the trace buffer is dumped, either explicitly or on a fatal error.
+
+const tmpdir = require('../common/tmpdir');
+
+function run(code, callback) {
+  tmpdir.refresh();
+  const proc = cp.spawn(process.execPath,
+                        [ '--trace-events-enabled',
+                          '--trace-event-flight-recorder',
+                          '-e', code ],
+                        { cwd: tmpdir.path });
+  proc.once('exit', common.mustCall(() => {
+    callback(path.join(tmpdir.path, 'node_trace.1.log'));
+  }));
+}
+
+run('setTimeout(() => {}, 1)', (file) => {
+  assert(!fs.existsSync(file));
+
+  run('setTimeout(() => require("trace_events").dumpTraceBuffer(), 1)',
+      (file) => {
+        const traces = JSON.parse(fs.readFileSync(file, 'utf8')).traceEvents;
+        assert(traces.length > 0);
+
+        // The file is not terminated when the process aborts, so only check
+        // that events have been written.
+        run('setTimeout(() => process.abort(), 1)', (file) => {
+          const data = fs.readFileSync(file, 'utf8');
+          assert(data.startsWith('{"traceEvents":[{'), data.slice(0, 32));
+        });
+      });
+});
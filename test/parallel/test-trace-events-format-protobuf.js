@@ -0,0 +1,33 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const cp = require('child_process');
+const fs = require('fs');
+const path = require('path');
+
+const tmpdir = require('../common/tmpdir');
+tmpdir.refresh();
+const FILE_NAME = path.join(tmpdir.path, 'node_trace.1.log');
+
+const proc = cp.spawn(process.execPath,
+                      [ '--trace-events-enabled',
+                        '--trace-event-format', 'protobuf',
+                        '-e', 'setTimeout(() => {}, 1)' ],
+                      { cwd: tmpdir.path });
+
+proc.once('exit', common.mustCall((code) => {
+  assert.strictEqual(code, 0);
+  const data = fs.readFileSync(FILE_NAME);
+  // Every trace packet is a length-delimited field 1 of the Trace message.
+  assert.strictEqual(data[0], 0x0a);
+  // Category and event names are interned and written as plain strings.
+  assert(data.includes('__metadata'));
+  assert(data.includes('process_name'));
+  assert(data.includes('node.async_hooks'));
+}));
+
+cp.exec(`"${process.execPath}" --trace-event-format=xml -e ""`,
+        common.mustCall((err, stdout, stderr) => {
+          assert.strictEqual(err.code, 9);
+          assert(stderr.includes('invalid value for --trace-event-format'));
+        }));
@@ -0,0 +1,99 @@
+'use strict';
+
+const common = require('../common');
+const assert = require('assert');
+const fixtures = require('../common/fixtures');
+const zlib = require('zlib');
+
+// This test ensures that the one-shot deflate methods produce valid output
+// when the input is compressed in blocks on several threads.
+
+// Several blocks' worth of compressible input that does not end on a block
+// boundary.
+const text = fixtures.readSync('person.jpg').toString('base64');
+const input = Buffer.from(text.repeat(Math.ceil(600 * 1024 / text.length)));
+assert.ok(input.length > 4 * 128 * 1024);
+
+for (const [compress, decompress] of [
+  ['gzip', 'gunzip'],
+  ['deflate', 'inflate'],
+  ['deflateRaw', 'inflateRaw']
+]) {
+  for (const level of [zlib.constants.Z_DEFAULT_COMPRESSION, 0, 1, 9]) {
+    for (const windowBits of [9, 15]) {
+      const opts = { parallel: 4, level, windowBits };
+      const compressed = zlib[`${compress}Sync`](input, opts);
+      assert.deepStrictEqual(
+        zlib[`${decompress}Sync`](compressed, { windowBits }), input);
+
+      if (compress === 'deflate') {
+        // The zlib header is the same as without `parallel`.
+        const serial = zlib.deflateSync(input, { level, windowBits });
+        assert.deepStrictEqual(compressed.slice(0, 2), serial.slice(0, 2));
+      }
+    }
+  }
+
+  zlib[compress](input, { parallel: 3 }, common.mustCall((err, compressed) => {
+    assert.ifError(err);
+    zlib[decompress](compressed, common.mustCall((err, result) => {
+      assert.ifError(err);
+      assert.deepStrictEqual(result, input);
+    }));
+  }));
+}
+
+// The gzip header and trailer match what zlib writes itself.
+{
+  const compressed = zlib.gzipSync(input, { parallel: 2 });
+  const serial = zlib.gzipSync(input);
+  assert.deepStrictEqual(compressed.slice(0, 10), serial.slice(0, 10));
+  assert.deepStrictEqual(compressed.slice(-8), serial.slice(-8));
+}
+
+// Strings and other kinds of input are accepted as well.
+{
+  const compressed = zlib.gzipSync(input.toString('latin1'), { parallel: 2 });
+  assert.deepStrictEqual(zlib.gunzipSync(compressed), input);
+}
+
+zlib.deflate(new Uint8Array(input), { parallel: 2 }, common.mustCall(
+  (err, compressed) => {
+    assert.ifError(err);
+    assert.deepStrictEqual(zlib.inflateSync(compressed), input);
+  }));
+
+// With `info`, the engine reports the number of bytes compressed.
+{
+  const { buffer, engine } = zlib.gzipSync(input, { parallel: 2, info: true });
+  assert.strictEqual(engine.bytesWritten, input.length);
+  assert.deepStrictEqual(zlib.gunzipSync(buffer), input);
+}
+
+// Input that fits into a single block, and compression with a dictionary,
+// are not split up.
+{
+  const small = input.slice(0, 1024);
+  assert.deepStrictEqual(zlib.deflateSync(small, { parallel: 4 }),
+                         zlib.deflateSync(small));
+
+  const dictionary = Buffer.from(text.slice(0, 1024));
+  assert.deepStrictEqual(
+    zlib.deflateSync(input, { parallel: 4, dictionary }),
+    zlib.deflateSync(input, { dictionary }));
+}
+
+for (const parallel of [0, 129, 1.5]) {
+  common.expectsError(() => zlib.gzipSync(input, { parallel }), {
+    code: 'ERR_OUT_OF_RANGE',
+    type: RangeError
+  });
+}
+
+common.expectsError(
+  () => zlib.gzip(input, { parallel: '2' }, common.mustNotCall()),
+  {
+    code: 'ERR_INVALID_ARG_TYPE',
+    type: TypeError
+  }
+);
@@ -0,0 +1,163 @@
+'use strict';
+
+const common = require('../common');
+const assert = require('assert');
+const zlib = require('zlib');
+
+// This test ensures that zlib pools compress and decompress batches of small
+// messages with reused zlib states, and with a shared dictionary.
+
+const dictionary = Buffer.from('{"type":"update","id":,"price":,"size":}');
+const messages = [];
+for (let i = 0; i < 300; i++) {
+  messages.push(Buffer.from(
+    JSON.stringify({ type: 'update', id: i, price: i * 3, size: i % 7 })));
+}
+// An empty message, and one that barely compresses and needs more room than
+// the others together.
+messages.push(Buffer.alloc(0));
+{
+  const noise = Buffer.alloc(32768);
+  let seed = 1;
+  for (let i = 0; i < noise.length; i++) {
+    seed = (seed * 1103515245 + 12345) & 0x7fffffff;
+    noise[i] = seed >> 16;
+  }
+  messages.push(noise);
+}
+
+for (const [compress, decompress, dict] of [
+  ['deflateRaw', 'inflateRaw', dictionary],
+  ['deflate', 'inflate', dictionary],
+  ['gzip', 'gunzip', undefined]
+]) {
+  const compressor = zlib.createPool(compress, { dictionary: dict });
+  const decompressor = zlib.createPool(decompress, { dictionary: dict });
+
+  // Every message is a complete stream on its own, and the zlib states of the
+  // pool are reused for the second round.
+  for (let round = 0; round < 2; round++) {
+    const compressed = compressor.batchSync(messages);
+    assert.strictEqual(compressed.length, messages.length);
+    compressed.forEach((buffer, i) => {
+      assert.deepStrictEqual(
+        zlib[`${decompress}Sync`](buffer, { dictionary: dict }), messages[i]);
+    });
+    assert.deepStrictEqual(decompressor.batchSync(compressed), messages);
+  }
+
+  compressor.batch(messages, common.mustCall((err, compressed) => {
+    assert.ifError(err);
+    decompressor.batch(compressed, common.mustCall((err, result) => {
+      assert.ifError(err);
+      assert.deepStrictEqual(result, messages);
+      compressor.close();
+      decompressor.close();
+    }));
+  }));
+}
+
+// The dictionary makes small messages smaller.
+{
+  const withDictionary = zlib.createPool('deflateRaw', { dictionary });
+  const without = zlib.createPool('deflateRaw');
+  const sizes = [withDictionary, without].map((pool) => {
+    return pool.batchSync(messages.slice(0, 100))
+      .reduce((size, buffer) => size + buffer.length, 0);
+  });
+  assert.ok(sizes[0] < sizes[1], `${sizes[0]} >= ${sizes[1]}`);
+}
+
+// Strings and other kinds of input are accepted as well.
+{
+  const pool = zlib.createPool('gzip', { level: 1 });
+  const [a, b, c] = pool.batchSync([
+    'hello', new Uint8Array([1, 2, 3]), new ArrayBuffer(8)
+  ]);
+  assert.strictEqual(zlib.gunzipSync(a).toString(), 'hello');
+  assert.deepStrictEqual(zlib.gunzipSync(b), Buffer.from([1, 2, 3]));
+  assert.deepStrictEqual(zlib.gunzipSync(c), Buffer.alloc(8));
+  assert.deepStrictEqual(pool.batchSync([]), []);
+  pool.batch([], common.mustCall((err, results) => {
+    assert.ifError(err);
+    assert.deepStrictEqual(results, []);
+  }));
+}
+
+// Invalid input fails the whole batch, and the pool stays usable.
+{
+  const pool = zlib.createPool('inflate');
+  const valid = zlib.deflateSync('valid');
+  common.expectsError(() => pool.batchSync([valid, Buffer.from('invalid')]), {
+    code: 'Z_DATA_ERROR',
+    type: Error,
+    message: 'incorrect header check'
+  });
+  assert.strictEqual(pool.batchSync([valid])[0].toString(), 'valid');
+
+  pool.batch([Buffer.from('invalid')], common.mustCall((err, results) => {
+    assert.strictEqual(err.code, 'Z_DATA_ERROR');
+    assert.strictEqual(err.errno, zlib.constants.Z_DATA_ERROR);
+    assert.strictEqual(results, undefined);
+  }));
+}
+
+// A context that failed is reset and reused, so that invalid input does not
+// make the pool use more memory.
+{
+  const pool = zlib.createPool('inflate');
+  const batch = [zlib.deflateSync('valid'), Buffer.from('invalid')];
+  const fail = () => {
+    assert.throws(() => pool.batchSync(batch), { code: 'Z_DATA_ERROR' });
+  };
+  fail();
+  const { external } = process.memoryUsage();
+  for (let i = 0; i < 4000; i++)
+    fail();
+  const growth = process.memoryUsage().external - external;
+  assert(growth < 4 * 1024 * 1024, `external memory grew by ${growth} bytes`);
+  assert.strictEqual(pool.batchSync(batch.slice(0, 1))[0].toString(), 'valid');
+  pool.close();
+}
+
+// A pool that is closed cannot be used anymore.
+{
+  const pool = zlib.createPool('deflate');
+  pool.close();
+  pool.close();
+  for (const method of ['batch', 'batchSync']) {
+    common.expectsError(() => pool[method](['data'], common.mustNotCall()), {
+      code: 'ERR_ZLIB_POOL_CLOSED',
+      type: Error,
+      message: `Cannot call ${method}() on a closed pool`
+    });
+  }
+}
+
+common.expectsError(() => zlib.createPool('unzip'), {
+  code: 'ERR_INVALID_ARG_VALUE',
+  type: TypeError
+});
+
+common.expectsError(() => zlib.createPool('deflate', { level: 10 }), {
+  code: 'ERR_OUT_OF_RANGE',
+  type: RangeError
+});
+
+{
+  const pool = zlib.createPool('deflate');
+  common.expectsError(() => pool.batchSync('data'), {
+    code: 'ERR_INVALID_ARG_TYPE',
+    type: TypeError
+  });
+  common.expectsError(() => pool.batchSync(['data', 42]), {
+    code: 'ERR_INVALID_ARG_TYPE',
+    type: TypeError,
+    message: 'The "buffers[1]" argument must be one of type string, Buffer, ' +
+             'TypedArray, DataView, or ArrayBuffer. Received type number'
+  });
+  common.expectsError(() => pool.batch(['data']), {
+    code: 'ERR_INVALID_CALLBACK',
+    type: TypeError
+  });
+}
@@ -123,6 +123,21 @@ if (common.hasCrypto) { // eslint-disable-line node-core/crypto-check
     testInitialized(this, 'AsyncWrap');
   }));
 
+  crypto.hash('sha256', Buffer.alloc(64 * 1024), common.mustCall(function() {
+    testInitialized(this, 'AsyncWrap');
+  }));
+
+  const privateKey = fixtures.readKey('rsa_private_1024.pem');
+  const sign = crypto.createSign('sha256').update('data');
+  sign.sign(privateKey, common.mustCall(function() {
+    testInitialized(this, 'AsyncWrap');
+  }));
+
+  crypto.privateEncrypt(privateKey, Buffer.from('data'),
+                        common.mustCall(function() {
+                          testInitialized(this, 'AsyncWrap');
+                        }));
+
   if (typeof internalBinding('crypto').scrypt === 'function') {
     crypto.scrypt('password', 'salt', 8, common.mustCall(function() {
       testInitialized(this, 'AsyncWrap');
@@ -192,6 +207,19 @@ if (common.hasCrypto) { // eslint-disable-line node-core/crypto-check
   testInitialized(new Signal(), 'Signal');
 }
 
+{
+  const { join } = require('path');
+  const { captureCpuProfile, captureHeapProfile } = require('v8');
+  captureCpuProfile({
+    duration: 1,
+    filename: join(tmpdir.path, 'getasyncid.cpuprofile')
+  }, common.mustCall());
+  captureHeapProfile({
+    duration: 1,
+    filename: join(tmpdir.path, 'getasyncid.heapprofile')
+  }, common.mustCall());
+}
+
 {
   async function openTest() {
     const fd = await fsPromises.open(__filename, 'r');
@@ -0,0 +1,95 @@
+// Flags: --experimental-worker
+'use strict';
+
+// Tests the heap snapshots written by v8.writeHeapSnapshot() and
+// --heapsnapshot-signal.
+
+const common = require('../common');
+const assert = require('assert');
+const fs = require('fs');
+const path = require('path');
+const { spawn } = require('child_process');
+const { writeHeapSnapshot } = require('v8');
+const { Worker } = require('worker_threads');
+
+const tmpdir = require('../common/tmpdir');
+tmpdir.refresh();
+process.chdir(tmpdir.path);
+
+function verifySnapshot(file) {
+  const snapshot = JSON.parse(fs.readFileSync(file, 'utf8'));
+  assert(snapshot.snapshot.meta.node_fields.length > 0);
+  assert(snapshot.nodes.length > 0);
+  assert(snapshot.strings.length > 0);
+}
+
+function getSnapshots() {
+  return fs.readdirSync(tmpdir.path)
+    .filter((file) => file.endsWith('.heapsnapshot'));
+}
+
+{
+  const filename = writeHeapSnapshot();
+  assert(/^Heap\.\d{8}\.\d{6}\.\d+\.0\.\d+\.heapsnapshot$/.test(filename),
+         filename);
+  verifySnapshot(filename);
+  fs.unlinkSync(filename);
+}
+
+{
+  const filename = path.join(tmpdir.path, 'my.heapdump');
+  assert.strictEqual(writeHeapSnapshot('my.heapdump'), filename);
+  verifySnapshot(filename);
+  fs.unlinkSync(filename);
+}
+
+[1, true, {}, [], null].forEach((filename) => {
+  common.expectsError(() => writeHeapSnapshot(filename), {
+    code: 'ERR_INVALID_ARG_TYPE'
+  });
+});
+
+common.expectsError(() => {
+  writeHeapSnapshot(path.join(tmpdir.path, 'missing', 'my.heapdump'));
+}, { code: 'ENOENT', syscall: 'open' });
+
+// Worker threads write snapshots of their own heap.
+{
+  const worker = new Worker(`
+    const { parentPort } = require('worker_threads');
+    const { writeHeapSnapshot } = require('v8');
+    parentPort.postMessage(writeHeapSnapshot());
+  `, { eval: true });
+  worker.once('message', common.mustCall((filename) => {
+    assert(/^Heap\.\d{8}\.\d{6}\.\d+\.[1-9]\d*\.\d+\.heapsnapshot$/
+      .test(filename), filename);
+    verifySnapshot(filename);
+    fs.unlinkSync(filename);
+    if (!common.isWindows)
+      testSignal();
+  }));
+}
+
+function testSignal() {
+  const child = spawn(process.execPath, [
+    '--heapsnapshot-signal', 'SIGUSR2',
+    '-e', 'process.send("ready"); process.on("message", () => process.exit());'
+  ], { cwd: tmpdir.path, stdio: ['inherit', 'inherit', 'inherit', 'ipc'] });
+  child.once('message', common.mustCall(() => {
+    child.kill('SIGUSR2');
+    // The snapshot is written on the child's main thread, so it is complete
+    // once the child reacts to messages again.
+    const interval = setInterval(() => {
+      if (getSnapshots().length === 0)
+        return;
+      clearInterval(interval);
+      child.send('exit');
+    }, 100);
+  }));
+  child.once('exit', common.mustCall((code) => {
+    assert.strictEqual(code, 0);
+    const snapshots = getSnapshots();
+    assert.strictEqual(snapshots.length, 1);
+    verifySnapshot(snapshots[0]);
+  }));
+}
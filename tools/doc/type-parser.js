@@ -119,6 +119,7 @@ const customTypesMap = {
 
   'tls.SecureContext': 'tls.html#tls_tls_createsecurecontext_options',
   'tls.Server': 'tls.html#tls_class_tls_server',
+  'tls.SessionCache': 'tls.html#tls_class_tls_sessioncache',
   'tls.TLSSocket': 'tls.html#tls_class_tls_tlssocket',
 
   'Tracing': 'tracing.html#tracing_tracing_object',
@@ -128,6 +129,7 @@ const customTypesMap = {
 
   'MessagePort': 'worker_threads.html#worker_threads_class_messageport',
 
+  'ZlibPool': 'zlib.html#zlib_class_zlibpool',
   'zlib options': 'zlib.html#zlib_class_options',
 };
 